@@ -314,6 +314,7 @@ extern "C" {
   /*lint -restore*/
   rtcnt_t port_rt_get_counter_value(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
 #ifdef __cplusplus
 }
 #endif
@@ -443,11 +444,12 @@ static inline void port_enable(void) {
  *          The simplest implementation is an empty function or macro but this
  *          would not take advantage of architecture-specific power saving
  *          modes.
- * @note    Implemented as an inlined @p WFI instruction.
+ * @note    Implemented by the simulator HAL, the host thread can sleep
+ *          until an interrupt source becomes active.
  */
 static inline void port_wait_for_interrupt(void) {
 
-  _sim_check_for_interrupts();
+  _sim_wait_for_interrupts();
 }
 
 #endif /* !defined(_FROM_ASM_) */
@@ -54,6 +54,16 @@
 #define HAL_CRY_ENFORCE_FALLBACK            FALSE
 #endif
 
+/**
+ * @brief   Enables the jobs queue API.
+ * @details When enabled, operations can be posted to the driver in batches
+ *          and are executed back to back by a dispatcher thread provided
+ *          by the application.
+ */
+#if !defined(HAL_CRY_USE_JOBS) || defined(__DOXYGEN__)
+#define HAL_CRY_USE_JOBS                    FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -107,6 +117,31 @@ typedef enum {
   cry_algo_hmac                             /**< HMAC variable size.        */
 } cryalgorithm_t;
 
+#if (HAL_CRY_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a job descriptor.
+ */
+typedef struct cry_job cry_job_t;
+
+/**
+ * @brief   Type of a driver jobs queue.
+ */
+typedef struct {
+  /**
+   * @brief   First job waiting for execution.
+   */
+  cry_job_t                 *head;
+  /**
+   * @brief   Last job waiting for execution.
+   */
+  cry_job_t                 *tail;
+  /**
+   * @brief   Dispatcher thread waiting for jobs.
+   */
+  thread_reference_t        dispatcher;
+} cry_jobs_queue_t;
+#endif
+
 #if HAL_CRY_ENFORCE_FALLBACK == FALSE
 /* Use the defined low level driver.*/
 #include "hal_crypto_lld.h"
@@ -150,6 +185,11 @@ typedef uint_fast8_t crykey_t;
 
 typedef struct CRYDriver CRYDriver;
 
+/* The fall-back keys are part of the driver structure.*/
+#if HAL_CRY_USE_FALLBACK == TRUE
+#include "hal_crypto_fallback.h"
+#endif
+
 typedef struct {
   uint32_t                  dummy;
 } CRYConfig;
@@ -157,13 +197,14 @@ typedef struct {
 struct CRYDriver {
   crystate_t                state;
   const CRYConfig           *config;
-};
-#endif /* HAL_CRY_ENFORCE_FALLBACK == TRUE */
-
-/* The fallback header is included only if required by settings.*/
+#if HAL_CRY_USE_JOBS == TRUE
+  cry_jobs_queue_t          jobs;
+#endif
 #if HAL_CRY_USE_FALLBACK == TRUE
-#include "hal_crypto_fallback.h"
+  cry_fallback_keys_t       fallback;
 #endif
+};
+#endif /* HAL_CRY_ENFORCE_FALLBACK == TRUE */
 
 #if (HAL_CRY_USE_FALLBACK == FALSE) && (CRY_LLD_SUPPORTS_SHA1 == FALSE)
 /* Stub @p SHA1Context structure type declaration. It is not provided by
@@ -205,6 +246,127 @@ typedef struct {
 } HMACSHA512Context;
 #endif
 
+#if (HAL_CRY_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Job operations.
+ */
+typedef enum {
+  CRY_JOB_LOAD_AES_KEY = 0,                 /**< Key in @p in, @p size.     */
+  CRY_JOB_LOAD_DES_KEY,                     /**< Key in @p in, @p size.     */
+  CRY_JOB_LOAD_HMAC_KEY,                    /**< Key in @p in, @p size.     */
+  CRY_JOB_ENCRYPT_AES_ECB,
+  CRY_JOB_DECRYPT_AES_ECB,
+  CRY_JOB_ENCRYPT_AES_CBC,
+  CRY_JOB_DECRYPT_AES_CBC,
+  CRY_JOB_ENCRYPT_AES_CFB,
+  CRY_JOB_DECRYPT_AES_CFB,
+  CRY_JOB_ENCRYPT_AES_CTR,
+  CRY_JOB_DECRYPT_AES_CTR,
+  CRY_JOB_ENCRYPT_AES_GCM,
+  CRY_JOB_DECRYPT_AES_GCM,
+  CRY_JOB_ENCRYPT_DES_ECB,
+  CRY_JOB_DECRYPT_DES_ECB,
+  CRY_JOB_ENCRYPT_DES_CBC,
+  CRY_JOB_DECRYPT_DES_CBC,
+  CRY_JOB_SHA1,                             /**< Digest of @p in in @p out. */
+  CRY_JOB_SHA256,                           /**< Digest of @p in in @p out. */
+  CRY_JOB_SHA512,                           /**< Digest of @p in in @p out. */
+  CRY_JOB_HMAC_SHA256,                      /**< MAC of @p in in @p out.    */
+  CRY_JOB_HMAC_SHA512                       /**< MAC of @p in in @p out.    */
+} cryjobop_t;
+
+/**
+ * @brief   Job states.
+ */
+typedef enum {
+  CRY_JOB_IDLE = 0,                         /**< Not posted.                */
+  CRY_JOB_QUEUED = 1,                       /**< Waiting for execution.     */
+  CRY_JOB_DONE = 2                          /**< Executed, @p err is valid. */
+} cryjobstate_t;
+
+/**
+ * @brief   Job completion callback type.
+ * @note    Callbacks are invoked from the dispatcher thread, outside of
+ *          critical zones.
+ */
+typedef void (*cryjobcb_t)(CRYDriver *cryp, cry_job_t *jobp);
+
+/**
+ * @brief   Structure representing a job.
+ * @details Each field has the meaning of the homonymous parameter of the
+ *          equivalent synchronous API, fields not used by the operation
+ *          are ignored.
+ */
+struct cry_job {
+  /**
+   * @brief   Next job in the driver queue.
+   * @note    Driver private field.
+   */
+  cry_job_t                 *next;
+  /**
+   * @brief   Job state.
+   */
+  volatile cryjobstate_t    state;
+  /**
+   * @brief   Thread waiting for the job completion.
+   * @note    Driver private field.
+   */
+  thread_reference_t        waiter;
+  /**
+   * @brief   Operation to be performed.
+   */
+  cryjobop_t                op;
+  /**
+   * @brief   Operation result.
+   */
+  cryerror_t                err;
+  /**
+   * @brief   Key to be used for the operation.
+   */
+  crykey_t                  key_id;
+  /**
+   * @brief   Size of the text, message or key.
+   */
+  size_t                    size;
+  /**
+   * @brief   Input text, message or key.
+   */
+  const uint8_t             *in;
+  /**
+   * @brief   Output text, digest or MAC.
+   */
+  uint8_t                   *out;
+  /**
+   * @brief   Input vector.
+   */
+  const uint8_t             *iv;
+  /**
+   * @brief   Size of the data to be authenticated.
+   */
+  size_t                    auth_size;
+  /**
+   * @brief   Data to be authenticated.
+   */
+  const uint8_t             *auth_in;
+  /**
+   * @brief   Size of the authentication tag.
+   */
+  size_t                    tag_size;
+  /**
+   * @brief   Authentication tag, written on encryption, read on decryption.
+   */
+  uint8_t                   *tag;
+  /**
+   * @brief   Completion callback or @p NULL.
+   */
+  cryjobcb_t                cb;
+  /**
+   * @brief   Callback argument.
+   */
+  void                      *arg;
+};
+#endif /* HAL_CRY_USE_JOBS == TRUE */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -372,6 +534,13 @@ extern "C" {
   cryerror_t cryHMACSHA512Final(CRYDriver *cryp,
                                 HMACSHA512Context *hmacsha512ctxp,
                                 uint8_t *out);
+#if HAL_CRY_USE_JOBS == TRUE
+  void cryPostJobsI(CRYDriver *cryp, cry_job_t *jobs, size_t n);
+  void cryPostJobs(CRYDriver *cryp, cry_job_t *jobs, size_t n);
+  msg_t cryWaitJobTimeout(CRYDriver *cryp, cry_job_t *jobp,
+                          sysinterval_t timeout);
+  msg_t cryDispatchJobsTimeout(CRYDriver *cryp, sysinterval_t timeout);
+#endif
 #ifdef __cplusplus
 }
 #endif
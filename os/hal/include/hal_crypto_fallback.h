@@ -0,0 +1,449 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_fallback.h
+ * @brief   Cryptographic Driver software fall-back macros and structures.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#ifndef HAL_CRYPTO_FALLBACK_H
+#define HAL_CRYPTO_FALLBACK_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Fall-back configuration options
+ * @{
+ */
+/**
+ * @brief   Number of AES lookup tables for each direction.
+ * @details With four tables each AES round is performed using only lookups
+ *          and XORs, the tables take 4kB for each direction. With a single
+ *          table the remaining three are obtained by rotation, the tables
+ *          take 1kB for each direction.
+ * @note    Allowed values are 1 and 4.
+ */
+#if !defined(CRY_FALLBACK_AES_TABLES) || defined(__DOXYGEN__)
+#define CRY_FALLBACK_AES_TABLES             4
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CRY_FALLBACK_AES_TABLES != 1) && (CRY_FALLBACK_AES_TABLES != 4)
+#error "invalid CRY_FALLBACK_AES_TABLES value"
+#endif
+
+/**
+ * @brief   The fall-back implements at least one AES mode.
+ */
+#define CRY_FALLBACK_USES_AES                                               \
+  ((CRY_LLD_SUPPORTS_AES == FALSE) || (CRY_LLD_SUPPORTS_AES_ECB == FALSE) ||\
+   (CRY_LLD_SUPPORTS_AES_CBC == FALSE) ||                                   \
+   (CRY_LLD_SUPPORTS_AES_CFB == FALSE) ||                                   \
+   (CRY_LLD_SUPPORTS_AES_CTR == FALSE) ||                                   \
+   (CRY_LLD_SUPPORTS_AES_GCM == FALSE))
+
+/**
+ * @brief   The fall-back implements at least one DES mode.
+ */
+#define CRY_FALLBACK_USES_DES                                               \
+  ((CRY_LLD_SUPPORTS_DES == FALSE) || (CRY_LLD_SUPPORTS_DES_ECB == FALSE) ||\
+   (CRY_LLD_SUPPORTS_DES_CBC == FALSE))
+
+/**
+ * @brief   The fall-back implements at least one HMAC algorithm.
+ */
+#define CRY_FALLBACK_USES_HMAC                                              \
+  ((CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) ||                               \
+   (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE))
+
+/**
+ * @brief   The fall-back keeps transient keys into the driver structure.
+ */
+#define CRY_FALLBACK_USES_KEYS                                              \
+  (CRY_FALLBACK_USES_AES || CRY_FALLBACK_USES_DES || CRY_FALLBACK_USES_HMAC)
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of the fall-back transient keys.
+ * @note    An instance is part of each @p CRYDriver structure so each
+ *          driver has its own set of keys.
+ */
+typedef struct {
+#if CRY_FALLBACK_USES_AES || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of rounds of the loaded AES key, zero if no key.
+   */
+  unsigned      aes_nr;
+  /**
+   * @brief   AES encryption round keys.
+   */
+  uint32_t      aes_erk[60];
+  /**
+   * @brief   AES decryption round keys.
+   */
+  uint32_t      aes_drk[60];
+#endif
+#if (CRY_LLD_SUPPORTS_AES_GCM == FALSE) || defined(__DOXYGEN__)
+  /**
+   * @brief   GHASH multiples of the hash subkey, high halves.
+   */
+  uint64_t      ghash_hh[16];
+  /**
+   * @brief   GHASH multiples of the hash subkey, low halves.
+   */
+  uint64_t      ghash_hl[16];
+#endif
+#if CRY_FALLBACK_USES_DES || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of DES keys loaded, one for DES, three for TDES, zero
+   *          if no key.
+   */
+  unsigned      des_nkeys;
+  /**
+   * @brief   DES round keys for each of the keys.
+   */
+  uint32_t      des_sk[3][32];
+#endif
+#if CRY_FALLBACK_USES_HMAC || defined(__DOXYGEN__)
+  /**
+   * @brief   HMAC key loaded.
+   */
+  bool          hmac_loaded;
+#endif
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+  /**
+   * @brief   SHA256 state after hashing the key XORed with ipad.
+   */
+  uint32_t      hmac256_istate[8];
+  /**
+   * @brief   SHA256 state after hashing the key XORed with opad.
+   */
+  uint32_t      hmac256_ostate[8];
+#endif
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+  /**
+   * @brief   SHA512 state after hashing the key XORed with ipad.
+   */
+  uint64_t      hmac512_istate[8];
+  /**
+   * @brief   SHA512 state after hashing the key XORed with opad.
+   */
+  uint64_t      hmac512_ostate[8];
+#endif
+#if !CRY_FALLBACK_USES_KEYS
+  uint32_t      dummy;
+#endif
+} cry_fallback_keys_t;
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA1 context.
+ */
+typedef struct {
+  /**
+   * @brief   Intermediate hash value.
+   */
+  uint32_t      state[5];
+  /**
+   * @brief   Number of bytes hashed so far.
+   */
+  uint64_t      count;
+  /**
+   * @brief   Partial block not yet hashed.
+   */
+  uint8_t       buffer[64];
+} SHA1Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA256 context used by the fall-back.
+ * @note    It is also the base of the HMAC_SHA256 fall-back context.
+ */
+typedef struct {
+  /**
+   * @brief   Intermediate hash value.
+   */
+  uint32_t      state[8];
+  /**
+   * @brief   Number of bytes hashed so far.
+   */
+  uint64_t      count;
+  /**
+   * @brief   Partial block not yet hashed.
+   */
+  uint8_t       buffer[64];
+} cry_fallback_sha256_t;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA512 context used by the fall-back.
+ * @note    It is also the base of the HMAC_SHA512 fall-back context.
+ */
+typedef struct {
+  /**
+   * @brief   Intermediate hash value.
+   */
+  uint64_t      state[8];
+  /**
+   * @brief   Number of bytes hashed so far.
+   */
+  uint64_t      count;
+  /**
+   * @brief   Partial block not yet hashed.
+   */
+  uint8_t       buffer[128];
+} cry_fallback_sha512_t;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA256 context.
+ */
+typedef cry_fallback_sha256_t SHA256Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA512 context.
+ */
+typedef cry_fallback_sha512_t SHA512Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a HMAC_SHA256 context.
+ */
+typedef struct {
+  /**
+   * @brief   Hash context, inner hash until finalization.
+   */
+  cry_fallback_sha256_t shactx;
+} HMACSHA256Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a HMAC_SHA512 context.
+ */
+typedef struct {
+  /**
+   * @brief   Hash context, inner hash until finalization.
+   */
+  cry_fallback_sha512_t shactx;
+} HMACSHA512Context;
+#endif
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  cryerror_t cry_fallback_aes_loadkey(CRYDriver *cryp,
+                                      size_t size,
+                                      const uint8_t *keyp);
+  cryerror_t cry_fallback_encrypt_AES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_CFB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CFB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_CTR(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CTR(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_GCM(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t auth_size,
+                                          const uint8_t *auth_in,
+                                          size_t text_size,
+                                          const uint8_t *text_in,
+                                          uint8_t *text_out,
+                                          const uint8_t *iv,
+                                          size_t tag_size,
+                                          uint8_t *tag_out);
+  cryerror_t cry_fallback_decrypt_AES_GCM(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t auth_size,
+                                          const uint8_t *auth_in,
+                                          size_t text_size,
+                                          const uint8_t *text_in,
+                                          uint8_t *text_out,
+                                          const uint8_t *iv,
+                                          size_t tag_size,
+                                          const uint8_t *tag_in);
+  cryerror_t cry_fallback_des_loadkey(CRYDriver *cryp,
+                                      size_t size,
+                                      const uint8_t *keyp);
+  cryerror_t cry_fallback_encrypt_DES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_decrypt_DES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_encrypt_DES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_decrypt_DES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_encrypt_DES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_DES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  void cry_fallback_init(CRYDriver *cryp);
+#if CRY_LLD_SUPPORTS_SHA1 == FALSE
+  cryerror_t cry_fallback_SHA1_init(CRYDriver *cryp, SHA1Context *sha1ctxp);
+  cryerror_t cry_fallback_SHA1_update(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                      size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA1_final(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                     uint8_t *out);
+#endif
+#if CRY_LLD_SUPPORTS_SHA256 == FALSE
+  cryerror_t cry_fallback_SHA256_init(CRYDriver *cryp,
+                                      SHA256Context *sha256ctxp);
+  cryerror_t cry_fallback_SHA256_update(CRYDriver *cryp,
+                                        SHA256Context *sha256ctxp,
+                                        size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA256_final(CRYDriver *cryp,
+                                       SHA256Context *sha256ctxp,
+                                       uint8_t *out);
+#endif
+#if CRY_LLD_SUPPORTS_SHA512 == FALSE
+  cryerror_t cry_fallback_SHA512_init(CRYDriver *cryp,
+                                      SHA512Context *sha512ctxp);
+  cryerror_t cry_fallback_SHA512_update(CRYDriver *cryp,
+                                        SHA512Context *sha512ctxp,
+                                        size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA512_final(CRYDriver *cryp,
+                                       SHA512Context *sha512ctxp,
+                                       uint8_t *out);
+#endif
+  cryerror_t cry_fallback_hmac_loadkey(CRYDriver *cryp,
+                                       size_t size,
+                                       const uint8_t *keyp);
+#if CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE
+  cryerror_t cry_fallback_HMACSHA256_init(CRYDriver *cryp,
+                                          HMACSHA256Context *hmacsha256ctxp);
+  cryerror_t cry_fallback_HMACSHA256_update(CRYDriver *cryp,
+                                            HMACSHA256Context *hmacsha256ctxp,
+                                            size_t size,
+                                            const uint8_t *in);
+  cryerror_t cry_fallback_HMACSHA256_final(CRYDriver *cryp,
+                                           HMACSHA256Context *hmacsha256ctxp,
+                                           uint8_t *out);
+#endif
+#if CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE
+  cryerror_t cry_fallback_HMACSHA512_init(CRYDriver *cryp,
+                                          HMACSHA512Context *hmacsha512ctxp);
+  cryerror_t cry_fallback_HMACSHA512_update(CRYDriver *cryp,
+                                            HMACSHA512Context *hmacsha512ctxp,
+                                            size_t size,
+                                            const uint8_t *in);
+  cryerror_t cry_fallback_HMACSHA512_final(CRYDriver *cryp,
+                                           HMACSHA512Context *hmacsha512ctxp,
+                                           uint8_t *out);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_CRYPTO_FALLBACK_H */
+
+/** @} */
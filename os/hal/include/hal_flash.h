@@ -170,6 +170,48 @@ typedef struct {
   uint32_t              size;
 } flash_descriptor_t;
 
+/**
+ * @brief   Statistics of a class of flash operations.
+ * @note    Times are expressed in system ticks, operations shorter than
+ *          the system tick are accounted with reduced accuracy.
+ */
+typedef struct {
+  /**
+   * @brief     Number of completed operations.
+   */
+  uint32_t              n;
+  /**
+   * @brief     Number of device status polls.
+   */
+  uint32_t              polls;
+  /**
+   * @brief     Shortest operation time.
+   */
+  sysinterval_t         best;
+  /**
+   * @brief     Longest operation time.
+   */
+  sysinterval_t         worst;
+  /**
+   * @brief     Cumulative time of all operations.
+   */
+  uint64_t              cumulative;
+} flash_op_stats_t;
+
+/**
+ * @brief   Flash operations statistics.
+ */
+typedef struct {
+  /**
+   * @brief     Program operations, one for each program call.
+   */
+  flash_op_stats_t      program;
+  /**
+   * @brief     Erase operations, from start to the completion detection.
+   */
+  flash_op_stats_t      erase;
+} flash_stats_t;
+
 /**
  * @brief   @p BaseFlash specific methods.
  */
@@ -189,7 +231,9 @@ typedef struct {
                                       flash_sector_t sector);               \
   flash_error_t (*query_erase)(void *instance, uint32_t *wait_time);        \
   /* Verify erase single sector.*/                                          \
-  flash_error_t (*verify_erase)(void *instance, flash_sector_t sector);
+  flash_error_t (*verify_erase)(void *instance, flash_sector_t sector);     \
+  /* Get operations statistics.*/                                           \
+  flash_error_t (*get_stats)(void *instance, flash_stats_t *sp);
 
 /**
  * @brief   @p BaseFlash specific methods with inherited ones.
@@ -348,6 +392,22 @@ typedef struct {
  */
 #define flashVerifyErase(ip, sector)                                        \
   (ip)->vmt->verify_erase(ip, sector)
+
+/**
+ * @brief   Returns the operations statistics.
+ *
+ * @param[in] ip                    pointer to a @p BaseFlash or derived class
+ * @param[out] sp                   pointer to the statistics structure to
+ *                                  be filled
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if the statistics have been returned.
+ * @retval FLASH_ERROR_UNIMPLEMENTED if the driver does not collect
+ *                                  statistics.
+ *
+ * @api
+ */
+#define flashGetStats(ip, sp)                                               \
+  (ip)->vmt->get_stats(ip, sp)
 /** @} */
 
 /*===========================================================================*/
@@ -108,6 +108,19 @@ typedef io_queue_t input_queue_t;
  */
 typedef io_queue_t output_queue_t;
 
+/**
+ * @brief   Type of a queue buffer area.
+ * @details Because of the circular nature of the queue buffer an area can
+ *          be split in two contiguous spans, the second span is empty
+ *          when the area does not cross the buffer boundary.
+ */
+typedef struct {
+  uint8_t               *p1;        /**< @brief First span pointer.         */
+  size_t                n1;         /**< @brief First span size.            */
+  uint8_t               *p2;        /**< @brief Second span pointer.        */
+  size_t                n2;         /**< @brief Second span size.           */
+} io_queue_span_t;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -309,6 +322,11 @@ extern "C" {
   size_t iqReadI(input_queue_t *iqp, uint8_t *bp, size_t n);
   size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
                        size_t n, sysinterval_t timeout);
+  size_t iqPeekI(input_queue_t *iqp, io_queue_span_t *sp);
+  size_t iqPeekTimeout(input_queue_t *iqp, size_t n, io_queue_span_t *sp,
+                       sysinterval_t timeout);
+  void iqConsumeI(input_queue_t *iqp, size_t n);
+  void iqConsume(input_queue_t *iqp, size_t n);
 
   void oqObjectInit(output_queue_t *oqp, uint8_t *bp, size_t size,
                     qnotify_t onfy, void *link);
@@ -319,6 +337,11 @@ extern "C" {
   size_t oqWriteI(output_queue_t *oqp, const uint8_t *bp, size_t n);
   size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
                         size_t n, sysinterval_t timeout);
+  size_t oqReserveI(output_queue_t *oqp, io_queue_span_t *sp);
+  size_t oqReserveTimeout(output_queue_t *oqp, size_t n, io_queue_span_t *sp,
+                          sysinterval_t timeout);
+  void oqCommitI(output_queue_t *oqp, size_t n);
+  void oqCommit(output_queue_t *oqp, size_t n);
 #ifdef __cplusplus
 }
 #endif
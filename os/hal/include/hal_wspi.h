@@ -133,6 +133,12 @@ typedef struct {
 #error "low level does not define WSPI_DEFAULT_CFG_MASKS"
 #endif
 
+/* Hardware status polling is an optional capability, low level drivers
+   not declaring it do not support it.*/
+#if !defined(WSPI_SUPPORTS_POLLING)
+#define WSPI_SUPPORTS_POLLING               FALSE
+#endif
+
 /**
  * @brief   Driver configuration structure.
  */
@@ -319,6 +325,34 @@ struct hal_wspi_driver {
   wspi_lld_receive(wspip, cmdp, n, rxbuf);                                  \
 }
 
+#if (WSPI_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Polls a device status register.
+ * @details This asynchronous function starts a status polling operation,
+ *          the command is repeated by the controller without CPU
+ *          intervention until the received byte, masked by @p mask,
+ *          is equal to @p match.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor, the data phase
+ *                      is one byte
+ * @param[in] mask      mask of the status bits to be checked
+ * @param[in] match     expected value of the masked status bits
+ * @param[out] statusp  pointer to the location receiving the last status
+ *                      byte
+ *
+ * @iclass
+ */
+#define wspiStartPollI(wspip, cmdp, mask, match, statusp) {                 \
+  osalDbgAssert(((cmdp)->cfg & WSPI_CFG_DATA_MODE_MASK) !=                  \
+                WSPI_CFG_DATA_MODE_NONE,                                    \
+                "data mode required");                                      \
+  (wspip)->state = WSPI_RECEIVE;                                            \
+  wspi_lld_poll(wspip, cmdp, mask, match, statusp);                         \
+}
+#endif /* WSPI_SUPPORTS_POLLING == TRUE */
+
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Maps in memory space a WSPI flash device.
@@ -447,6 +481,14 @@ extern "C" {
   bool wspiReceive(WSPIDriver *wspip, const wspi_command_t *cmdp,
                    size_t n, uint8_t *rxbuf);
 #endif
+#if WSPI_SUPPORTS_POLLING == TRUE
+  void wspiStartPoll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     uint8_t mask, uint8_t match, uint8_t *statusp);
+#if WSPI_USE_WAIT == TRUE
+  bool wspiPoll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                uint8_t mask, uint8_t match, uint8_t *statusp);
+#endif
+#endif
 #if WSPI_SUPPORTS_MEMMAP == TRUE
 void wspiMapFlash(WSPIDriver *wspip,
                   const wspi_command_t *cmdp,
@@ -0,0 +1,128 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_crc_engine.h
+ * @brief   CRC engine module header.
+ *
+ * @addtogroup HAL_CRC_ENGINE
+ * @{
+ */
+
+#ifndef HAL_CRC_ENGINE_H
+#define HAL_CRC_ENGINE_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    CRC parameters
+ * @{
+ */
+/**
+ * @brief   CRC16-CCITT initial value.
+ */
+#define CRC16_CCITT_INIT                    0xFFFFU
+
+/**
+ * @brief   CRC32 initial value.
+ */
+#define CRC32_INIT                          0xFFFFFFFFU
+
+/**
+ * @brief   CRC32 final XOR value.
+ */
+#define CRC32_XOROUT                        0xFFFFFFFFU
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of bytes processed for each step.
+ * @details The software implementation uses one lookup table for each
+ *          processed byte, the tables size is 512 bytes each for CRC16
+ *          and 1024 bytes each for CRC32.
+ * @note    Allowed values are 1, 4 and 8.
+ */
+#if !defined(CRC_CFG_SLICES) || defined(__DOXYGEN__)
+#define CRC_CFG_SLICES                      4
+#endif
+
+#if defined(__DOXYGEN__)
+/**
+ * @brief   Accelerated CRC16 implementation.
+ * @details If defined then @p crc16() invokes it instead of the software
+ *          implementation, it can be used to route the calculation to a
+ *          CRC peripheral. The interface is the same of @p crc16().
+ */
+#define CRC_CFG_CRC16_ACCEL(crc, data, n)
+
+/**
+ * @brief   Accelerated CRC32 implementation.
+ * @details If defined then @p crc32() invokes it instead of the software
+ *          implementation, it can be used to route the calculation to a
+ *          CRC peripheral. The interface is the same of @p crc32().
+ */
+#define CRC_CFG_CRC32_ACCEL(crc, data, n)
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CRC_CFG_SLICES != 1) && (CRC_CFG_SLICES != 4) && (CRC_CFG_SLICES != 8)
+#error "invalid CRC_CFG_SLICES value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  uint16_t crc16(uint16_t crc, const uint8_t *data, size_t n);
+  uint32_t crc32(uint32_t crc, const uint8_t *data, size_t n);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* HAL_CRC_ENGINE_H */
+
+/** @} */
@@ -0,0 +1,15 @@
+# The CRC engine can be required by several modules, it is only added
+# once.
+ifeq ($(CRCENGSRC),)
+
+# List of all the CRC engine files.
+CRCENGSRC := $(CHIBIOS)/os/hal/lib/complex/crc/hal_crc_engine.c
+
+# Required include directories
+CRCENGINC := $(CHIBIOS)/os/hal/lib/complex/crc
+
+# Shared variables
+ALLCSRC += $(CRCENGSRC)
+ALLINC  += $(CRCENGINC)
+
+endif
@@ -62,6 +62,19 @@
 #define ALIGNED_SIZEOF(t)                                                   \
   (((sizeof (t) - 1U) | MFS_ALIGN_MASK) + 1U)
 
+/**
+ * @brief   Offset of a checkpoint slot in a bank.
+ */
+#define SLOT_OFFSET(i)                                                      \
+  (ALIGNED_SIZEOF(mfs_bank_header_t) +                                      \
+   (ALIGNED_SIZEOF(mfs_checkpoint_slot_t) * (i)))
+
+/**
+ * @brief   Descriptors hash table slot for a record identifier.
+ */
+#define HASH_SLOT(id)                                                       \
+  (unsigned)(((uint32_t)(id) * 2654435761U) % (uint32_t)MFS_CFG_MAX_RECORDS)
+
 /**
  * @brief   Combines two values (0..3) in one (0..15).
  */
@@ -85,70 +98,190 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
-static const uint16_t crc16_table[256] = {
-  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
-  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
-  0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
-  0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
-  0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
-  0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
-  0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
-  0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
-  0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
-  0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
-  0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
-  0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
-  0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
-  0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
-  0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
-  0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
-  0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
-  0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
-  0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
-  0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
-  0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
-  0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
-  0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
-  0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
-  0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
-  0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
-  0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
-  0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
-  0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
-  0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
-  0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
-  0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
-};
-
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
-uint16_t crc16(uint16_t crc, const uint8_t *data, size_t n) {
+static void mfs_descriptors_reset(MFSDriver *mfsp) {
+  unsigned i;
 
-  while (n > 0U) {
-    crc = (crc << 8U) ^ crc16_table[(crc >> 8U) ^ (uint16_t)*data];
-    data++;
-    n--;
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    mfsp->descriptors[i].offset = 0U;
+    mfsp->descriptors[i].size   = 0U;
   }
-
-  return crc;
+  mfsp->records_count = 0U;
 }
 
 static void mfs_state_reset(MFSDriver *mfsp) {
-  unsigned i;
 
   mfsp->current_bank    = MFS_BANK_0;
   mfsp->current_counter = 0U;
   mfsp->next_offset     = 0U;
   mfsp->used_space      = 0U;
+  mfsp->gc_active       = false;
+  mfsp->gc_dirty        = false;
+  mfsp->gc_waste        = false;
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  mfsp->cp_slot         = 0U;
+  mfsp->cp_records      = 0U;
+#endif
 
-  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
-    mfsp->descriptors[i].offset = 0U;
-    mfsp->descriptors[i].size   = 0U;
+  mfs_descriptors_reset(mfsp);
+}
+
+#if (MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS) || defined(__DOXYGEN__)
+/**
+ * @brief   Searches the descriptor of a record.
+ * @details The descriptors table is an open addressing hash table with
+ *          linear probing, the search ends on the first free entry.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @return              The record descriptor.
+ * @retval NULL         if the record does not exist.
+ *
+ * @notapi
+ */
+static mfs_record_descriptor_t *mfs_descriptor_find(MFSDriver *mfsp,
+                                                    mfs_id_t id) {
+  unsigned i, n;
+
+  i = HASH_SLOT(id);
+  for (n = 0U; n < MFS_CFG_MAX_RECORDS; n++) {
+    mfs_record_descriptor_t *dp = &mfsp->descriptors[i];
+
+    if (dp->offset == 0U) {
+      break;
+    }
+    if (dp->id == id) {
+      return dp;
+    }
+    if (++i >= MFS_CFG_MAX_RECORDS) {
+      i = 0U;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Creates or updates the descriptor of a record.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @param[in] offset    offset of the record header
+ * @param[in] size      record data size
+ * @return              The operation result.
+ * @retval false        if the descriptors table is full.
+ *
+ * @notapi
+ */
+static bool mfs_descriptor_set(MFSDriver *mfsp, mfs_id_t id,
+                               flash_offset_t offset, uint32_t size) {
+  unsigned i, n;
+
+  i = HASH_SLOT(id);
+  for (n = 0U; n < MFS_CFG_MAX_RECORDS; n++) {
+    mfs_record_descriptor_t *dp = &mfsp->descriptors[i];
+
+    if (dp->offset == 0U) {
+      /* Free entry, the record is new.*/
+      dp->id = id;
+      mfsp->records_count++;
+    }
+    if (dp->id == id) {
+      dp->offset = offset;
+      dp->size   = size;
+      return true;
+    }
+    if (++i >= MFS_CFG_MAX_RECORDS) {
+      i = 0U;
+    }
   }
+
+  return false;
 }
 
+/**
+ * @brief   Removes the descriptor of a record.
+ * @details Entries following the removed one are shifted back in order
+ *          to not leave holes in the probing sequences.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ *
+ * @notapi
+ */
+static void mfs_descriptor_clear(MFSDriver *mfsp, mfs_id_t id) {
+  mfs_record_descriptor_t *dp;
+  unsigned i, j;
+
+  dp = mfs_descriptor_find(mfsp, id);
+  if (dp == NULL) {
+    return;
+  }
+
+  i = (unsigned)(dp - &mfsp->descriptors[0]);
+  mfsp->descriptors[i].offset = 0U;
+  mfsp->descriptors[i].size   = 0U;
+  mfsp->records_count--;
+
+  j = i;
+  while (true) {
+    unsigned k;
+
+    if (++j >= MFS_CFG_MAX_RECORDS) {
+      j = 0U;
+    }
+    if (mfsp->descriptors[j].offset == 0U) {
+      break;
+    }
+
+    /* The entry is moved into the hole unless its home slot lies
+       cyclically in (i, j].*/
+    k = HASH_SLOT(mfsp->descriptors[j].id);
+    if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+      continue;
+    }
+    mfsp->descriptors[i] = mfsp->descriptors[j];
+    mfsp->descriptors[j].offset = 0U;
+    mfsp->descriptors[j].size   = 0U;
+    i = j;
+  }
+}
+
+#else /* MFS_CFG_MAX_ID <= MFS_CFG_MAX_RECORDS */
+static mfs_record_descriptor_t *mfs_descriptor_find(MFSDriver *mfsp,
+                                                    mfs_id_t id) {
+  mfs_record_descriptor_t *dp = &mfsp->descriptors[id - 1U];
+
+  return dp->offset != 0U ? dp : NULL;
+}
+
+static bool mfs_descriptor_set(MFSDriver *mfsp, mfs_id_t id,
+                               flash_offset_t offset, uint32_t size) {
+  mfs_record_descriptor_t *dp = &mfsp->descriptors[id - 1U];
+
+  if (dp->offset == 0U) {
+    mfsp->records_count++;
+  }
+  dp->offset = offset;
+  dp->size   = size;
+
+  return true;
+}
+
+static void mfs_descriptor_clear(MFSDriver *mfsp, mfs_id_t id) {
+  mfs_record_descriptor_t *dp = &mfsp->descriptors[id - 1U];
+
+  if (dp->offset != 0U) {
+    mfsp->records_count--;
+  }
+  dp->offset = 0U;
+  dp->size   = 0U;
+}
+#endif /* MFS_CFG_MAX_ID <= MFS_CFG_MAX_RECORDS */
+
 static flash_offset_t mfs_flash_get_bank_offset(MFSDriver *mfsp,
                                                 mfs_bank_t bank) {
 
@@ -227,10 +360,31 @@ static mfs_error_t mfs_flash_write(MFSDriver *mfsp,
   return MFS_NO_ERROR;
 }
 
+/**
+ * @brief   Returns the buffer used for data copy.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[out] np       size of the buffer
+ * @return              Pointer to the buffer.
+ *
+ * @notapi
+ */
+static uint8_t *mfs_copy_get_buffer(MFSDriver *mfsp, size_t *np) {
+
+  if (mfsp->config->gc_buffer != NULL) {
+    *np = mfsp->config->gc_buffer_size;
+    return mfsp->config->gc_buffer;
+  }
+
+  *np = MFS_CFG_BUFFER_SIZE;
+  return mfsp->buffer.data8;
+}
+
 /**
  * @brief   Flash copy.
- * @note    If the option @p MFS_CFG_WRITE_VERIFY is enabled then the flash
- *          is also read back for verification.
+ * @details The device-side copy function is used if configured, otherwise
+ *          data is copied through the garbage collection buffer.
+ * @note    Copied data is not verified, see @p mfs_record_verify().
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] doffset   destination flash offset
@@ -244,21 +398,39 @@ static mfs_error_t mfs_flash_copy(MFSDriver *mfsp,
                                   flash_offset_t doffset,
                                   flash_offset_t soffset,
                                   uint32_t n) {
+  flash_error_t ferr;
+  uint8_t *buf;
+  size_t bufsize;
 
-  /* Splitting the operation in smaller operations because the buffer is
-     small.*/
+  if (mfsp->config->gc_copy != NULL) {
+    ferr = mfsp->config->gc_copy(mfsp->config->flashp,
+                                 doffset, soffset, (size_t)n);
+    if (ferr != FLASH_NO_ERROR) {
+      mfsp->state = MFS_ERROR;
+      return MFS_ERR_FLASH_FAILURE;
+    }
+
+    return MFS_NO_ERROR;
+  }
+
+  /* Splitting the operation in buffer-sized operations.*/
+  buf = mfs_copy_get_buffer(mfsp, &bufsize);
   while (n > 0U) {
-    /* Data size that can be written in a single program page operation.*/
-    size_t chunk = (size_t)(((doffset | (MFS_CFG_BUFFER_SIZE - 1U)) + 1U) -
-                            doffset);
+    /* Data size that can be written in a single program operation, writes
+       are aligned to the buffer size.*/
+    size_t chunk = bufsize - (size_t)(doffset % (flash_offset_t)bufsize);
     if (chunk > n) {
       chunk = n;
     }
 
-    RET_ON_ERROR(mfs_flash_read(mfsp, soffset, chunk, mfsp->buffer.data8));
-    RET_ON_ERROR(mfs_flash_write(mfsp, doffset, chunk, mfsp->buffer.data8));
+    RET_ON_ERROR(mfs_flash_read(mfsp, soffset, chunk, buf));
+    ferr = flashProgram(mfsp->config->flashp, doffset, chunk, buf);
+    if (ferr != FLASH_NO_ERROR) {
+      mfsp->state = MFS_ERROR;
+      return MFS_ERR_FLASH_FAILURE;
+    }
 
-    /* Next page.*/
+    /* Next chunk.*/
     soffset += chunk;
     doffset += chunk;
     n       -= chunk;
@@ -267,6 +439,61 @@ static mfs_error_t mfs_flash_copy(MFSDriver *mfsp,
   return MFS_NO_ERROR;
 }
 
+#if (MFS_CFG_WRITE_VERIFY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Verifies a copied record.
+ * @details The record is read back calculating the CRC of its data, the
+ *          result is compared with the CRC stored in the record header.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] offset    offset of the record header
+ * @param[in] size      expected record data size
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_record_verify(MFSDriver *mfsp,
+                                     flash_offset_t offset,
+                                     uint32_t size) {
+  uint8_t *buf;
+  size_t bufsize;
+  uint16_t crc, hcrc;
+
+  RET_ON_ERROR(mfs_flash_read(mfsp, offset,
+                              sizeof (mfs_data_header_t),
+                              mfsp->buffer.data8));
+  if ((mfsp->buffer.dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
+      (mfsp->buffer.dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
+      (mfsp->buffer.dhdr.fields.size != size)) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+  hcrc = mfsp->buffer.dhdr.fields.crc;
+
+  /* Running CRC on the read back data, the buffer could be the same
+     containing the header.*/
+  buf = mfs_copy_get_buffer(mfsp, &bufsize);
+  offset += sizeof (mfs_data_header_t);
+  crc = 0xFFFFU;
+  while (size > 0U) {
+    size_t chunk = size > bufsize ? bufsize : (size_t)size;
+
+    RET_ON_ERROR(mfs_flash_read(mfsp, offset, chunk, buf));
+    crc = MFS_CFG_CRC16(crc, buf, chunk);
+
+    offset += chunk;
+    size   -= chunk;
+  }
+
+  if (crc != hcrc) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+
+  return MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_WRITE_VERIFY == TRUE */
+
 /**
  * @brief   Erases and verifies all sectors belonging to a bank.
  *
@@ -379,8 +606,9 @@ static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
   bhdr.fields.magic2    = MFS_BANK_MAGIC_2;
   bhdr.fields.counter   = cnt;
   bhdr.fields.reserved1 = (uint16_t)mfsp->config->erased;
-  bhdr.fields.crc       = crc16(0xFFFFU, bhdr.hdr8,
-                                sizeof (mfs_bank_header_t) - sizeof (uint16_t));
+  bhdr.fields.crc       = MFS_CFG_CRC16(0xFFFFU, bhdr.hdr8,
+                                        sizeof (mfs_bank_header_t) -
+                                        sizeof (uint16_t));
 
   return mfs_flash_write(mfsp,
                          flashGetSectorOffset(mfsp->config->flashp, sector),
@@ -415,8 +643,8 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
   }
 
   /* Verifying header CRC.*/
-  crc = crc16(0xFFFFU, mfsp->buffer.bhdr.hdr8,
-              sizeof (mfs_bank_header_t) - sizeof (uint16_t));
+  crc = MFS_CFG_CRC16(0xFFFFU, mfsp->buffer.bhdr.hdr8,
+                      sizeof (mfs_bank_header_t) - sizeof (uint16_t));
   if (crc != mfsp->buffer.bhdr.fields.crc) {
     return MFS_BANK_GARBAGE;
   }
@@ -424,6 +652,333 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
   return MFS_BANK_OK;
 }
 
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Restores a checkpoint entry into the descriptors table.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] entryp    pointer to the checkpoint entry
+ * @param[in] start     offset of the first record in the bank
+ * @param[in] end       offset of the checkpoint record
+ * @return              The operation result.
+ * @retval false        if the entry is not valid.
+ *
+ * @notapi
+ */
+static bool mfs_checkpoint_restore_entry(MFSDriver *mfsp,
+                                         const mfs_checkpoint_entry_t *entryp,
+                                         flash_offset_t start,
+                                         flash_offset_t end) {
+
+  if ((entryp->fields.id < 1U) ||
+      (entryp->fields.id > (uint32_t)MFS_CFG_MAX_ID) ||
+      (entryp->fields.offset < start) ||
+      (entryp->fields.offset >= end) ||
+      (entryp->fields.size == 0U) ||
+      (entryp->fields.size > end - entryp->fields.offset)) {
+    return false;
+  }
+
+  return mfs_descriptor_set(mfsp, (mfs_id_t)entryp->fields.id,
+                            entryp->fields.offset, entryp->fields.size);
+}
+
+/**
+ * @brief   Restores the records index from the most recent checkpoint.
+ * @details The checkpoint slots are scanned in order to locate the most
+ *          recent valid checkpoint, if found then the descriptors table
+ *          is loaded from the checkpoint record.
+ * @note    Any anomaly makes the function fall back to a full scan of the
+ *          bank, the scan then detects and reports damaged records.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[out] offsetp  offset of the first record to be scanned
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_load(MFSDriver *mfsp,
+                                       mfs_bank_t bank,
+                                       flash_offset_t *offsetp) {
+  flash_offset_t bank_offset, start_offset, end_offset, cp_offset, data;
+  mfs_checkpoint_entry_t entry;
+  uint32_t i, size, total;
+  uint16_t crc, hdr_crc;
+  bool valid;
+
+  /* Boundaries.*/
+  bank_offset  = mfs_flash_get_bank_offset(mfsp, bank);
+  start_offset = bank_offset + (flash_offset_t)MFS_RECORDS_OFFSET;
+  end_offset   = bank_offset + mfsp->config->bank_size;
+  *offsetp     = start_offset;
+
+  /* Searching for the most recent valid slot, slots are written in
+     sequence so the search ends on the first erased one.*/
+  cp_offset = 0U;
+  for (i = 0U; i < (uint32_t)MFS_CFG_CHECKPOINT_SLOTS; i++) {
+    mfs_checkpoint_slot_t *slotp = &mfsp->buffer.slot;
+
+    RET_ON_ERROR(mfs_flash_read(mfsp, bank_offset + SLOT_OFFSET(i),
+                                sizeof (mfs_checkpoint_slot_t),
+                                mfsp->buffer.data8));
+
+    if ((slotp->hdr32[0] == mfsp->config->erased) &&
+        (slotp->hdr32[1] == mfsp->config->erased) &&
+        (slotp->hdr32[2] == mfsp->config->erased) &&
+        (slotp->hdr32[3] == mfsp->config->erased)) {
+      break;
+    }
+
+    /* Damaged slots are skipped, the previous checkpoint is used.*/
+    if ((slotp->fields.magic == MFS_CHECKPOINT_MAGIC) &&
+        (slotp->fields.counter == mfsp->current_counter) &&
+        (slotp->fields.reserved1 == (uint16_t)mfsp->config->erased) &&
+        (slotp->fields.offset >= start_offset) &&
+        (slotp->fields.offset < end_offset - ALIGNED_DHDR_SIZE) &&
+        (slotp->fields.crc == MFS_CFG_CRC16(0xFFFFU, slotp->hdr8,
+                                            sizeof (mfs_checkpoint_slot_t) -
+                                            sizeof (uint16_t)))) {
+      cp_offset = slotp->fields.offset;
+    }
+  }
+  mfsp->cp_slot = i;
+
+  if (cp_offset == 0U) {
+    return MFS_NO_ERROR;
+  }
+
+  /* Reading and checking the checkpoint record header.*/
+  RET_ON_ERROR(mfs_flash_read(mfsp, cp_offset,
+                              sizeof (mfs_data_header_t),
+                              mfsp->buffer.data8));
+  if ((mfsp->buffer.dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
+      (mfsp->buffer.dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
+      (mfsp->buffer.dhdr.fields.id != 0U) ||
+      ((mfsp->buffer.dhdr.fields.size % sizeof (mfs_checkpoint_entry_t)) != 0U) ||
+      (mfsp->buffer.dhdr.fields.size > MFS_CFG_MAX_RECORDS *
+                                       sizeof (mfs_checkpoint_entry_t)) ||
+      (mfsp->buffer.dhdr.fields.size > end_offset - cp_offset -
+                                       ALIGNED_DHDR_SIZE)) {
+    return MFS_NO_ERROR;
+  }
+  size    = mfsp->buffer.dhdr.fields.size;
+  hdr_crc = mfsp->buffer.dhdr.fields.crc;
+
+  /* Loading the entries, the CRC is verified on the whole record so the
+     table could be reset at the end.*/
+  valid = true;
+  crc   = 0xFFFFU;
+  data  = cp_offset + sizeof (mfs_data_header_t);
+  total = size;
+  i     = 0U;
+  while (total > 0U) {
+    uint32_t j, chunk = total > MFS_CFG_BUFFER_SIZE ? MFS_CFG_BUFFER_SIZE :
+                                                     total;
+
+    /* Reading the data chunk.*/
+    RET_ON_ERROR(mfs_flash_read(mfsp, data, chunk, mfsp->buffer.data8));
+
+    /* CRC on the read data chunk.*/
+    crc = MFS_CFG_CRC16(crc, &mfsp->buffer.data8[0], chunk);
+
+    /* Entries can span across chunks.*/
+    for (j = 0U; j < chunk; j++) {
+      entry.entry8[i++] = mfsp->buffer.data8[j];
+      if (i >= sizeof (mfs_checkpoint_entry_t)) {
+        i = 0U;
+        if (valid) {
+          valid = mfs_checkpoint_restore_entry(mfsp, &entry,
+                                               start_offset, cp_offset);
+        }
+      }
+    }
+
+    /* Next chunk.*/
+    data  += chunk;
+    total -= chunk;
+  }
+
+  if (!valid || (crc != hdr_crc)) {
+    mfs_descriptors_reset(mfsp);
+    return MFS_NO_ERROR;
+  }
+
+  /* The scan continues after the checkpoint record.*/
+  *offsetp = cp_offset + ALIGNED_REC_SIZE(size);
+  mfsp->cp_records = 0U;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Fills a checkpoint entry from the descriptors table.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] i         index of the descriptors table entry to start from
+ * @param[out] entryp   pointer to the checkpoint entry
+ * @return              The index of the descriptors table entry following
+ *                      the one used for the checkpoint entry.
+ *
+ * @notapi
+ */
+static unsigned mfs_checkpoint_get_entry(MFSDriver *mfsp, unsigned i,
+                                         mfs_checkpoint_entry_t *entryp) {
+
+  while (mfsp->descriptors[i].offset == 0U) {
+    i++;
+  }
+
+  osalDbgAssert(i < MFS_CFG_MAX_RECORDS, "descriptors table overrun");
+
+#if MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS
+  entryp->fields.id     = (uint32_t)mfsp->descriptors[i].id;
+#else
+  entryp->fields.id     = (uint32_t)i + 1U;
+#endif
+  entryp->fields.offset = (uint32_t)mfsp->descriptors[i].offset;
+  entryp->fields.size   = mfsp->descriptors[i].size;
+
+  return i + 1U;
+}
+
+/**
+ * @brief   Writes a checkpoint in the current bank.
+ * @details The checkpoint record is appended to the bank like a normal
+ *          record then the checkpoint is validated by writing the next free
+ *          slot.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ * @retval MFS_ERR_OUT_OF_MEM       if there are no free slots or there is
+ *                                  not enough free space in the bank.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_write(MFSDriver *mfsp) {
+  mfs_checkpoint_entry_t entry;
+  mfs_checkpoint_slot_t slot;
+  flash_offset_t bank_offset, free, doffset;
+  uint32_t size, n;
+  unsigned i, pos;
+  uint16_t crc;
+
+  bank_offset = mfs_flash_get_bank_offset(mfsp, mfsp->current_bank);
+  size        = mfsp->records_count * sizeof (mfs_checkpoint_entry_t);
+  free        = (bank_offset + mfsp->config->bank_size) - mfsp->next_offset;
+  if ((mfsp->cp_slot >= (uint32_t)MFS_CFG_CHECKPOINT_SLOTS) ||
+      (ALIGNED_REC_SIZE(size) > free)) {
+    return MFS_ERR_OUT_OF_MEM;
+  }
+
+  /* The CRC is calculated in advance because the header is written
+     before the data.*/
+  crc = 0xFFFFU;
+  i   = 0U;
+  for (n = 0U; n < mfsp->records_count; n++) {
+    i = mfs_checkpoint_get_entry(mfsp, i, &entry);
+    crc = MFS_CFG_CRC16(crc, entry.entry8, sizeof (mfs_checkpoint_entry_t));
+  }
+
+  /* Writing the data header without the magic, it will be written last.*/
+  mfsp->buffer.dhdr.fields.id     = 0U;
+  mfsp->buffer.dhdr.fields.size   = size;
+  mfsp->buffer.dhdr.fields.crc    = crc;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset + (sizeof (uint32_t) * 2U),
+                               sizeof (mfs_data_header_t) - (sizeof (uint32_t) * 2U),
+                               mfsp->buffer.data8 + (sizeof (uint32_t) * 2U)));
+
+  /* Writing the entries, the operation is split in page-sized chunks
+     because the buffer is small.*/
+  doffset = mfsp->next_offset + sizeof (mfs_data_header_t);
+  n       = size;
+  i       = 0U;
+  pos     = sizeof (mfs_checkpoint_entry_t);
+  while (n > 0U) {
+    size_t j, chunk = (size_t)(((doffset | (MFS_CFG_BUFFER_SIZE - 1U)) + 1U) -
+                               doffset);
+    if (chunk > n) {
+      chunk = n;
+    }
+
+    for (j = 0U; j < chunk; j++) {
+      if (pos >= sizeof (mfs_checkpoint_entry_t)) {
+        i = mfs_checkpoint_get_entry(mfsp, i, &entry);
+        pos = 0U;
+      }
+      mfsp->buffer.data8[j] = entry.entry8[pos++];
+    }
+    RET_ON_ERROR(mfs_flash_write(mfsp, doffset, chunk, mfsp->buffer.data8));
+
+    /* Next page.*/
+    doffset += chunk;
+    n       -= chunk;
+  }
+
+  /* Writing the magic number, it seals the record.*/
+  mfsp->buffer.dhdr.fields.magic1 = (uint32_t)MFS_HEADER_MAGIC_1;
+  mfsp->buffer.dhdr.fields.magic2 = (uint32_t)MFS_HEADER_MAGIC_2;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (uint32_t) * 2U,
+                               mfsp->buffer.data8));
+
+  /* Finally writing the slot, it makes the checkpoint valid.*/
+  slot.fields.magic     = MFS_CHECKPOINT_MAGIC;
+  slot.fields.offset    = (uint32_t)mfsp->next_offset;
+  slot.fields.counter   = mfsp->current_counter;
+  slot.fields.reserved1 = (uint16_t)mfsp->config->erased;
+  slot.fields.crc       = MFS_CFG_CRC16(0xFFFFU, slot.hdr8,
+                                        sizeof (mfs_checkpoint_slot_t) -
+                                        sizeof (uint16_t));
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               bank_offset + SLOT_OFFSET(mfsp->cp_slot),
+                               sizeof (mfs_checkpoint_slot_t),
+                               slot.hdr8));
+
+  /* Adjusting bank-related metadata, the checkpoint record does not count
+     as used space because it is discarded by garbage collection.*/
+  mfsp->next_offset += ALIGNED_REC_SIZE(size);
+  mfsp->cp_slot++;
+  mfsp->cp_records = 0U;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Accounts appended records and writes automatic checkpoints.
+ * @note    Lack of space is not reported, the checkpoint is attempted again
+ *          on the next update.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] n         number of appended records
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_update(MFSDriver *mfsp, uint32_t n) {
+
+  mfsp->cp_records += n;
+
+#if MFS_CFG_CHECKPOINT_INTERVAL > 0
+  /* Checkpoints are not written during a garbage collection because
+     records could be in the other bank.*/
+  if ((mfsp->cp_records >= (uint32_t)MFS_CFG_CHECKPOINT_INTERVAL) &&
+      !mfsp->gc_active) {
+    mfs_error_t err;
+
+    err = mfs_checkpoint_write(mfsp);
+    if (err != MFS_ERR_OUT_OF_MEM) {
+      return err;
+    }
+  }
+#endif
+
+  return MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
 /**
  * @brief   Scans blocks searching for records.
  * @note    The block integrity is strongly checked.
@@ -446,12 +1001,18 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
 
   /* Boundaries.*/
   start_offset = mfs_flash_get_bank_offset(mfsp, bank);
-  hdr_offset   = start_offset + (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
   end_offset   = start_offset + mfsp->config->bank_size;
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  /* Restoring the index from the last checkpoint, if any, the scan starts
+     after it.*/
+  RET_ON_ERROR(mfs_checkpoint_load(mfsp, bank, &hdr_offset));
+#else
+  hdr_offset   = start_offset + (flash_offset_t)MFS_RECORDS_OFFSET;
+#endif
 
   /* Scanning records until there is there is not enough space left for an
      header.*/
-  while (hdr_offset < end_offset - ALIGNED_DHDR_SIZE) {
+  while (hdr_offset <= end_offset - ALIGNED_DHDR_SIZE) {
     union {
       mfs_data_header_t     dhdr;
       uint8_t               data8[ALIGNED_SIZEOF(mfs_data_header_t)];
@@ -473,8 +1034,12 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
     /* It is not erased so checking for integrity.*/
     if ((u.dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
         (u.dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
+#if MFS_CFG_USE_CHECKPOINTS == FALSE
         (u.dhdr.fields.id < 1U) ||
-        (u.dhdr.fields.id > (uint32_t)MFS_CFG_MAX_RECORDS) ||
+#endif
+#if MFS_CFG_MAX_ID < 65535
+        (u.dhdr.fields.id > (uint32_t)MFS_CFG_MAX_ID) ||
+#endif
         (u.dhdr.fields.size > end_offset - hdr_offset)) {
       *wflagp = true;
       break;
@@ -495,7 +1060,7 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
         RET_ON_ERROR(mfs_flash_read(mfsp, data, chunk, mfsp->buffer.data8));
 
         /* CRC on the read data chunk.*/
-        crc = crc16(crc, &mfsp->buffer.data8[0], chunk);
+        crc = MFS_CFG_CRC16(crc, &mfsp->buffer.data8[0], chunk);
 
         /* Next chunk.*/
         data  += chunk;
@@ -507,16 +1072,25 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
          continues because there could be more valid records afterward.*/
       *wflagp = true;
     }
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    else if (u.dhdr.fields.id == 0U) {
+      /* Checkpoint records are not part of the index.*/
+    }
+#endif
     else {
       /* Zero-sized records are erase markers.*/
       if (u.dhdr.fields.size == 0U) {
-        mfsp->descriptors[u.dhdr.fields.id - 1U].offset = 0U;
-        mfsp->descriptors[u.dhdr.fields.id - 1U].size   = 0U;
+        mfs_descriptor_clear(mfsp, (mfs_id_t)u.dhdr.fields.id);
       }
-      else {
-        mfsp->descriptors[u.dhdr.fields.id - 1U].offset = hdr_offset;
-        mfsp->descriptors[u.dhdr.fields.id - 1U].size   = u.dhdr.fields.size;
+      else if (!mfs_descriptor_set(mfsp, (mfs_id_t)u.dhdr.fields.id,
+                                   hdr_offset, u.dhdr.fields.size)) {
+        /* No space left in the descriptors table, it can only happen if
+           the configuration has been changed, the record is lost.*/
+        *wflagp = true;
       }
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+      mfsp->cp_records++;
+#endif
     }
 
     /* On the next header.*/
@@ -575,48 +1149,243 @@ static mfs_error_t mfs_bank_get_state(MFSDriver *mfsp,
   return MFS_NO_ERROR;
 }
 
+#if ((MFS_CFG_TRANSACTION_MAX > 0) &&                                        \
+     (MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS)) || defined(__DOXYGEN__)
 /**
- * @brief   Enforces a garbage collection.
- * @details Storage data is compacted into a single bank.
+ * @brief   Number of records created by the current transaction.
+ * @note    Multiple writes of the same new record are counted multiple
+ *          times, the result is an upper bound.
  *
- * @param[out] mfsp     pointer to the @p MFSDriver object
- * @return              The operation status.
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The number of new records.
  *
  * @notapi
  */
-static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
+static uint32_t mfs_transaction_new_records(MFSDriver *mfsp) {
+  uint32_t i, n;
+
+  n = 0U;
+  for (i = 0U; i < mfsp->tr_nops; i++) {
+    if ((mfsp->tr_ops[i].size > 0U) &&
+        (mfs_descriptor_find(mfsp, mfsp->tr_ops[i].id) == NULL)) {
+      n++;
+    }
+  }
+
+  return n;
+}
+#endif
+
+/**
+ * @brief   Returns the destination bank of a garbage collection.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The bank identifier.
+ *
+ * @notapi
+ */
+static mfs_bank_t mfs_gc_get_bank(MFSDriver *mfsp) {
+
+  return mfsp->current_bank == MFS_BANK_0 ? MFS_BANK_1 : MFS_BANK_0;
+}
+
+/**
+ * @brief   Checks if a record has been moved by the garbage collector.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] offset    offset of the record header
+ * @return              The record position.
+ * @retval false        if the record is in the current bank.
+ * @retval true         if the record is in the destination bank.
+ *
+ * @notapi
+ */
+static bool mfs_gc_is_moved(MFSDriver *mfsp, flash_offset_t offset) {
+  flash_offset_t start;
+
+  start = mfs_flash_get_bank_offset(mfsp, mfs_gc_get_bank(mfsp));
+
+  return (offset >= start) && (offset < start + mfsp->config->bank_size);
+}
+
+/**
+ * @brief   Checks if there are records still to be moved.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The check result.
+ *
+ * @notapi
+ */
+static bool mfs_gc_is_pending(MFSDriver *mfsp) {
   unsigned i;
-  mfs_bank_t sbank, dbank;
-  flash_offset_t dest_offset;
 
-  sbank = mfsp->current_bank;
-  if (sbank == MFS_BANK_0) {
-    dbank = MFS_BANK_1;
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    if ((mfsp->descriptors[i].offset != 0U) &&
+        !mfs_gc_is_moved(mfsp, mfsp->descriptors[i].offset)) {
+      return true;
+    }
   }
-  else {
-    dbank = MFS_BANK_0;
+
+  return false;
+}
+
+/**
+ * @brief   Aborts a garbage collection in progress.
+ * @details The records index is rebuilt by scanning the current bank
+ *          because moved records are lost, the destination bank is erased
+ *          by the next step.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_abort(MFSDriver *mfsp) {
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  uint32_t cp_slot = mfsp->cp_slot, cp_records = mfsp->cp_records;
+#endif
+  bool w;
+
+  mfsp->gc_active = false;
+  mfsp->gc_dirty  = true;
+
+  /* The current bank content is unchanged, the scan result does not need
+     to be checked.*/
+  mfs_descriptors_reset(mfsp);
+  RET_ON_ERROR(mfs_bank_scan_records(mfsp, mfsp->current_bank, &w));
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  mfsp->cp_slot    = cp_slot;
+  mfsp->cp_records = cp_records;
+#endif
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Writes an erase marker in the destination bank.
+ * @details A garbage collection is in progress and a copy of the erased
+ *          record could have already been moved, the marker in the
+ *          transient buffer is written after it.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_erase_record(MFSDriver *mfsp) {
+  flash_offset_t end;
+
+  end = mfs_flash_get_bank_offset(mfsp, mfs_gc_get_bank(mfsp)) +
+        mfsp->config->bank_size;
+  if ((flash_offset_t)ALIGNED_DHDR_SIZE > end - mfsp->gc_offset) {
+    return mfs_gc_abort(mfsp);
   }
 
-  /* Write address.*/
-  dest_offset = mfs_flash_get_bank_offset(mfsp, dbank) +
-                ALIGNED_SIZEOF(mfs_bank_header_t);
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->gc_offset,
+                               sizeof (mfs_data_header_t),
+                               mfsp->buffer.data8));
+  mfsp->gc_offset += ALIGNED_DHDR_SIZE;
+  mfsp->gc_waste   = true;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Performs a garbage collection step.
+ * @details Records are moved into the other bank following the descriptors
+ *          order, records written in the current bank after being moved
+ *          are moved again by further passes. The banks are swapped when
+ *          all records have been moved.
+ * @note    Records are never split, at least one record is moved in any
+ *          case.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] n         maximum amount of data to be moved
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR             if the garbage collection has been
+ *                                  completed.
+ * @retval MFS_WARN_GC_PENDING      if more steps are required.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_step(MFSDriver *mfsp, uint32_t n) {
+  mfs_bank_t sbank, dbank;
+  flash_offset_t end;
+  uint32_t moved;
+
+  sbank = mfsp->current_bank;
+  dbank = mfs_gc_get_bank(mfsp);
+  end   = mfs_flash_get_bank_offset(mfsp, dbank) + mfsp->config->bank_size;
+
+  if (!mfsp->gc_active) {
+    /* Erasing leftovers of an aborted garbage collection, it is a step
+       on its own.*/
+    if (mfsp->gc_dirty) {
+      RET_ON_ERROR(mfs_bank_erase(mfsp, dbank));
+      mfsp->gc_dirty = false;
+      return MFS_WARN_GC_PENDING;
+    }
+
+    mfsp->gc_active = true;
+    mfsp->gc_waste  = false;
+    mfsp->gc_index  = 0U;
+    mfsp->gc_offset = mfs_flash_get_bank_offset(mfsp, dbank) +
+                      MFS_RECORDS_OFFSET;
+  }
 
   /* Copying the most recent record instances only.*/
-  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
-    uint32_t totsize = ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
-    if (mfsp->descriptors[i].offset != 0) {
-      RET_ON_ERROR(mfs_flash_copy(mfsp, dest_offset,
-                                  mfsp->descriptors[i].offset,
+  moved = 0U;
+  while (mfsp->gc_index < MFS_CFG_MAX_RECORDS) {
+    mfs_record_descriptor_t *dp = &mfsp->descriptors[mfsp->gc_index];
+
+    if (moved >= n) {
+      return MFS_WARN_GC_PENDING;
+    }
+
+    if ((dp->offset != 0U) && !mfs_gc_is_moved(mfsp, dp->offset)) {
+      uint32_t totsize = ALIGNED_REC_SIZE(dp->size);
+
+      /* Obsolete data can make the destination bank overflow, restarting
+         in that case.*/
+      if (totsize > end - mfsp->gc_offset) {
+        RET_ON_ERROR(mfs_gc_abort(mfsp));
+        return MFS_WARN_GC_PENDING;
+      }
+
+      RET_ON_ERROR(mfs_flash_copy(mfsp, mfsp->gc_offset, dp->offset,
                                   totsize));
-      mfsp->descriptors[i].offset = dest_offset;
-      dest_offset += totsize;
+#if MFS_CFG_WRITE_VERIFY == TRUE
+      RET_ON_ERROR(mfs_record_verify(mfsp, mfsp->gc_offset, dp->size));
+#endif
+      dp->offset       = mfsp->gc_offset;
+      mfsp->gc_offset += totsize;
+      moved           += totsize;
     }
+
+    mfsp->gc_index++;
+  }
+
+  /* Records written during the pass require another pass, the bank swap
+     is a step on its own.*/
+  if (mfs_gc_is_pending(mfsp)) {
+    mfsp->gc_index = 0U;
+    return MFS_WARN_GC_PENDING;
+  }
+  if (moved > 0U) {
+    return MFS_WARN_GC_PENDING;
   }
 
   /* New current bank.*/
+  mfsp->gc_active = false;
   mfsp->current_bank = dbank;
   mfsp->current_counter += 1U;
-  mfsp->next_offset = dest_offset;
+  mfsp->next_offset = mfsp->gc_offset;
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  /* The new bank has no checkpoints, all records would be scanned.*/
+  mfsp->cp_slot    = 0U;
+  mfsp->cp_records = mfsp->records_count;
+#endif
 
   /* The header is written after the data.*/
   RET_ON_ERROR(mfs_bank_write_header(mfsp, dbank, mfsp->current_counter));
@@ -627,6 +1396,32 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   return MFS_NO_ERROR;
 }
 
+/**
+ * @brief   Enforces a garbage collection.
+ * @details Storage data is compacted into a single bank, a garbage
+ *          collection in progress is completed.
+ *
+ * @param[out] mfsp     pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
+  mfs_error_t err;
+
+  /* Obsolete data in the destination bank would not be freed, restarting
+     in order to have all the space available after the swap.*/
+  if (mfsp->gc_active && mfsp->gc_waste) {
+    RET_ON_ERROR(mfs_gc_abort(mfsp));
+  }
+
+  do {
+    err = mfs_gc_step(mfsp, 0xFFFFFFFFU);
+  } while (err == MFS_WARN_GC_PENDING);
+
+  return err;
+}
+
 /**
  * @brief   Performs a flash partition mount attempt.
  *
@@ -749,7 +1544,7 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
     RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank, &w2));
 
     /* Calculating the effective used size.*/
-    mfsp->used_space = ALIGNED_SIZEOF(mfs_bank_header_t);
+    mfsp->used_space = MFS_RECORDS_OFFSET;
     for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
       if (mfsp->descriptors[i].offset != 0U) {
         mfsp->used_space += ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
@@ -910,7 +1705,7 @@ mfs_error_t mfsErase(MFSDriver *mfsp) {
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] id        record numeric identifier, the valid range is between
- *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ *                      @p 1 and @p MFS_CFG_MAX_ID
  * @param[in,out] np    on input is the maximum buffer size, on return it is
  *                      the size of the data copied into the buffer
  * @param[out] buffer   pointer to a buffer for record data
@@ -931,10 +1726,11 @@ mfs_error_t mfsErase(MFSDriver *mfsp) {
  */
 mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
                           size_t *np, uint8_t *buffer) {
+  mfs_record_descriptor_t *dp;
   uint16_t crc;
 
   osalDbgCheck((mfsp != NULL) &&
-               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
+               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_ID) &&
                (np != NULL) && (*np > 0U) && (buffer != NULL));
 
   if ((mfsp->state != MFS_READY) && (mfsp->state != MFS_TRANSACTION)) {
@@ -942,30 +1738,31 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
   }
 
   /* Checking if the requested record actually exists.*/
-  if (mfsp->descriptors[id - 1U].offset == 0U) {
+  dp = mfs_descriptor_find(mfsp, id);
+  if (dp == NULL) {
     return MFS_ERR_NOT_FOUND;
   }
 
   /* Making sure to not overflow the buffer.*/
-  if (*np < mfsp->descriptors[id - 1U].size) {
+  if (*np < dp->size) {
     return MFS_ERR_INV_SIZE;
   }
 
   /* Header read from flash.*/
   RET_ON_ERROR(mfs_flash_read(mfsp,
-                              mfsp->descriptors[id - 1U].offset,
+                              dp->offset,
                               sizeof (mfs_data_header_t),
                               mfsp->buffer.data8));
 
   /* Data read from flash.*/
-  *np = mfsp->descriptors[id - 1U].size;
+  *np = dp->size;
   RET_ON_ERROR(mfs_flash_read(mfsp,
-                              mfsp->descriptors[id - 1U].offset + sizeof (mfs_data_header_t),
+                              dp->offset + sizeof (mfs_data_header_t),
                               *np,
                               buffer));
 
   /* Checking CRC.*/
-  crc = crc16(0xFFFFU, buffer, *np);
+  crc = MFS_CFG_CRC16(0xFFFFU, buffer, *np);
   if (crc != mfsp->buffer.dhdr.fields.crc) {
     mfsp->state = MFS_ERROR;
     return MFS_ERR_FLASH_FAILURE;
@@ -979,7 +1776,7 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] id        record numeric identifier, the valid range is between
- *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ *                      @p 1 and @p MFS_CFG_MAX_ID
  * @param[in] n         size of data to be written, it cannot be zero
  * @param[in] buffer    pointer to a buffer for record data
  * @return              The operation status.
@@ -1007,7 +1804,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
   flash_offset_t free, asize, rspace;
 
   osalDbgCheck((mfsp != NULL) &&
-               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
+               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_ID) &&
                (n > 0U) && (buffer != NULL));
 
   /* Aligned record size.*/
@@ -1015,8 +1812,17 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
 
   /* Normal mode code path.*/
   if (mfsp->state == MFS_READY) {
+    mfs_record_descriptor_t *dp;
     bool warning = false;
 
+#if MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS
+    /* A new record requires a free entry in the descriptors table.*/
+    if ((mfs_descriptor_find(mfsp, id) == NULL) &&
+        (mfsp->records_count >= (uint32_t)MFS_CFG_MAX_RECORDS)) {
+      return MFS_ERR_OUT_OF_MEM;
+    }
+#endif
+
     /* If the required space is beyond the available (compacted) block
        size then an error is returned.
        NOTE: The space for one extra header is reserved in order to allow
@@ -1039,7 +1845,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
     /* Writing the data header without the magic, it will be written last.*/
     mfsp->buffer.dhdr.fields.id     = (uint16_t)id;
     mfsp->buffer.dhdr.fields.size   = (uint32_t)n;
-    mfsp->buffer.dhdr.fields.crc    = crc16(0xFFFFU, buffer, n);
+    mfsp->buffer.dhdr.fields.crc    = MFS_CFG_CRC16(0xFFFFU, buffer, n);
     RET_ON_ERROR(mfs_flash_write(mfsp,
                                  mfsp->next_offset + (sizeof (uint32_t) * 2U),
                                  sizeof (mfs_data_header_t) - (sizeof (uint32_t) * 2U),
@@ -1061,16 +1867,26 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
 
     /* The size of the old record instance, if present, must be subtracted
        to the total used size.*/
-    if (mfsp->descriptors[id - 1U].offset != 0U) {
-      mfsp->used_space -= ALIGNED_REC_SIZE(mfsp->descriptors[id - 1U].size);
+    dp = mfs_descriptor_find(mfsp, id);
+    if (dp != NULL) {
+      mfsp->used_space -= ALIGNED_REC_SIZE(dp->size);
+
+      /* If the old instance has already been moved by a garbage collection
+         in progress then it becomes obsolete data in the destination bank.*/
+      if (mfsp->gc_active && mfs_gc_is_moved(mfsp, dp->offset)) {
+        mfsp->gc_waste = true;
+      }
     }
 
     /* Adjusting bank-related metadata.*/
-    mfsp->descriptors[id - 1U].offset = mfsp->next_offset;
-    mfsp->descriptors[id - 1U].size   = (uint32_t)n;
+    (void)mfs_descriptor_set(mfsp, id, mfsp->next_offset, (uint32_t)n);
     mfsp->next_offset += asize;
     mfsp->used_space  += asize;
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    RET_ON_ERROR(mfs_checkpoint_update(mfsp, 1U));
+#endif
+
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
 
@@ -1092,10 +1908,20 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
       return MFS_ERR_TRANSACTION_SIZE;
     }
 
+#if MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS
+    /* New records must fit the descriptors table on commit, records
+       created within the transaction are accounted conservatively.*/
+    if ((mfs_descriptor_find(mfsp, id) == NULL) &&
+        (mfsp->records_count + mfs_transaction_new_records(mfsp) >=
+         (uint32_t)MFS_CFG_MAX_RECORDS)) {
+      return MFS_ERR_OUT_OF_MEM;
+    }
+#endif
+
     /* Writing the data header without the magic, it will be written last.*/
     mfsp->buffer.dhdr.fields.id     = (uint16_t)id;
     mfsp->buffer.dhdr.fields.size   = (uint32_t)n;
-    mfsp->buffer.dhdr.fields.crc    = crc16(0xFFFFU, buffer, n);
+    mfsp->buffer.dhdr.fields.crc    = MFS_CFG_CRC16(0xFFFFU, buffer, n);
     RET_ON_ERROR(mfs_flash_write(mfsp,
                                  mfsp->tr_next_offset + (sizeof (uint32_t) * 2U),
                                  sizeof (mfs_data_header_t) - (sizeof (uint32_t) * 2U),
@@ -1130,7 +1956,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] id        record numeric identifier, the valid range is between
- *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ *                      @p 1 and @p MFS_CFG_MAX_ID
  * @return              The operation status.
  * @retval MFS_NO_ERROR             if the operation has been successfully
  *                                  completed.
@@ -1152,10 +1978,11 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
  * @api
  */
 mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
+  mfs_record_descriptor_t *dp;
   flash_offset_t free, asize, rspace;
 
   osalDbgCheck((mfsp != NULL) &&
-               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS));
+               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_ID));
 
   /* Aligned record size.*/
   asize = ALIGNED_DHDR_SIZE;
@@ -1165,7 +1992,8 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     bool warning = false;
 
     /* Checking if the requested record actually exists.*/
-    if (mfsp->descriptors[id - 1U].offset == 0U) {
+    dp = mfs_descriptor_find(mfsp, id);
+    if (dp == NULL) {
       return MFS_ERR_NOT_FOUND;
     }
 
@@ -1199,10 +2027,19 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
                                  mfsp->buffer.data8));
 
     /* Adjusting bank-related metadata.*/
-    mfsp->used_space  -= ALIGNED_REC_SIZE(mfsp->descriptors[id - 1U].size);
+    mfsp->used_space  -= ALIGNED_REC_SIZE(dp->size);
     mfsp->next_offset += sizeof (mfs_data_header_t);
-    mfsp->descriptors[id - 1U].offset = 0U;
-    mfsp->descriptors[id - 1U].size   = 0U;
+    mfs_descriptor_clear(mfsp, id);
+
+    /* The marker is also written in the destination bank of a garbage
+       collection in progress.*/
+    if (mfsp->gc_active) {
+      RET_ON_ERROR(mfs_gc_erase_record(mfsp));
+    }
+
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    RET_ON_ERROR(mfs_checkpoint_update(mfsp, 1U));
+#endif
 
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
@@ -1213,7 +2050,7 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     mfs_transaction_op_t *top;
 
     /* Checking if the requested record actually exists.*/
-    if (mfsp->descriptors[id - 1U].offset == 0U) {
+    if (mfs_descriptor_find(mfsp, id) == NULL) {
       return MFS_ERR_NOT_FOUND;
     }
 
@@ -1286,6 +2123,109 @@ mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp) {
   return mfs_garbage_collect(mfsp);
 }
 
+/**
+ * @brief   Performs a step of an incremental garbage collection.
+ * @details Each step moves a bounded amount of data into the other bank,
+ *          the driver can be used normally between steps so the garbage
+ *          collection can be performed by a background thread. Records
+ *          written or erased between steps are handled by further steps.
+ * @note    The driver is not thread safe, calls to this function must be
+ *          serialized with the other driver calls.
+ * @note    Garbage collections triggered by other operations complete the
+ *          garbage collection in progress.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] n         maximum amount of data to be moved by this step,
+ *                      records are never split so at least one record is
+ *                      moved in any case
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR             if the garbage collection has been
+ *                                  completed.
+ * @retval MFS_WARN_GC_PENDING      if more steps are required in order to
+ *                                  complete the garbage collection.
+ * @retval MFS_ERR_INV_STATE        if the driver is in not in @p MFS_READY
+ *                                  state.
+ * @retval MFS_ERR_FLASH_FAILURE    if the flash memory is unusable because HW
+ *                                  failures. Makes the driver enter the
+ *                                  @p MFS_ERROR state.
+ * @retval MFS_ERR_INTERNAL         if an internal logic failure is detected.
+ *
+ * @api
+ */
+mfs_error_t mfsPerformGarbageCollectionStep(MFSDriver *mfsp, size_t n) {
+
+  osalDbgCheck((mfsp != NULL) && (n > 0U));
+
+  if (mfsp->state != MFS_READY) {
+    return MFS_ERR_INV_STATE;
+  }
+
+  return mfs_gc_step(mfsp, (uint32_t)n);
+}
+
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Writes a checkpoint of the records index.
+ * @details On mount the records index is restored from the most recent
+ *          checkpoint and only the records written after it are scanned.
+ * @note    If all the checkpoint slots have been used or there is not
+ *          enough free space in the current bank then a garbage collection
+ *          is performed.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR             if the operation has been successfully
+ *                                  completed.
+ * @retval MFS_WARN_GC              if the operation triggered a garbage
+ *                                  collection.
+ * @retval MFS_ERR_INV_STATE        if the driver is in not in @p MFS_READY
+ *                                  state.
+ * @retval MFS_ERR_OUT_OF_MEM       if there is not enough flash space for the
+ *                                  operation.
+ * @retval MFS_ERR_FLASH_FAILURE    if the flash memory is unusable because HW
+ *                                  failures. Makes the driver enter the
+ *                                  @p MFS_ERROR state.
+ * @retval MFS_ERR_INTERNAL         if an internal logic failure is detected.
+ *
+ * @api
+ */
+mfs_error_t mfsWriteCheckpoint(MFSDriver *mfsp) {
+  flash_offset_t free, rspace;
+  bool warning = false;
+
+  osalDbgCheck(mfsp != NULL);
+
+  if (mfsp->state != MFS_READY) {
+    return MFS_ERR_INV_STATE;
+  }
+
+  /* If the required space is beyond the available (compacted) block
+     size then an error is returned.*/
+  rspace = ALIGNED_REC_SIZE(mfsp->records_count *
+                            sizeof (mfs_checkpoint_entry_t));
+  if (rspace > mfsp->config->bank_size - mfsp->used_space) {
+    return MFS_ERR_OUT_OF_MEM;
+  }
+
+  /* Checking for immediately (not compacted) available space and for a
+     free slot.*/
+  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+          mfsp->config->bank_size) - mfsp->next_offset;
+  if ((rspace > free) ||
+      (mfsp->cp_slot >= (uint32_t)MFS_CFG_CHECKPOINT_SLOTS) ||
+      mfsp->gc_active) {
+    /* We need to perform a garbage collection, it also frees the
+       slots. A garbage collection in progress is completed.*/
+    warning = true;
+    RET_ON_ERROR(mfs_garbage_collect(mfsp));
+  }
+
+  RET_ON_ERROR(mfs_checkpoint_write(mfsp));
+
+  return warning ? MFS_WARN_GC : MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
 #if (MFS_CFG_TRANSACTION_MAX > 0) || defined(__DOXYGEN__)
 /**
  * @brief   Puts the driver in transaction mode.
@@ -1340,9 +2280,10 @@ mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size) {
   /* Checking for immediately (not compacted) available space.*/
   free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
           mfsp->config->bank_size) - mfsp->next_offset;
-  if (rspace > free) {
+  if ((rspace > free) || mfsp->gc_active) {
     /* We need to perform a garbage collection, there is enough space
-       but it has to be freed.*/
+       but it has to be freed. A garbage collection in progress is
+       completed because transactions are not supported during it.*/
     RET_ON_ERROR(mfs_garbage_collect(mfsp));
   }
 
@@ -1402,28 +2343,27 @@ mfs_error_t mfsCommitTransaction(MFSDriver *mfsp) {
      magic number, now updating the internal state using the buffered data.*/
   mfsp->next_offset = mfsp->tr_next_offset;
   while (top < &mfsp->tr_ops[mfsp->tr_nops]) {
-    unsigned i = (unsigned)top->id - 1U;
+    mfs_record_descriptor_t *dp = mfs_descriptor_find(mfsp, top->id);
 
     /* The calculation is a bit different depending on write or erase record
        operations.*/
     if (top->size > 0U) {
       /* It is a write.*/
-      if (mfsp->descriptors[i].offset != 0U) {
+      if (dp != NULL) {
         /* The size of the old record instance, if present, must be subtracted
            to the total used size.*/
-        mfsp->used_space -= ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
+        mfsp->used_space -= ALIGNED_REC_SIZE(dp->size);
       }
 
       /* Adjusting bank-related metadata.*/
-      mfsp->used_space           += ALIGNED_REC_SIZE(top->size);
-      mfsp->descriptors[i].offset = top->offset;
-      mfsp->descriptors[i].size   = top->size;
+      mfsp->used_space += ALIGNED_REC_SIZE(top->size);
+      (void)mfs_descriptor_set(mfsp, top->id, top->offset, (uint32_t)top->size);
     }
-    else {
-      /* It is an erase.*/
-      mfsp->used_space           -= ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
-      mfsp->descriptors[i].offset = 0U;
-      mfsp->descriptors[i].size   = 0U;
+    else if (dp != NULL) {
+      /* It is an erase, the record could have already been erased by a
+         previous operation in the same transaction.*/
+      mfsp->used_space -= ALIGNED_REC_SIZE(dp->size);
+      mfs_descriptor_clear(mfsp, top->id);
     }
 
     /* On the next element.*/
@@ -1433,6 +2373,10 @@ mfs_error_t mfsCommitTransaction(MFSDriver *mfsp) {
   /* Returning to ready mode.*/
   mfsp->state = MFS_READY;
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  RET_ON_ERROR(mfs_checkpoint_update(mfsp, mfsp->tr_nops));
+#endif
+
   return MFS_NO_ERROR;
 }
 
@@ -29,6 +29,7 @@
 #define HAL_MFS_H
 
 #include "hal_flash.h"
+#include "hal_crc_engine.h"
 
 /*===========================================================================*/
 /* Driver constants.                                                         */
@@ -38,6 +39,7 @@
 #define MFS_BANK_MAGIC_2                    0xF0339CC5U
 #define MFS_HEADER_MAGIC_1                  0x5FAE45F0U
 #define MFS_HEADER_MAGIC_2                  0xF045AE5FU
+#define MFS_CHECKPOINT_MAGIC                0xC4E3C17EU
 
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
@@ -49,12 +51,25 @@
  */
 /**
  * @brief   Maximum number of indexed records in the managed storage.
- * @note    Record indexes go from 1 to @p MFS_CFG_MAX_RECORDS.
+ * @note    Record indexes go from 1 to @p MFS_CFG_MAX_RECORDS unless
+ *          @p MFS_CFG_MAX_ID is specified.
  */
 #if !defined(MFS_CFG_MAX_RECORDS) || defined(__DOXYGEN__)
 #define MFS_CFG_MAX_RECORDS                 32
 #endif
 
+/**
+ * @brief   Maximum value of a record identifier.
+ * @details If greater than @p MFS_CFG_MAX_RECORDS then identifiers are
+ *          sparse and the descriptors table is organized as an hash table
+ *          of @p MFS_CFG_MAX_RECORDS entries, at most
+ *          @p MFS_CFG_MAX_RECORDS records can exist at any time.
+ * @note    Record identifiers go from 1 to @p MFS_CFG_MAX_ID.
+ */
+#if !defined(MFS_CFG_MAX_ID) || defined(__DOXYGEN__)
+#define MFS_CFG_MAX_ID                      MFS_CFG_MAX_RECORDS
+#endif
+
 /**
  * @brief   Maximum number of repair attempts on partition mount.
  */
@@ -64,6 +79,8 @@
 
 /**
  * @brief   Verify written data.
+ * @note    Records copied by the garbage collector are verified by
+ *          calculating the CRC of the data read back.
  */
 #if !defined(MFS_CFG_WRITE_VERIFY) || defined(__DOXYGEN__)
 #define MFS_CFG_WRITE_VERIFY                TRUE
@@ -107,6 +124,48 @@
 #if !defined(MFS_CFG_TRANSACTION_MAX) || defined(__DOXYGEN__)
 #define MFS_CFG_TRANSACTION_MAX             16
 #endif
+
+/**
+ * @brief   Enables the checkpoints mechanism.
+ * @details A checkpoint is a snapshot of the records index written in the
+ *          current bank, on mount the index is restored from the most
+ *          recent checkpoint and only the records written after it are
+ *          scanned.
+ * @note    This option changes the layout of the banks, the storage must
+ *          be erased when the setting is changed.
+ */
+#if !defined(MFS_CFG_USE_CHECKPOINTS) || defined(__DOXYGEN__)
+#define MFS_CFG_USE_CHECKPOINTS             FALSE
+#endif
+
+/**
+ * @brief   Number of checkpoint slots in a bank.
+ * @details Each checkpoint consumes a slot, when all slots have been used
+ *          further checkpoints require a garbage collection.
+ */
+#if !defined(MFS_CFG_CHECKPOINT_SLOTS) || defined(__DOXYGEN__)
+#define MFS_CFG_CHECKPOINT_SLOTS            8
+#endif
+
+/**
+ * @brief   Automatic checkpoint interval.
+ * @details A checkpoint is automatically written after the specified
+ *          number of records has been appended to the bank since the
+ *          previous checkpoint, zero disables automatic checkpoints.
+ */
+#if !defined(MFS_CFG_CHECKPOINT_INTERVAL) || defined(__DOXYGEN__)
+#define MFS_CFG_CHECKPOINT_INTERVAL         0
+#endif
+
+/**
+ * @brief   CRC16 implementation.
+ * @details The function used for records and headers checksums, it must
+ *          calculate a CRC16-CCITT with the same interface of @p crc16().
+ *          By default the CRC engine module is used.
+ */
+#if !defined(MFS_CFG_CRC16) || defined(__DOXYGEN__)
+#define MFS_CFG_CRC16(crc, data, n)         crc16(crc, data, n)
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -117,6 +176,10 @@
 #error "invalid MFS_CFG_MAX_RECORDS value"
 #endif
 
+#if (MFS_CFG_MAX_ID < MFS_CFG_MAX_RECORDS) || (MFS_CFG_MAX_ID > 65535)
+#error "invalid MFS_CFG_MAX_ID value"
+#endif
+
 #if (MFS_CFG_MAX_REPAIR_ATTEMPTS < 1) ||                                    \
     (MFS_CFG_MAX_REPAIR_ATTEMPTS > 10)
 #error "invalid MFS_MAX_REPAIR_ATTEMPTS value"
@@ -144,6 +207,14 @@
 #error "invalid MFS_CFG_TRANSACTION_MAX value"
 #endif
 
+#if (MFS_CFG_CHECKPOINT_SLOTS < 1) || (MFS_CFG_CHECKPOINT_SLOTS > 256)
+#error "invalid MFS_CFG_CHECKPOINT_SLOTS value"
+#endif
+
+#if MFS_CFG_CHECKPOINT_INTERVAL < 0
+#error "invalid MFS_CFG_CHECKPOINT_INTERVAL value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -176,6 +247,7 @@ typedef enum {
   MFS_NO_ERROR = 0,
   MFS_WARN_REPAIR = 1,
   MFS_WARN_GC = 2,
+  MFS_WARN_GC_PENDING = 3,
   MFS_ERR_INV_STATE = -1,
   MFS_ERR_INV_SIZE = -2,
   MFS_ERR_NOT_FOUND = -3,
@@ -266,6 +338,65 @@ typedef union {
   uint32_t                  hdr32[4];
 } mfs_data_header_t;
 
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a checkpoint slot.
+ * @details Slots are located after the bank header, each written slot
+ *          points to a checkpoint record. A checkpoint record is a data
+ *          record with identifier zero containing an array of
+ *          @p mfs_checkpoint_entry_t.
+ */
+typedef union {
+  struct {
+    /**
+     * @brief   Slot magic.
+     */
+    uint32_t                magic;
+    /**
+     * @brief   Offset of the checkpoint record header.
+     */
+    uint32_t                offset;
+    /**
+     * @brief   Usage counter of the bank containing the slot.
+     */
+    uint32_t                counter;
+    /**
+     * @brief   Reserved field.
+     */
+    uint16_t                reserved1;
+    /**
+     * @brief   Slot CRC.
+     */
+    uint16_t                crc;
+  } fields;
+  uint8_t                   hdr8[16];
+  uint32_t                  hdr32[4];
+} mfs_checkpoint_slot_t;
+
+/**
+ * @brief   Type of a checkpoint entry.
+ * @details Each entry describes a record present when the checkpoint
+ *          has been written.
+ */
+typedef union {
+  struct {
+    /**
+     * @brief   Record identifier.
+     */
+    uint32_t                id;
+    /**
+     * @brief   Offset of the record header.
+     */
+    uint32_t                offset;
+    /**
+     * @brief   Record data size.
+     */
+    uint32_t                size;
+  } fields;
+  uint8_t                   entry8[12];
+} mfs_checkpoint_entry_t;
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
 typedef struct {
   /**
    * @brief   Offset of the record header.
@@ -275,8 +406,24 @@ typedef struct {
    * @brief   Record data size.
    */
   uint32_t                  size;
+#if (MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS) || defined(__DOXYGEN__)
+  /**
+   * @brief   Record identifier.
+   */
+  mfs_id_t                  id;
+#endif
 } mfs_record_descriptor_t;
 
+/**
+ * @brief   Type of a device-side flash copy function.
+ * @details The function copies @p n bytes from @p soffset to @p doffset
+ *          without transferring the data to the host.
+ */
+typedef flash_error_t (*mfs_flash_copy_t)(BaseFlash *flashp,
+                                          flash_offset_t doffset,
+                                          flash_offset_t soffset,
+                                          size_t n);
+
 /**
  * @brief   Type of a MFS configuration structure.
  */
@@ -313,6 +460,23 @@ typedef struct {
    *          @p bank_size.
    */
   flash_sector_t            bank1_sectors;
+  /**
+   * @brief   Buffer used for data copy during garbage collection.
+   * @note    If @p NULL then the driver transient buffer is used, a larger
+   *          buffer reduces the number of flash operations.
+   */
+  uint8_t                   *gc_buffer;
+  /**
+   * @brief   Size of the garbage collection buffer.
+   * @note    It must be a multiple of @p MFS_CFG_BUFFER_SIZE.
+   */
+  size_t                    gc_buffer_size;
+  /**
+   * @brief   Device-side copy function used during garbage collection.
+   * @note    If @p NULL then data is copied through the garbage collection
+   *          buffer.
+   */
+  mfs_flash_copy_t          gc_copy;
 } MFSConfig;
 
 /**
@@ -364,8 +528,45 @@ typedef struct {
   /**
    * @brief   Offsets of the most recent instance of the records.
    * @note    Zero means that there is not a record with that id.
+   * @note    If @p MFS_CFG_MAX_ID is greater than @p MFS_CFG_MAX_RECORDS
+   *          then this is an hash table indexed by record identifier,
+   *          otherwise it is indexed directly by @p id - 1.
    */
   mfs_record_descriptor_t   descriptors[MFS_CFG_MAX_RECORDS];
+  /**
+   * @brief   Number of records in the descriptors table.
+   */
+  uint32_t                  records_count;
+  /**
+   * @brief   Incremental garbage collection in progress.
+   */
+  bool                      gc_active;
+  /**
+   * @brief   The other bank contains data and must be erased before use.
+   */
+  bool                      gc_dirty;
+  /**
+   * @brief   The other bank contains obsolete data.
+   */
+  bool                      gc_waste;
+  /**
+   * @brief   Next descriptor to be examined by the garbage collector.
+   */
+  uint32_t                  gc_index;
+  /**
+   * @brief   Next write offset in the other bank.
+   */
+  flash_offset_t            gc_offset;
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Next free checkpoint slot in the current bank.
+   */
+  uint32_t                  cp_slot;
+  /**
+   * @brief   Records appended to the bank since the last checkpoint.
+   */
+  uint32_t                  cp_records;
+#endif
 #if (MFS_CFG_TRANSACTION_MAX > 0) || defined(__DOXYGEN__)
   /**
    * @brief   Next write offset for current transaction.
@@ -390,6 +591,9 @@ typedef struct {
   union {
     mfs_data_header_t       dhdr;
     mfs_bank_header_t       bhdr;
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    mfs_checkpoint_slot_t   slot;
+#endif
     uint8_t                 data8[MFS_CFG_BUFFER_SIZE];
     uint16_t                data16[MFS_CFG_BUFFER_SIZE / sizeof (uint16_t)];
     uint32_t                data32[MFS_CFG_BUFFER_SIZE / sizeof (uint32_t)];
@@ -419,6 +623,20 @@ typedef struct {
                                             MFS_CFG_MEMORY_ALIGNMENT)
 /** @} */
 
+/**
+ * @brief   Offset of the first record from the start of a bank.
+ * @details The records area is preceded by the bank header and, if enabled,
+ *          by the checkpoint slots.
+ */
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+#define MFS_RECORDS_OFFSET                                                  \
+  (MFS_ALIGN_NEXT(sizeof (mfs_bank_header_t)) +                             \
+   (MFS_ALIGN_NEXT(sizeof (mfs_checkpoint_slot_t)) *                        \
+    (uint32_t)MFS_CFG_CHECKPOINT_SLOTS))
+#else
+#define MFS_RECORDS_OFFSET  MFS_ALIGN_NEXT(sizeof (mfs_bank_header_t))
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -436,6 +654,10 @@ extern "C" {
                              size_t n, const uint8_t *buffer);
   mfs_error_t mfsEraseRecord(MFSDriver *devp, mfs_id_t id);
   mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp);
+  mfs_error_t mfsPerformGarbageCollectionStep(MFSDriver *mfsp, size_t n);
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  mfs_error_t mfsWriteCheckpoint(MFSDriver *mfsp);
+#endif
 #if MFS_CFG_TRANSACTION_MAX > 0
   mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size);
   mfs_error_t mfsCommitTransaction(MFSDriver *mfsp);
@@ -7,3 +7,7 @@ MFSINC := $(CHIBIOS)/os/hal/lib/complex/mfs
 # Shared variables
 ALLCSRC += $(MFSSRC)
 ALLINC  += $(MFSINC)
+
+# Required modules, the CRC engine makefile can also be included by the
+# project, it is only processed once.
+include $(CHIBIOS)/os/hal/lib/complex/crc/hal_crc_engine.mk
@@ -0,0 +1,1258 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_flash_device.c
+ * @brief   JEDEC SFDP generic serial flash driver code.
+ *
+ * @addtogroup JEDEC_SFDP
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "hal_serial_nor.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define SFDP_SIGNATURE                      0x50444653U
+
+/**
+ * @name    Parameter tables identifiers
+ * @{
+ */
+#define SFDP_ID_BFPT                        0xFF00U
+#define SFDP_ID_PROFILE1                    0xFF05U
+#define SFDP_ID_OCTAL_DDR                   0xFF0AU
+#define SFDP_ID_4BAIT                       0xFF84U
+/** @} */
+
+/**
+ * @name    Parameter tables sizes in DWORDs
+ * @{
+ */
+#define SFDP_MAX_HEADERS                    8U
+#define BFPT_MIN_DWORDS                     9U
+#define BFPT_MAX_DWORDS                     20U
+#define BAIT_DWORDS                         2U
+#define PROFILE1_DWORDS                     5U
+#define OCTAL_DDR_DWORDS                    8U
+/** @} */
+
+/**
+ * @name    4 bytes address instruction table support bits
+ * @{
+ */
+#define BAIT_READ_1_1_1                     (1U << 1)
+#define BAIT_READ_1_1_2                     (1U << 2)
+#define BAIT_READ_1_2_2                     (1U << 3)
+#define BAIT_READ_1_1_4                     (1U << 4)
+#define BAIT_READ_1_4_4                     (1U << 5)
+#define BAIT_PP_1_1_1                       (1U << 6)
+#define BAIT_ERASE_TYPE1                    (1U << 9)
+#define BAIT_READ_1_1_8                     (1U << 20)
+#define BAIT_READ_1_8_8                     (1U << 21)
+/** @} */
+
+/* BFPT DWORD, numbered from one like in JESD216.*/
+#define BFPT(tp, n)                         ((tp)->bfpt[(n) - 1U])
+
+/* Largest device addressable with 3 bytes addresses.*/
+#define SFDP_3B_LIMIT                       0x01000000U
+
+/* Defaults for parameters not declared by old SFDP revisions.*/
+#define SFDP_DEFAULT_PAGE_SIZE              256U
+#define SFDP_DEFAULT_PROGRAM_TIME           1000U
+#define SFDP_DEFAULT_ERASE_TIME             250000U
+#define SFDP_DEFAULT_CHIP_ERASE_TIME        100000000U
+#define SFDP_DEFAULT_8D_DUMMY               20U
+#define SFDP_SFDP_DUMMY                     8U
+#define SFDP_8D_SFDP_DUMMY                  20U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Generic device descriptor.
+ * @note    Geometry and attributes are filled from SFDP.
+ */
+flash_descriptor_t snor_descriptor = {
+  .attributes       = FLASH_ATTR_ERASED_IS_ONE | FLASH_ATTR_REWRITABLE,
+  .page_size        = SFDP_DEFAULT_PAGE_SIZE,
+  .sectors_count    = 0U,           /* It is overwritten.*/
+  .sectors          = NULL,
+  .sectors_size     = 0U,           /* It is overwritten.*/
+  .address          = 0U,
+  .size             = 0U            /* It is overwritten.*/
+};
+
+/**
+ * @brief   Device parameters discovered through SFDP.
+ */
+sfdp_params_t snor_sfdp_params;
+
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
+#if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Fast read command for memory mapped mode.
+ * @note    It is filled with the selected read mode.
+ */
+wspi_command_t snor_memmap_read;
+#endif /* WSPI_SUPPORTS_MEMMAP == TRUE */
+#endif /* SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI */
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Parameter tables read from the device.
+ */
+typedef struct {
+  uint32_t                  bfpt[BFPT_MAX_DWORDS];
+  uint32_t                  bfpt_n;
+  uint32_t                  bait[BAIT_DWORDS];
+  uint32_t                  bait_n;
+  uint32_t                  profile1[PROFILE1_DWORDS];
+  uint32_t                  profile1_n;
+  uint32_t                  octal[OCTAL_DDR_DWORDS];
+  uint32_t                  octal_n;
+} sfdp_tables_t;
+
+/**
+ * @brief   Bus lines of instruction, address and data phases.
+ */
+static const uint8_t sfdp_proto_lines[SFDP_PROTO_N][3] = {
+  {1U, 1U, 1U}, {1U, 1U, 2U}, {1U, 2U, 2U}, {1U, 1U, 4U}, {1U, 4U, 4U},
+  {4U, 4U, 4U}, {1U, 1U, 8U}, {1U, 8U, 8U}, {8U, 8U, 8U}
+};
+
+/**
+ * @brief   Support bits of the 4 bytes read instructions.
+ * @note    The 4-4-4 mode uses the same 4 bytes instruction of 1-4-4.
+ */
+static const uint32_t sfdp_bait_reads[SFDP_PROTO_N] = {
+  BAIT_READ_1_1_1, BAIT_READ_1_1_2, BAIT_READ_1_2_2, BAIT_READ_1_1_4,
+  BAIT_READ_1_4_4, BAIT_READ_1_4_4, BAIT_READ_1_1_8, BAIT_READ_1_8_8, 0U
+};
+
+/**
+ * @brief   Erase suspended by @p snor_device_suspend_erase().
+ */
+static bool sfdp_suspended;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Encodes an instruction for the current commands protocol.
+ * @details In 8D-8D-8D mode instructions are 16 bits wide, the second
+ *          byte is a copy or the complement of the first.
+ *
+ * @param[in] op        instruction code
+ * @return              The encoded instruction.
+ */
+static uint32_t sfdp_cmd(uint8_t op) {
+
+  if (snor_sfdp_params.cmd_proto == SFDP_PROTO_8D_8D_8D) {
+    return ((uint32_t)op << 8) |
+           (snor_sfdp_params.cmd_ext_inv ? (uint32_t)(uint8_t)~op :
+                                           (uint32_t)op);
+  }
+
+  return (uint32_t)op;
+}
+
+/**
+ * @brief   Converts an instruction to its 4 bytes address variant.
+ *
+ * @param[in] op        3 bytes address instruction code
+ * @return              The 4 bytes address instruction code or zero if
+ *                      there is no known conversion.
+ */
+static uint8_t sfdp_opcode_4b(uint8_t op) {
+
+  switch (op) {
+  case 0x03U: return 0x13U;
+  case 0x0BU: return 0x0CU;
+  case 0x3BU: return 0x3CU;
+  case 0xBBU: return 0xBCU;
+  case 0x6BU: return 0x6CU;
+  case 0xEBU: return 0xECU;
+  case 0x8BU: return 0x7CU;
+  case 0xCBU: return 0xCCU;
+  case 0x02U: return 0x12U;
+  case 0x20U: return 0x21U;
+  case 0x52U: return 0x5CU;
+  case 0xD8U: return 0xDCU;
+  default:    return 0U;
+  }
+}
+
+/**
+ * @brief   Sets up a read mode from a BFPT fast read descriptor.
+ *
+ * @param[out] rp       pointer to the read mode
+ * @param[in] proto     read protocol
+ * @param[in] hw        16 bits descriptor: instruction, mode clocks and
+ *                      wait states
+ * @return              The protocol mask, zero if not supported.
+ */
+static uint32_t sfdp_set_read(sfdp_read_mode_t *rp, uint8_t proto,
+                              uint32_t hw) {
+
+  rp->proto  = proto;
+  rp->opcode = (uint8_t)(hw >> 8);
+  rp->dummy  = (uint8_t)(((hw >> 5) & 7U) + (hw & 0x1FU));
+
+  return rp->opcode != 0U ? SFDP_PROTO_MASK(proto) : 0U;
+}
+
+/**
+ * @brief   Bus cycles of a 256 bytes read in a read mode.
+ *
+ * @param[in] rp        pointer to the read mode
+ * @param[in] addr_bytes address size
+ * @return              The number of bus cycles.
+ */
+static uint32_t sfdp_read_cycles(const sfdp_read_mode_t *rp,
+                                 uint32_t addr_bytes) {
+  const uint8_t *lp = sfdp_proto_lines[rp->proto];
+  uint32_t dtr = rp->proto == SFDP_PROTO_8D_8D_8D ? 2U : 1U;
+
+  return (8U * dtr) / (lp[0] * dtr) + (addr_bytes * 8U) / (lp[1] * dtr) +
+         (uint32_t)rp->dummy + (256U * 8U) / (lp[2] * dtr);
+}
+
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
+/**
+ * @brief   WSPI settings of a protocol.
+ *
+ * @param[in] proto     protocol
+ * @param[in] addr_bytes address size, zero if there is no address phase
+ * @param[in] data      data phase present
+ * @return              The WSPI settings.
+ */
+static uint32_t sfdp_wspi_cfg(uint8_t proto, uint32_t addr_bytes, bool data) {
+  const uint8_t *lp = sfdp_proto_lines[proto];
+  uint32_t cfg;
+
+  /* Lines to phase mode fields, 1, 2, 4, 8 lines are modes 1, 2, 3, 4.*/
+  cfg = (uint32_t)(__builtin_ctz(lp[0]) + 1) * WSPI_CFG_CMD_MODE_ONE_LINE;
+  if (addr_bytes > 0U) {
+    cfg |= (uint32_t)(__builtin_ctz(lp[1]) + 1) * WSPI_CFG_ADDR_MODE_ONE_LINE;
+    cfg |= addr_bytes == 4U ? WSPI_CFG_ADDR_SIZE_32 : WSPI_CFG_ADDR_SIZE_24;
+  }
+  if (data) {
+    cfg |= (uint32_t)(__builtin_ctz(lp[2]) + 1) * WSPI_CFG_DATA_MODE_ONE_LINE;
+  }
+  if (proto == SFDP_PROTO_8D_8D_8D) {
+    cfg |= WSPI_CFG_CMD_SIZE_16 | WSPI_CFG_ALL_DTR;
+    if (data) {
+      cfg |= WSPI_CFG_DQS_ENABLE;
+    }
+  }
+  else {
+    cfg |= WSPI_CFG_CMD_SIZE_8;
+  }
+
+  return cfg;
+}
+#endif /* SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI */
+
+/**
+ * @brief   Sets the bus settings for the current protocols.
+ */
+static void sfdp_set_cfg(void) {
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  sfdp_params_t *pp = &snor_sfdp_params;
+
+  pp->cfg_read          = sfdp_wspi_cfg(pp->read.proto, pp->addr_bytes, true);
+  pp->cfg_cmd           = sfdp_wspi_cfg(pp->cmd_proto, 0U, false);
+  pp->cfg_cmd_addr      = sfdp_wspi_cfg(pp->cmd_proto, pp->addr_bytes, false);
+  pp->cfg_cmd_data      = sfdp_wspi_cfg(pp->cmd_proto, 0U, true);
+  pp->cfg_cmd_addr_data = sfdp_wspi_cfg(pp->cmd_proto, pp->addr_bytes, true);
+#endif
+}
+
+/**
+ * @brief   Reads the SFDP area in the current commands protocol.
+ * @note    Addresses are 3 bytes wide and followed by 8 dummy cycles except
+ *          in 8D-8D-8D mode where addresses are 4 bytes wide and followed
+ *          by 20 dummy cycles.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] offset    SFDP offset
+ * @param[in] n         number of bytes
+ * @param[out] rp       pointer to the buffer
+ */
+static void sfdp_read(SNORDriver *devp, uint32_t offset,
+                      size_t n, uint8_t *rp) {
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  uint8_t proto = snor_sfdp_params.cmd_proto;
+  bool dtr = proto == SFDP_PROTO_8D_8D_8D;
+  wspi_command_t cmd;
+
+  cmd.cmd   = sfdp_cmd(SFDP_CMD_RDSFDP);
+  cmd.cfg   = sfdp_wspi_cfg(proto, dtr ? 4U : 3U, true);
+  cmd.addr  = offset;
+  cmd.alt   = 0U;
+  cmd.dummy = dtr ? SFDP_8D_SFDP_DUMMY : SFDP_SFDP_DUMMY;
+  wspiReceive(devp->config->busp, &cmd, n, rp);
+#else
+  uint8_t buf[5];
+
+  buf[0] = SFDP_CMD_RDSFDP;
+  buf[1] = (uint8_t)(offset >> 16);
+  buf[2] = (uint8_t)(offset >> 8);
+  buf[3] = (uint8_t)(offset >> 0);
+  buf[4] = 0xFFU;                   /* 8 dummy cycles.*/
+  spiSelect(devp->config->busp);
+  spiSend(devp->config->busp, sizeof buf, buf);
+  spiReceive(devp->config->busp, n, rp);
+  spiUnselect(devp->config->busp);
+#endif
+}
+
+/**
+ * @brief   Reads little endian DWORDs from the SFDP area.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] offset    SFDP offset
+ * @param[out] dwp      pointer to the DWORDs buffer
+ * @param[in] n         number of DWORDs
+ */
+static void sfdp_read_dwords(SNORDriver *devp, uint32_t offset,
+                             uint32_t *dwp, uint32_t n) {
+  uint32_t i;
+
+  sfdp_read(devp, offset, (size_t)n * 4U, (uint8_t *)dwp);
+  for (i = 0U; i < n; i++) {
+    const uint8_t *p = (const uint8_t *)&dwp[i];
+
+    dwp[i] = (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+             ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+}
+
+/**
+ * @brief   Reads the parameter tables used by the driver.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[out] tp       pointer to the tables, zero-filled
+ * @return              The operation status.
+ * @retval false        if the device has no valid SFDP.
+ * @retval true         if at least the BFPT has been read.
+ */
+static bool sfdp_read_tables(SNORDriver *devp, sfdp_tables_t *tp) {
+  uint32_t hdr[2], i, nph;
+
+  sfdp_read_dwords(devp, 0U, hdr, 2U);
+  if (hdr[0] != SFDP_SIGNATURE) {
+    return false;
+  }
+
+  nph = ((hdr[1] >> 16) & 0xFFU) + 1U;
+  if (nph > SFDP_MAX_HEADERS) {
+    nph = SFDP_MAX_HEADERS;
+  }
+
+  for (i = 0U; i < nph; i++) {
+    uint32_t ph[2], id, len, ptr;
+
+    sfdp_read_dwords(devp, 8U + (i * 8U), ph, 2U);
+    id  = ((ph[1] >> 16) & 0xFF00U) | (ph[0] & 0xFFU);
+    len = ph[0] >> 24;
+    ptr = ph[1] & 0x00FFFFFFU;
+
+    /* Only major revision 1 tables are understood.*/
+    if (((ph[0] >> 16) & 0xFFU) != 1U) {
+      continue;
+    }
+
+    switch (id) {
+    case SFDP_ID_BFPT:
+      /* Later BFPT revisions are longer and supersede the older ones.*/
+      if ((len >= BFPT_MIN_DWORDS) && (len > tp->bfpt_n)) {
+        tp->bfpt_n = len < BFPT_MAX_DWORDS ? len : BFPT_MAX_DWORDS;
+        sfdp_read_dwords(devp, ptr, tp->bfpt, tp->bfpt_n);
+      }
+      break;
+    case SFDP_ID_4BAIT:
+      if (len >= BAIT_DWORDS) {
+        tp->bait_n = BAIT_DWORDS;
+        sfdp_read_dwords(devp, ptr, tp->bait, tp->bait_n);
+      }
+      break;
+    case SFDP_ID_PROFILE1:
+      if (len >= 1U) {
+        tp->profile1_n = len < PROFILE1_DWORDS ? len : PROFILE1_DWORDS;
+        sfdp_read_dwords(devp, ptr, tp->profile1, tp->profile1_n);
+      }
+      break;
+    case SFDP_ID_OCTAL_DDR:
+      if (len >= 2U) {
+        tp->octal_n = len < OCTAL_DDR_DWORDS ? len : OCTAL_DDR_DWORDS;
+        sfdp_read_dwords(devp, ptr, tp->octal, tp->octal_n);
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  return tp->bfpt_n >= BFPT_MIN_DWORDS;
+}
+
+/**
+ * @brief   Fills a minimal BFPT for devices without SFDP.
+ * @details The device is assumed to support 4kB and 64kB erases with the
+ *          standard instructions, the size is taken from the JEDEC ID.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[out] tp       pointer to the tables, zero-filled
+ */
+static void sfdp_default_tables(SNORDriver *devp, sfdp_tables_t *tp) {
+  uint32_t n = (uint32_t)devp->device_id[2];
+
+  osalDbgAssert((n >= 16U) && (n <= 31U), "unknown device size");
+  if ((n < 16U) || (n > 31U)) {
+    n = 16U;
+  }
+
+  tp->bfpt_n     = BFPT_MIN_DWORDS;
+  BFPT(tp, 1U)   = 0xFF8020E5U;         /* 4kB erase with 20h.*/
+  BFPT(tp, 2U)   = 0x80000000U | (n + 3U);
+  BFPT(tp, 8U)   = 0x0000200CU;         /* Type 1 4kB with 20h.*/
+  BFPT(tp, 9U)   = 0x0000D810U;         /* Type 3 64kB with D8h.*/
+}
+
+/**
+ * @brief   Attempts to set up the device parameters for a read mode.
+ *
+ * @param[in] tp        pointer to the tables
+ * @param[in] rp        pointer to the read mode
+ * @param[in] size      device size
+ * @return              The operation status.
+ * @retval false        if the read mode is not usable.
+ * @retval true         if the parameters have been set up.
+ */
+static bool sfdp_try_mode(const sfdp_tables_t *tp,
+                          const sfdp_read_mode_t *rp, uint32_t size) {
+  sfdp_params_t *pp = &snor_sfdp_params;
+  uint32_t bait = tp->bait_n > 0U ? tp->bait[0] : 0U;
+  uint32_t t, erase_size, erase_type;
+  bool need4;
+
+  /* Addressing, 8D-8D-8D always uses 4 bytes addresses and instructions,
+     else 4 bytes instructions are preferred over the stateful 4 bytes
+     mode.*/
+  pp->read = *rp;
+  need4 = (size > SFDP_3B_LIMIT) || (((BFPT(tp, 1U) >> 17) & 3U) == 2U);
+  if (rp->proto == SFDP_PROTO_8D_8D_8D) {
+    if ((tp->bait_n > 0U) && ((bait & BAIT_PP_1_1_1) == 0U)) {
+      return false;
+    }
+    pp->addr_mode = SFDP_ADDR_4B_OPCODES;
+  }
+  else if (!need4) {
+    pp->addr_mode = SFDP_ADDR_3B;
+  }
+  else if ((bait & (sfdp_bait_reads[rp->proto] | BAIT_PP_1_1_1)) ==
+           (sfdp_bait_reads[rp->proto] | BAIT_PP_1_1_1)) {
+    pp->addr_mode = SFDP_ADDR_4B_OPCODES;
+    pp->read.opcode = sfdp_opcode_4b(rp->opcode);
+  }
+  else if ((tp->bfpt_n >= 16U) &&
+           ((BFPT(tp, 16U) & ((1U << 24) | (1U << 25) | (1U << 30))) != 0U)) {
+    pp->addr_mode = SFDP_ADDR_4B_MODE;
+  }
+  else {
+    /* Only the first 16MB are accessible.*/
+    pp->addr_mode = SFDP_ADDR_3B;
+  }
+  pp->addr_bytes = pp->addr_mode == SFDP_ADDR_3B ? 3U : 4U;
+  pp->pp_opcode  = pp->addr_mode == SFDP_ADDR_4B_OPCODES ?
+                   sfdp_opcode_4b(SFDP_CMD_PP) : SFDP_CMD_PP;
+  if (pp->read.opcode == 0U) {
+    return false;
+  }
+
+  /* Erase type, the smallest or the largest one among those having a
+     usable instruction.*/
+  erase_size = 0U;
+  erase_type = 0U;
+  for (t = 1U; t <= 4U; t++) {
+    uint32_t hw = BFPT(tp, 8U + ((t - 1U) / 2U)) >> (((t - 1U) & 1U) * 16U);
+    uint32_t exp = hw & 0xFFU;
+    uint8_t op = (uint8_t)(hw >> 8);
+
+    if ((exp < 8U) || (exp > 31U)) {
+      continue;
+    }
+    if (pp->addr_mode == SFDP_ADDR_4B_OPCODES) {
+      if (tp->bait_n > 0U) {
+        op = (bait & (BAIT_ERASE_TYPE1 << (t - 1U))) != 0U ?
+             (uint8_t)(tp->bait[1] >> ((t - 1U) * 8U)) : 0U;
+      }
+      else {
+        op = sfdp_opcode_4b(op);
+      }
+    }
+    if ((op == 0U) || (op == 0xFFU)) {
+      continue;
+    }
+#if SFDP_USE_SUB_SECTORS == TRUE
+    if ((erase_size == 0U) || ((1U << exp) < erase_size)) {
+#else
+    if ((1U << exp) > erase_size) {
+#endif
+      erase_size       = 1U << exp;
+      erase_type       = t;
+      pp->erase_opcode = op;
+    }
+  }
+  if (erase_size == 0U) {
+    return false;
+  }
+
+  /* Typical times.*/
+  pp->erase_time = SFDP_DEFAULT_ERASE_TIME;
+  if (tp->bfpt_n >= 10U) {
+    static const uint32_t units[4] = {1000U, 16000U, 128000U, 1000000U};
+    uint32_t shift = 4U + ((erase_type - 1U) * 7U);
+    uint32_t count = (BFPT(tp, 10U) >> shift) & 0x1FU;
+
+    pp->erase_time = (count + 1U) * units[(BFPT(tp, 10U) >> (shift + 5U)) &
+                                          3U];
+  }
+  pp->program_time    = SFDP_DEFAULT_PROGRAM_TIME;
+  pp->chip_erase_time = SFDP_DEFAULT_CHIP_ERASE_TIME;
+  snor_descriptor.page_size = SFDP_DEFAULT_PAGE_SIZE;
+  if (tp->bfpt_n >= 11U) {
+    static const uint32_t units[4] = {16000U, 256000U, 4000000U, 64000000U};
+    uint32_t dw = BFPT(tp, 11U);
+
+    snor_descriptor.page_size = 1U << ((dw >> 4) & 0x0FU);
+    pp->program_time    = (((dw >> 8) & 0x1FU) + 1U) *
+                          ((dw & (1U << 13)) != 0U ? 64U : 8U);
+    pp->chip_erase_time = (((dw >> 24) & 0x1FU) + 1U) * units[(dw >> 29) & 3U];
+  }
+
+  /* Erase suspend, a clear bit 31 means supported.*/
+  pp->suspend_opcode = 0U;
+  pp->resume_opcode  = 0U;
+  if ((tp->bfpt_n >= 13U) && ((BFPT(tp, 12U) & (1U << 31)) == 0U)) {
+    pp->suspend_opcode = (uint8_t)(BFPT(tp, 13U) >> 24);
+    pp->resume_opcode  = (uint8_t)(BFPT(tp, 13U) >> 16);
+  }
+
+  /* 8D-8D-8D instructions extension and status register read.*/
+  if (rp->proto == SFDP_PROTO_8D_8D_8D) {
+    pp->cmd_ext_inv     = ((BFPT(tp, 18U) >> 29) & 3U) == 1U;
+    pp->rdsr_addr_bytes = (tp->profile1[0] & (1U << 29)) != 0U ? 4U : 0U;
+    pp->rdsr_dummy      = (tp->profile1[0] & (1U << 28)) != 0U ? 8U : 4U;
+  }
+
+  /* Geometry.*/
+  if ((pp->addr_bytes == 3U) && (size > SFDP_3B_LIMIT)) {
+    size = SFDP_3B_LIMIT;
+  }
+  snor_descriptor.sectors_size  = erase_size;
+  snor_descriptor.sectors_count = size / erase_size;
+  snor_descriptor.size          = snor_descriptor.sectors_count * erase_size;
+
+  return true;
+}
+
+/**
+ * @brief   Parses the tables and selects the device parameters.
+ * @details The read modes supported by the device are tried from the one
+ *          requiring less bus cycles.
+ *
+ * @param[in] tp        pointer to the tables
+ */
+static void sfdp_select(const sfdp_tables_t *tp) {
+  sfdp_params_t *pp = &snor_sfdp_params;
+  sfdp_read_mode_t reads[SFDP_PROTO_N];
+  uint32_t dw, size, protocols, tried, allowed, qer;
+
+  /* Density, in bits.*/
+  dw = BFPT(tp, 2U);
+  if ((dw & 0x80000000U) != 0U) {
+    dw &= 0x7FFFFFFFU;
+    size = dw < 3U ? 1U : (dw > 34U ? 0x80000000U : 1U << (dw - 3U));
+  }
+  else {
+    size = (dw / 8U) + 1U;
+  }
+
+  /* Read modes, the 1-1-1 fast read is always supported.*/
+  memset(reads, 0, sizeof reads);
+  protocols = sfdp_set_read(&reads[SFDP_PROTO_1_1_1], SFDP_PROTO_1_1_1,
+                            ((uint32_t)SFDP_CMD_FAST_READ << 8) | 8U);
+  dw = BFPT(tp, 1U);
+  if ((dw & (1U << 16)) != 0U) {
+    protocols |= sfdp_set_read(&reads[SFDP_PROTO_1_1_2], SFDP_PROTO_1_1_2,
+                               BFPT(tp, 4U) & 0xFFFFU);
+  }
+  if ((dw & (1U << 20)) != 0U) {
+    protocols |= sfdp_set_read(&reads[SFDP_PROTO_1_2_2], SFDP_PROTO_1_2_2,
+                               BFPT(tp, 4U) >> 16);
+  }
+  if ((dw & (1U << 22)) != 0U) {
+    protocols |= sfdp_set_read(&reads[SFDP_PROTO_1_1_4], SFDP_PROTO_1_1_4,
+                               BFPT(tp, 3U) >> 16);
+  }
+  if ((dw & (1U << 21)) != 0U) {
+    protocols |= sfdp_set_read(&reads[SFDP_PROTO_1_4_4], SFDP_PROTO_1_4_4,
+                               BFPT(tp, 3U) & 0xFFFFU);
+  }
+  if ((BFPT(tp, 5U) & (1U << 4)) != 0U) {
+    protocols |= sfdp_set_read(&reads[SFDP_PROTO_4_4_4], SFDP_PROTO_4_4_4,
+                               BFPT(tp, 7U) >> 16);
+  }
+  if (tp->bfpt_n >= 17U) {
+    protocols |= sfdp_set_read(&reads[SFDP_PROTO_1_1_8], SFDP_PROTO_1_1_8,
+                               BFPT(tp, 17U) & 0xFFFFU);
+    protocols |= sfdp_set_read(&reads[SFDP_PROTO_1_8_8], SFDP_PROTO_1_8_8,
+                               BFPT(tp, 17U) >> 16);
+  }
+  if (tp->profile1_n >= 1U) {
+    uint32_t dummy = 0U;
+
+    /* Dummy cycles for the highest declared frequency, rounded to an even
+       number.*/
+    if (tp->profile1_n >= 4U) {
+      dummy = (tp->profile1[3] >> 7) & 0x1FU;
+    }
+    if ((dummy == 0U) && (tp->profile1_n >= 5U)) {
+      dummy = (tp->profile1[4] >> 27) & 0x1FU;
+      if (dummy == 0U) {
+        dummy = (tp->profile1[4] >> 17) & 0x1FU;
+      }
+      if (dummy == 0U) {
+        dummy = (tp->profile1[4] >> 7) & 0x1FU;
+      }
+    }
+    if (dummy == 0U) {
+      dummy = SFDP_DEFAULT_8D_DUMMY;
+    }
+    reads[SFDP_PROTO_8D_8D_8D].proto  = SFDP_PROTO_8D_8D_8D;
+    reads[SFDP_PROTO_8D_8D_8D].opcode = (uint8_t)(tp->profile1[0] >> 8);
+    reads[SFDP_PROTO_8D_8D_8D].dummy  = (uint8_t)((dummy + 1U) & ~1U);
+    if (reads[SFDP_PROTO_8D_8D_8D].opcode != 0U) {
+      protocols |= SFDP_PROTO_MASK(SFDP_PROTO_8D_8D_8D);
+    }
+  }
+
+  /* Quad protocols require a known Quad Enable procedure, 4-4-4 also
+     requires a known QPI enable instruction.*/
+  qer = tp->bfpt_n >= 15U ? (BFPT(tp, 15U) >> 20) & 7U : 7U;
+  if (qer == 7U) {
+    protocols &= ~(SFDP_PROTO_MASK(SFDP_PROTO_1_1_4) |
+                   SFDP_PROTO_MASK(SFDP_PROTO_1_4_4) |
+                   SFDP_PROTO_MASK(SFDP_PROTO_4_4_4));
+  }
+  else if ((BFPT(tp, 15U) & (7U << 4)) == 0U) {
+    protocols &= ~SFDP_PROTO_MASK(SFDP_PROTO_4_4_4);
+  }
+
+  /* 8D-8D-8D requires a supported instruction extension and the enable
+     sequence.*/
+  if ((tp->bfpt_n < 18U) || (((BFPT(tp, 18U) >> 29) & 3U) > 1U) ||
+      (tp->octal_n < 2U) || ((tp->octal[0] >> 24) == 0U)) {
+    protocols &= ~SFDP_PROTO_MASK(SFDP_PROTO_8D_8D_8D);
+  }
+
+  /* Protocols allowed by the bus, plain SPI can only use 1-1-1 with the
+     normal read instruction.*/
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  allowed = (uint32_t)(SFDP_READ_PROTOCOLS) | SFDP_PROTO_MASK(SFDP_PROTO_1_1_1);
+#else
+  allowed = SFDP_PROTO_MASK(SFDP_PROTO_1_1_1);
+  reads[SFDP_PROTO_1_1_1].opcode = SFDP_CMD_READ;
+  reads[SFDP_PROTO_1_1_1].dummy  = 0U;
+  if (size > SFDP_3B_LIMIT) {
+    size = SFDP_3B_LIMIT;
+  }
+#endif
+  protocols &= allowed;
+
+  /* Trying the fastest modes first, 1-1-1 is the last resort.*/
+  tried = 0U;
+  while (true) {
+    uint32_t proto, best = SFDP_PROTO_1_1_1, best_cycles = 0xFFFFFFFFU;
+
+    for (proto = 0U; proto < SFDP_PROTO_N; proto++) {
+      if ((protocols & ~tried & SFDP_PROTO_MASK(proto)) != 0U) {
+        uint32_t cycles = sfdp_read_cycles(&reads[proto],
+                                           size > SFDP_3B_LIMIT ? 4U : 3U);
+        if (cycles < best_cycles) {
+          best        = proto;
+          best_cycles = cycles;
+        }
+      }
+    }
+    if ((best_cycles == 0xFFFFFFFFU) ||
+        sfdp_try_mode(tp, &reads[best], size)) {
+      break;
+    }
+    tried |= SFDP_PROTO_MASK(best);
+    protocols &= ~SFDP_PROTO_MASK(best);
+  }
+  pp->protocols = protocols;
+
+  osalDbgAssert(pp->read.opcode != 0U, "no usable read mode");
+}
+
+/**
+ * @brief   Reads the status register.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @return              The status register value.
+ */
+static uint8_t sfdp_read_status(SNORDriver *devp) {
+  uint8_t sts[2];
+
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  if (snor_sfdp_params.cmd_proto == SFDP_PROTO_8D_8D_8D) {
+    wspi_command_t cmd;
+
+    /* Status read can require an address and dummy cycles, two bytes are
+       read because DTR.*/
+    cmd.cmd   = sfdp_cmd(SFDP_CMD_RDSR);
+    cmd.cfg   = sfdp_wspi_cfg(SFDP_PROTO_8D_8D_8D,
+                              snor_sfdp_params.rdsr_addr_bytes, true);
+    cmd.addr  = 0U;
+    cmd.alt   = 0U;
+    cmd.dummy = snor_sfdp_params.rdsr_dummy;
+    wspiReceive(devp->config->busp, &cmd, 2U, sts);
+
+    return sts[0];
+  }
+#endif
+
+  bus_cmd_receive(devp->config->busp, sfdp_cmd(SFDP_CMD_RDSR), 1U, sts);
+
+  return sts[0];
+}
+
+/**
+ * @brief   Waits for the completion of an operation.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] typical   typical operation time in microseconds
+ */
+static void sfdp_poll_status(SNORDriver *devp, uint32_t typical) {
+
+#if SNOR_BUS_SUPPORTS_POLLING == TRUE
+  if (snor_sfdp_params.cmd_proto != SFDP_PROTO_8D_8D_8D) {
+    uint8_t sts[1];
+
+    /* The controller polls the WIP bit, the thread sleeps meanwhile.*/
+    bus_cmd_poll(devp->config->busp, sfdp_cmd(SFDP_CMD_RDSR), 1U, 0U, sts);
+    return;
+  }
+#endif
+
+  snor_wait_start(devp, typical);
+  do {
+#if SFDP_NICE_WAITING == TRUE
+    osalThreadSleepMicroseconds(snor_wait_next(devp));
+#endif
+  } while ((sfdp_read_status(devp) & 1U) != 0U);
+}
+
+/**
+ * @brief   Sets the Quad Enable bit.
+ * @details The procedure depends on the Quad Enable Requirements field of
+ *          the BFPT.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] qer       Quad Enable Requirements
+ */
+static void sfdp_quad_enable(SNORDriver *devp, uint32_t qer) {
+  BUSDriver *busp = devp->config->busp;
+  uint8_t sr[2];
+
+  switch (qer) {
+  case 1U:
+  case 4U:
+    /* QE is bit 1 of SR2 which cannot be read, writing SR1 alone would
+       clear it.*/
+    sr[0] = sfdp_read_status(devp);
+    sr[1] = 0x02U;
+    bus_cmd(busp, sfdp_cmd(SFDP_CMD_WREN));
+    bus_cmd_send(busp, sfdp_cmd(SFDP_CMD_WRSR), 2U, sr);
+    break;
+  case 2U:
+    /* QE is bit 6 of SR1.*/
+    sr[0] = sfdp_read_status(devp);
+    if ((sr[0] & 0x40U) != 0U) {
+      return;
+    }
+    sr[0] |= 0x40U;
+    bus_cmd(busp, sfdp_cmd(SFDP_CMD_WREN));
+    bus_cmd_send(busp, sfdp_cmd(SFDP_CMD_WRSR), 1U, sr);
+    break;
+  case 3U:
+    /* QE is bit 7 of SR2, accessed with dedicated instructions.*/
+    bus_cmd_receive(busp, sfdp_cmd(SFDP_CMD_RDSR2_B7), 1U, sr);
+    if ((sr[0] & 0x80U) != 0U) {
+      return;
+    }
+    sr[0] |= 0x80U;
+    bus_cmd(busp, sfdp_cmd(SFDP_CMD_WREN));
+    bus_cmd_send(busp, sfdp_cmd(SFDP_CMD_WRSR2_B7), 1U, sr);
+    break;
+  case 5U:
+    /* QE is bit 1 of SR2, written together with SR1.*/
+    sr[0] = sfdp_read_status(devp);
+    bus_cmd_receive(busp, sfdp_cmd(SFDP_CMD_RDSR2), 1U, &sr[1]);
+    if ((sr[1] & 0x02U) != 0U) {
+      return;
+    }
+    sr[1] |= 0x02U;
+    bus_cmd(busp, sfdp_cmd(SFDP_CMD_WREN));
+    bus_cmd_send(busp, sfdp_cmd(SFDP_CMD_WRSR), 2U, sr);
+    break;
+  case 6U:
+    /* QE is bit 1 of SR2, written alone.*/
+    bus_cmd_receive(busp, sfdp_cmd(SFDP_CMD_RDSR2), 1U, sr);
+    if ((sr[0] & 0x02U) != 0U) {
+      return;
+    }
+    sr[0] |= 0x02U;
+    bus_cmd(busp, sfdp_cmd(SFDP_CMD_WREN));
+    bus_cmd_send(busp, sfdp_cmd(SFDP_CMD_WRSR2), 1U, sr);
+    break;
+  default:
+    /* No QE bit.*/
+    return;
+  }
+
+  sfdp_poll_status(devp, snor_sfdp_params.program_time);
+}
+
+/**
+ * @brief   Switches the device to the selected modes.
+ * @note    Commands are sent in 1-1-1 mode, the commands protocol is
+ *          switched at the end.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] tp        pointer to the tables
+ */
+static void sfdp_enter_modes(SNORDriver *devp, const sfdp_tables_t *tp) {
+  sfdp_params_t *pp = &snor_sfdp_params;
+  BUSDriver *busp = devp->config->busp;
+  uint32_t qpi = (BFPT(tp, 15U) >> 4) & 7U;
+  uint32_t i;
+
+  /* Quad Enable for the quad protocols, 4-4-4 needs it only for some
+     enable methods.*/
+  if ((pp->read.proto == SFDP_PROTO_1_1_4) ||
+      (pp->read.proto == SFDP_PROTO_1_4_4) ||
+      ((pp->read.proto == SFDP_PROTO_4_4_4) && ((qpi & 1U) != 0U))) {
+    sfdp_quad_enable(devp, (BFPT(tp, 15U) >> 20) & 7U);
+  }
+
+  /* 4 bytes addressing mode.*/
+  if ((pp->addr_mode == SFDP_ADDR_4B_MODE) &&
+      ((BFPT(tp, 16U) & (1U << 30)) == 0U)) {
+    if ((BFPT(tp, 16U) & (1U << 24)) == 0U) {
+      bus_cmd(busp, SFDP_CMD_WREN);
+    }
+    bus_cmd(busp, SFDP_CMD_EN4B);
+  }
+
+  /* Commands protocol.*/
+  if (pp->read.proto == SFDP_PROTO_4_4_4) {
+    bus_cmd(busp, (qpi & 3U) != 0U ? SFDP_CMD_EQIO_38 : SFDP_CMD_EQIO_35);
+    pp->cmd_proto = SFDP_PROTO_4_4_4;
+  }
+  else if (pp->read.proto == SFDP_PROTO_8D_8D_8D) {
+    /* Up to four sequences of up to seven bytes, sent in 1-1-1 mode.*/
+    for (i = 0U; i + 1U < tp->octal_n; i += 2U) {
+      uint32_t len = tp->octal[i] >> 24;
+      uint8_t seq[7];
+
+      if ((len == 0U) || (len > sizeof seq)) {
+        break;
+      }
+      seq[0] = (uint8_t)(tp->octal[i] >> 16);
+      seq[1] = (uint8_t)(tp->octal[i] >> 8);
+      seq[2] = (uint8_t)(tp->octal[i] >> 0);
+      seq[3] = (uint8_t)(tp->octal[i + 1U] >> 24);
+      seq[4] = (uint8_t)(tp->octal[i + 1U] >> 16);
+      seq[5] = (uint8_t)(tp->octal[i + 1U] >> 8);
+      seq[6] = (uint8_t)(tp->octal[i + 1U] >> 0);
+      if (len == 1U) {
+        bus_cmd(busp, seq[0]);
+      }
+      else {
+        bus_cmd_send(busp, seq[0], len - 1U, &seq[1]);
+      }
+    }
+    pp->cmd_proto = SFDP_PROTO_8D_8D_8D;
+  }
+  else {
+    pp->cmd_proto = SFDP_PROTO_1_1_1;
+  }
+}
+
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
+/**
+ * @brief   Device software reset.
+ * @details The reset sequence is sent in 8D-8D-8D, 4-4-4 and 1-1-1 modes,
+ *          devices ignore commands not matching their current mode.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+static void sfdp_reset(SNORDriver *devp) {
+  static const struct {
+    uint8_t     proto;
+    uint32_t    cmd;
+  } seq[] = {
+    {SFDP_PROTO_8D_8D_8D, 0x6699U}, {SFDP_PROTO_8D_8D_8D, 0x9966U},
+    {SFDP_PROTO_8D_8D_8D, 0x6666U}, {SFDP_PROTO_8D_8D_8D, 0x9999U},
+    {SFDP_PROTO_4_4_4,    0x66U},   {SFDP_PROTO_4_4_4,    0x99U},
+    {SFDP_PROTO_1_1_1,    0x66U},   {SFDP_PROTO_1_1_1,    0x99U}
+  };
+  wspi_command_t cmd;
+  size_t i;
+
+  for (i = 0U; i < sizeof seq / sizeof seq[0]; i++) {
+    cmd.cmd   = seq[i].cmd;
+    cmd.cfg   = sfdp_wspi_cfg(seq[i].proto, 0U, false);
+    cmd.addr  = 0U;
+    cmd.alt   = 0U;
+    cmd.dummy = 0U;
+    wspiCommand(devp->config->busp, &cmd);
+  }
+}
+#endif /* SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Device initialization.
+ * @details The SFDP tables are read and parsed, the device is then
+ *          switched in the selected modes.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+void snor_device_init(SNORDriver *devp) {
+  sfdp_params_t *pp = &snor_sfdp_params;
+  sfdp_tables_t tables;
+
+  /* Initial 1-1-1 mode with 3 bytes addresses.*/
+  memset(pp, 0, sizeof (sfdp_params_t));
+  pp->cmd_proto  = SFDP_PROTO_1_1_1;
+  pp->read.proto = SFDP_PROTO_1_1_1;
+  pp->addr_bytes = 3U;
+  sfdp_set_cfg();
+  sfdp_suspended = false;
+
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) && (SFDP_RESET_ON_INIT == TRUE)
+  /* Attempting a reset of the device, it could be in an unexpected state
+     because a CPU reset does not reset the memory too.*/
+  sfdp_reset(devp);
+
+  /* The device requires at least 10uS to recover after a reset, it could
+     need up to 100mS in cause a reset occurred during a chip erase, 50uS
+     covers most cases.*/
+  osalThreadSleepMicroseconds(50);
+#endif
+
+  /* Reading device ID.*/
+  bus_cmd_receive(devp->config->busp, SFDP_CMD_RDID, 3U, devp->device_id);
+
+  /* Parsing SFDP, devices without SFDP are handled like a basic
+     JESD216 device.*/
+  memset(&tables, 0, sizeof tables);
+  pp->valid = sfdp_read_tables(devp, &tables);
+  if (!pp->valid) {
+    sfdp_default_tables(devp, &tables);
+  }
+  sfdp_select(&tables);
+
+  /* Entering the selected modes then switching the bus settings.*/
+  sfdp_enter_modes(devp, &tables);
+  sfdp_set_cfg();
+
+  snor_descriptor.attributes = FLASH_ATTR_ERASED_IS_ONE |
+                               FLASH_ATTR_REWRITABLE;
+  if (pp->suspend_opcode != 0U) {
+    snor_descriptor.attributes |= FLASH_ATTR_SUSPEND_ERASE_CAPABLE;
+  }
+
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) && (WSPI_SUPPORTS_MEMMAP == TRUE)
+  snor_memmap_read.cmd   = sfdp_cmd(pp->read.opcode);
+  snor_memmap_read.cfg   = pp->cfg_read;
+  snor_memmap_read.addr  = 0U;
+  snor_memmap_read.alt   = 0U;
+  snor_memmap_read.dummy = pp->read.dummy;
+#endif
+}
+
+/**
+ * @brief   Device read.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes
+ * @param[out] rp       pointer to the buffer
+ */
+flash_error_t snor_device_read(SNORDriver *devp, flash_offset_t offset,
+                               size_t n, uint8_t *rp) {
+
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  wspi_command_t cmd;
+
+  /* Read in the selected mode.*/
+  cmd.cmd   = sfdp_cmd(snor_sfdp_params.read.opcode);
+  cmd.cfg   = snor_sfdp_params.cfg_read;
+  cmd.addr  = offset;
+  cmd.alt   = 0U;
+  cmd.dummy = snor_sfdp_params.read.dummy;
+  wspiReceive(devp->config->busp, &cmd, n, rp);
+#else
+  /* Normal read command in SPI mode.*/
+  bus_cmd_addr_receive(devp->config->busp, snor_sfdp_params.read.opcode,
+                       offset, n, rp);
+#endif
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Device program.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes
+ * @param[in] pp        pointer to the buffer
+ */
+flash_error_t snor_device_program(SNORDriver *devp, flash_offset_t offset,
+                                  size_t n, const uint8_t *pp) {
+  flash_offset_t page_mask = snor_descriptor.page_size - 1U;
+
+  /* Data is programmed page by page.*/
+  while (n > 0U) {
+    /* Data size that can be written in a single program page operation.*/
+    size_t chunk = (size_t)(((offset | page_mask) + 1U) - offset);
+    if (chunk > n) {
+      chunk = n;
+    }
+
+    /* Enabling write operation.*/
+    bus_cmd(devp->config->busp, sfdp_cmd(SFDP_CMD_WREN));
+
+    /* Page program command.*/
+    bus_cmd_addr_send(devp->config->busp,
+                      sfdp_cmd(snor_sfdp_params.pp_opcode),
+                      offset, chunk, pp);
+
+    /* Wait for status.*/
+    sfdp_poll_status(devp, snor_sfdp_params.program_time);
+
+    /* Next page.*/
+    offset += chunk;
+    pp     += chunk;
+    n      -= chunk;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Device global erase start.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+flash_error_t snor_device_start_erase_all(SNORDriver *devp) {
+
+  /* Enabling write operation.*/
+  bus_cmd(devp->config->busp, sfdp_cmd(SFDP_CMD_WREN));
+
+  /* Bulk erase command.*/
+  bus_cmd(devp->config->busp, sfdp_cmd(SFDP_CMD_CE));
+
+  /* Completion polled by snor_device_query_erase().*/
+  snor_wait_start(devp, snor_sfdp_params.chip_erase_time);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Device sector erase start.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] sector    flash sector
+ */
+flash_error_t snor_device_start_erase_sector(SNORDriver *devp,
+                                             flash_sector_t sector) {
+  flash_offset_t offset = (flash_offset_t)(sector *
+                                           snor_descriptor.sectors_size);
+
+  /* Enabling write operation.*/
+  bus_cmd(devp->config->busp, sfdp_cmd(SFDP_CMD_WREN));
+
+  /* Sector erase command.*/
+  bus_cmd_addr(devp->config->busp, sfdp_cmd(snor_sfdp_params.erase_opcode),
+               offset);
+
+  /* Completion polled by snor_device_query_erase().*/
+  snor_wait_start(devp, snor_sfdp_params.erase_time);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Device erase verify.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] sector    flash sector
+ */
+flash_error_t snor_device_verify_erase(SNORDriver *devp,
+                                       flash_sector_t sector) {
+  uint8_t cmpbuf[SFDP_COMPARE_BUFFER_SIZE];
+  flash_offset_t offset;
+  size_t n;
+
+  /* Read command.*/
+  offset = (flash_offset_t)(sector * snor_descriptor.sectors_size);
+  n = snor_descriptor.sectors_size;
+  while (n > 0U) {
+    uint8_t *p;
+
+    (void) snor_device_read(devp, offset, sizeof cmpbuf, cmpbuf);
+
+    /* Checking for erased state of current buffer.*/
+    for (p = cmpbuf; p < &cmpbuf[SFDP_COMPARE_BUFFER_SIZE]; p++) {
+      if (*p != 0xFFU) {
+        /* Ready state again.*/
+        devp->state = FLASH_READY;
+
+        return FLASH_ERROR_VERIFY;
+      }
+    }
+
+    offset += sizeof cmpbuf;
+    n -= sizeof cmpbuf;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Queries if there is an erase in progress.
+ * @note    Generic devices have no standard error flags, erase failures
+ *          are only detected by verify.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[out] msec     suggested number of milliseconds before calling this
+ *                      function again
+ */
+flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec) {
+
+  /* If the WIP bit is one (busy) or the erase is suspended then report
+     that the operation is still in progress.*/
+  if (((sfdp_read_status(devp) & 1U) != 0U) || sfdp_suspended) {
+
+    /* Recommended time before polling again, adapted to the typical
+       erase time.*/
+    if (msec != NULL) {
+      *msec = (snor_wait_next(devp) + 999U) / 1000U;
+    }
+
+    return FLASH_BUSY_ERASING;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Suspends the erase in progress.
+ * @details The function returns when the device accepts read commands,
+ *          the erase could also have been completed in the meantime.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @return              The operation status.
+ * @retval FLASH_NO_ERROR       if the erase is suspended or completed.
+ * @retval FLASH_BUSY_ERASING   if the device does not support suspend.
+ */
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+
+  if (snor_sfdp_params.suspend_opcode == 0U) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Erase suspend command.*/
+  bus_cmd(devp->config->busp, sfdp_cmd(snor_sfdp_params.suspend_opcode));
+  sfdp_suspended = true;
+
+  /* Waiting for the WIP bit to go low, the suspend latency is in the tens
+     of microseconds range so sleeping would only add latency.*/
+  while ((sfdp_read_status(devp) & 1U) != 0U) {
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Resumes a suspended erase.
+ * @note    The command is ignored by the device if there is no suspended
+ *          erase.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+flash_error_t snor_device_resume_erase(SNORDriver *devp) {
+
+  if (sfdp_suspended) {
+    /* Erase resume command.*/
+    bus_cmd(devp->config->busp, sfdp_cmd(snor_sfdp_params.resume_opcode));
+    sfdp_suspended = false;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Reads the SFDP area.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ * @param[in] offset    SFDP offset
+ * @param[in] n         number of bytes
+ * @param[out] rp       pointer to the buffer
+ */
+flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
+                                    size_t n, uint8_t *rp) {
+
+  sfdp_read(devp, (uint32_t)offset, n, rp);
+
+  return FLASH_NO_ERROR;
+}
+
+/** @} */
@@ -0,0 +1,336 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_flash_device.h
+ * @brief   JEDEC SFDP generic serial flash driver header.
+ * @details The device parameters are discovered at initialization by
+ *          parsing the JESD216 Serial Flash Discoverable Parameters, the
+ *          fastest read protocol supported by both the device and the
+ *          configuration is selected automatically.
+ *
+ * @addtogroup JEDEC_SFDP
+ * @{
+ */
+
+#ifndef HAL_FLASH_DEVICE_H
+#define HAL_FLASH_DEVICE_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Device capabilities
+ * @note    Erase suspend is supported by the code, the actual device
+ *          capability is discovered from the BFPT and reported by the
+ *          @p FLASH_ATTR_SUSPEND_ERASE_CAPABLE attribute.
+ * @{
+ */
+#define SNOR_DEVICE_SUPPORTS_XIP            FALSE
+#define SNOR_DEVICE_SUPPORTS_SUSPEND        TRUE
+/** @} */
+
+/**
+ * @name    Read protocols
+ * @{
+ */
+#define SFDP_PROTO_1_1_1                    0U
+#define SFDP_PROTO_1_1_2                    1U
+#define SFDP_PROTO_1_2_2                    2U
+#define SFDP_PROTO_1_1_4                    3U
+#define SFDP_PROTO_1_4_4                    4U
+#define SFDP_PROTO_4_4_4                    5U
+#define SFDP_PROTO_1_1_8                    6U
+#define SFDP_PROTO_1_8_8                    7U
+#define SFDP_PROTO_8D_8D_8D                 8U
+#define SFDP_PROTO_N                        9U
+
+#define SFDP_PROTO_MASK(proto)              (1U << (proto))
+#define SFDP_PROTO_ALL                      ((1U << SFDP_PROTO_N) - 1U)
+/** @} */
+
+/**
+ * @name    Addressing modes
+ * @{
+ */
+#define SFDP_ADDR_3B                        0U
+#define SFDP_ADDR_4B_OPCODES                1U
+#define SFDP_ADDR_4B_MODE                   2U
+/** @} */
+
+/**
+ * @name    Command codes
+ * @{
+ */
+#define SFDP_CMD_READ                       0x03U
+#define SFDP_CMD_FAST_READ                  0x0BU
+#define SFDP_CMD_PP                         0x02U
+#define SFDP_CMD_CE                         0xC7U
+#define SFDP_CMD_WREN                       0x06U
+#define SFDP_CMD_RDSR                       0x05U
+#define SFDP_CMD_WRSR                       0x01U
+#define SFDP_CMD_RDSR2                      0x35U
+#define SFDP_CMD_WRSR2                      0x31U
+#define SFDP_CMD_RDSR2_B7                   0x3FU
+#define SFDP_CMD_WRSR2_B7                   0x3EU
+#define SFDP_CMD_EN4B                       0xB7U
+#define SFDP_CMD_EQIO_38                    0x38U
+#define SFDP_CMD_EQIO_35                    0x35U
+#define SFDP_CMD_RSTEN                      0x66U
+#define SFDP_CMD_RST                        0x99U
+#define SFDP_CMD_RDID                       0x9FU
+#define SFDP_CMD_RDSFDP                     0x5AU
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   SW reset on initialization.
+ * @details Enforces a reset on initialization, the device could have been
+ *          left in QPI, OPI or 4 bytes addressing modes by a previous
+ *          run.
+ * @note    It is only effective if the WSPI driver is in use, it does
+ *          nothing when SPI driver is used.
+ */
+#if !defined(SFDP_RESET_ON_INIT) || defined(__DOXYGEN__)
+#define SFDP_RESET_ON_INIT                  TRUE
+#endif
+
+/**
+ * @brief   Read protocols allowed by the bus controller.
+ * @details Mask of @p SFDP_PROTO_MASK() values, the fastest protocol
+ *          supported by both the device and this mask is selected.
+ * @note    Controllers with less than eight data lines must exclude the
+ *          octal protocols.
+ * @note    Only 1-1-1 is possible when SPI driver is used.
+ */
+#if !defined(SFDP_READ_PROTOCOLS) || defined(__DOXYGEN__)
+#define SFDP_READ_PROTOCOLS                 SFDP_PROTO_ALL
+#endif
+
+/**
+ * @brief   Delays insertions.
+ * @details If enabled this options inserts delays into the flash waiting
+ *          routines releasing some extra CPU time for threads with lower
+ *          priority. The first delay is the typical operation time as
+ *          declared by the device, then the status is polled with
+ *          exponentially growing delays.
+ * @note    Program operations do not use delays if the bus controller is
+ *          able to poll the device status autonomously.
+ */
+#if !defined(SFDP_NICE_WAITING) || defined(__DOXYGEN__)
+#define SFDP_NICE_WAITING                   TRUE
+#endif
+
+/**
+ * @brief   Uses the smallest erase type rather than the largest one.
+ */
+#if !defined(SFDP_USE_SUB_SECTORS) || defined(__DOXYGEN__)
+#define SFDP_USE_SUB_SECTORS                FALSE
+#endif
+
+/**
+ * @brief   Size of the compare buffer.
+ * @details This buffer is allocated in the stack frame of the function
+ *          @p flashVerifyErase() and its size must be a power of two.
+ *          Larger buffers lead to better verify performance but increase
+ *          stack usage for that function.
+ */
+#if !defined(SFDP_COMPARE_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define SFDP_COMPARE_BUFFER_SIZE            32
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SFDP_COMPARE_BUFFER_SIZE & (SFDP_COMPARE_BUFFER_SIZE - 1)) != 0
+#error "invalid SFDP_COMPARE_BUFFER_SIZE value"
+#endif
+
+#if ((SFDP_READ_PROTOCOLS) & ~SFDP_PROTO_ALL) != 0
+#error "invalid SFDP_READ_PROTOCOLS value"
+#endif
+
+/**
+ * @name    WSPI settings of the commands protocol
+ * @note    The bus settings depend on the protocol selected at run time.
+ * @{
+ */
+#define SNOR_WSPI_CFG_CMD               (snor_sfdp_params.cfg_cmd)
+#define SNOR_WSPI_CFG_CMD_ADDR          (snor_sfdp_params.cfg_cmd_addr)
+#define SNOR_WSPI_CFG_CMD_DATA          (snor_sfdp_params.cfg_cmd_data)
+#define SNOR_WSPI_CFG_CMD_ADDR_DATA     (snor_sfdp_params.cfg_cmd_addr_data)
+/** @} */
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a read mode.
+ */
+typedef struct {
+  /**
+   * @brief   Read protocol.
+   */
+  uint8_t                   proto;
+  /**
+   * @brief   Instruction code.
+   */
+  uint8_t                   opcode;
+  /**
+   * @brief   Mode clocks and wait states.
+   */
+  uint8_t                   dummy;
+} sfdp_read_mode_t;
+
+/**
+ * @brief   Type of the device parameters discovered through SFDP.
+ */
+typedef struct {
+  /**
+   * @brief   SFDP found and parsed.
+   */
+  bool                      valid;
+  /**
+   * @brief   Read protocols supported by the device, usable with the
+   *          selected addressing and allowed by configuration.
+   */
+  uint32_t                  protocols;
+  /**
+   * @brief   Selected read mode.
+   */
+  sfdp_read_mode_t          read;
+  /**
+   * @brief   Protocol of all non-read commands (1-1-1, 4-4-4 or 8D-8D-8D).
+   */
+  uint8_t                   cmd_proto;
+  /**
+   * @brief   Addressing mode.
+   */
+  uint8_t                   addr_mode;
+  /**
+   * @brief   Address size in bytes.
+   */
+  uint8_t                   addr_bytes;
+  /**
+   * @brief   8D-8D-8D commands second byte is the complement of the first.
+   */
+  bool                      cmd_ext_inv;
+  /**
+   * @brief   Page program instruction code.
+   */
+  uint8_t                   pp_opcode;
+  /**
+   * @brief   Sector erase instruction code.
+   */
+  uint8_t                   erase_opcode;
+  /**
+   * @brief   Erase suspend instruction code, zero if not supported.
+   */
+  uint8_t                   suspend_opcode;
+  /**
+   * @brief   Erase resume instruction code.
+   */
+  uint8_t                   resume_opcode;
+  /**
+   * @brief   Address bytes of the status register read in 8D-8D-8D mode.
+   */
+  uint8_t                   rdsr_addr_bytes;
+  /**
+   * @brief   Dummy cycles of the status register read in 8D-8D-8D mode.
+   */
+  uint8_t                   rdsr_dummy;
+  /**
+   * @brief   Typical page program time, microseconds.
+   */
+  uint32_t                  program_time;
+  /**
+   * @brief   Typical sector erase time, microseconds.
+   */
+  uint32_t                  erase_time;
+  /**
+   * @brief   Typical chip erase time, microseconds.
+   */
+  uint32_t                  chip_erase_time;
+  /**
+   * @brief   WSPI settings for the selected read mode.
+   */
+  uint32_t                  cfg_read;
+  /**
+   * @brief   WSPI settings for command only.
+   */
+  uint32_t                  cfg_cmd;
+  /**
+   * @brief   WSPI settings for command and address.
+   */
+  uint32_t                  cfg_cmd_addr;
+  /**
+   * @brief   WSPI settings for command and data.
+   */
+  uint32_t                  cfg_cmd_data;
+  /**
+   * @brief   WSPI settings for command, address and data.
+   */
+  uint32_t                  cfg_cmd_addr_data;
+} sfdp_params_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern flash_descriptor_t snor_descriptor;
+extern sfdp_params_t snor_sfdp_params;
+#endif
+
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) && (WSPI_SUPPORTS_MEMMAP == TRUE)
+extern wspi_command_t snor_memmap_read;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void snor_device_init(SNORDriver *devp);
+  flash_error_t snor_device_read(SNORDriver *devp, flash_offset_t offset,
+                                 size_t n, uint8_t *rp);
+  flash_error_t snor_device_program(SNORDriver *devp, flash_offset_t offset,
+                                    size_t n, const uint8_t *pp);
+  flash_error_t snor_device_start_erase_all(SNORDriver *devp);
+  flash_error_t snor_device_start_erase_sector(SNORDriver *devp,
+                                               flash_sector_t sector);
+  flash_error_t snor_device_verify_erase(SNORDriver *devp,
+                                         flash_sector_t sector);
+  flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec);
+  flash_error_t snor_device_suspend_erase(SNORDriver *devp);
+  flash_error_t snor_device_resume_erase(SNORDriver *devp);
+  flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
+                                      size_t n, uint8_t *rp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_FLASH_DEVICE_H */
+
+/** @} */
@@ -0,0 +1,11 @@
+# List of all the JEDEC SFDP device files.
+SERNORSRC := $(CHIBIOS)/os/hal/lib/complex/serial_nor/hal_serial_nor.c \
+             $(CHIBIOS)/os/hal/lib/complex/serial_nor/devices/jedec_sfdp/hal_flash_device.c
+
+# Required include directories
+SERNORINC := $(CHIBIOS)/os/hal/lib/complex/serial_nor \
+             $(CHIBIOS)/os/hal/lib/complex/serial_nor/devices/jedec_sfdp
+
+# Shared variables
+ALLCSRC += $(SERNORSRC)
+ALLINC  += $(SERNORINC)
@@ -37,9 +37,11 @@
 #if MX25_USE_SUB_SECTORS == TRUE
 #define SECTOR_SIZE                         0x00001000U
 #define CMD_SECTOR_ERASE                    MX25_CMD_SUBSECTOR_ERASE
+#define SECTOR_ERASE_TIME                   MX25_SUBSECTOR_ERASE_TIME
 #else
 #define SECTOR_SIZE                         0x00010000U
 #define CMD_SECTOR_ERASE                    MX25_CMD_SECTOR_ERASE
+#define SECTOR_ERASE_TIME                   MX25_SECTOR_ERASE_TIME
 #endif
 
 /*===========================================================================*/
@@ -134,12 +136,18 @@ static bool mx25_find_id(const uint8_t *set, size_t size, uint8_t element) {
   return false;
 }
 
-static flash_error_t mx25_poll_status(SNORDriver *devp) {
+static flash_error_t mx25_poll_status(SNORDriver *devp, uint32_t typical) {
   uint8_t sts[2], sec[2];
 
+#if (SNOR_BUS_SUPPORTS_POLLING == TRUE) && (MX25_BUS_MODE == MX25_BUS_MODE_SPI)
+  /* The controller polls the WIP bit, the thread sleeps meanwhile.*/
+  (void)typical;
+  bus_cmd_poll(devp->config->busp, MX25_CMD_SPI_RDSR, 1U, 0U, sts);
+#else
+  snor_wait_start(devp, typical);
   do {
 #if MX25_NICE_WAITING == TRUE
-    osalThreadSleepMilliseconds(1);
+    osalThreadSleepMicroseconds(snor_wait_next(devp));
 #endif
     /* Read status command.*/
 #if MX25_BUS_MODE == MX25_BUS_MODE_SPI
@@ -149,6 +157,7 @@ static flash_error_t mx25_poll_status(SNORDriver *devp) {
                                0U, 4U, 2U, sts);   /*Note: always 4 dummies.*/
 #endif
   } while ((sts[0] & 1U) != 0U);
+#endif
 
   /* Reading security register and checking for errors.*/
 #if MX25_BUS_MODE == MX25_BUS_MODE_SPI
@@ -471,7 +480,7 @@ flash_error_t snor_device_program(SNORDriver *devp, flash_offset_t offset,
 #endif
 
     /* Wait for status and check errors.*/
-    err = mx25_poll_status(devp);
+    err = mx25_poll_status(devp, MX25_PROGRAM_TIME);
     if (err != FLASH_NO_ERROR) {
 
       return err;
@@ -507,6 +516,9 @@ flash_error_t snor_device_start_erase_all(SNORDriver *devp) {
   bus_cmd(devp->config->busp, MX25_CMD_OPI_CE);
 #endif
 
+  /* Completion polled by snor_device_query_erase().*/
+  snor_wait_start(devp, MX25_CHIP_ERASE_TIME);
+
   return FLASH_NO_ERROR;
 }
 
@@ -545,6 +557,9 @@ flash_error_t snor_device_start_erase_sector(SNORDriver *devp,
 #endif
 #endif
 
+  /* Completion polled by snor_device_query_erase().*/
+  snor_wait_start(devp, SECTOR_ERASE_TIME);
+
   return FLASH_NO_ERROR;
 }
 
@@ -633,10 +648,10 @@ flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec) {
      report that the operation is still in progress.*/
   if (((sts[0] & 1) != 0U) || ((sec[0] & 8) != 0U)) {
 
-    /* Recommended time before polling again, this is a simplified
-       implementation.*/
+    /* Recommended time before polling again, adapted to the typical
+       erase time.*/
     if (msec != NULL) {
-      *msec = 1U;
+      *msec = (snor_wait_next(devp) + 999U) / 1000U;
     }
 
     return FLASH_BUSY_ERASING;
@@ -652,6 +667,58 @@ flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec) {
   return FLASH_NO_ERROR;
 }
 
+/**
+ * @brief   Suspends the erase in progress.
+ * @details The function returns when the device accepts read commands,
+ *          the erase could also have been completed in the meantime.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+  uint8_t sts[2];
+
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  /* Erase suspend command.*/
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_SUSPEND);
+#else
+  /* Erase suspend command.*/
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_SUSPEND);
+#endif
+
+  /* Waiting for the WIP bit to go low, the suspend latency is in the tens
+     of microseconds range so sleeping would only add latency.*/
+  do {
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+    bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSR, 1U, sts);
+#else
+    bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSR,
+                               0U, 4U, 2U, sts);   /*Note: always 4 dummies.*/
+#endif
+  } while ((sts[0] & 1U) != 0U);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Resumes a suspended erase.
+ * @note    The command is ignored by the device if there is no suspended
+ *          erase.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+flash_error_t snor_device_resume_erase(SNORDriver *devp) {
+
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  /* Erase resume command.*/
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_RESUME);
+#else
+  /* Erase resume command.*/
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_RESUME);
+#endif
+
+  return FLASH_NO_ERROR;
+}
+
 flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
                                     size_t n, uint8_t *rp) {
 
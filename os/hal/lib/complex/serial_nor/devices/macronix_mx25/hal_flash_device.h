@@ -34,6 +34,7 @@
  * @{
  */
 #define SNOR_DEVICE_SUPPORTS_XIP            FALSE
+#define SNOR_DEVICE_SUPPORTS_SUSPEND        TRUE
 /** @} */
 
 /**
@@ -302,12 +303,43 @@
  * @brief   Delays insertions.
  * @details If enabled this options inserts delays into the flash waiting
  *          routines releasing some extra CPU time for threads with lower
- *          priority, this may slow down the driver a bit however.
+ *          priority. The first delay is the typical operation time, then
+ *          the status is polled with exponentially growing delays.
+ * @note    Program operations do not use delays if the bus controller is
+ *          able to poll the device status autonomously.
  */
 #if !defined(MX25_NICE_WAITING) || defined(__DOXYGEN__)
 #define MX25_NICE_WAITING                   TRUE
 #endif
 
+/**
+ * @brief   Typical page program time in microseconds.
+ */
+#if !defined(MX25_PROGRAM_TIME) || defined(__DOXYGEN__)
+#define MX25_PROGRAM_TIME                   150
+#endif
+
+/**
+ * @brief   Typical 4kB sub-sector erase time in microseconds.
+ */
+#if !defined(MX25_SUBSECTOR_ERASE_TIME) || defined(__DOXYGEN__)
+#define MX25_SUBSECTOR_ERASE_TIME           25000
+#endif
+
+/**
+ * @brief   Typical 64kB sector erase time in microseconds.
+ */
+#if !defined(MX25_SECTOR_ERASE_TIME) || defined(__DOXYGEN__)
+#define MX25_SECTOR_ERASE_TIME              220000
+#endif
+
+/**
+ * @brief   Typical whole device erase time in microseconds.
+ */
+#if !defined(MX25_CHIP_ERASE_TIME) || defined(__DOXYGEN__)
+#define MX25_CHIP_ERASE_TIME                150000000
+#endif
+
 /**
  * @brief   Uses 4kB sub-sectors rather than 64kB sectors.
  */
@@ -424,6 +456,8 @@ extern "C" {
   flash_error_t snor_device_verify_erase(SNORDriver *devp,
                                          flash_sector_t sector);
   flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec);
+  flash_error_t snor_device_suspend_erase(SNORDriver *devp);
+  flash_error_t snor_device_resume_erase(SNORDriver *devp);
   flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
                                       size_t n, uint8_t *rp);
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) &&                            \
@@ -37,9 +37,11 @@
 #if N25Q_USE_SUB_SECTORS == TRUE
 #define SECTOR_SIZE                         0x00001000U
 #define CMD_SECTOR_ERASE                    N25Q_CMD_SUBSECTOR_ERASE
+#define SECTOR_ERASE_TIME                   N25Q_SUBSECTOR_ERASE_TIME
 #else
 #define SECTOR_SIZE                         0x00010000U
 #define CMD_SECTOR_ERASE                    N25Q_CMD_SECTOR_ERASE
+#define SECTOR_ERASE_TIME                   N25Q_SECTOR_ERASE_TIME
 #endif
 
 /*===========================================================================*/
@@ -197,17 +199,25 @@ static bool n25q_find_id(const uint8_t *set, size_t size, uint8_t element) {
   return false;
 }
 
-static flash_error_t n25q_poll_status(SNORDriver *devp) {
+static flash_error_t n25q_poll_status(SNORDriver *devp, uint32_t typical) {
   uint8_t sts;
 
+#if SNOR_BUS_SUPPORTS_POLLING == TRUE
+  /* The controller polls the P/E bit, the thread sleeps meanwhile.*/
+  (void)typical;
+  bus_cmd_poll(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
+               N25Q_FLAGS_PROGRAM_ERASE, N25Q_FLAGS_PROGRAM_ERASE, &sts);
+#else
+  snor_wait_start(devp, typical);
   do {
 #if N25Q_NICE_WAITING == TRUE
-    osalThreadSleepMilliseconds(1);
+    osalThreadSleepMicroseconds(snor_wait_next(devp));
 #endif
     /* Read status command.*/
     bus_cmd_receive(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
                     1, &sts);
   } while ((sts & N25Q_FLAGS_PROGRAM_ERASE) == 0U);
+#endif
 
   /* Checking for errors.*/
   if ((sts & N25Q_FLAGS_ALL_ERRORS) != 0U) {
@@ -408,7 +418,7 @@ flash_error_t snor_device_program(SNORDriver *devp, flash_offset_t offset,
                       chunk, pp);
 
     /* Wait for status and check errors.*/
-    err = n25q_poll_status(devp);
+    err = n25q_poll_status(devp, N25Q_PROGRAM_TIME);
     if (err != FLASH_NO_ERROR) {
 
       return err;
@@ -431,6 +441,9 @@ flash_error_t snor_device_start_erase_all(SNORDriver *devp) {
   /* Bulk erase command.*/
   bus_cmd(devp->config->busp, N25Q_CMD_BULK_ERASE);
 
+  /* Completion polled by snor_device_query_erase().*/
+  snor_wait_start(devp, N25Q_CHIP_ERASE_TIME);
+
   return FLASH_NO_ERROR;
 }
 
@@ -444,6 +457,9 @@ flash_error_t snor_device_start_erase_sector(SNORDriver *devp,
   /* Sector erase command.*/
   bus_cmd_addr(devp->config->busp, N25Q_CMD_SECTOR_ERASE, offset);
 
+  /* Completion polled by snor_device_query_erase().*/
+  snor_wait_start(devp, SECTOR_ERASE_TIME);
+
   return FLASH_NO_ERROR;
 }
 
@@ -498,10 +514,10 @@ flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec) {
   if (((sts & N25Q_FLAGS_PROGRAM_ERASE) == 0U) ||
       ((sts & N25Q_FLAGS_ERASE_SUSPEND) != 0U)) {
 
-    /* Recommended time before polling again, this is a simplified
-       implementation.*/
+    /* Recommended time before polling again, adapted to the typical
+       erase time.*/
     if (msec != NULL) {
-      *msec = 1U;
+      *msec = (snor_wait_next(devp) + 999U) / 1000U;
     }
 
     return FLASH_BUSY_ERASING;
@@ -520,6 +536,30 @@ flash_error_t snor_device_query_erase(SNORDriver *devp, uint32_t *msec) {
   return FLASH_NO_ERROR;
 }
 
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+  uint8_t sts;
+
+  /* Erase suspend command.*/
+  bus_cmd(devp->config->busp, N25Q_CMD_PROGRAM_ERASE_SUSPEND);
+
+  /* Waiting for the P/E bit to go high, the suspend latency is in the
+     tens of microseconds range so sleeping would only add latency.*/
+  do {
+    bus_cmd_receive(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
+                    1, &sts);
+  } while ((sts & N25Q_FLAGS_PROGRAM_ERASE) == 0U);
+
+  return FLASH_NO_ERROR;
+}
+
+flash_error_t snor_device_resume_erase(SNORDriver *devp) {
+
+  /* Erase resume command, ignored if there is no suspended erase.*/
+  bus_cmd(devp->config->busp, N25Q_CMD_PROGRAM_ERASE_RESUME);
+
+  return FLASH_NO_ERROR;
+}
+
 flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
                                     size_t n, uint8_t *rp) {
 
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "hal_serial_nor.h"
 
@@ -29,6 +31,17 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) &&                                     \
+    (SNOR_DEVICE_SUPPORTS_SUSPEND == FALSE)
+#error "SNOR_USE_ERASE_SUSPEND requires a device supporting erase suspend"
+#endif
+
+/**
+ * @brief   Ratio between the typical operation time and the shortest
+ *          status polling delay.
+ */
+#define SNOR_WAIT_MIN_RATIO                 8U
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -48,6 +61,7 @@ static flash_error_t snor_start_erase_sector(void *instance,
 static flash_error_t snor_verify_erase(void *instance,
                                        flash_sector_t sector);
 static flash_error_t snor_query_erase(void *instance, uint32_t *msec);
+static flash_error_t snor_get_stats(void *instance, flash_stats_t *sp);
 static flash_error_t snor_read_sfdp(void *instance, flash_offset_t offset,
                                     size_t n, uint8_t *rp);
 
@@ -59,13 +73,37 @@ static const struct SNORDriverVMT snor_vmt = {
   snor_get_descriptor, snor_read, snor_program,
   snor_start_erase_all, snor_start_erase_sector,
   snor_query_erase, snor_verify_erase,
-  snor_read_sfdp
+  snor_get_stats, snor_read_sfdp
 };
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SNOR_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Accounts a completed operation.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[out] sp       pointer to the statistics of the operation class
+ * @param[in] start     operation start time
+ */
+static void snor_stats_update(SNORDriver *devp, flash_op_stats_t *sp,
+                              systime_t start) {
+  sysinterval_t t = osalTimeDiffX(start, osalOsGetSystemTimeX());
+
+  if ((sp->n == 0U) || (t < sp->best)) {
+    sp->best = t;
+  }
+  if (t > sp->worst) {
+    sp->worst = t;
+  }
+  sp->n++;
+  sp->polls      += devp->wait_polls;
+  sp->cumulative += (uint64_t)t;
+}
+#endif /* SNOR_USE_STATISTICS == TRUE */
+
 /**
  * @brief   Returns a pointer to the device descriptor.
  *
@@ -82,6 +120,91 @@ static const flash_descriptor_t *snor_get_descriptor(void *instance) {
   return &snor_descriptor;
 }
 
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Read operation during an erase.
+ * @details The erase is suspended, the read is performed then the erase
+ *          is resumed. Readers queued on the bus while the erase is
+ *          suspended are served, in priority order, before resuming it
+ *          up to @p SNOR_ERASE_SUSPEND_WINDOW reads.
+ * @note    If the device does not report @p FLASH_ATTR_SUSPEND_ERASE_CAPABLE
+ *          then @p FLASH_BUSY_ERASING is returned without queuing.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              An error code.
+ */
+static flash_error_t snor_read_erasing(SNORDriver *devp, flash_offset_t offset,
+                                       size_t n, uint8_t *rp) {
+  size_t first, end;
+  flash_error_t err;
+
+  /* The device could lack the erase suspend capability, it is only known
+     after the device has been identified.*/
+  if ((snor_descriptor.attributes & FLASH_ATTR_SUSPEND_ERASE_CAPABLE) == 0U) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Sectors being erased cannot be read.*/
+  first = (size_t)devp->erase_first * (size_t)snor_descriptor.sectors_size;
+  end   = first + ((size_t)devp->erase_n *
+                   (size_t)snor_descriptor.sectors_size);
+  if (((size_t)offset < end) && ((size_t)offset + n > first)) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Queuing on the bus, the bus mutex serves the readers in priority
+     order.*/
+  osalSysLock();
+  devp->readers++;
+  osalSysUnlock();
+
+  /* Bus acquired.*/
+  bus_acquire(devp->config->busp, devp->config->buscfg);
+
+  osalSysLock();
+  devp->readers--;
+  osalSysUnlock();
+
+  if (devp->state != FLASH_ERASE) {
+    /* The erase has been completed while waiting for the bus.*/
+    devp->state = FLASH_READ;
+    err = snor_device_read(devp, offset, n, rp);
+    devp->state = FLASH_READY;
+  }
+  else {
+    /* Suspending the erase if not already suspended by a previous
+       reader.*/
+    err = FLASH_NO_ERROR;
+    if (devp->served == 0U) {
+      err = snor_device_suspend_erase(devp);
+    }
+
+    /* Actual read implementation, the suspension window is only opened
+       and accounted if the erase has been actually suspended.*/
+    if (err == FLASH_NO_ERROR) {
+      err = snor_device_read(devp, offset, n, rp);
+      devp->served++;
+
+      /* The erase is resumed if there are no other readers queued or if
+         the suspension window has been exhausted.*/
+      if ((devp->readers == 0U) ||
+          (devp->served >= (uint32_t)SNOR_ERASE_SUSPEND_WINDOW)) {
+        (void) snor_device_resume_erase(devp);
+        devp->served = 0U;
+      }
+    }
+  }
+
+  /* Bus released.*/
+  bus_release(devp->config->busp);
+
+  return err;
+}
+#endif /* SNOR_USE_ERASE_SUSPEND == TRUE */
+
 static flash_error_t snor_read(void *instance, flash_offset_t offset,
                                size_t n, uint8_t *rp) {
   SNORDriver *devp = (SNORDriver *)instance;
@@ -94,7 +217,11 @@ static flash_error_t snor_read(void *instance, flash_offset_t offset,
                 "invalid state");
 
   if (devp->state == FLASH_ERASE) {
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+    return snor_read_erasing(devp, offset, n, rp);
+#else
     return FLASH_BUSY_ERASING;
+#endif
   }
 
   /* Bus acquired.*/
@@ -135,9 +262,21 @@ static flash_error_t snor_program(void *instance, flash_offset_t offset,
 
   /* FLASH_PGM state while the operation is performed.*/
   devp->state = FLASH_PGM;
+  devp->wait_polls = 0U;
+
+#if SNOR_USE_STATISTICS == TRUE
+  {
+    systime_t start = osalOsGetSystemTimeX();
 
+    /* Actual program implementation.*/
+    err = snor_device_program(devp, offset, n, pp);
+
+    snor_stats_update(devp, &devp->stats.program, start);
+  }
+#else
   /* Actual program implementation.*/
   err = snor_device_program(devp, offset, n, pp);
+#endif
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
@@ -165,13 +304,19 @@ static flash_error_t snor_start_erase_all(void *instance) {
 
   /* FLASH_ERASE state while the operation is performed.*/
   devp->state = FLASH_ERASE;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_first = (flash_sector_t)0;
+  devp->erase_n     = snor_descriptor.sectors_count;
+  devp->served      = 0U;
+#endif
+  devp->wait_polls  = 0U;
+#if SNOR_USE_STATISTICS == TRUE
+  devp->erase_start = osalOsGetSystemTimeX();
+#endif
 
   /* Actual erase implementation.*/
   err = snor_device_start_erase_all(devp);
 
-  /* Ready state again.*/
-  devp->state = FLASH_READY;
-
   /* Bus released.*/
   bus_release(devp->config->busp);
 
@@ -197,6 +342,15 @@ static flash_error_t snor_start_erase_sector(void *instance,
 
   /* FLASH_ERASE state while the operation is performed.*/
   devp->state = FLASH_ERASE;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_first = sector;
+  devp->erase_n     = (flash_sector_t)1;
+  devp->served      = 0U;
+#endif
+  devp->wait_polls  = 0U;
+#if SNOR_USE_STATISTICS == TRUE
+  devp->erase_start = osalOsGetSystemTimeX();
+#endif
 
   /* Actual erase implementation.*/
   err = snor_device_start_erase_sector(devp, sector);
@@ -256,6 +410,13 @@ static flash_error_t snor_query_erase(void *instance, uint32_t *msec) {
     /* Actual query erase implementation.*/
     err = snor_device_query_erase(devp, msec);
 
+#if SNOR_USE_STATISTICS == TRUE
+    /* Erase completion.*/
+    if (err == FLASH_NO_ERROR) {
+      snor_stats_update(devp, &devp->stats.erase, devp->erase_start);
+    }
+#endif
+
     /* The device is ready to accept commands.*/
     if (err == FLASH_NO_ERROR) {
       devp->state = FLASH_READY;
@@ -271,6 +432,28 @@ static flash_error_t snor_query_erase(void *instance, uint32_t *msec) {
   return err;
 }
 
+static flash_error_t snor_get_stats(void *instance, flash_stats_t *sp) {
+#if SNOR_USE_STATISTICS == TRUE
+  SNORDriver *devp = (SNORDriver *)instance;
+
+  osalDbgCheck((instance != NULL) && (sp != NULL));
+  osalDbgAssert((devp->state != FLASH_UNINIT) && (devp->state != FLASH_STOP),
+                "invalid state");
+
+  /* Statistics are updated while owning the bus.*/
+  bus_acquire(devp->config->busp, devp->config->buscfg);
+  *sp = devp->stats;
+  bus_release(devp->config->busp);
+
+  return FLASH_NO_ERROR;
+#else
+  (void)instance;
+  (void)sp;
+
+  return FLASH_ERROR_UNIMPLEMENTED;
+#endif
+}
+
 static flash_error_t snor_read_sfdp(void *instance, flash_offset_t offset,
                                     size_t n, uint8_t *rp) {
   SNORDriver *devp = (SNORDriver *)instance;
@@ -633,6 +816,88 @@ void bus_cmd_addr_dummy_receive(BUSDriver *busp,
 }
 #endif /* SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI */
 
+#if (SNOR_BUS_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Polls a status register until a condition is met.
+ * @details The polling is performed by the bus controller, the calling
+ *          thread is suspended until the condition is met.
+ *
+ * @param[in] busp      pointer to the bus driver
+ * @param[in] cmd       status register read instruction code
+ * @param[in] mask      mask of the status bits to be checked
+ * @param[in] match     expected value of the masked status bits
+ * @param[out] p        last status byte
+ *
+ * @notapi
+ */
+void bus_cmd_poll(BUSDriver *busp,
+                  uint32_t cmd,
+                  uint8_t mask,
+                  uint8_t match,
+                  uint8_t *p) {
+  wspi_command_t mode;
+
+  mode.cmd   = cmd;
+  mode.cfg   = SNOR_WSPI_CFG_CMD_DATA;
+  mode.addr  = 0U;
+  mode.alt   = 0U;
+  mode.dummy = 0U;
+  wspiPoll(busp, &mode, mask, match, p);
+}
+#endif /* SNOR_BUS_SUPPORTS_POLLING == TRUE */
+
+/**
+ * @brief   Starts the status polling of a device operation.
+ * @details The first status poll is delayed by the typical operation time,
+ *          subsequent polls start from a fraction of it and the delay is
+ *          doubled on each poll up to the typical time.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] typical   typical operation time in microseconds
+ *
+ * @notapi
+ */
+void snor_wait_start(SNORDriver *devp, uint32_t typical) {
+
+  devp->wait_typical = typical > 0U ? typical : 1U;
+  devp->wait_delay   = 0U;
+}
+
+/**
+ * @brief   Returns the delay before the next status poll.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @return              The delay in microseconds, it is never zero.
+ *
+ * @notapi
+ */
+uint32_t snor_wait_next(SNORDriver *devp) {
+  uint32_t delay;
+
+  if (devp->wait_delay == 0U) {
+    /* First poll after the typical time, the operation is likely
+       complete at that point.*/
+    delay = devp->wait_typical;
+    devp->wait_delay = devp->wait_typical / SNOR_WAIT_MIN_RATIO;
+    if (devp->wait_delay == 0U) {
+      devp->wait_delay = 1U;
+    }
+  }
+  else {
+    /* Exponential backoff up to the typical time.*/
+    delay = devp->wait_delay;
+    if (delay < devp->wait_typical / 2U) {
+      devp->wait_delay = delay * 2U;
+    }
+    else {
+      devp->wait_delay = devp->wait_typical;
+    }
+  }
+  devp->wait_polls++;
+
+  return delay;
+}
+
 /**
  * @brief   Initializes an instance.
  *
@@ -647,6 +912,19 @@ void snorObjectInit(SNORDriver *devp) {
   devp->vmt         = &snor_vmt;
   devp->state       = FLASH_STOP;
   devp->config      = NULL;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_first = (flash_sector_t)0;
+  devp->erase_n     = (flash_sector_t)0;
+  devp->readers     = 0U;
+  devp->served      = 0U;
+#endif
+  devp->wait_typical = 1U;
+  devp->wait_delay   = 0U;
+  devp->wait_polls   = 0U;
+#if SNOR_USE_STATISTICS == TRUE
+  devp->erase_start  = (systime_t)0;
+  snorResetStats(devp);
+#endif
 }
 
 /**
@@ -711,6 +989,22 @@ void snorStop(SNORDriver *devp) {
   }
 }
 
+#if (SNOR_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Clears the operations statistics.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ *
+ * @api
+ */
+void snorResetStats(SNORDriver *devp) {
+
+  osalDbgCheck(devp != NULL);
+
+  memset(&devp->stats, 0, sizeof (flash_stats_t));
+}
+#endif /* SNOR_USE_STATISTICS == TRUE */
+
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
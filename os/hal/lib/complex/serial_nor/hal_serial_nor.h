@@ -65,6 +65,41 @@
 #if !defined(SNOR_SHARED_BUS) || defined(__DOXYGEN__)
 #define SNOR_SHARED_BUS                     TRUE
 #endif
+
+/**
+ * @brief   Reads during erase operations.
+ * @details If set to @p TRUE then read operations issued while an erase
+ *          is in progress suspend the erase, are served and then resume
+ *          it. If set to @p FALSE then such reads fail with
+ *          @p FLASH_BUSY_ERASING.
+ * @note    Requires a device supporting erase suspend.
+ * @note    Reads targeting the sectors being erased always fail with
+ *          @p FLASH_BUSY_ERASING.
+ */
+#if !defined(SNOR_USE_ERASE_SUSPEND) || defined(__DOXYGEN__)
+#define SNOR_USE_ERASE_SUSPEND              TRUE
+#endif
+
+/**
+ * @brief   Maximum number of reads served in a single erase suspension.
+ * @details Readers queued on the bus while the erase is suspended are
+ *          served in priority order without resuming it, after this
+ *          number of reads the erase is resumed in order to guarantee
+ *          its progress.
+ * @note    Queuing is only possible if @p SNOR_SHARED_BUS is enabled.
+ */
+#if !defined(SNOR_ERASE_SUSPEND_WINDOW) || defined(__DOXYGEN__)
+#define SNOR_ERASE_SUSPEND_WINDOW           4
+#endif
+
+/**
+ * @brief   Operations statistics.
+ * @details If set to @p TRUE then program and erase times are measured
+ *          and made available through the @p flashGetStats() method.
+ */
+#if !defined(SNOR_USE_STATISTICS) || defined(__DOXYGEN__)
+#define SNOR_USE_STATISTICS                 FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -81,6 +116,20 @@
 #error "invalid SNOR_BUS_DRIVER setting"
 #endif
 
+#if SNOR_ERASE_SUSPEND_WINDOW < 1
+#error "invalid SNOR_ERASE_SUSPEND_WINDOW value"
+#endif
+
+/**
+ * @brief   Status polling performed by the bus controller.
+ */
+#if ((SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) &&                           \
+     (WSPI_SUPPORTS_POLLING == TRUE)) || defined(__DOXYGEN__)
+#define SNOR_BUS_SUPPORTS_POLLING           TRUE
+#else
+#define SNOR_BUS_SUPPORTS_POLLING           FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -138,6 +187,47 @@ typedef struct {
    * @brief   Device ID and unique ID.
    */
   uint8_t                       device_id[20];
+  /**
+   * @brief   Typical time of the operation in progress, microseconds.
+   */
+  uint32_t                      wait_typical;
+  /**
+   * @brief   Next status polling delay, zero before the first poll.
+   */
+  uint32_t                      wait_delay;
+  /**
+   * @brief   Status polls performed by the operation in progress.
+   */
+  uint32_t                      wait_polls;
+#if (SNOR_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Start time of the erase in progress.
+   */
+  systime_t                     erase_start;
+  /**
+   * @brief   Operations statistics.
+   */
+  flash_stats_t                 stats;
+#endif
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   First sector of the erase in progress.
+   */
+  flash_sector_t                erase_first;
+  /**
+   * @brief   Number of sectors of the erase in progress.
+   */
+  flash_sector_t                erase_n;
+  /**
+   * @brief   Number of readers queued for the bus during an erase.
+   */
+  volatile uint32_t             readers;
+  /**
+   * @brief   Reads served in the current erase suspension, zero if the
+   *          erase is not suspended.
+   */
+  uint32_t                      served;
+#endif
 } SNORDriver;
 
 /*===========================================================================*/
@@ -188,9 +278,21 @@ extern "C" {
                                   size_t n,
                                   uint8_t *p);
 #endif
+#if (SNOR_BUS_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+  void bus_cmd_poll(BUSDriver *busp,
+                    uint32_t cmd,
+                    uint8_t mask,
+                    uint8_t match,
+                    uint8_t *p);
+#endif
+  void snor_wait_start(SNORDriver *devp, uint32_t typical);
+  uint32_t snor_wait_next(SNORDriver *devp);
   void snorObjectInit(SNORDriver *devp);
   void snorStart(SNORDriver *devp, const SNORConfig *config);
   void snorStop(SNORDriver *devp);
+#if (SNOR_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  void snorResetStats(SNORDriver *devp);
+#endif
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
   void snorMemoryMap(SNORDriver *devp, uint8_t ** addrp);
@@ -93,6 +93,11 @@ typedef uint16_t crykey_t;
  */
 typedef struct CRYDriver CRYDriver;
 
+/* The fall-back keys are part of the driver structure.*/
+#if HAL_CRY_USE_FALLBACK == TRUE
+#include "hal_crypto_fallback.h"
+#endif
+
 /**
  * @brief   Driver configuration structure.
  * @note    It could be empty on some architectures.
@@ -124,9 +129,15 @@ struct CRYDriver {
   size_t                    key0_size;
 #if (HAL_CRY_USE_FALLBACK == TRUE) || defined(__DOXYGEN__)
   /**
-   * @brief   Key buffer for the fall-back implementation.
+   * @brief   Fall-back transient keys.
+   */
+  cry_fallback_keys_t       fallback;
+#endif
+#if (HAL_CRY_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Jobs queue.
    */
-  uint8_t                   key0_buffer[HAL_CRY_MAX_KEY_SIZE];
+  cry_jobs_queue_t          jobs;
 #endif
 #if defined(CRY_DRIVER_EXT_FIELDS)
   CRY_DRIVER_EXT_FIELDS
@@ -86,6 +86,14 @@ static void wspi_lld_serve_dma_interrupt(WSPIDriver *wspip, uint32_t flags) {
  */
 static void wspi_lld_serve_interrupt(WSPIDriver *wspip) {
 
+  /* End of an automatic polling operation, the last status read is
+     available in the data register.*/
+  if ((wspip->qspi->CR & QUADSPI_CR_SMIE) != 0U) {
+    *wspip->statusp = (uint8_t)wspip->qspi->DR;
+    wspip->qspi->CR = (wspip->qspi->CR & ~(QUADSPI_CR_APMS | QUADSPI_CR_SMIE)) |
+                      QUADSPI_CR_DMAEN;
+  }
+
   /* Portable WSPI ISR code defined in the high level driver, note, it is
      a macro.*/
   _wspi_isr_code(wspip);
@@ -315,6 +323,43 @@ void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
   dmaStreamEnable(wspip->dma);
 }
 
+/**
+ * @brief   Polls a device status register.
+ * @details The QUADSPI automatic polling mode is used, the operation stops
+ *          on the first match.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] mask      mask of the status bits to be checked
+ * @param[in] match     expected value of the masked status bits
+ * @param[out] statusp  pointer to the location receiving the last status
+ *                      byte
+ *
+ * @notapi
+ */
+void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   uint8_t mask, uint8_t match, uint8_t *statusp) {
+
+  wspip->statusp = statusp;
+
+  /* DMA requests disabled while polling, the status match interrupt
+     terminates the operation.*/
+  wspip->qspi->CR    = (wspip->qspi->CR & ~QUADSPI_CR_DMAEN) |
+                       QUADSPI_CR_APMS | QUADSPI_CR_SMIE;
+  wspip->qspi->PSMKR = (uint32_t)mask;
+  wspip->qspi->PSMAR = (uint32_t)match;
+  wspip->qspi->PIR   = STM32_WSPI_QUADSPI1_POLLING_INTERVAL;
+  wspip->qspi->DLR   = 0U;
+  wspip->qspi->ABR   = cmdp->alt;
+  wspip->qspi->CCR   = cmdp->cmd | cmdp->cfg |
+                       QUADSPI_CCR_DUMMY_CYCLES(cmdp->dummy) |
+                       QUADSPI_CCR_FMODE_1;
+  if ((cmdp->cfg & WSPI_CFG_ADDR_MODE_MASK) != WSPI_CFG_ADDR_MODE_NONE) {
+    wspip->qspi->AR  = cmdp->addr;
+  }
+}
+
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Maps in memory space a WSPI flash device.
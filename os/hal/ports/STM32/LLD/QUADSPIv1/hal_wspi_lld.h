@@ -37,6 +37,7 @@
  */
 #define WSPI_SUPPORTS_MEMMAP                TRUE
 #define WSPI_DEFAULT_CFG_MASKS              FALSE
+#define WSPI_SUPPORTS_POLLING               TRUE
 /** @} */
 
 /**
@@ -149,6 +150,15 @@
 #define STM32_WSPI_QUADSPI1_PRESCALER_VALUE 1
 #endif
 
+/**
+ * @brief   QUADSPI1 status polling interval.
+ * @note    This is the number of QUADSPI clock cycles between two status
+ *          reads in automatic polling mode, 1..65535.
+ */
+#if !defined(STM32_WSPI_QUADSPI1_POLLING_INTERVAL) || defined(__DOXYGEN__)
+#define STM32_WSPI_QUADSPI1_POLLING_INTERVAL 256
+#endif
+
 /**
  * @brief   QUADSPI1 interrupt priority level setting.
  */
@@ -275,7 +285,9 @@
   /* QUADSPI DMA stream.*/                                                  \
   const stm32_dma_stream_t  *dma;                                           \
   /* QUADSPI DMA mode bit mask.*/                                           \
-  uint32_t                  dmamode
+  uint32_t                  dmamode;                                        \
+  /* Destination of the status in automatic polling mode.*/                 \
+  uint8_t                   *statusp
 
 /*===========================================================================*/
 /* External declarations.                                                    */
@@ -296,6 +308,8 @@ extern "C" {
                      size_t n, const uint8_t *txbuf);
   void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
                         size_t n, uint8_t *rxbuf);
+  void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     uint8_t mask, uint8_t match, uint8_t *statusp);
 #if WSPI_SUPPORTS_MEMMAP == TRUE
   void wspi_lld_map_flash(WSPIDriver *wspip,
                           const wspi_command_t *cmdp,
@@ -0,0 +1,412 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_mac_lld.c
+ * @brief   Simulator low level MAC driver code.
+ *
+ * @addtogroup SIMULATOR_MAC
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_MAC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Buffer states
+ * @{
+ */
+#define SIM_MAC_BUF_FREE        0U  /**< Owned by the simulated DMA.        */
+#define SIM_MAC_BUF_FILLED      1U  /**< Frame waiting to be fetched.       */
+#define SIM_MAC_BUF_LOCKED      2U  /**< Owned by a descriptor.             */
+/** @} */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   ETHD1 driver identifier.
+ */
+#if (USE_SIM_MAC1 == TRUE) || defined(__DOXYGEN__)
+MACDriver ETHD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Loops a transmitted frame back into the receive buffers.
+ * @details The frame is dropped if the next receive buffer is still owned
+ *          by the application, like a DMA engine would do.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] bp        pointer to the transmit buffer
+ * @param[in] size      size of the frame
+ *
+ * @notapi
+ */
+static void mac_loopback_frame(MACDriver *macp,
+                               const sim_mac_buffer_t *bp,
+                               size_t size) {
+  sim_mac_buffer_t *rxbp = &macp->rxbuf[macp->rxwrite];
+
+  if (rxbp->state != SIM_MAC_BUF_FREE) {
+    macp->rxdropped++;
+    return;
+  }
+
+  memcpy(rxbp->data, bp->data, size);
+  rxbp->size  = size;
+  rxbp->state = SIM_MAC_BUF_FILLED;
+  if (++macp->rxwrite >= SIM_MAC_RECEIVE_BUFFERS) {
+    macp->rxwrite = 0U;
+  }
+
+  /* Same actions a receive interrupt would perform.*/
+  osalThreadDequeueAllI(&macp->rdqueue, MSG_RESET);
+#if MAC_USE_EVENTS == TRUE
+  osalEventBroadcastFlagsI(&macp->rdevent, 0);
+#endif
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level MAC initialization.
+ *
+ * @notapi
+ */
+void mac_lld_init(void) {
+
+#if USE_SIM_MAC1 == TRUE
+  macObjectInit(&ETHD1);
+  ETHD1.link_up = false;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_start(MACDriver *macp) {
+  unsigned i;
+
+  for (i = 0U; i < SIM_MAC_TRANSMIT_BUFFERS; i++) {
+    macp->txbuf[i].state = SIM_MAC_BUF_FREE;
+  }
+  for (i = 0U; i < SIM_MAC_RECEIVE_BUFFERS; i++) {
+    macp->rxbuf[i].state = SIM_MAC_BUF_FREE;
+  }
+  macp->txnext    = 0U;
+  macp->rxwrite   = 0U;
+  macp->rxread    = 0U;
+  macp->rxdropped = 0U;
+
+  /* The loopback link is always up.*/
+  macp->link_up   = true;
+}
+
+/**
+ * @brief   Deactivates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_stop(MACDriver *macp) {
+
+  macp->link_up = false;
+}
+
+/**
+ * @brief   Returns a transmission descriptor.
+ * @details One of the available transmission descriptors is locked and
+ *          returned.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tdp      pointer to a @p MACTransmitDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                      MACTransmitDescriptor *tdp) {
+  sim_mac_buffer_t *bp;
+
+  if (!macp->link_up) {
+    return MSG_TIMEOUT;
+  }
+
+  bp = &macp->txbuf[macp->txnext];
+  if (bp->state != SIM_MAC_BUF_FREE) {
+    return MSG_TIMEOUT;
+  }
+
+  bp->state = SIM_MAC_BUF_LOCKED;
+  if (++macp->txnext >= SIM_MAC_TRANSMIT_BUFFERS) {
+    macp->txnext = 0U;
+  }
+
+  tdp->offset   = 0U;
+  tdp->size     = SIM_MAC_BUFFERS_SIZE;
+  tdp->physdesc = bp;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a transmit descriptor and starts the transmission of the
+ *          enqueued data as a single frame.
+ * @details The frame is immediately received back by the driver.
+ *
+ * @param[in] tdp       the pointer to the @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
+
+  osalDbgAssert(tdp->physdesc->state == SIM_MAC_BUF_LOCKED,
+                "descriptor not locked");
+
+  osalSysLock();
+
+  if (tdp->offset > 0U) {
+    mac_loopback_frame(&ETHD1, tdp->physdesc, tdp->offset);
+  }
+
+  /* The transmit buffer is immediately available again.*/
+  tdp->physdesc->state = SIM_MAC_BUF_FREE;
+  osalThreadDequeueAllI(&ETHD1.tdqueue, MSG_RESET);
+
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns a receive descriptor.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] rdp      pointer to a @p MACReceiveDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+  sim_mac_buffer_t *bp = &macp->rxbuf[macp->rxread];
+
+  if (bp->state != SIM_MAC_BUF_FILLED) {
+    return MSG_TIMEOUT;
+  }
+
+  bp->state = SIM_MAC_BUF_LOCKED;
+  if (++macp->rxread >= SIM_MAC_RECEIVE_BUFFERS) {
+    macp->rxread = 0U;
+  }
+
+  rdp->offset   = 0U;
+  rdp->size     = bp->size;
+  rdp->physdesc = bp;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a receive descriptor.
+ * @details The descriptor and its buffer are made available for more incoming
+ *          frames.
+ * @note    Descriptors can be released in any order.
+ *
+ * @param[in] rdp       the pointer to the @p MACReceiveDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp) {
+
+  osalDbgAssert(rdp->physdesc->state == SIM_MAC_BUF_LOCKED,
+                "descriptor not locked");
+
+  osalSysLock();
+  rdp->physdesc->state = SIM_MAC_BUF_FREE;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Updates and returns the link status.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ * @retval true         if the link is active.
+ * @retval false        if the link is down.
+ *
+ * @notapi
+ */
+bool mac_lld_poll_link_status(MACDriver *macp) {
+
+  return macp->link_up;
+}
+
+/**
+ * @brief   Writes to a transmit descriptor's stream.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer containing the data to be
+ *                      written
+ * @param[in] size      number of bytes to be written
+ * @return              The number of bytes written into the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if the maximum
+ *                      frame size is reached.
+ *
+ * @notapi
+ */
+size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                         uint8_t *buf,
+                                         size_t size) {
+
+  if (size > tdp->size - tdp->offset) {
+    size = tdp->size - tdp->offset;
+  }
+
+  if (size > 0U) {
+    memcpy(&tdp->physdesc->data[tdp->offset], buf, size);
+    tdp->offset += size;
+  }
+
+  return size;
+}
+
+/**
+ * @brief   Reads from a receive descriptor's stream.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[in] buf       pointer to the buffer that will receive the read data
+ * @param[in] size      number of bytes to be read
+ * @return              The number of bytes read from the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if there are
+ *                      no more bytes to read.
+ *
+ * @notapi
+ */
+size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                       uint8_t *buf,
+                                       size_t size) {
+
+  if (size > rdp->size - rdp->offset) {
+    size = rdp->size - rdp->offset;
+  }
+
+  if (size > 0U) {
+    memcpy(buf, &rdp->physdesc->data[rdp->offset], size);
+    rdp->offset += size;
+  }
+
+  return size;
+}
+
+#if (MAC_USE_ZERO_COPY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a pointer to the next transmit buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that enough buffers can be requested to fill
+ *          a whole frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] size      size of the requested buffer. Specify the frame size
+ *                      on the first call then scale the value down subtracting
+ *                      the amount of data already copied into the previous
+ *                      buffers.
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ *                      Note that a returned size lower than the amount
+ *                      requested means that more buffers must be requested
+ *                      in order to fill the frame data entirely.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                          size_t size,
+                                          size_t *sizep) {
+
+  if (tdp->offset == 0U) {
+    *sizep      = tdp->size;
+    tdp->offset = size;
+    return tdp->physdesc->data;
+  }
+  *sizep = 0U;
+  return NULL;
+}
+
+/**
+ * @brief   Returns a pointer to the next receive buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that the descriptor chain contains a whole
+ *          frame.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                               size_t *sizep) {
+
+  if (rdp->size > 0U) {
+    *sizep      = rdp->size;
+    rdp->offset = rdp->size;
+    rdp->size   = 0U;
+    return rdp->physdesc->data;
+  }
+  *sizep = 0U;
+  return NULL;
+}
+#endif /* MAC_USE_ZERO_COPY == TRUE */
+
+#endif /* HAL_USE_MAC == TRUE */
+
+/** @} */
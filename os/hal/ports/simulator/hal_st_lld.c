@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <time.h>
+
 #include "hal.h"
 
 #if (OSAL_ST_MODE != OSAL_ST_MODE_NONE) || defined(__DOXYGEN__)
@@ -42,10 +44,69 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Host time at counter start in nanoseconds.
+ */
+static uint64_t st_start;
+
+/**
+ * @brief   Alarm time extended to 64 bits.
+ */
+static uint64_t st_alarm;
+
+/**
+ * @brief   Alarm enabled.
+ */
+static bool st_alarm_active;
+
+/**
+ * @brief   Alarm armed, cleared when the alarm triggers.
+ */
+static bool st_alarm_armed;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the host monotonic time in nanoseconds.
+ */
+static uint64_t st_host_time(void) {
+  struct timespec ts;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief   Returns the counter value extended to 64 bits.
+ */
+static uint64_t st_get_counter64(void) {
+  uint64_t ns = st_host_time() - st_start;
+
+  return ((ns / 1000000000ULL) * (uint64_t)OSAL_ST_FREQUENCY) +
+         (((ns % 1000000000ULL) * (uint64_t)OSAL_ST_FREQUENCY) /
+          1000000000ULL);
+}
+
+/**
+ * @brief   Arms the alarm.
+ * @note    Like a compare register the alarm matches the next time the
+ *          counter reaches the specified value, a time already passed
+ *          matches after a counter wrap.
+ */
+static void st_arm_alarm(systime_t time) {
+  uint64_t now = st_get_counter64();
+
+  st_alarm       = now + (uint64_t)(systime_t)(time - (systime_t)now);
+  st_alarm_armed = true;
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -60,7 +121,134 @@
  * @notapi
  */
 void st_lld_init(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  st_start        = st_host_time();
+  st_alarm        = 0U;
+  st_alarm_active = false;
+  st_alarm_armed  = false;
+#endif
+}
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time counter value.
+ *
+ * @return              The counter value.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_counter(void) {
+
+  return (systime_t)st_get_counter64();
+}
+
+/**
+ * @brief   Starts the alarm.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void st_lld_start_alarm(systime_t time) {
+
+  st_alarm_active = true;
+  st_arm_alarm(time);
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ *
+ * @notapi
+ */
+void st_lld_stop_alarm(void) {
+
+  st_alarm_active = false;
+  st_alarm_armed  = false;
+}
+
+/**
+ * @brief   Sets the alarm time.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void st_lld_set_alarm(systime_t time) {
+
+  st_arm_alarm(time);
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently set alarm time.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_alarm(void) {
+
+  return (systime_t)st_alarm;
+}
+
+/**
+ * @brief   Determines if the alarm is active.
+ *
+ * @return              The alarm status.
+ * @retval false        if the alarm is not active.
+ * @retval true         is the alarm is active
+ *
+ * @notapi
+ */
+bool st_lld_is_alarm_active(void) {
+
+  return st_alarm_active;
+}
+
+/**
+ * @brief   Checks if the alarm triggered.
+ * @details The alarm is disarmed when triggering, it is armed again by the
+ *          next alarm setting.
+ *
+ * @return              The alarm trigger status.
+ * @retval false        if the alarm did not trigger.
+ * @retval true         if the alarm triggered.
+ *
+ * @notapi
+ */
+bool st_lld_alarm_triggered(void) {
+
+  if (st_alarm_armed && (st_get_counter64() >= st_alarm)) {
+    st_alarm_armed = false;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Returns the host time of the armed alarm.
+ *
+ * @param[out] nsp      host monotonic time of the alarm in nanoseconds
+ * @return              The alarm armed status.
+ * @retval false        if the alarm is not armed.
+ * @retval true         if the alarm is armed.
+ *
+ * @notapi
+ */
+bool st_lld_get_deadline(uint64_t *nsp) {
+  uint64_t freq = (uint64_t)OSAL_ST_FREQUENCY;
+
+  if (!st_alarm_armed) {
+    return false;
+  }
+
+  *nsp = st_start + ((st_alarm / freq) * 1000000000ULL) +
+         ((((st_alarm % freq) * 1000000000ULL) + freq - 1U) / freq);
+
+  return true;
 }
+#endif /* OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING */
 
 #endif /* OSAL_ST_MODE != OSAL_ST_MODE_NONE */
 
@@ -39,6 +39,10 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) && defined(WIN32)
+#error "free running mode not supported by the Win32 simulator"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -55,6 +59,16 @@
 extern "C" {
 #endif
   void st_lld_init(void);
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+  systime_t st_lld_get_counter(void);
+  void st_lld_start_alarm(systime_t time);
+  void st_lld_stop_alarm(void);
+  void st_lld_set_alarm(systime_t time);
+  systime_t st_lld_get_alarm(void);
+  bool st_lld_is_alarm_active(void);
+  bool st_lld_alarm_triggered(void);
+  bool st_lld_get_deadline(uint64_t *nsp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -63,6 +77,8 @@ extern "C" {
 /* Driver inline functions.                                                  */
 /*===========================================================================*/
 
+#if OSAL_ST_MODE != OSAL_ST_MODE_FREERUNNING
+
 /**
  * @brief   Returns the time counter value.
  *
@@ -136,6 +152,8 @@ static inline bool st_lld_is_alarm_active(void) {
   return false;
 }
 
+#endif /* OSAL_ST_MODE != OSAL_ST_MODE_FREERUNNING */
+
 #endif /* HAL_ST_LLD_H */
 
 /** @} */
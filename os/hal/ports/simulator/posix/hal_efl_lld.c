@@ -0,0 +1,492 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_efl_lld.c
+ * @brief   Posix simulator embedded flash driver code.
+ *
+ * @addtogroup HAL_EFL
+ * @{
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   EFL1 driver identifier.
+ */
+EFlashDriver EFLD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Default configuration, anonymous memory and no latencies.
+ */
+static const EFlashConfig efl_default_config = {
+  NULL,
+  (flash_sector_t)SIM_EFL_SECTORS_COUNT,
+  (uint32_t)SIM_EFL_SECTORS_SIZE,
+  (uint32_t)SIM_EFL_PAGE_SIZE,
+  0U,
+  0U,
+  0U
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of program pages touched by an operation.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver instance
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes
+ * @return              The number of pages.
+ *
+ * @notapi
+ */
+static uint32_t efl_sim_pages(EFlashDriver *eflp,
+                              flash_offset_t offset, size_t n) {
+  uint32_t page_size = eflp->descriptor.page_size;
+
+  return (((uint32_t)offset + (uint32_t)n + page_size - 1U) / page_size) -
+         ((uint32_t)offset / page_size);
+}
+
+/**
+ * @brief   Erases a range of sectors.
+ * @details The array content is updated immediately, the device is then
+ *          busy until the simulated erase time has elapsed.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver instance
+ * @param[in] first     first sector to be erased
+ * @param[in] n         number of sectors to be erased
+ *
+ * @notapi
+ */
+static void efl_sim_erase(EFlashDriver *eflp,
+                          flash_sector_t first, flash_sector_t n) {
+  uint32_t size = eflp->descriptor.sectors_size;
+  uint64_t time = (uint64_t)eflp->config->erase_time * (uint64_t)n;
+  flash_sector_t i;
+
+  memset(eflp->array + ((size_t)first * size), 0xFF, (size_t)n * size);
+  for (i = first; i < first + n; i++) {
+    eflp->wear[i]++;
+  }
+  eflp->stats.n_erases  += n;
+  eflp->stats.busy_time += time;
+  eflp->erase_end        = _sim_get_time_us() + time;
+  eflp->state            = FLASH_ERASE;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level Embedded Flash driver initialization.
+ *
+ * @notapi
+ */
+void efl_lld_init(void) {
+
+  eflObjectInit(&EFLD1);
+  EFLD1.array = NULL;
+  EFLD1.wear  = NULL;
+}
+
+/**
+ * @brief   Configures and activates the Embedded Flash peripheral.
+ * @note    The flash array is mapped on the first activation, the host file
+ *          is created if missing.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+void efl_lld_start(EFlashDriver *eflp) {
+
+  if (eflp->config == NULL) {
+    eflp->config = &efl_default_config;
+  }
+
+  if (eflp->state == FLASH_STOP) {
+    osalDbgCheck((eflp->config->sectors_count > 0U) &&
+                 (eflp->config->page_size > 0U) &&
+                 ((eflp->config->sectors_size %
+                   eflp->config->page_size) == 0U));
+
+    eflp->descriptor.attributes    = FLASH_ATTR_ERASED_IS_ONE |
+                                     FLASH_ATTR_REWRITABLE;
+    eflp->descriptor.page_size     = eflp->config->page_size;
+    eflp->descriptor.sectors_count = eflp->config->sectors_count;
+    eflp->descriptor.sectors       = NULL;
+    eflp->descriptor.sectors_size  = eflp->config->sectors_size;
+    eflp->descriptor.address       = NULL;
+    eflp->descriptor.size          = eflp->config->sectors_count *
+                                     eflp->config->sectors_size;
+
+    eflp->array = _sim_storage_map(eflp->config->path,
+                                   (size_t)eflp->descriptor.size, 0xFFU);
+    eflp->wear  = calloc((size_t)eflp->config->sectors_count,
+                         sizeof (uint32_t));
+    osalDbgAssert(eflp->wear != NULL, "out of memory");
+    eflp->erase_end = 0U;
+    eflSimResetStats(eflp);
+  }
+}
+
+/**
+ * @brief   Deactivates the Embedded Flash peripheral.
+ * @note    The flash array is written back to the host file.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+void efl_lld_stop(EFlashDriver *eflp) {
+
+  if (eflp->state != FLASH_STOP) {
+    if (eflp->config->path != NULL) {
+      _sim_storage_sync(eflp->array, (size_t)eflp->descriptor.size);
+    }
+    _sim_storage_unmap(eflp->array, (size_t)eflp->descriptor.size);
+    free(eflp->wear);
+    eflp->array = NULL;
+    eflp->wear  = NULL;
+  }
+}
+
+/**
+ * @brief   Gets the flash descriptor structure.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @return                          A flash device descriptor.
+ *
+ * @notapi
+ */
+const flash_descriptor_t *efl_lld_get_descriptor(void *instance) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  return &devp->descriptor;
+}
+
+/**
+ * @brief   Read operation.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] offset                flash offset
+ * @param[in] n                     number of bytes to be read
+ * @param[out] rp                   pointer to the data buffer
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_READ         if the read operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE   if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                           size_t n, uint8_t *rp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  uint32_t time;
+
+  osalDbgCheck((instance != NULL) && (rp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= (size_t)devp->descriptor.size);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No reading while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* FLASH_READ state while the operation is performed.*/
+  devp->state = FLASH_READ;
+
+  time = efl_sim_pages(devp, offset, n) * devp->config->read_time;
+  memcpy((void *)rp, (const void *)(devp->array + offset), n);
+  _sim_delay_us(time);
+  devp->stats.n_reads++;
+  devp->stats.read_bytes += (uint32_t)n;
+  devp->stats.busy_time  += time;
+
+  /* Ready state again.*/
+  devp->state = FLASH_READY;
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Program operation.
+ * @note    Like in NOR devices, programming can only clear bits.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] offset                flash offset
+ * @param[in] n                     number of bytes to be programmed
+ * @param[in] pp                    pointer to the data buffer
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_PROGRAM      if the program operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE   if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                              size_t n, const uint8_t *pp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  uint8_t *p;
+  uint32_t time;
+  size_t i;
+
+  osalDbgCheck((instance != NULL) && (pp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= (size_t)devp->descriptor.size);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No programming while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* FLASH_PGM state while the operation is performed.*/
+  devp->state = FLASH_PGM;
+
+  time = efl_sim_pages(devp, offset, n) * devp->config->program_time;
+  p = devp->array + offset;
+  for (i = 0U; i < n; i++) {
+    p[i] &= pp[i];
+  }
+  _sim_delay_us(time);
+  devp->stats.n_programs++;
+  devp->stats.programmed_bytes += (uint32_t)n;
+  devp->stats.busy_time        += time;
+
+  /* Ready state again.*/
+  devp->state = FLASH_READY;
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Starts a whole-device erase operation.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_all(void *instance) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No erasing while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  efl_sim_erase(devp, (flash_sector_t)0, devp->descriptor.sectors_count);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Starts an sector erase operation.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] sector                sector to be erased
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_sector(void *instance,
+                                         flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < devp->descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No erasing while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  efl_sim_erase(devp, sector, (flash_sector_t)1);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Queries the driver for erase operation progress.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[out] msec                 recommended time, in milliseconds, that
+ *                                  should be spent before calling this
+ *                                  function again, can be @p NULL
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_ERASE        if the erase operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE   if access to the memory failed.
+ *
+ * @api
+ */
+flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  uint64_t now;
+
+  /* If there is an erase in progress then the simulated time must be
+     checked.*/
+  if (devp->state == FLASH_ERASE) {
+    now = _sim_get_time_us();
+    if (now < devp->erase_end) {
+      /* Recommended time before polling again, the remaining time rounded
+         up to milliseconds.*/
+      if (msec != NULL) {
+        *msec = (uint32_t)((devp->erase_end - now + 999U) / 1000U);
+      }
+
+      return FLASH_BUSY_ERASING;
+    }
+
+    /* Back to ready state.*/
+    devp->state = FLASH_READY;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Returns the erase state of a sector.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] sector                sector to be verified
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if the sector is erased.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_VERIFY       if the verify operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE   if access to the memory failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  const uint8_t *p;
+  uint32_t i;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < devp->descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No verifying while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  p = devp->array + ((size_t)sector * devp->descriptor.sectors_size);
+  for (i = 0U; i < devp->descriptor.sectors_size; i++) {
+    if (p[i] != 0xFFU) {
+      return FLASH_ERROR_VERIFY;
+    }
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Returns the simulated flash statistics.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @return              Pointer to the statistics structure.
+ *
+ * @api
+ */
+const efl_sim_stats_t *eflSimGetStats(EFlashDriver *eflp) {
+
+  osalDbgCheck(eflp != NULL);
+
+  return &eflp->stats;
+}
+
+/**
+ * @brief   Clears the simulated flash statistics.
+ * @note    The sectors erase counters are not cleared.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @api
+ */
+void eflSimResetStats(EFlashDriver *eflp) {
+
+  osalDbgCheck(eflp != NULL);
+
+  memset(&eflp->stats, 0, sizeof (efl_sim_stats_t));
+}
+
+/**
+ * @brief   Returns the number of erase operations of a sector.
+ * @note    Counters are kept since the driver activation.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @param[in] sector    sector number
+ * @return              The number of erase operations.
+ *
+ * @api
+ */
+uint32_t eflSimGetEraseCount(EFlashDriver *eflp, flash_sector_t sector) {
+
+  osalDbgCheck((eflp != NULL) && (eflp->wear != NULL) &&
+               (sector < eflp->descriptor.sectors_count));
+
+  return eflp->wear[sector];
+}
+
+#endif /* HAL_USE_EFL == TRUE */
+
+/** @} */
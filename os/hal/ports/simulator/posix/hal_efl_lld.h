@@ -0,0 +1,181 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_efl_lld.h
+ * @brief   Posix simulator embedded flash driver header.
+ * @details The flash array is a memory area mapped on a host file or on
+ *          anonymous memory. Program operations can only clear bits like
+ *          in NOR devices, the read, program and erase times are simulated
+ *          and the erase operations are counted for each sector.
+ *
+ * @addtogroup HAL_EFL
+ * @{
+ */
+
+#ifndef HAL_EFL_LLD_H
+#define HAL_EFL_LLD_H
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Simulator EFL driver configuration options
+ * @note    The options specify the geometry used when @p eflStart() is
+ *          invoked with a @p NULL configuration.
+ * @{
+ */
+/**
+ * @brief   Default number of sectors.
+ */
+#if !defined(SIM_EFL_SECTORS_COUNT) || defined(__DOXYGEN__)
+#define SIM_EFL_SECTORS_COUNT               64
+#endif
+
+/**
+ * @brief   Default sectors size.
+ */
+#if !defined(SIM_EFL_SECTORS_SIZE) || defined(__DOXYGEN__)
+#define SIM_EFL_SECTORS_SIZE                4096
+#endif
+
+/**
+ * @brief   Default program page size.
+ */
+#if !defined(SIM_EFL_PAGE_SIZE) || defined(__DOXYGEN__)
+#define SIM_EFL_PAGE_SIZE                   8
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated flash statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of read operations.
+   */
+  uint32_t                  n_reads;
+  /**
+   * @brief   Number of bytes read.
+   */
+  uint32_t                  read_bytes;
+  /**
+   * @brief   Number of program operations.
+   */
+  uint32_t                  n_programs;
+  /**
+   * @brief   Number of bytes programmed.
+   */
+  uint32_t                  programmed_bytes;
+  /**
+   * @brief   Number of erased sectors.
+   */
+  uint32_t                  n_erases;
+  /**
+   * @brief   Simulated device busy time in microseconds.
+   */
+  uint64_t                  busy_time;
+} efl_sim_stats_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the embedded flash driver structure.
+ */
+#define efl_lld_driver_fields                                               \
+  /* Device descriptor, built from the configuration.*/                     \
+  flash_descriptor_t        descriptor;                                     \
+  /* Flash array.*/                                                         \
+  uint8_t                   *array;                                         \
+  /* Erase operations counters, one for each sector.*/                      \
+  uint32_t                  *wear;                                          \
+  /* Host time of the end of the current erase operation.*/                 \
+  uint64_t                  erase_end;                                      \
+  /* Operations statistics.*/                                               \
+  efl_sim_stats_t           stats
+
+/**
+ * @brief   Low level fields of the embedded flash configuration structure.
+ */
+#define efl_lld_config_fields                                               \
+  /* Host file backing the flash array, NULL for anonymous memory.*/        \
+  const char                *path;                                          \
+  /* Number of sectors.*/                                                   \
+  flash_sector_t            sectors_count;                                  \
+  /* Size of sectors.*/                                                     \
+  uint32_t                  sectors_size;                                   \
+  /* Size of program pages.*/                                               \
+  uint32_t                  page_size;                                      \
+  /* Read time for each touched page, microseconds.*/                       \
+  uint32_t                  read_time;                                      \
+  /* Program time for each touched page, microseconds.*/                    \
+  uint32_t                  program_time;                                   \
+  /* Erase time for each sector, microseconds.*/                            \
+  uint32_t                  erase_time
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern EFlashDriver EFLD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void efl_lld_init(void);
+  void efl_lld_start(EFlashDriver *eflp);
+  void efl_lld_stop(EFlashDriver *eflp);
+  const flash_descriptor_t *efl_lld_get_descriptor(void *instance);
+  flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                             size_t n, uint8_t *rp);
+  flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                                size_t n, const uint8_t *pp);
+  flash_error_t efl_lld_start_erase_all(void *instance);
+  flash_error_t efl_lld_start_erase_sector(void *instance,
+                                           flash_sector_t sector);
+  flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec);
+  flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector);
+  const efl_sim_stats_t *eflSimGetStats(EFlashDriver *eflp);
+  void eflSimResetStats(EFlashDriver *eflp);
+  uint32_t eflSimGetEraseCount(EFlashDriver *eflp, flash_sector_t sector);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_EFL == TRUE */
+
+#endif /* HAL_EFL_LLD_H */
+
+/** @} */
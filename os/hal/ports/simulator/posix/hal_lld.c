@@ -24,10 +24,19 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 
 #include "hal.h"
 
+#if SIM_USE_EPOLL == TRUE
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -36,13 +45,128 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC) && (SIM_USE_EPOLL == FALSE)
 static struct timeval nextcnt;
 static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
+#endif
+
+#if SIM_USE_EPOLL == TRUE
+static int epoll_fd = -1;
+static int timer_fd = -1;
+#endif
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   System timer interrupt simulation.
+ */
+static void timer_interrupt(void) {
+
+  CH_IRQ_PROLOGUE();
+
+  chSysLockFromISR();
+  chSysTimerHandlerI();
+  chSysUnlockFromISR();
+
+  CH_IRQ_EPILOGUE();
+}
+
+/**
+ * @brief   Serves the active interrupt sources.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt occurred.
+ * @retval true         if an interrupt occurred.
+ */
+static bool serve_interrupts(void) {
+  bool int_occurred = false;
+
+#if HAL_USE_SERIAL
+  if (sd_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_WSPI
+  if (wspi_lld_serve_interrupt(&WSPID1)) {
+    int_occurred = true;
+  }
+#endif
+
+#if SIM_USE_EPOLL == TRUE
+  {
+    uint64_t n;
+
+    /* Reading the expirations count also clears the descriptor.*/
+    if (read(timer_fd, &n, sizeof (n)) != (ssize_t)sizeof (n)) {
+      n = 0U;
+    }
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+    while (n > 0U) {
+      int_occurred = true;
+      timer_interrupt();
+      n--;
+    }
+#endif
+  }
+#endif
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  if (st_lld_alarm_triggered()) {
+    int_occurred = true;
+    timer_interrupt();
+  }
+#elif SIM_USE_EPOLL == FALSE
+  {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    if (timercmp(&tv, &nextcnt, >=)) {
+      int_occurred = true;
+      timeradd(&nextcnt, &tick, &nextcnt);
+      timer_interrupt();
+    }
+  }
+#endif
+
+  return int_occurred;
+}
+
+/**
+ * @brief   Rescheduling after interrupts.
+ */
+static void do_preemption(void) {
+
+  __dbg_check_lock();
+  if (chSchIsPreemptionRequired())
+    chSchDoPreemption();
+  __dbg_check_unlock();
+}
+
+#if (SIM_USE_EPOLL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sleeps until an interrupt source becomes active.
+ */
+static void wait_events(void) {
+  struct epoll_event events[4];
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  struct itimerspec its = {{0, 0}, {0, 0}};
+  uint64_t ns;
+
+  /* The timer is programmed on the next alarm or disarmed.*/
+  if (st_lld_get_deadline(&ns)) {
+    its.it_value.tv_sec  = (time_t)(ns / 1000000000ULL);
+    its.it_value.tv_nsec = (long)(ns % 1000000000ULL);
+  }
+  (void) timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+#endif
+
+  (void) epoll_wait(epoll_fd, events, 4, -1);
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -61,42 +185,187 @@ void hal_lld_init(void) {
 #else
   puts("ChibiOS/RT simulator (Linux)\n");
 #endif
+
+#if SIM_USE_EPOLL == TRUE
+  epoll_fd = epoll_create1(0);
+  timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+  if ((epoll_fd == -1) || (timer_fd == -1)) {
+    puts("Unable to create the simulator event descriptors");
+    exit(1);
+  }
+  _sim_register_fd(timer_fd);
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  {
+    struct itimerspec its;
+
+    its.it_interval.tv_sec  = 0;
+    its.it_interval.tv_nsec = 1000000000L / OSAL_ST_FREQUENCY;
+    its.it_value            = its.it_interval;
+    (void) timerfd_settime(timer_fd, 0, &its, NULL);
+  }
+#endif
+#elif OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
   gettimeofday(&nextcnt, NULL);
   timeradd(&nextcnt, &tick, &nextcnt);
+#endif
 }
 
+#if (SIM_USE_EPOLL == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Interrupt simulation.
+ * @brief   Registers a descriptor as interrupt source.
+ * @details Input and output readiness of the descriptor wakes up the
+ *          simulator from @p _sim_wait_for_interrupts(). Descriptors are
+ *          automatically unregistered when closed.
+ * @note    Events are edge-triggered, the interrupt handlers must serve the
+ *          descriptor until @p EWOULDBLOCK.
+ *
+ * @param[in] fd        the descriptor
  */
-void _sim_check_for_interrupts(void) {
-  struct timeval tv;
-  bool int_occurred = false;
+void _sim_register_fd(int fd) {
+  struct epoll_event ev;
 
-#if HAL_USE_SERIAL
-  if (sd_lld_interrupt_pending()) {
-    int_occurred = true;
+  ev.events  = EPOLLIN | EPOLLOUT | EPOLLET;
+  ev.data.fd = fd;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+    puts("Unable to register a simulator event descriptor");
+    exit(1);
   }
+}
 #endif
 
-  gettimeofday(&tv, NULL);
-  if (timercmp(&tv, &nextcnt, >=)) {
-    int_occurred = true;
-    timeradd(&nextcnt, &tick, &nextcnt);
+/**
+ * @brief   Returns the host monotonic time.
+ *
+ * @return              The time in microseconds.
+ */
+uint64_t _sim_get_time_us(void) {
+  struct timespec ts;
 
-    CH_IRQ_PROLOGUE();
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
 
-    chSysLockFromISR();
-    chSysTimerHandlerI();
-    chSysUnlockFromISR();
+  return ((uint64_t)ts.tv_sec * 1000000ULL) + ((uint64_t)ts.tv_nsec / 1000U);
+}
+
+/**
+ * @brief   Spins for the specified time.
+ * @note    The whole simulated system is stalled, this is meant for
+ *          simulating synchronous peripheral operations.
+ *
+ * @param[in] us        the time in microseconds
+ */
+void _sim_delay_us(uint32_t us) {
+  uint64_t deadline;
+
+  if (us > 0U) {
+    deadline = _sim_get_time_us() + us;
+    while (_sim_get_time_us() < deadline) {
+    }
+  }
+}
+
+/**
+ * @brief   Maps a memory area for a simulated storage device.
+ * @details If a path is specified then the area is backed by that host
+ *          file, the file is created if missing. A file with a different
+ *          size is resized and its content is lost.
+ *
+ * @param[in] path      host file path or @p NULL for anonymous memory
+ * @param[in] size      size of the area
+ * @param[in] fill      value of the bytes of a new area
+ * @return              Pointer to the mapped area.
+ */
+uint8_t *_sim_storage_map(const char *path, size_t size, uint8_t fill) {
+  void *p;
+
+  if (path == NULL) {
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      puts("Unable to map the simulated storage");
+      exit(1);
+    }
+    memset(p, fill, size);
+  }
+  else {
+    struct stat st;
+    int fd;
 
-    CH_IRQ_EPILOGUE();
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if ((fd == -1) || (fstat(fd, &st) != 0)) {
+      printf("Unable to open the simulated storage file %s\n", path);
+      exit(1);
+    }
+    if ((size_t)st.st_size != size) {
+      if (ftruncate(fd, (off_t)size) != 0) {
+        printf("Unable to resize the simulated storage file %s\n", path);
+        exit(1);
+      }
+    }
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void) close(fd);
+    if (p == MAP_FAILED) {
+      printf("Unable to map the simulated storage file %s\n", path);
+      exit(1);
+    }
+    if ((size_t)st.st_size != size) {
+      memset(p, fill, size);
+    }
   }
 
+  return (uint8_t *)p;
+}
+
+/**
+ * @brief   Writes a simulated storage area back to its host file.
+ *
+ * @param[in] p         pointer to the mapped area
+ * @param[in] size      size of the area
+ */
+void _sim_storage_sync(uint8_t *p, size_t size) {
+
+  (void) msync((void *)p, size, MS_SYNC);
+}
+
+/**
+ * @brief   Unmaps a simulated storage area.
+ *
+ * @param[in] p         pointer to the mapped area
+ * @param[in] size      size of the area
+ */
+void _sim_storage_unmap(uint8_t *p, size_t size) {
+
+  (void) munmap((void *)p, size);
+}
+
+/**
+ * @brief   Interrupt simulation.
+ */
+void _sim_check_for_interrupts(void) {
+
+  if (serve_interrupts()) {
+    do_preemption();
+  }
+}
+
+/**
+ * @brief   Waits for interrupts.
+ * @details Serves the active interrupt sources, if there are none then the
+ *          host thread sleeps until a source becomes active if
+ *          @p SIM_USE_EPOLL is enabled.
+ */
+void _sim_wait_for_interrupts(void) {
+  bool int_occurred = serve_interrupts();
+
+#if SIM_USE_EPOLL == TRUE
+  if (!int_occurred) {
+    wait_events();
+    int_occurred = serve_interrupts();
+  }
+#endif
+
   if (int_occurred) {
-    __dbg_check_lock();
-    if (chSchIsPreemptionRequired())
-      chSchDoPreemption();
-    __dbg_check_unlock();
+    do_preemption();
   }
 }
 
@@ -53,10 +53,27 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Event-driven interrupts simulation.
+ * @details If enabled the idle thread sleeps in @p epoll_wait() on a timer
+ *          descriptor and on the serial sockets instead of polling the host
+ *          time, the host CPU is not used while the simulated system is
+ *          idle. In tick-less mode the timer is programmed one-shot on the
+ *          next system timer alarm.
+ * @note    Linux only.
+ */
+#if !defined(SIM_USE_EPOLL) || defined(__DOXYGEN__)
+#define SIM_USE_EPOLL                       FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SIM_USE_EPOLL == TRUE) && !defined(__linux__)
+#error "SIM_USE_EPOLL requires a Linux host"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -70,6 +87,15 @@ extern "C" {
 #endif
   void hal_lld_init(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
+#if SIM_USE_EPOLL == TRUE
+  void _sim_register_fd(int fd);
+#endif
+  uint64_t _sim_get_time_us(void);
+  void _sim_delay_us(uint32_t us);
+  uint8_t *_sim_storage_map(const char *path, size_t size, uint8_t fill);
+  void _sim_storage_sync(uint8_t *p, size_t size);
+  void _sim_storage_unmap(uint8_t *p, size_t size);
 #ifdef __cplusplus
 }
 #endif
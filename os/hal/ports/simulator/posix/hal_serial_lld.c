@@ -100,6 +100,9 @@ static void init(SerialDriver *sdp, uint16_t port) {
     printf("%s: Error listening socket\n", sdp->com_name);
     goto abort;
   }
+#if SIM_USE_EPOLL == TRUE
+  _sim_register_fd(sdp->com_listen);
+#endif
   printf("Full Duplex Channel %s listening on port %d\n", sdp->com_name, port);
   return;
 
@@ -130,6 +133,10 @@ static bool connint(SerialDriver *sdp) {
       goto abort;
     }
 
+#if SIM_USE_EPOLL == TRUE
+    _sim_register_fd(sdp->com_data);
+#endif
+
     osalSysLockFromISR();
     chnAddFlagsI(sdp, CHN_CONNECTED);
     osalSysUnlockFromISR();
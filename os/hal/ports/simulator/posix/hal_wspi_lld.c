@@ -0,0 +1,865 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_wspi_lld.c
+ * @brief   Posix simulator WSPI driver code.
+ *
+ * @addtogroup WSPI
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_WSPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Simulated device command codes
+ * @{
+ */
+#define SIM_CMD_READ                        0x03U
+#define SIM_CMD_FAST_READ                   0x0BU
+#define SIM_CMD_READ4B                      0x13U
+#define SIM_CMD_FAST_READ4B                 0x0CU
+#define SIM_CMD_DREAD                       0x3BU
+#define SIM_CMD_DREAD4B                     0x3CU
+#define SIM_CMD_2READ                       0xBBU
+#define SIM_CMD_2READ4B                     0xBCU
+#define SIM_CMD_QREAD                       0x6BU
+#define SIM_CMD_QREAD4B                     0x6CU
+#define SIM_CMD_4READ                       0xEBU
+#define SIM_CMD_4READ4B                     0xECU
+#define SIM_CMD_8READ                       0xECU
+#define SIM_CMD_8DTRD                       0xEEU
+#define SIM_CMD_RDSFDP                      0x5AU
+#define SIM_CMD_PP                          0x02U
+#define SIM_CMD_PP4B                        0x12U
+#define SIM_CMD_SE                          0x20U
+#define SIM_CMD_SE4B                        0x21U
+#define SIM_CMD_BE                          0xD8U
+#define SIM_CMD_BE4B                        0xDCU
+#define SIM_CMD_CE                          0xC7U
+#define SIM_CMD_CE2                         0x60U
+#define SIM_CMD_WREN                        0x06U
+#define SIM_CMD_WRDI                        0x04U
+#define SIM_CMD_SUSPEND                     0xB0U
+#define SIM_CMD_RESUME                      0x30U
+#define SIM_CMD_RST                         0x99U
+#define SIM_CMD_RDID                        0x9FU
+#define SIM_CMD_RDSR                        0x05U
+#define SIM_CMD_WRSR                        0x01U
+#define SIM_CMD_RDSCUR                      0x2BU
+#define SIM_CMD_WRCR2                       0x72U
+#define SIM_CMD_EN4B                        0xB7U
+#define SIM_CMD_EX4B                        0xE9U
+#define SIM_CMD_EQIO                        0x35U
+#define SIM_CMD_RSTQIO                      0xF5U
+/** @} */
+
+/**
+ * @name    Simulated device registers bits
+ * @{
+ */
+#define SIM_SR_WIP                          0x01U
+#define SIM_SR_WEL                          0x02U
+#define SIM_SR_QE                           0x40U
+#define SIM_SCUR_ESB                        0x08U
+/** @} */
+
+/**
+ * @name    Simulated device bus modes
+ * @{
+ */
+#define SIM_MODE_SPI                        0U
+#define SIM_MODE_QPI                        1U
+#define SIM_MODE_OPI_STR                    2U
+#define SIM_MODE_OPI_DTR                    3U
+/** @} */
+
+#define SIM_MANUFACTURER_ID                 0xC2U
+#define SIM_MEMORY_TYPE_ID                  0x85U
+#define SIM_PAGE_SIZE                       256U
+#define SIM_SECTOR_SIZE                     0x00001000U
+#define SIM_BLOCK_SIZE                      0x00010000U
+#define SIM_SFDP_DUMMY                      8U
+#define SIM_OPI_SFDP_DUMMY                  20U
+#define SIM_OPI_REG_DUMMY                   4U
+
+/* Bus lines of a transfer phase from its mode field, zero if absent.*/
+#define SIM_LINES(mode)                     ((mode) == 0U ? 0U :            \
+                                             1U << ((mode) - 1U))
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   WSPID1 driver identifier.
+ */
+WSPIDriver WSPID1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Updates the device state at the specified time.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] now       current host time
+ *
+ * @notapi
+ */
+static void wspi_sim_update(WSPIDriver *wspip, uint64_t now) {
+
+  if (((wspip->sr & SIM_SR_WIP) != 0U) && (now >= wspip->busy_end)) {
+    /* The operation or the suspension is complete.*/
+    wspip->sr &= ~(SIM_SR_WIP | SIM_SR_WEL);
+    if ((wspip->scur & SIM_SCUR_ESB) == 0U) {
+      wspip->erasing = false;
+    }
+  }
+}
+
+/**
+ * @brief   Returns the value of a status register.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmd       status register read command
+ * @return              The register value, 0xFF for unknown commands.
+ *
+ * @notapi
+ */
+static uint8_t wspi_sim_status(WSPIDriver *wspip, uint32_t cmd) {
+
+  if (cmd == SIM_CMD_RDSR) {
+    return wspip->sr;
+  }
+  if (cmd == SIM_CMD_RDSCUR) {
+    return wspip->scur;
+  }
+  return 0xFFU;
+}
+
+/**
+ * @brief   Starts an erase operation.
+ * @details The array content is updated immediately, the device is then
+ *          busy until the simulated erase time has elapsed.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] addr      address inside the area to be erased
+ * @param[in] size      size of the area to be erased
+ * @param[in] time      erase time
+ * @param[in] now       current host time
+ *
+ * @notapi
+ */
+static void wspi_sim_erase(WSPIDriver *wspip, uint32_t addr, uint32_t size,
+                           uint32_t time, uint64_t now) {
+
+  addr &= ~(size - 1U);
+  memset(wspip->array + addr, 0xFF, (size_t)size);
+  wspip->sr       |= SIM_SR_WIP;
+  wspip->busy_end  = now + time;
+  wspip->erasing   = true;
+  wspip->stats.n_erases++;
+}
+
+/**
+ * @brief   Bus cycles of a transfer phase.
+ *
+ * @param[in] bits      number of bits in the phase
+ * @param[in] mode      phase mode field
+ * @param[in] dtr       double transfer rate phase
+ * @return              The number of bus cycles.
+ *
+ * @notapi
+ */
+static uint32_t wspi_sim_cycles(uint32_t bits, uint32_t mode, bool dtr) {
+  uint32_t lines = SIM_LINES(mode) * (dtr ? 2U : 1U);
+
+  if (lines == 0U) {
+    return 0U;
+  }
+  return (bits + lines - 1U) / lines;
+}
+
+/**
+ * @brief   Decodes the instruction phase of a command.
+ * @details The instruction must use the bus width of the current device
+ *          mode, in OPI modes instructions are 16 bits wide and the second
+ *          byte is the complement of the first.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[out] opp      the decoded operation code
+ * @return              The decoding result.
+ * @retval false        if the command is not accepted by the device.
+ * @retval true         if the command has been decoded.
+ *
+ * @notapi
+ */
+static bool wspi_sim_decode(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                            uint8_t *opp) {
+  uint32_t cfg = cmdp->cfg;
+
+  switch (wspip->mode) {
+  case SIM_MODE_SPI:
+  case SIM_MODE_QPI:
+    if (((cfg & WSPI_CFG_CMD_MODE_MASK) !=
+         (wspip->mode == SIM_MODE_SPI ? WSPI_CFG_CMD_MODE_ONE_LINE :
+                                        WSPI_CFG_CMD_MODE_FOUR_LINES)) ||
+        ((cfg & WSPI_CFG_CMD_SIZE_MASK) != WSPI_CFG_CMD_SIZE_8) ||
+        ((cfg & WSPI_CFG_CMD_DTR) != 0U)) {
+      return false;
+    }
+    *opp = (uint8_t)cmdp->cmd;
+    return true;
+  default:
+    if (((cfg & WSPI_CFG_CMD_MODE_MASK) != WSPI_CFG_CMD_MODE_EIGHT_LINES) ||
+        ((cfg & WSPI_CFG_CMD_SIZE_MASK) != WSPI_CFG_CMD_SIZE_16) ||
+        (((cfg & WSPI_CFG_CMD_DTR) != 0U) !=
+         (wspip->mode == SIM_MODE_OPI_DTR)) ||
+        (((cmdp->cmd >> 8) & 0xFFU) != (~cmdp->cmd & 0xFFU))) {
+      return false;
+    }
+    *opp = (uint8_t)(cmdp->cmd >> 8);
+    return true;
+  }
+}
+
+/**
+ * @brief   Checks the address, dummy and data phases of a command.
+ * @note    Data phases are optional, when present their width must match.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] alines    expected address lines, zero if no address
+ * @param[in] abytes    expected address size in bytes
+ * @param[in] dummy     expected dummy cycles
+ * @param[in] dlines    expected data lines
+ * @return              The check result.
+ * @retval false        if the phases do not match the command.
+ * @retval true         if the phases match the command.
+ *
+ * @notapi
+ */
+static bool wspi_sim_check(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                           uint32_t alines, uint32_t abytes,
+                           uint32_t dummy, uint32_t dlines) {
+  uint32_t cfg = cmdp->cfg;
+  uint32_t amode = (cfg & WSPI_CFG_ADDR_MODE_MASK) >> 8U;
+  uint32_t dmode = (cfg & WSPI_CFG_DATA_MODE_MASK) >> 24U;
+  bool dtr = wspip->mode == SIM_MODE_OPI_DTR;
+
+  if ((SIM_LINES(amode) != alines) || (cmdp->dummy != dummy)) {
+    return false;
+  }
+  if ((alines != 0U) &&
+      ((((cfg & WSPI_CFG_ADDR_SIZE_MASK) >> 12U) + 1U != abytes) ||
+       (((cfg & WSPI_CFG_ADDR_DTR) != 0U) != dtr))) {
+    return false;
+  }
+  if ((dmode != 0U) &&
+      ((SIM_LINES(dmode) != dlines) ||
+       (((cfg & WSPI_CFG_DATA_DTR) != 0U) != dtr))) {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief   Returns the bus width of a read command.
+ * @details Read commands have their own address and data widths in SPI
+ *          mode, in QPI and OPI modes all phases use all lines.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] op        operation code
+ * @param[out] alinesp  address lines
+ * @param[out] dlinesp  data lines
+ * @param[out] dummyp   dummy cycles
+ * @return              The read command identification.
+ * @retval false        if the operation is not a read for the current mode.
+ * @retval true         if the operation is a read.
+ *
+ * @notapi
+ */
+static bool wspi_sim_read_mode(WSPIDriver *wspip, uint8_t op,
+                               uint32_t *alinesp, uint32_t *dlinesp,
+                               uint32_t *dummyp) {
+
+  if (wspip->mode == SIM_MODE_QPI) {
+    *alinesp = 4U;
+    *dlinesp = 4U;
+    *dummyp  = 6U;
+    return (op == SIM_CMD_4READ) || (op == SIM_CMD_4READ4B);
+  }
+  if (wspip->mode != SIM_MODE_SPI) {
+    *alinesp = 8U;
+    *dlinesp = 8U;
+    *dummyp  = wspip->opi_dummy;
+    return op == (wspip->mode == SIM_MODE_OPI_DTR ? SIM_CMD_8DTRD :
+                                                    SIM_CMD_8READ);
+  }
+
+  switch (op) {
+  case SIM_CMD_READ:
+  case SIM_CMD_READ4B:
+    *alinesp = 1U; *dlinesp = 1U; *dummyp = 0U;
+    return true;
+  case SIM_CMD_FAST_READ:
+  case SIM_CMD_FAST_READ4B:
+    *alinesp = 1U; *dlinesp = 1U; *dummyp = 8U;
+    return true;
+  case SIM_CMD_DREAD:
+  case SIM_CMD_DREAD4B:
+    *alinesp = 1U; *dlinesp = 2U; *dummyp = 8U;
+    return true;
+  case SIM_CMD_2READ:
+  case SIM_CMD_2READ4B:
+    *alinesp = 2U; *dlinesp = 2U; *dummyp = 4U;
+    return true;
+  case SIM_CMD_QREAD:
+  case SIM_CMD_QREAD4B:
+    *alinesp = 1U; *dlinesp = 4U; *dummyp = 8U;
+    return (wspip->sr & SIM_SR_QE) != 0U;
+  case SIM_CMD_4READ:
+  case SIM_CMD_4READ4B:
+    *alinesp = 4U; *dlinesp = 4U; *dummyp = 6U;
+    return (wspip->sr & SIM_SR_QE) != 0U;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief   Executes a command on the simulated device.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes in the data phase
+ * @param[in] txbuf     the pointer to the transmit buffer or @p NULL
+ * @param[out] rxbuf    the pointer to the receive buffer or @p NULL
+ *
+ * @notapi
+ */
+static void wspi_sim_execute(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                             size_t n, const uint8_t *txbuf, uint8_t *rxbuf) {
+  const WSPIConfig *cfg = wspip->config;
+  uint32_t addr, cycles, lines, abytes, alines, dlines, dummy;
+  bool opi, writable;
+  uint64_t now;
+  uint8_t op;
+  size_t i;
+
+  /* Bus time of the whole transfer, each phase is transferred on its own
+     number of lines.*/
+  cycles = wspi_sim_cycles((((cmdp->cfg & WSPI_CFG_CMD_SIZE_MASK) >> 4U) +
+                            1U) * 8U,
+                           cmdp->cfg & WSPI_CFG_CMD_MODE_MASK,
+                           (cmdp->cfg & WSPI_CFG_CMD_DTR) != 0U) +
+           wspi_sim_cycles((((cmdp->cfg & WSPI_CFG_ADDR_SIZE_MASK) >> 12U) +
+                            1U) * 8U,
+                           (cmdp->cfg & WSPI_CFG_ADDR_MODE_MASK) >> 8U,
+                           (cmdp->cfg & WSPI_CFG_ADDR_DTR) != 0U) +
+           (uint32_t)cmdp->dummy +
+           wspi_sim_cycles((uint32_t)n * 8U,
+                           (cmdp->cfg & WSPI_CFG_DATA_MODE_MASK) >> 24U,
+                           (cmdp->cfg & WSPI_CFG_DATA_DTR) != 0U);
+  _sim_delay_us(((cycles * cfg->byte_time) / 8U + 999U) / 1000U);
+  wspip->stats.n_commands++;
+  wspip->stats.xfer_bytes += (uint32_t)n;
+
+  /* Received data when there is no answer from the device.*/
+  if (rxbuf != NULL) {
+    memset(rxbuf, 0xFF, n);
+  }
+
+  /* Commands not matching the current bus mode are ignored like a real
+     device would do.*/
+  if (!wspi_sim_decode(wspip, cmdp, &op)) {
+    return;
+  }
+
+  now = _sim_get_time_us();
+  wspi_sim_update(wspip, now);
+  addr = cmdp->addr & (SIM_WSPI_FLASH_SIZE - 1U);
+  opi  = wspip->mode >= SIM_MODE_OPI_STR;
+
+  /* Width of all phases of non-read commands and address size of the
+     command, 4 bytes addresses are used by 4 bytes commands, in OPI modes
+     and after EN4B.*/
+  lines  = opi ? 8U : (wspip->mode == SIM_MODE_QPI ? 4U : 1U);
+  abytes = (opi || wspip->addr4) ? 4U : 3U;
+  switch (op) {
+  case SIM_CMD_READ4B:
+  case SIM_CMD_FAST_READ4B:
+  case SIM_CMD_DREAD4B:
+  case SIM_CMD_2READ4B:
+  case SIM_CMD_QREAD4B:
+  case SIM_CMD_4READ4B:
+  case SIM_CMD_PP4B:
+  case SIM_CMD_SE4B:
+  case SIM_CMD_BE4B:
+    abytes = 4U;
+    break;
+  default:
+    break;
+  }
+
+  /* Array modifications require WEL and no operation in progress or
+     suspended.*/
+  writable = ((wspip->sr & (SIM_SR_WIP | SIM_SR_WEL)) == SIM_SR_WEL) &&
+             ((wspip->scur & SIM_SCUR_ESB) == 0U);
+
+  /* Read commands.*/
+  if (wspi_sim_read_mode(wspip, op, &alines, &dlines, &dummy)) {
+    /* The array is not accessible while busy.*/
+    if (wspi_sim_check(wspip, cmdp, alines, abytes, dummy, dlines) &&
+        (rxbuf != NULL) && ((wspip->sr & SIM_SR_WIP) == 0U)) {
+      for (i = 0U; i < n; i++) {
+        rxbuf[i] = wspip->array[(addr + i) & (SIM_WSPI_FLASH_SIZE - 1U)];
+      }
+    }
+    return;
+  }
+
+  switch (op) {
+  case SIM_CMD_RDID:
+    if ((rxbuf != NULL) &&
+        wspi_sim_check(wspip, cmdp, opi ? 8U : 0U, 4U,
+                       opi ? SIM_OPI_REG_DUMMY : 0U, lines)) {
+      uint8_t id[6] = {SIM_MANUFACTURER_ID, SIM_MEMORY_TYPE_ID,
+                       (uint8_t)__builtin_ctz(SIM_WSPI_FLASH_SIZE)};
+
+      /* In DTR mode each ID byte is output twice.*/
+      if (wspip->mode == SIM_MODE_OPI_DTR) {
+        id[4] = id[2];
+        id[5] = id[2];
+        id[2] = id[1];
+        id[3] = id[1];
+        id[1] = id[0];
+      }
+      memcpy(rxbuf, id, n < sizeof id ? n : sizeof id);
+    }
+    break;
+  case SIM_CMD_RDSR:
+  case SIM_CMD_RDSCUR:
+    if ((rxbuf != NULL) &&
+        wspi_sim_check(wspip, cmdp, opi ? 8U : 0U, 4U,
+                       opi ? SIM_OPI_REG_DUMMY : 0U, lines)) {
+      memset(rxbuf, wspi_sim_status(wspip, op), n);
+    }
+    break;
+  case SIM_CMD_RDSFDP:
+    /* SFDP uses 3 bytes addresses and 8 dummy cycles outside OPI modes,
+       areas not covered by the SFDP image are read as erased.*/
+    if ((rxbuf != NULL) &&
+        wspi_sim_check(wspip, cmdp, lines, opi ? 4U : 3U,
+                       opi ? SIM_OPI_SFDP_DUMMY : SIM_SFDP_DUMMY, lines)) {
+      for (i = 0U; i < n; i++) {
+        if ((cfg->sfdp != NULL) && (cmdp->addr + i < cfg->sfdp_size)) {
+          rxbuf[i] = cfg->sfdp[cmdp->addr + i];
+        }
+        else {
+          rxbuf[i] = 0xFFU;
+        }
+      }
+    }
+    break;
+  case SIM_CMD_WREN:
+    if ((wspip->sr & SIM_SR_WIP) == 0U) {
+      wspip->sr |= SIM_SR_WEL;
+    }
+    break;
+  case SIM_CMD_WRDI:
+    wspip->sr &= ~SIM_SR_WEL;
+    break;
+  case SIM_CMD_WRSR:
+    /* Only the QE bit is simulated.*/
+    if ((txbuf != NULL) && (n >= 1U) && writable && !opi &&
+        wspi_sim_check(wspip, cmdp, 0U, 0U, 0U, lines)) {
+      wspip->sr = (wspip->sr & ~(SIM_SR_QE | SIM_SR_WEL)) |
+                  (txbuf[0] & SIM_SR_QE);
+    }
+    break;
+  case SIM_CMD_WRCR2:
+    /* The address can also be sent as part of the data phase, the bus
+       signals are the same. Only the bus mode and the OPI dummy cycles
+       registers are simulated.*/
+    if ((txbuf != NULL) && writable) {
+      uint32_t reg;
+      uint8_t value;
+
+      if (((cmdp->cfg & WSPI_CFG_ADDR_MODE_MASK) ==
+           WSPI_CFG_ADDR_MODE_NONE) && !opi && (n == 5U) &&
+          wspi_sim_check(wspip, cmdp, 0U, 0U, 0U, lines)) {
+        reg   = ((uint32_t)txbuf[0] << 24) | ((uint32_t)txbuf[1] << 16) |
+                ((uint32_t)txbuf[2] << 8) | (uint32_t)txbuf[3];
+        value = txbuf[4];
+      }
+      else if ((n >= 1U) && wspi_sim_check(wspip, cmdp, lines, 4U,
+                                             0U, lines)) {
+        reg   = cmdp->addr;
+        value = txbuf[0];
+      }
+      else {
+        break;
+      }
+      wspip->sr &= ~SIM_SR_WEL;
+      if (reg == 0x00000000U) {
+        wspip->mode = value == 2U ? SIM_MODE_OPI_DTR :
+                      value == 1U ? SIM_MODE_OPI_STR : SIM_MODE_SPI;
+      }
+      else if (reg == 0x00000300U) {
+        wspip->opi_dummy = 20U - (2U * (value & 7U));
+      }
+    }
+    break;
+  case SIM_CMD_PP:
+  case SIM_CMD_PP4B:
+    if ((txbuf != NULL) && writable &&
+        wspi_sim_check(wspip, cmdp, lines, abytes, 0U, lines)) {
+      /* Like in real devices, the address wraps inside the page.*/
+      for (i = 0U; i < n; i++) {
+        wspip->array[(addr & ~(SIM_PAGE_SIZE - 1U)) +
+                     ((addr + i) & (SIM_PAGE_SIZE - 1U))] &= txbuf[i];
+      }
+      wspip->sr       |= SIM_SR_WIP;
+      wspip->busy_end  = now + cfg->program_time;
+    }
+    break;
+  case SIM_CMD_SE:
+  case SIM_CMD_SE4B:
+    if (writable && wspi_sim_check(wspip, cmdp, lines, abytes, 0U, 0U)) {
+      wspi_sim_erase(wspip, addr, SIM_SECTOR_SIZE,
+                     cfg->sector_erase_time, now);
+    }
+    break;
+  case SIM_CMD_BE:
+  case SIM_CMD_BE4B:
+    if (writable && wspi_sim_check(wspip, cmdp, lines, abytes, 0U, 0U)) {
+      wspi_sim_erase(wspip, addr, SIM_BLOCK_SIZE,
+                     cfg->block_erase_time, now);
+    }
+    break;
+  case SIM_CMD_CE:
+  case SIM_CMD_CE2:
+    if (writable && wspi_sim_check(wspip, cmdp, 0U, 0U, 0U, 0U)) {
+      wspi_sim_erase(wspip, 0U, SIM_WSPI_FLASH_SIZE,
+                     cfg->block_erase_time *
+                     (SIM_WSPI_FLASH_SIZE / SIM_BLOCK_SIZE), now);
+    }
+    break;
+  case SIM_CMD_SUSPEND:
+    /* Only a running erase can be suspended, the device stays busy for the
+       suspend latency.*/
+    if (((wspip->sr & SIM_SR_WIP) != 0U) && wspip->erasing &&
+        ((wspip->scur & SIM_SCUR_ESB) == 0U)) {
+      wspip->erase_left     = wspip->busy_end - now;
+      wspip->busy_end       = now + cfg->suspend_time;
+      wspip->suspend_start  = now;
+      wspip->scur          |= SIM_SCUR_ESB;
+      wspip->stats.n_suspends++;
+    }
+    break;
+  case SIM_CMD_RESUME:
+    /* The erase restarts, part of the erase time is lost on each
+       resume.*/
+    if (((wspip->sr & SIM_SR_WIP) == 0U) &&
+        ((wspip->scur & SIM_SCUR_ESB) != 0U)) {
+      wspip->scur     &= ~SIM_SCUR_ESB;
+      wspip->sr       |= SIM_SR_WIP;
+      wspip->busy_end  = now + wspip->erase_left + cfg->resume_time;
+      wspip->stats.suspended_time += now - wspip->suspend_start;
+    }
+    break;
+  case SIM_CMD_EN4B:
+    wspip->addr4 = true;
+    break;
+  case SIM_CMD_EX4B:
+    wspip->addr4 = false;
+    break;
+  case SIM_CMD_EQIO:
+    if (wspip->mode == SIM_MODE_SPI) {
+      wspip->mode = SIM_MODE_QPI;
+    }
+    break;
+  case SIM_CMD_RSTQIO:
+    if (wspip->mode == SIM_MODE_QPI) {
+      wspip->mode = SIM_MODE_SPI;
+    }
+    break;
+  case SIM_CMD_RST:
+    /* Volatile state is lost, the QE bit is non volatile.*/
+    wspip->sr       &= SIM_SR_QE;
+    wspip->scur      = 0U;
+    wspip->erasing   = false;
+    wspip->mode      = SIM_MODE_SPI;
+    wspip->addr4     = false;
+    wspip->opi_dummy = SIM_OPI_SFDP_DUMMY;
+    break;
+  default:
+    /* Unknown or not simulated commands are ignored.*/
+    break;
+  }
+}
+
+/**
+ * @brief   Signals the end of a transfer.
+ * @details The completion is served as an interrupt, the caller thread
+ *          is not yet suspended at this point.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+static void wspi_sim_complete(WSPIDriver *wspip) {
+
+  wspip->pending = true;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Serves a pending transfer completion.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @return              The interrupt status.
+ * @retval false        if no interrupt occurred.
+ * @retval true         if an interrupt occurred.
+ *
+ * @notapi
+ */
+bool wspi_lld_serve_interrupt(WSPIDriver *wspip) {
+
+  /* Status polling, the register is read again each time the system is
+     idle, the polling ends when the condition is met.*/
+  if (wspip->polling) {
+    uint8_t sts;
+
+    wspi_sim_update(wspip, _sim_get_time_us());
+    sts = wspi_sim_status(wspip, wspip->poll_cmd);
+    wspip->stats.n_polls++;
+    if ((sts & wspip->poll_mask) == wspip->poll_match) {
+      *wspip->poll_statusp = sts;
+      wspip->polling       = false;
+      wspip->pending       = true;
+    }
+  }
+
+  if (!wspip->pending) {
+    return false;
+  }
+
+  OSAL_IRQ_PROLOGUE();
+
+  wspip->pending = false;
+  _wspi_isr_code(wspip);
+
+  OSAL_IRQ_EPILOGUE();
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level WSPI driver initialization.
+ *
+ * @notapi
+ */
+void wspi_lld_init(void) {
+
+  wspiObjectInit(&WSPID1);
+  WSPID1.array   = NULL;
+  WSPID1.pending = false;
+  WSPID1.polling = false;
+}
+
+/**
+ * @brief   Configures and activates the WSPI peripheral.
+ * @note    The flash array is mapped on the first activation, the host file
+ *          is created if missing.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+void wspi_lld_start(WSPIDriver *wspip) {
+
+  if (wspip->state == WSPI_STOP) {
+    wspip->array = _sim_storage_map(wspip->config->path,
+                                    (size_t)SIM_WSPI_FLASH_SIZE, 0xFFU);
+    wspip->sr        = 0U;
+    wspip->scur      = 0U;
+    wspip->erasing   = false;
+    wspip->busy_end  = 0U;
+    wspip->mode      = SIM_MODE_SPI;
+    wspip->addr4     = false;
+    wspip->opi_dummy = SIM_OPI_SFDP_DUMMY;
+    wspiSimResetStats(wspip);
+  }
+}
+
+/**
+ * @brief   Deactivates the WSPI peripheral.
+ * @note    The flash array is written back to the host file.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @notapi
+ */
+void wspi_lld_stop(WSPIDriver *wspip) {
+
+  if (wspip->state == WSPI_READY) {
+    if (wspip->config->path != NULL) {
+      _sim_storage_sync(wspip->array, (size_t)SIM_WSPI_FLASH_SIZE);
+    }
+    _sim_storage_unmap(wspip->array, (size_t)SIM_WSPI_FLASH_SIZE);
+    wspip->array = NULL;
+  }
+}
+
+/**
+ * @brief   Sends a command without data phase.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ *
+ * @notapi
+ */
+void wspi_lld_command(WSPIDriver *wspip, const wspi_command_t *cmdp) {
+
+  wspi_sim_execute(wspip, cmdp, 0U, NULL, NULL);
+  wspi_sim_complete(wspip);
+}
+
+/**
+ * @brief   Sends a command with data over the WSPI bus.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void wspi_lld_send(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   size_t n, const uint8_t *txbuf) {
+
+  wspi_sim_execute(wspip, cmdp, n, txbuf, NULL);
+  wspi_sim_complete(wspip);
+}
+
+/**
+ * @brief   Sends a command then receives data over the WSPI bus.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] n         number of bytes to send
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                      size_t n, uint8_t *rxbuf) {
+
+  wspi_sim_execute(wspip, cmdp, n, NULL, rxbuf);
+  wspi_sim_complete(wspip);
+}
+
+/**
+ * @brief   Polls a device status register.
+ * @details The first read is a normal bus transfer, if the condition is
+ *          not met then the register is polled in background.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] mask      mask of the status bits to be checked
+ * @param[in] match     expected value of the masked status bits
+ * @param[out] statusp  pointer to the location receiving the last status
+ *                      byte
+ *
+ * @notapi
+ */
+void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   uint8_t mask, uint8_t match, uint8_t *statusp) {
+
+  wspi_sim_execute(wspip, cmdp, 1U, NULL, statusp);
+  if ((*statusp & mask) == match) {
+    wspi_sim_complete(wspip);
+  }
+  else {
+    wspip->poll_cmd     = wspip->mode >= SIM_MODE_OPI_STR ? cmdp->cmd >> 8 :
+                                                        cmdp->cmd;
+    wspip->poll_mask    = mask;
+    wspip->poll_match   = match;
+    wspip->poll_statusp = statusp;
+    wspip->polling      = true;
+  }
+}
+
+/**
+ * @brief   Returns the simulated flash statistics.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @return              Pointer to the statistics structure.
+ *
+ * @api
+ */
+const wspi_sim_stats_t *wspiSimGetStats(WSPIDriver *wspip) {
+
+  osalDbgCheck(wspip != NULL);
+
+  return &wspip->stats;
+}
+
+/**
+ * @brief   Clears the simulated flash statistics.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ *
+ * @api
+ */
+void wspiSimResetStats(WSPIDriver *wspip) {
+
+  osalDbgCheck(wspip != NULL);
+
+  memset(&wspip->stats, 0, sizeof (wspi_sim_stats_t));
+}
+
+#endif /* HAL_USE_WSPI == TRUE */
+
+/** @} */
@@ -0,0 +1,211 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_wspi_lld.h
+ * @brief   Posix simulator WSPI driver header.
+ * @details A simulated serial NOR flash is connected to the WSPI port, the
+ *          device implements a subset of the command set of Macronix
+ *          MX25 devices: SPI mode with dual and quad reads, QPI mode, OPI
+ *          STR and DTR modes, 3 and 4 bytes addressing and SFDP. Commands
+ *          not matching the current bus mode, or with phases not matching
+ *          the command, are ignored like a real device would do.
+ *          The flash array is a memory area mapped on a host file or on
+ *          anonymous memory. Bus transfers, program, erase and erase
+ *          suspend times are simulated, erase operations proceed only while
+ *          not suspended. Status polling is performed by the simulated
+ *          controller while the system is idle.
+ *
+ * @addtogroup WSPI
+ * @{
+ */
+
+#ifndef HAL_WSPI_LLD_H
+#define HAL_WSPI_LLD_H
+
+#if (HAL_USE_WSPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    WSPI implementation capabilities
+ * @{
+ */
+#define WSPI_SUPPORTS_MEMMAP                FALSE
+#define WSPI_DEFAULT_CFG_MASKS              TRUE
+#define WSPI_SUPPORTS_POLLING               TRUE
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Simulator WSPI driver configuration options
+ * @{
+ */
+/**
+ * @brief   Simulated flash size, it must be a power of two.
+ */
+#if !defined(SIM_WSPI_FLASH_SIZE) || defined(__DOXYGEN__)
+#define SIM_WSPI_FLASH_SIZE                 0x00400000U
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_WSPI_FLASH_SIZE < 0x00010000U) ||                                  \
+    ((SIM_WSPI_FLASH_SIZE & (SIM_WSPI_FLASH_SIZE - 1U)) != 0U)
+#error "invalid SIM_WSPI_FLASH_SIZE value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated serial flash statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of commands.
+   */
+  uint32_t                  n_commands;
+  /**
+   * @brief   Number of bytes transferred in data phases.
+   */
+  uint32_t                  xfer_bytes;
+  /**
+   * @brief   Number of erase operations.
+   */
+  uint32_t                  n_erases;
+  /**
+   * @brief   Number of erase suspensions.
+   */
+  uint32_t                  n_suspends;
+  /**
+   * @brief   Total time spent with an erase suspended, microseconds.
+   */
+  uint64_t                  suspended_time;
+  /**
+   * @brief   Number of status reads performed by the controller polling.
+   */
+  uint32_t                  n_polls;
+} wspi_sim_stats_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the WSPI driver structure.
+ */
+#define wspi_lld_driver_fields                                              \
+  /* Flash array.*/                                                         \
+  uint8_t                   *array;                                         \
+  /* Status register.*/                                                     \
+  uint8_t                   sr;                                             \
+  /* Security register.*/                                                   \
+  uint8_t                   scur;                                           \
+  /* Bus mode.*/                                                            \
+  uint8_t                   mode;                                           \
+  /* 4 bytes addressing mode.*/                                             \
+  bool                      addr4;                                          \
+  /* Dummy cycles of OPI read commands.*/                                   \
+  uint32_t                  opi_dummy;                                      \
+  /* Erase in progress or suspended.*/                                      \
+  bool                      erasing;                                        \
+  /* Host time of the end of the current operation or suspension.*/         \
+  uint64_t                  busy_end;                                       \
+  /* Erase time left when the erase has been suspended.*/                   \
+  uint64_t                  erase_left;                                     \
+  /* Host time of the erase suspension.*/                                   \
+  uint64_t                  suspend_start;                                  \
+  /* Transfer completion waiting to be served.*/                            \
+  bool                      pending;                                        \
+  /* Status polling in progress.*/                                          \
+  bool                      polling;                                        \
+  /* Polled status command.*/                                               \
+  uint32_t                  poll_cmd;                                       \
+  /* Polled status bits mask.*/                                             \
+  uint8_t                   poll_mask;                                      \
+  /* Polled status bits expected value.*/                                   \
+  uint8_t                   poll_match;                                     \
+  /* Polled status destination.*/                                           \
+  uint8_t                   *poll_statusp;                                  \
+  /* Operations statistics.*/                                               \
+  wspi_sim_stats_t          stats
+
+/**
+ * @brief   Low level fields of the WSPI configuration structure.
+ */
+#define wspi_lld_config_fields                                              \
+  /* Host file backing the flash array, NULL for anonymous memory.*/        \
+  const char                *path;                                          \
+  /* Bus transfer time of each byte, nanoseconds.*/                         \
+  uint32_t                  byte_time;                                      \
+  /* Page program time, microseconds.*/                                     \
+  uint32_t                  program_time;                                   \
+  /* 4kB sector erase time, microseconds.*/                                 \
+  uint32_t                  sector_erase_time;                              \
+  /* 64kB block erase time, microseconds.*/                                 \
+  uint32_t                  block_erase_time;                               \
+  /* Erase suspend latency, microseconds.*/                                 \
+  uint32_t                  suspend_time;                                   \
+  /* Erase time lost on each resume, microseconds.*/                        \
+  uint32_t                  resume_time;                                    \
+  /* SFDP image, NULL if the device has no SFDP.*/                          \
+  const uint8_t             *sfdp;                                          \
+  /* Size of the SFDP image.*/                                              \
+  size_t                    sfdp_size
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern WSPIDriver WSPID1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void wspi_lld_init(void);
+  void wspi_lld_start(WSPIDriver *wspip);
+  void wspi_lld_stop(WSPIDriver *wspip);
+  void wspi_lld_command(WSPIDriver *wspip, const wspi_command_t *cmdp);
+  void wspi_lld_send(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     size_t n, const uint8_t *txbuf);
+  void wspi_lld_receive(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                        size_t n, uint8_t *rxbuf);
+  void wspi_lld_poll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                     uint8_t mask, uint8_t match, uint8_t *statusp);
+  bool wspi_lld_serve_interrupt(WSPIDriver *wspip);
+  const wspi_sim_stats_t *wspiSimGetStats(WSPIDriver *wspip);
+  void wspiSimResetStats(WSPIDriver *wspip);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_WSPI == TRUE */
+
+#endif /* HAL_WSPI_LLD_H */
+
+/** @} */
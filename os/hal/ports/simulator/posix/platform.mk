@@ -1,7 +1,11 @@
 # List of all the Posix platform files.
 PLATFORMSRC = ${CHIBIOS}/os/hal/ports/simulator/posix/hal_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/hal_efl_lld.c \
               ${CHIBIOS}/os/hal/ports/simulator/posix/hal_serial_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/hal_wspi_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/simblk.c \
               ${CHIBIOS}/os/hal/ports/simulator/console.c \
+              ${CHIBIOS}/os/hal/ports/simulator/hal_mac_lld.c \
               ${CHIBIOS}/os/hal/ports/simulator/hal_pal_lld.c \
               ${CHIBIOS}/os/hal/ports/simulator/hal_st_lld.c
 
@@ -0,0 +1,300 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/simblk.c
+ * @brief   Simulator block device code.
+ *
+ * @addtogroup POSIX_SIMBLK
+ * @{
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+#include "simblk.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated block device 1.
+ */
+SimBlockDevice SBLKD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static bool sblk_is_inserted(void *instance) {
+
+  (void)instance;
+
+  return true;
+}
+
+static bool sblk_is_protected(void *instance) {
+
+  (void)instance;
+
+  return false;
+}
+
+static bool sblk_connect(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state == BLK_STOP) {
+    return HAL_FAILED;
+  }
+  sbdp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool sblk_disconnect(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state == BLK_STOP) {
+    return HAL_FAILED;
+  }
+  sbdp->state = BLK_ACTIVE;
+
+  return HAL_SUCCESS;
+}
+
+static bool sblk_read(void *instance, uint32_t startblk,
+                      uint8_t *buffer, uint32_t n) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+  const SimBlockConfig *cfgp = sbdp->config;
+  uint32_t time;
+
+  if ((sbdp->state != BLK_READY) || (startblk >= cfgp->blk_num) ||
+      (n > cfgp->blk_num - startblk)) {
+    return HAL_FAILED;
+  }
+
+  time = cfgp->access_time + (n * cfgp->read_time);
+  memcpy(buffer, sbdp->array + ((size_t)startblk * cfgp->blk_size),
+         (size_t)n * cfgp->blk_size);
+  _sim_delay_us(time);
+  sbdp->stats.n_reads++;
+  sbdp->stats.n_read_blocks += n;
+  sbdp->stats.busy_time     += time;
+
+  return HAL_SUCCESS;
+}
+
+static bool sblk_write(void *instance, uint32_t startblk,
+                       const uint8_t *buffer, uint32_t n) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+  const SimBlockConfig *cfgp = sbdp->config;
+  uint32_t i, time;
+
+  if ((sbdp->state != BLK_READY) || (startblk >= cfgp->blk_num) ||
+      (n > cfgp->blk_num - startblk)) {
+    return HAL_FAILED;
+  }
+
+  time = cfgp->access_time + (n * cfgp->write_time);
+  memcpy(sbdp->array + ((size_t)startblk * cfgp->blk_size), buffer,
+         (size_t)n * cfgp->blk_size);
+  for (i = startblk; i < startblk + n; i++) {
+    sbdp->wear[i]++;
+  }
+  _sim_delay_us(time);
+  sbdp->stats.n_writes++;
+  sbdp->stats.n_written_blocks += n;
+  sbdp->stats.busy_time        += time;
+
+  return HAL_SUCCESS;
+}
+
+static bool sblk_sync(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+  if (sbdp->config->path != NULL) {
+    _sim_storage_sync(sbdp->array, (size_t)sbdp->config->blk_num *
+                                   sbdp->config->blk_size);
+  }
+  sbdp->stats.n_syncs++;
+
+  return HAL_SUCCESS;
+}
+
+static bool sblk_get_info(void *instance, BlockDeviceInfo *bdip) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+  bdip->blk_size = sbdp->config->blk_size;
+  bdip->blk_num  = sbdp->config->blk_num;
+
+  return HAL_SUCCESS;
+}
+
+static const struct SimBlockDeviceVMT vmt = {
+  (size_t)0,
+  sblk_is_inserted,
+  sblk_is_protected,
+  sblk_connect,
+  sblk_disconnect,
+  sblk_read,
+  sblk_write,
+  sblk_sync,
+  sblk_get_info
+};
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] sbdp     pointer to the @p SimBlockDevice object
+ *
+ * @init
+ */
+void sblkObjectInit(SimBlockDevice *sbdp) {
+
+  sbdp->vmt    = &vmt;
+  sbdp->state  = BLK_STOP;
+  sbdp->config = NULL;
+  sbdp->array  = NULL;
+  sbdp->wear   = NULL;
+  sblkResetStats(sbdp);
+}
+
+/**
+ * @brief   Configures and activates the block device, the device is also
+ *          connected.
+ * @note    The blocks array is mapped on activation, the host file is
+ *          created if missing.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void sblkStart(SimBlockDevice *sbdp, const SimBlockConfig *config) {
+
+  osalDbgCheck((sbdp != NULL) && (config != NULL) &&
+               (config->blk_size > 0U) && (config->blk_num > 0U));
+  osalDbgAssert(sbdp->state == BLK_STOP, "invalid state");
+
+  sbdp->config = config;
+  sbdp->array  = _sim_storage_map(config->path,
+                                  (size_t)config->blk_num * config->blk_size,
+                                  0U);
+  sbdp->wear   = calloc((size_t)config->blk_num, sizeof (uint32_t));
+  osalDbgAssert(sbdp->wear != NULL, "out of memory");
+  sblkResetStats(sbdp);
+  sbdp->state  = BLK_READY;
+}
+
+/**
+ * @brief   Deactivates the block device.
+ * @note    The blocks array is written back to the host file.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ *
+ * @api
+ */
+void sblkStop(SimBlockDevice *sbdp) {
+  size_t size;
+
+  osalDbgCheck(sbdp != NULL);
+
+  if (sbdp->state != BLK_STOP) {
+    size = (size_t)sbdp->config->blk_num * sbdp->config->blk_size;
+    if (sbdp->config->path != NULL) {
+      _sim_storage_sync(sbdp->array, size);
+    }
+    _sim_storage_unmap(sbdp->array, size);
+    free(sbdp->wear);
+    sbdp->array = NULL;
+    sbdp->wear  = NULL;
+  }
+  sbdp->state = BLK_STOP;
+}
+
+/**
+ * @brief   Returns the accesses statistics.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @return              Pointer to the statistics structure.
+ *
+ * @api
+ */
+const sim_blk_stats_t *sblkGetStats(SimBlockDevice *sbdp) {
+
+  osalDbgCheck(sbdp != NULL);
+
+  return &sbdp->stats;
+}
+
+/**
+ * @brief   Clears the accesses statistics.
+ * @note    The blocks write counters are not cleared.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ *
+ * @api
+ */
+void sblkResetStats(SimBlockDevice *sbdp) {
+
+  osalDbgCheck(sbdp != NULL);
+
+  memset(&sbdp->stats, 0, sizeof (sim_blk_stats_t));
+}
+
+/**
+ * @brief   Returns the number of write operations of a block.
+ * @note    Counters are kept since the device activation.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @param[in] blk       block number
+ * @return              The number of write operations.
+ *
+ * @api
+ */
+uint32_t sblkGetWriteCount(SimBlockDevice *sbdp, uint32_t blk) {
+
+  osalDbgCheck((sbdp != NULL) && (sbdp->wear != NULL) &&
+               (blk < sbdp->config->blk_num));
+
+  return sbdp->wear[blk];
+}
+
+/** @} */
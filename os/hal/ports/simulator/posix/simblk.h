@@ -0,0 +1,170 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/simblk.h
+ * @brief   Simulator block device header.
+ * @details The blocks array is a memory area mapped on a host file or on
+ *          anonymous memory. Access and transfer times are simulated and
+ *          the write operations are counted for each block.
+ *
+ * @addtogroup POSIX_SIMBLK
+ * @{
+ */
+
+#ifndef SIMBLK_H
+#define SIMBLK_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated block device configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Host file backing the blocks, @p NULL for anonymous memory.
+   */
+  const char            *path;
+  /**
+   * @brief   Block size in bytes.
+   */
+  uint32_t              blk_size;
+  /**
+   * @brief   Number of blocks.
+   */
+  uint32_t              blk_num;
+  /**
+   * @brief   Access time for each read or write command, microseconds.
+   */
+  uint32_t              access_time;
+  /**
+   * @brief   Transfer time for each block read, microseconds.
+   */
+  uint32_t              read_time;
+  /**
+   * @brief   Transfer time for each block written, microseconds.
+   */
+  uint32_t              write_time;
+} SimBlockConfig;
+
+/**
+ * @brief   Simulated block device statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of read operations.
+   */
+  uint32_t              n_reads;
+  /**
+   * @brief   Number of blocks read.
+   */
+  uint32_t              n_read_blocks;
+  /**
+   * @brief   Number of write operations.
+   */
+  uint32_t              n_writes;
+  /**
+   * @brief   Number of blocks written.
+   */
+  uint32_t              n_written_blocks;
+  /**
+   * @brief   Number of sync operations.
+   */
+  uint32_t              n_syncs;
+  /**
+   * @brief   Simulated device busy time in microseconds.
+   */
+  uint64_t              busy_time;
+} sim_blk_stats_t;
+
+/**
+ * @brief   @p SimBlockDevice specific methods.
+ */
+#define _sim_block_device_methods                                           \
+  _base_block_device_methods
+
+/**
+ * @brief   @p SimBlockDevice specific data.
+ */
+#define _sim_block_device_data                                              \
+  _base_block_device_data                                                   \
+  /* Current configuration data.*/                                          \
+  const SimBlockConfig  *config;                                            \
+  /* Blocks array.*/                                                        \
+  uint8_t               *array;                                             \
+  /* Write operations counters, one for each block.*/                       \
+  uint32_t              *wear;                                              \
+  /* Operations statistics.*/                                               \
+  sim_blk_stats_t       stats;
+
+/**
+ * @brief   @p SimBlockDevice virtual methods table.
+ */
+struct SimBlockDeviceVMT {
+  _sim_block_device_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Simulated block device.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct SimBlockDeviceVMT *vmt;
+  _sim_block_device_data
+} SimBlockDevice;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern SimBlockDevice SBLKD1;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void sblkObjectInit(SimBlockDevice *sbdp);
+  void sblkStart(SimBlockDevice *sbdp, const SimBlockConfig *config);
+  void sblkStop(SimBlockDevice *sbdp);
+  const sim_blk_stats_t *sblkGetStats(SimBlockDevice *sbdp);
+  void sblkResetStats(SimBlockDevice *sbdp);
+  uint32_t sblkGetWriteCount(SimBlockDevice *sbdp, uint32_t blk);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMBLK_H */
+
+/** @} */
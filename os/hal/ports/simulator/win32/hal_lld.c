@@ -107,4 +107,13 @@ void _sim_check_for_interrupts(void) {
   }
 }
 
+/**
+ * @brief   Waits for interrupts.
+ * @note    Interrupts are polled in this simulator.
+ */
+void _sim_wait_for_interrupts(void) {
+
+  _sim_check_for_interrupts();
+}
+
 /** @} */
@@ -42,6 +42,124 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (HAL_CRY_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Executes a single job.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] jp                pointer to the @p cry_job_t object
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+static cryerror_t cry_job_execute(CRYDriver *cryp, cry_job_t *jp) {
+  union {
+    SHA1Context             sha1;
+    SHA256Context           sha256;
+    SHA512Context           sha512;
+    HMACSHA256Context       hmacsha256;
+    HMACSHA512Context       hmacsha512;
+  } ctx;
+  cryerror_t err;
+
+  switch (jp->op) {
+  case CRY_JOB_LOAD_AES_KEY:
+    return cryLoadAESTransientKey(cryp, jp->size, jp->in);
+  case CRY_JOB_LOAD_DES_KEY:
+    return cryLoadDESTransientKey(cryp, jp->size, jp->in);
+  case CRY_JOB_LOAD_HMAC_KEY:
+    return cryLoadHMACTransientKey(cryp, jp->size, jp->in);
+  case CRY_JOB_ENCRYPT_AES_ECB:
+    return cryEncryptAES_ECB(cryp, jp->key_id, jp->size, jp->in, jp->out);
+  case CRY_JOB_DECRYPT_AES_ECB:
+    return cryDecryptAES_ECB(cryp, jp->key_id, jp->size, jp->in, jp->out);
+  case CRY_JOB_ENCRYPT_AES_CBC:
+    return cryEncryptAES_CBC(cryp, jp->key_id, jp->size, jp->in, jp->out,
+                             jp->iv);
+  case CRY_JOB_DECRYPT_AES_CBC:
+    return cryDecryptAES_CBC(cryp, jp->key_id, jp->size, jp->in, jp->out,
+                             jp->iv);
+  case CRY_JOB_ENCRYPT_AES_CFB:
+    return cryEncryptAES_CFB(cryp, jp->key_id, jp->size, jp->in, jp->out,
+                             jp->iv);
+  case CRY_JOB_DECRYPT_AES_CFB:
+    return cryDecryptAES_CFB(cryp, jp->key_id, jp->size, jp->in, jp->out,
+                             jp->iv);
+  case CRY_JOB_ENCRYPT_AES_CTR:
+    return cryEncryptAES_CTR(cryp, jp->key_id, jp->size, jp->in, jp->out,
+                             jp->iv);
+  case CRY_JOB_DECRYPT_AES_CTR:
+    return cryDecryptAES_CTR(cryp, jp->key_id, jp->size, jp->in, jp->out,
+                             jp->iv);
+  case CRY_JOB_ENCRYPT_AES_GCM:
+    return cryEncryptAES_GCM(cryp, jp->key_id, jp->auth_size, jp->auth_in,
+                             jp->size, jp->in, jp->out, jp->iv,
+                             jp->tag_size, jp->tag);
+  case CRY_JOB_DECRYPT_AES_GCM:
+    return cryDecryptAES_GCM(cryp, jp->key_id, jp->auth_size, jp->auth_in,
+                             jp->size, jp->in, jp->out, jp->iv,
+                             jp->tag_size, jp->tag);
+  case CRY_JOB_ENCRYPT_DES_ECB:
+    return cryEncryptDES_ECB(cryp, jp->key_id, jp->size, jp->in, jp->out);
+  case CRY_JOB_DECRYPT_DES_ECB:
+    return cryDecryptDES_ECB(cryp, jp->key_id, jp->size, jp->in, jp->out);
+  case CRY_JOB_ENCRYPT_DES_CBC:
+    return cryEncryptDES_CBC(cryp, jp->key_id, jp->size, jp->in, jp->out,
+                             jp->iv);
+  case CRY_JOB_DECRYPT_DES_CBC:
+    return cryDecryptDES_CBC(cryp, jp->key_id, jp->size, jp->in, jp->out,
+                             jp->iv);
+  case CRY_JOB_SHA1:
+    err = crySHA1Init(cryp, &ctx.sha1);
+    if (err == CRY_NOERROR) {
+      err = crySHA1Update(cryp, &ctx.sha1, jp->size, jp->in);
+    }
+    if (err == CRY_NOERROR) {
+      err = crySHA1Final(cryp, &ctx.sha1, jp->out);
+    }
+    return err;
+  case CRY_JOB_SHA256:
+    err = crySHA256Init(cryp, &ctx.sha256);
+    if (err == CRY_NOERROR) {
+      err = crySHA256Update(cryp, &ctx.sha256, jp->size, jp->in);
+    }
+    if (err == CRY_NOERROR) {
+      err = crySHA256Final(cryp, &ctx.sha256, jp->out);
+    }
+    return err;
+  case CRY_JOB_SHA512:
+    err = crySHA512Init(cryp, &ctx.sha512);
+    if (err == CRY_NOERROR) {
+      err = crySHA512Update(cryp, &ctx.sha512, jp->size, jp->in);
+    }
+    if (err == CRY_NOERROR) {
+      err = crySHA512Final(cryp, &ctx.sha512, jp->out);
+    }
+    return err;
+  case CRY_JOB_HMAC_SHA256:
+    err = cryHMACSHA256Init(cryp, &ctx.hmacsha256);
+    if (err == CRY_NOERROR) {
+      err = cryHMACSHA256Update(cryp, &ctx.hmacsha256, jp->size, jp->in);
+    }
+    if (err == CRY_NOERROR) {
+      err = cryHMACSHA256Final(cryp, &ctx.hmacsha256, jp->out);
+    }
+    return err;
+  case CRY_JOB_HMAC_SHA512:
+    err = cryHMACSHA512Init(cryp, &ctx.hmacsha512);
+    if (err == CRY_NOERROR) {
+      err = cryHMACSHA512Update(cryp, &ctx.hmacsha512, jp->size, jp->in);
+    }
+    if (err == CRY_NOERROR) {
+      err = cryHMACSHA512Final(cryp, &ctx.hmacsha512, jp->out);
+    }
+    return err;
+  default:
+    return CRY_ERR_INV_ALGO;
+  }
+}
+#endif /* HAL_CRY_USE_JOBS == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -71,6 +189,14 @@ void cryObjectInit(CRYDriver *cryp) {
 
   cryp->state    = CRY_STOP;
   cryp->config   = NULL;
+#if HAL_CRY_USE_JOBS == TRUE
+  cryp->jobs.head       = NULL;
+  cryp->jobs.tail       = NULL;
+  cryp->jobs.dispatcher = NULL;
+#endif
+#if HAL_CRY_USE_FALLBACK == TRUE
+  cry_fallback_init(cryp);
+#endif
 #if defined(CRY_DRIVER_EXT_INIT_HOOK)
   CRY_DRIVER_EXT_INIT_HOOK(cryp);
 #endif
@@ -115,6 +241,9 @@ void cryStop(CRYDriver *cryp) {
 
   osalDbgAssert((cryp->state == CRY_STOP) || (cryp->state == CRY_READY),
                 "invalid state");
+#if HAL_CRY_USE_JOBS == TRUE
+  osalDbgAssert(cryp->jobs.head == NULL, "jobs pending");
+#endif
 
 #if HAL_CRY_ENFORCE_FALLBACK == FALSE
   cry_lld_stop(cryp);
@@ -148,7 +277,18 @@ cryerror_t cryLoadAESTransientKey(CRYDriver *cryp,
   osalDbgCheck((cryp != NULL) &&  (keyp != NULL));
 
 #if CRY_LLD_SUPPORTS_AES == TRUE
-  return cry_lld_aes_loadkey(cryp, size, keyp);
+  cryerror_t err;
+
+  err = cry_lld_aes_loadkey(cryp, size, keyp);
+#if (HAL_CRY_USE_FALLBACK == TRUE) && CRY_FALLBACK_USES_AES
+  /* The fall-back implements the modes not supported by the LLD, it needs
+     its own copy of the key.*/
+  if (err == CRY_NOERROR) {
+    err = cry_fallback_aes_loadkey(cryp, size, keyp);
+  }
+#endif
+
+  return err;
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_aes_loadkey(cryp, size, keyp);
 #else
@@ -844,7 +984,18 @@ cryerror_t cryLoadDESTransientKey(CRYDriver *cryp,
   osalDbgCheck((cryp != NULL) &&  (keyp != NULL));
 
 #if CRY_LLD_SUPPORTS_DES == TRUE
-  return cry_lld_des_loadkey(cryp, size, keyp);
+  cryerror_t err;
+
+  err = cry_lld_des_loadkey(cryp, size, keyp);
+#if (HAL_CRY_USE_FALLBACK == TRUE) && CRY_FALLBACK_USES_DES
+  /* The fall-back implements the modes not supported by the LLD, it needs
+     its own copy of the key.*/
+  if (err == CRY_NOERROR) {
+    err = cry_fallback_des_loadkey(cryp, size, keyp);
+  }
+#endif
+
+  return err;
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_des_loadkey(cryp, size, keyp);
 #else
@@ -1501,7 +1652,18 @@ cryerror_t cryLoadHMACTransientKey(CRYDriver *cryp,
 
 #if (CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                               \
     (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)
-  return cry_lld_hmac_loadkey(cryp, size, keyp);
+  cryerror_t err;
+
+  err = cry_lld_hmac_loadkey(cryp, size, keyp);
+#if (HAL_CRY_USE_FALLBACK == TRUE) && CRY_FALLBACK_USES_HMAC
+  /* The fall-back implements the modes not supported by the LLD, it needs
+     its own copy of the key.*/
+  if (err == CRY_NOERROR) {
+    err = cry_fallback_hmac_loadkey(cryp, size, keyp);
+  }
+#endif
+
+  return err;
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_hmac_loadkey(cryp, size, keyp);
 #else
@@ -1731,6 +1893,166 @@ cryerror_t cryHMACSHA512Final(CRYDriver *cryp,
 #endif
 }
 
+#if (HAL_CRY_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Posts a batch of jobs.
+ * @details The jobs are appended to the driver queue in array order and are
+ *          executed back to back by the dispatcher thread, a batch is never
+ *          interleaved with jobs posted by other clients.
+ * @note    Transient keys are shared by all clients, a batch using a
+ *          transient key should start with its own key load job.
+ * @note    The jobs must not be modified until they reach the
+ *          @p CRY_JOB_DONE state.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] jobs              array of @p cry_job_t objects
+ * @param[in] n                 number of jobs in the array, must be greater
+ *                              than zero
+ *
+ * @iclass
+ */
+void cryPostJobsI(CRYDriver *cryp, cry_job_t *jobs, size_t n) {
+  size_t i;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((cryp != NULL) && (jobs != NULL) && (n > (size_t)0));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+  for (i = 0U; i < n; i++) {
+    osalDbgAssert(jobs[i].state != CRY_JOB_QUEUED, "already queued");
+
+    jobs[i].state  = CRY_JOB_QUEUED;
+    jobs[i].waiter = NULL;
+    jobs[i].err    = CRY_NOERROR;
+    jobs[i].next   = i + 1U < n ? &jobs[i + 1U] : NULL;
+  }
+
+  if (cryp->jobs.head == NULL) {
+    cryp->jobs.head = &jobs[0];
+  }
+  else {
+    cryp->jobs.tail->next = &jobs[0];
+  }
+  cryp->jobs.tail = &jobs[n - 1U];
+
+  osalThreadResumeI(&cryp->jobs.dispatcher, MSG_OK);
+}
+
+/**
+ * @brief   Posts a batch of jobs.
+ * @details The jobs are appended to the driver queue in array order and are
+ *          executed back to back by the dispatcher thread, a batch is never
+ *          interleaved with jobs posted by other clients.
+ * @note    Transient keys are shared by all clients, a batch using a
+ *          transient key should start with its own key load job.
+ * @note    The jobs must not be modified until they reach the
+ *          @p CRY_JOB_DONE state.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] jobs              array of @p cry_job_t objects
+ * @param[in] n                 number of jobs in the array, must be greater
+ *                              than zero
+ *
+ * @api
+ */
+void cryPostJobs(CRYDriver *cryp, cry_job_t *jobs, size_t n) {
+
+  osalSysLock();
+  cryPostJobsI(cryp, jobs, n);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Waits for a job completion.
+ * @note    Only one thread can wait on a job.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] jobp              pointer to a posted @p cry_job_t object
+ * @param[in] timeout           wait timeout
+ * @return                      The wait result.
+ * @retval MSG_OK               if the job has been executed, the operation
+ *                              status is in the @p err field.
+ * @retval MSG_TIMEOUT          if the job has not been executed within the
+ *                              specified timeout.
+ *
+ * @api
+ */
+msg_t cryWaitJobTimeout(CRYDriver *cryp, cry_job_t *jobp,
+                        sysinterval_t timeout) {
+  msg_t msg;
+
+  osalDbgCheck((cryp != NULL) && (jobp != NULL));
+
+  osalSysLock();
+  osalDbgAssert(jobp->state != CRY_JOB_IDLE, "not posted");
+
+  if (jobp->state == CRY_JOB_DONE) {
+    msg = MSG_OK;
+  }
+  else {
+    msg = osalThreadSuspendTimeoutS(&jobp->waiter, timeout);
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Executes the queued jobs.
+ * @details This function is meant to be called in a loop by a dispatcher
+ *          thread provided by the application, it waits for jobs then
+ *          executes all the queued jobs back to back. For each job the
+ *          callback is invoked then the waiting thread, if any, is resumed.
+ * @note    Only one dispatcher thread can serve a driver.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] timeout           jobs wait timeout
+ * @return                      The wait result.
+ * @retval MSG_OK               if one or more jobs have been executed.
+ * @retval MSG_TIMEOUT          if no job has been posted within the
+ *                              specified timeout.
+ *
+ * @api
+ */
+msg_t cryDispatchJobsTimeout(CRYDriver *cryp, sysinterval_t timeout) {
+  cry_job_t *jp, *next;
+
+  osalDbgCheck(cryp != NULL);
+
+  osalSysLock();
+  if (cryp->jobs.head == NULL) {
+    msg_t msg = osalThreadSuspendTimeoutS(&cryp->jobs.dispatcher, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return msg;
+    }
+  }
+  jp = cryp->jobs.head;
+  cryp->jobs.head = NULL;
+  cryp->jobs.tail = NULL;
+  osalSysUnlock();
+
+  while (jp != NULL) {
+    next    = jp->next;
+    jp->err = cry_job_execute(cryp, jp);
+    if (jp->cb != NULL) {
+      jp->cb(cryp, jp);
+    }
+
+    osalSysLock();
+    jp->state = CRY_JOB_DONE;
+    osalThreadResumeS(&jp->waiter, MSG_OK);
+    osalSysUnlock();
+
+    jp = next;
+  }
+
+  return MSG_OK;
+}
+#endif /* HAL_CRY_USE_JOBS == TRUE */
+
 #endif /* HAL_USE_CRY == TRUE */
 
 /** @} */
@@ -42,6 +42,14 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+static flash_error_t efl_get_stats(void *instance, flash_stats_t *sp) {
+
+  (void)instance;
+  (void)sp;
+
+  return FLASH_ERROR_UNIMPLEMENTED;
+}
+
 static const struct EFlashDriverVMT vmt = {
   (size_t)0,
   efl_lld_get_descriptor,
@@ -50,7 +58,8 @@ static const struct EFlashDriverVMT vmt = {
   efl_lld_start_erase_all,
   efl_lld_start_erase_sector,
   efl_lld_query_erase,
-  efl_lld_verify_erase
+  efl_lld_verify_erase,
+  efl_get_stats
 };
 
 /*===========================================================================*/
@@ -139,6 +139,58 @@ static size_t oq_write(output_queue_t *oqp, const uint8_t *bp, size_t n) {
   return n;
 }
 
+/**
+ * @brief   Describes a queue buffer area as spans.
+ *
+ * @param[in] qp        pointer to an @p io_queue_t structure
+ * @param[in] p         pointer to the start of the area
+ * @param[in] n         size of the area
+ * @param[out] sp       pointer to the spans to be filled
+ *
+ * @notapi
+ */
+static void q_spans(io_queue_t *qp, uint8_t *p, size_t n,
+                    io_queue_span_t *sp) {
+  size_t s1;
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(qp->q_top - p);
+  /*lint -restore*/
+
+  sp->p1 = p;
+  if (n <= s1) {
+    sp->n1 = n;
+    sp->p2 = NULL;
+    sp->n2 = (size_t)0;
+  }
+  else {
+    sp->n1 = s1;
+    sp->p2 = qp->q_buffer;
+    sp->n2 = n - s1;
+  }
+}
+
+/**
+ * @brief   Advances a queue buffer pointer with wrap around.
+ *
+ * @param[in] qp        pointer to an @p io_queue_t structure
+ * @param[in] p         the pointer to be advanced
+ * @param[in] n         number of bytes
+ * @return              The advanced pointer.
+ *
+ * @notapi
+ */
+static uint8_t *q_advance(io_queue_t *qp, uint8_t *p, size_t n) {
+
+  p += n;
+  if (p >= qp->q_top) {
+    p -= qSizeX(qp);
+  }
+
+  return p;
+}
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -428,6 +480,126 @@ size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Input queue non-blocking peek.
+ * @details The function returns all the data currently queued as one or
+ *          two contiguous spans, the data can be parsed in place and then
+ *          removed from the queue using @p iqConsumeI().
+ * @note    The exposed data remains valid until it is consumed or the
+ *          queue is reset.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[out] sp       pointer to an @p io_queue_span_t structure receiving
+ *                      the queued data area
+ * @return              The number of bytes available.
+ *
+ * @iclass
+ */
+size_t iqPeekI(input_queue_t *iqp, io_queue_span_t *sp) {
+  size_t n;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(sp != NULL);
+
+  n = iqGetFullI(iqp);
+  q_spans(iqp, iqp->q_rdptr, n, sp);
+
+  return n;
+}
+
+/**
+ * @brief   Input queue peek with timeout.
+ * @details The function waits until at least @p n bytes are queued then
+ *          returns all the queued data as one or two contiguous spans,
+ *          the data can be parsed in place and then removed from the queue
+ *          using @p iqConsume().
+ * @note    The function is not atomic, if you need atomicity it is suggested
+ *          to use a semaphore or a mutex for mutual exclusion.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] n         the minimum number of bytes to be waited for, the
+ *                      value 0 is reserved
+ * @param[out] sp       pointer to an @p io_queue_span_t structure receiving
+ *                      the queued data area
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes available, it can be larger
+ *                      than @p n.
+ * @retval 0            if a timeout occurred or the queue has been reset.
+ *
+ * @api
+ */
+size_t iqPeekTimeout(input_queue_t *iqp, size_t n, io_queue_span_t *sp,
+                     sysinterval_t timeout) {
+  size_t full;
+
+  osalDbgCheck((n > 0U) && (n <= qSizeX(iqp)) && (sp != NULL));
+
+  osalSysLock();
+
+  /* Waiting until there is enough data or a timeout occurs.*/
+  while (iqGetFullI(iqp) < n) {
+    msg_t msg = osalThreadEnqueueTimeoutS(&iqp->q_waiting, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return (size_t)0;
+    }
+  }
+
+  full = iqPeekI(iqp, sp);
+
+  osalSysUnlock();
+
+  return full;
+}
+
+/**
+ * @brief   Input queue non-blocking consume.
+ * @details The first @p n bytes of the area previously returned by
+ *          @p iqPeekI() or @p iqPeekTimeout() are removed from the queue.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] n         the number of bytes to be consumed
+ *
+ * @iclass
+ */
+void iqConsumeI(input_queue_t *iqp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgAssert(n <= iqGetFullI(iqp), "consume exceeds peek");
+
+  if (n > 0U) {
+    iqp->q_rdptr = q_advance(iqp, iqp->q_rdptr, n);
+    iqp->q_counter -= n;
+
+    /* Inform the low side that the queue has at least one empty slot
+       available.*/
+    if (iqp->q_notify != NULL) {
+      iqp->q_notify(iqp);
+    }
+  }
+}
+
+/**
+ * @brief   Input queue consume.
+ * @details The first @p n bytes of the area previously returned by
+ *          @p iqPeekI() or @p iqPeekTimeout() are removed from the queue.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] n         the number of bytes to be consumed
+ *
+ * @api
+ */
+void iqConsume(input_queue_t *iqp, size_t n) {
+
+  osalSysLock();
+  iqConsumeI(iqp, n);
+  osalSysUnlock();
+}
+
 /**
  * @brief   Initializes an output queue.
  * @details A Semaphore is internally initialized and works as a counter of
@@ -696,4 +868,126 @@ size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Output queue non-blocking reserve.
+ * @details The function returns all the free space as one or two
+ *          contiguous spans, the space can be filled in place and then
+ *          made available to the low side using @p oqCommitI().
+ * @note    The exposed space remains valid until it is committed or the
+ *          queue is reset.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[out] sp       pointer to an @p io_queue_span_t structure receiving
+ *                      the free space area
+ * @return              The number of bytes reserved.
+ *
+ * @iclass
+ */
+size_t oqReserveI(output_queue_t *oqp, io_queue_span_t *sp) {
+  size_t n;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(sp != NULL);
+
+  n = oqGetEmptyI(oqp);
+  q_spans(oqp, oqp->q_wrptr, n, sp);
+
+  return n;
+}
+
+/**
+ * @brief   Output queue reserve with timeout.
+ * @details The function waits until at least @p n bytes are free then
+ *          returns all the free space as one or two contiguous spans,
+ *          the space can be filled in place and then made available to the
+ *          low side using @p oqCommit().
+ * @note    The function is not atomic, if you need atomicity it is suggested
+ *          to use a semaphore or a mutex for mutual exclusion.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] n         the minimum number of bytes to be waited for, the
+ *                      value 0 is reserved
+ * @param[out] sp       pointer to an @p io_queue_span_t structure receiving
+ *                      the free space area
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes reserved, it can be larger
+ *                      than @p n.
+ * @retval 0            if a timeout occurred or the queue has been reset.
+ *
+ * @api
+ */
+size_t oqReserveTimeout(output_queue_t *oqp, size_t n, io_queue_span_t *sp,
+                        sysinterval_t timeout) {
+  size_t empty;
+
+  osalDbgCheck((n > 0U) && (n <= qSizeX(oqp)) && (sp != NULL));
+
+  osalSysLock();
+
+  /* Waiting until there is enough space or a timeout occurs.*/
+  while (oqGetEmptyI(oqp) < n) {
+    msg_t msg = osalThreadEnqueueTimeoutS(&oqp->q_waiting, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return (size_t)0;
+    }
+  }
+
+  empty = oqReserveI(oqp, sp);
+
+  osalSysUnlock();
+
+  return empty;
+}
+
+/**
+ * @brief   Output queue non-blocking commit.
+ * @details The first @p n bytes of the area previously returned by
+ *          @p oqReserveI() or @p oqReserveTimeout() are made available to
+ *          the low side.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] n         the number of bytes to be committed
+ *
+ * @iclass
+ */
+void oqCommitI(output_queue_t *oqp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgAssert(n <= oqGetEmptyI(oqp), "commit exceeds reservation");
+
+  if (n > 0U) {
+    oqp->q_wrptr = q_advance(oqp, oqp->q_wrptr, n);
+    oqp->q_counter -= n;
+
+    /* Inform the low side that the queue has at least one character
+       available.*/
+    if (oqp->q_notify != NULL) {
+      oqp->q_notify(oqp);
+    }
+  }
+}
+
+/**
+ * @brief   Output queue commit.
+ * @details The first @p n bytes of the area previously returned by
+ *          @p oqReserveI() or @p oqReserveTimeout() are made available to
+ *          the low side.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] n         the number of bytes to be committed
+ *
+ * @api
+ */
+void oqCommit(output_queue_t *oqp, size_t n) {
+
+  osalSysLock();
+  oqCommitI(oqp, n);
+  osalSysUnlock();
+}
+
 /** @} */
@@ -315,6 +315,81 @@ bool wspiReceive(WSPIDriver *wspip, const wspi_command_t *cmdp,
 }
 #endif /* WSPI_USE_WAIT == TRUE */
 
+#if (WSPI_SUPPORTS_POLLING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Polls a device status register.
+ * @details The command is repeated by the controller until the received
+ *          byte, masked by @p mask, is equal to @p match.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] mask      mask of the status bits to be checked
+ * @param[in] match     expected value of the masked status bits
+ * @param[out] statusp  pointer to the location receiving the last status
+ *                      byte
+ *
+ * @api
+ */
+void wspiStartPoll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+                   uint8_t mask, uint8_t match, uint8_t *statusp) {
+
+  osalDbgCheck((wspip != NULL) && (cmdp != NULL) && (statusp != NULL));
+
+  osalSysLock();
+
+  osalDbgAssert(wspip->state == WSPI_READY, "not ready");
+
+  wspiStartPollI(wspip, cmdp, mask, match, statusp);
+
+  osalSysUnlock();
+}
+
+#if (WSPI_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Polls a device status register.
+ * @details The command is repeated by the controller until the received
+ *          byte, masked by @p mask, is equal to @p match. The calling
+ *          thread is suspended for the whole polling time.
+ * @pre     In order to use this function the option @p WSPI_USE_WAIT must be
+ *          enabled.
+ * @pre     In order to use this function the driver must have been configured
+ *          without callbacks (@p end_cb = @p NULL).
+ *
+ * @param[in] wspip     pointer to the @p WSPIDriver object
+ * @param[in] cmdp      pointer to the command descriptor
+ * @param[in] mask      mask of the status bits to be checked
+ * @param[in] match     expected value of the masked status bits
+ * @param[out] statusp  pointer to the location receiving the last status
+ *                      byte
+ * @return              The operation status.
+ * @retval false        if the operation succeeded.
+ * @retval true         if the operation failed because HW issues.
+ *
+ * @api
+ */
+bool wspiPoll(WSPIDriver *wspip, const wspi_command_t *cmdp,
+              uint8_t mask, uint8_t match, uint8_t *statusp) {
+  msg_t msg;
+
+  osalDbgCheck((wspip != NULL) && (cmdp != NULL) && (statusp != NULL));
+  osalDbgCheck((cmdp->cfg & WSPI_CFG_DATA_MODE_MASK) != WSPI_CFG_DATA_MODE_NONE);
+
+  osalSysLock();
+
+  osalDbgAssert(wspip->state == WSPI_READY, "not ready");
+  osalDbgAssert(wspip->config->end_cb == NULL, "has callback");
+
+  wspiStartPollI(wspip, cmdp, mask, match, statusp);
+  msg = osalThreadSuspendS(&wspip->thread);
+
+  osalSysUnlock();
+
+  return (bool)(msg != MSG_OK);
+}
+#endif /* WSPI_USE_WAIT == TRUE */
+#endif /* WSPI_SUPPORTS_POLLING == TRUE */
+
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Maps in memory space a WSPI flash device.
@@ -87,6 +87,11 @@ typedef uint32_t crykey_t;
  */
 typedef struct CRYDriver CRYDriver;
 
+/* The fall-back keys are part of the driver structure.*/
+#if HAL_CRY_USE_FALLBACK == TRUE
+#include "hal_crypto_fallback.h"
+#endif
+
 /**
  * @brief   Driver configuration structure.
  * @note    It could be empty on some architectures.
@@ -107,6 +112,18 @@ struct CRYDriver {
    * @brief   Current configuration data.
    */
   const CRYConfig           *config;
+#if (HAL_CRY_USE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Fall-back transient keys.
+   */
+  cry_fallback_keys_t       fallback;
+#endif
+#if (HAL_CRY_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Jobs queue.
+   */
+  cry_jobs_queue_t          jobs;
+#endif
 #if defined(CRY_DRIVER_EXT_FIELDS)
   CRY_DRIVER_EXT_FIELDS
 #endif
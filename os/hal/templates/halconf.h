@@ -281,6 +281,13 @@
 #define HAL_CRY_ENFORCE_FALLBACK            FALSE
 #endif
 
+/**
+ * @brief   Enables the jobs queue API.
+ */
+#if !defined(HAL_CRY_USE_JOBS) || defined(__DOXYGEN__)
+#define HAL_CRY_USE_JOBS                    FALSE
+#endif
+
 /*===========================================================================*/
 /* DAC driver related settings.                                              */
 /*===========================================================================*/
@@ -40,8 +40,10 @@
  */
 #if (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
 #define CH_HEAP_ALIGNMENT   8U
+#define CH_HEAP_ALIGN_SHIFT 3U
 #elif (SIZEOF_PTR == 2)
 #define CH_HEAP_ALIGNMENT   4U
+#define CH_HEAP_ALIGN_SHIFT 2U
 #else
 #error "unsupported pointer size"
 #endif
@@ -50,6 +52,36 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   TLSF heap engine.
+ * @details If enabled then heaps can be initialized using
+ *          @p chHeapObjectInitTLSF() in order to use a two-level
+ *          segregated fit allocator instead of the first-fit one.
+ */
+#if !defined(CH_CFG_HEAP_USE_TLSF) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_USE_TLSF                FALSE
+#endif
+
+/**
+ * @brief   TLSF second level index bits.
+ * @details Each power of two size range is split in
+ *          2^CH_CFG_HEAP_TLSF_SL_BITS free lists, the worst case internal
+ *          fragmentation is 1/2^CH_CFG_HEAP_TLSF_SL_BITS of the block size.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_SL_BITS) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_TLSF_SL_BITS            3
+#endif
+
+/**
+ * @brief   TLSF maximum block size as a power of two.
+ * @details Blocks up to 2^CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2 - 1 bytes can be
+ *          handled, the size of the control structure placed in front of
+ *          the heap area is proportional to this value.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2     20
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -62,6 +94,37 @@
 #error "CH_CFG_USE_HEAP requires CH_CFG_USE_MUTEXES and/or CH_CFG_USE_SEMAPHORES"
 #endif
 
+#if (CH_CFG_HEAP_USE_TLSF == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_HEAP_TLSF_SL_BITS < 1) || (CH_CFG_HEAP_TLSF_SL_BITS > 5)
+#error "invalid CH_CFG_HEAP_TLSF_SL_BITS value"
+#endif
+
+/**
+ * @brief   Number of TLSF second level lists for each first level index.
+ */
+#define CH_HEAP_TLSF_SL_COUNT                                               \
+  (1U << CH_CFG_HEAP_TLSF_SL_BITS)
+
+/**
+ * @brief   Sizes below 2^CH_HEAP_TLSF_FL_SHIFT share the first level
+ *          index zero.
+ */
+#define CH_HEAP_TLSF_FL_SHIFT                                               \
+  (CH_CFG_HEAP_TLSF_SL_BITS + CH_HEAP_ALIGN_SHIFT)
+
+/**
+ * @brief   Number of TLSF first level indexes.
+ */
+#define CH_HEAP_TLSF_FL_COUNT                                               \
+  ((CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2 - CH_HEAP_TLSF_FL_SHIFT) + 1U)
+
+#if (CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2 <= CH_HEAP_TLSF_FL_SHIFT) ||           \
+    (CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2 > 31) ||                               \
+    (CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2 > (SIZEOF_PTR * 8))
+#error "invalid CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2 value"
+#endif
+#endif /* CH_CFG_HEAP_USE_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -90,6 +153,46 @@ union heap_header {
   } used;
 };
 
+#if (CH_CFG_HEAP_USE_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a TLSF block.
+ */
+typedef struct heap_tlsf_block heap_tlsf_block_t;
+
+/**
+ * @brief   TLSF block structure.
+ * @details The block size is the size of the area following the first two
+ *          fields, when the block is in use the area starts with a
+ *          @p heap_header_t so that the common heap functions can identify
+ *          the owner heap.
+ */
+struct heap_tlsf_block {
+  heap_tlsf_block_t     *prev;      /**< @brief Physically previous block,
+                                                valid only if free.         */
+  size_t                size;       /**< @brief Size of the area in bytes
+                                                and status flags.           */
+  union {
+    struct {
+      heap_tlsf_block_t *next;      /**< @brief Next in free list.          */
+      heap_tlsf_block_t *prev;      /**< @brief Previous in free list.      */
+    } free;
+    heap_header_t       header;     /**< @brief Used block header.          */
+  } u;
+};
+
+/**
+ * @brief   TLSF control structure.
+ * @note    This structure is placed at the beginning of the heap area.
+ */
+typedef struct {
+  uint32_t              fl_map;     /**< @brief First level bitmap.         */
+  uint32_t              sl_map[CH_HEAP_TLSF_FL_COUNT];
+                                    /**< @brief Second level bitmaps.       */
+  heap_tlsf_block_t     *lists[CH_HEAP_TLSF_FL_COUNT][CH_HEAP_TLSF_SL_COUNT];
+                                    /**< @brief Segregated free lists.      */
+} heap_tlsf_t;
+#endif /* CH_CFG_HEAP_USE_TLSF == TRUE */
+
 /**
  * @brief   Structure describing a memory heap.
  */
@@ -97,6 +200,10 @@ struct memory_heap {
   memgetfunc2_t         provider;   /**< @brief Memory blocks provider for
                                                 this heap.                  */
   heap_header_t         header;     /**< @brief Free blocks list header.    */
+#if (CH_CFG_HEAP_USE_TLSF == TRUE) || defined(__DOXYGEN__)
+  heap_tlsf_t           *tlsf;      /**< @brief TLSF control structure or
+                                                @p NULL for first-fit.      */
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   mutex_t               mtx;        /**< @brief Heap access mutex.          */
 #else
@@ -124,6 +231,10 @@ extern "C" {
 #endif
   void __heap_init(void);
   void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size);
+#if CH_CFG_HEAP_USE_TLSF == TRUE
+  void chHeapObjectInitTLSF(memory_heap_t *heapp, void *buf, size_t size,
+                            memgetfunc2_t provider);
+#endif
   void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align);
   void chHeapFree(void *p);
   size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp);
@@ -136,8 +247,7 @@ extern "C" {
 /*===========================================================================*/
 
 /**
- * @brief   Allocates a block of memory from the heap by using the first-fit
- *          algorithm.
+ * @brief   Allocates a block of memory from the heap.
  * @details The allocated block is guaranteed to be properly aligned for a
  *          pointer data type.
  *
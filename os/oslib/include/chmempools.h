@@ -38,6 +38,16 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Memory pool magazines.
+ * @details If enabled then the per-thread magazine APIs are included, a
+ *          magazine caches a small number of objects of a memory pool,
+ *          objects are exchanged with the pool in batches.
+ */
+#if !defined(CH_CFG_MEMPOOLS_USE_MAGAZINES) || defined(__DOXYGEN__)
+#define CH_CFG_MEMPOOLS_USE_MAGAZINES       FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -81,6 +91,43 @@ typedef struct {
 } guarded_memory_pool_t;
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Memory pool magazine statistics.
+ */
+typedef struct {
+  ucnt_t                n_alloc;        /**< @brief Allocations.            */
+  ucnt_t                n_alloc_hit;    /**< @brief Allocations served by
+                                                    the magazine.           */
+  ucnt_t                n_free;         /**< @brief Releases.               */
+  ucnt_t                n_free_hit;     /**< @brief Releases absorbed by the
+                                                    magazine.               */
+  ucnt_t                n_refill;       /**< @brief Batches obtained from
+                                                    the pool.               */
+  ucnt_t                n_drain;        /**< @brief Batches returned to the
+                                                    pool.                   */
+} pool_magazine_stats_t;
+
+/**
+ * @brief   Memory pool magazine descriptor.
+ * @note    A magazine is meant to be used by a single thread, the cached
+ *          objects are accessed without any lock.
+ */
+typedef struct {
+  memory_pool_t         *pool;          /**< @brief Associated pool.        */
+  struct pool_header    *next;          /**< @brief Cached objects list.    */
+  size_t                cnt;            /**< @brief Cached objects number.  */
+  size_t                size;           /**< @brief Magazine capacity.      */
+  size_t                batch;          /**< @brief Objects exchanged with
+                                                    the pool in a single
+                                                    operation.              */
+#if (CH_DBG_ENABLE_ASSERTS == TRUE) || defined(__DOXYGEN__)
+  thread_t              *owner;         /**< @brief Owner thread.           */
+#endif
+  pool_magazine_stats_t stats;          /**< @brief Magazine statistics.    */
+} pool_magazine_t;
+#endif /* CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE */
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -165,6 +212,13 @@ extern "C" {
                                   sysinterval_t timeout);
   void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp);
 #endif
+#if CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE
+  void chPoolMagazineObjectInit(pool_magazine_t *mgp, memory_pool_t *mp,
+                                size_t size, size_t batch);
+  void *chPoolMagazineAlloc(pool_magazine_t *mgp);
+  void chPoolMagazineFree(pool_magazine_t *mgp, void *objp);
+  void chPoolMagazineFlush(pool_magazine_t *mgp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -378,6 +432,34 @@ static inline void chGuardedPoolAddS(guarded_memory_pool_t *gmp, void *objp) {
 }
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of objects cached in a magazine.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @return              The number of cached objects.
+ *
+ * @xclass
+ */
+static inline size_t chPoolMagazineGetCountX(pool_magazine_t *mgp) {
+
+  return mgp->cnt;
+}
+
+/**
+ * @brief   Returns a pointer to the magazine statistics.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @return              A pointer to the statistics structure.
+ *
+ * @xclass
+ */
+static inline const pool_magazine_stats_t *chPoolMagazineGetStatsX(pool_magazine_t *mgp) {
+
+  return &mgp->stats;
+}
+#endif /* CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE */
+
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
 #endif /* CHMEMPOOLS_H */
@@ -50,10 +50,60 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Open addressing hash table.
+ * @details If enabled the cache index is an open addressing table of
+ *          compact tags probed linearly, lookups do not need to follow
+ *          the objects collision lists.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_USE_OPEN_HASH) || defined(__DOXYGEN__)
+#define CH_CFG_OBJ_CACHES_USE_OPEN_HASH     FALSE
+#endif
+
+/**
+ * @brief   Maximum load factor of the open addressing hash table.
+ * @details Maximum percentage of hash table slots that can be occupied,
+ *          lower values make probe sequences shorter at the cost of a
+ *          larger table.
+ * @note    Only meaningful if @p CH_CFG_OBJ_CACHES_USE_OPEN_HASH is
+ *          enabled.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_LOAD_FACTOR) || defined(__DOXYGEN__)
+#define CH_CFG_OBJ_CACHES_LOAD_FACTOR       50
+#endif
+
+/**
+ * @brief   Maximum number of objects written in a single flush batch.
+ * @note    A flush operation allocates an array of pointers of this size
+ *          on the stack.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_FLUSH_BATCH) || defined(__DOXYGEN__)
+#define CH_CFG_OBJ_CACHES_FLUSH_BATCH       8
+#endif
+
+/**
+ * @brief   Write-back flusher support.
+ * @details If enabled then a thread can be dedicated to cleaning dirty
+ *          objects when their number exceeds an high watermark, the
+ *          allocation path prefers clean objects over lazy writes.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_USE_FLUSHER) || defined(__DOXYGEN__)
+#define CH_CFG_OBJ_CACHES_USE_FLUSHER       FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_OBJ_CACHES_LOAD_FACTOR < 10) ||                                 \
+    (CH_CFG_OBJ_CACHES_LOAD_FACTOR > 90)
+#error "invalid CH_CFG_OBJ_CACHES_LOAD_FACTOR value"
+#endif
+
+#if CH_CFG_OBJ_CACHES_FLUSH_BATCH < 1
+#error "invalid CH_CFG_OBJ_CACHES_FLUSH_BATCH value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -107,6 +157,41 @@ typedef bool (*oc_writef_t)(objects_cache_t *ocp,
                             oc_object_t *objp,
                             bool async);
 
+/**
+ * @brief   Objects batch write function.
+ * @details Writes synchronously a series of objects belonging to the same
+ *          group and having consecutive keys in ascending order.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objpp     array of pointers to the objects to be written
+ * @param[in] n         number of objects in the array, greater than one
+ * @return              The operation status.
+ * @retval false        if the operation succeeded.
+ * @retval true         if the write operation failed.
+ */
+typedef bool (*oc_writebf_t)(objects_cache_t *ocp,
+                             oc_object_t *objpp[],
+                             ucnt_t n);
+
+/**
+ * @brief   Type of cache statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of lookups finding the object in cache.
+   */
+  ucnt_t                n_hit;
+  /**
+   * @brief   Number of lookups not finding the object in cache.
+   */
+  ucnt_t                n_miss;
+  /**
+   * @brief   Number of cached objects reused for a different identifier.
+   */
+  ucnt_t                n_evict;
+} oc_stats_t;
+
+#if (CH_CFG_OBJ_CACHES_USE_OPEN_HASH == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Structure representing an hash table element.
  */
@@ -120,11 +205,27 @@ struct ch_oc_hash_header {
    */
   oc_object_t           *hash_prev;
 };
+#else
+/**
+ * @brief   Structure representing an hash table element.
+ */
+struct ch_oc_hash_header {
+  /**
+   * @brief   Hash tag of the object in the slot.
+   */
+  uint32_t              tag;
+  /**
+   * @brief   Object in the slot or @p NULL if the slot is free.
+   */
+  oc_object_t           *objp;
+};
+#endif
 
 /**
  * @brief   Structure representing an hash table element.
  */
 struct ch_oc_lru_header {
+#if (CH_CFG_OBJ_CACHES_USE_OPEN_HASH == FALSE) || defined(__DOXYGEN__)
   /**
    * @brief   Next in the collisions list.
    */
@@ -133,6 +234,7 @@ struct ch_oc_lru_header {
    * @brief   Previous in the collisions list.
    */
   oc_object_t           *hash_prev;
+#endif
   /**
    * @brief   Next in the LRU list.
    */
@@ -147,6 +249,7 @@ struct ch_oc_lru_header {
  * @brief   Structure representing a cached object.
  */
 struct ch_oc_object {
+#if (CH_CFG_OBJ_CACHES_USE_OPEN_HASH == FALSE) || defined(__DOXYGEN__)
   /**
    * @brief   Next in the collisions list.
    */
@@ -155,6 +258,7 @@ struct ch_oc_object {
    * @brief   Previous in the collisions list.
    */
   oc_object_t           *hash_prev;
+#endif
   /**
    * @brief   Next in the LRU list.
    */
@@ -231,12 +335,56 @@ struct ch_objects_cache {
    * @brief   Writer functions for cached objects.
    */
   oc_writef_t           writef;
+  /**
+   * @brief   Batch writer function for cached objects or @p NULL.
+   */
+  oc_writebf_t          writebf;
+  /**
+   * @brief   Number of objects in the LRU list requiring a lazy write.
+   */
+  ucnt_t                dirtyn;
+#if (CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Flusher thread reference.
+   */
+  thread_reference_t    flusher;
+  /**
+   * @brief   Number of dirty objects waking up the flusher.
+   */
+  ucnt_t                high_wm;
+  /**
+   * @brief   Number of dirty objects stopping the flusher.
+   */
+  ucnt_t                low_wm;
+#endif
+  /**
+   * @brief   Cache statistics.
+   */
+  oc_stats_t            stats;
 };
 
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Minimum number of hash table elements for a number of objects.
+ * @note    The hash table size must also be a power of two, the value
+ *          returned by this macro must be rounded up accordingly.
+ *
+ * @param[in] objn      number of objects in the cache
+ * @return              The minimum number of hash table elements.
+ *
+ * @api
+ */
+#if (CH_CFG_OBJ_CACHES_USE_OPEN_HASH == FALSE) || defined(__DOXYGEN__)
+#define OC_HASH_MIN_SIZE(objn) (objn)
+#else
+#define OC_HASH_MIN_SIZE(objn)                                              \
+  ((((objn) * 100U) + (CH_CFG_OBJ_CACHES_LOAD_FACTOR - 1U)) /               \
+   CH_CFG_OBJ_CACHES_LOAD_FACTOR)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -263,6 +411,13 @@ extern "C" {
   bool chCacheWriteObject(objects_cache_t *ocp,
                           oc_object_t *objp,
                           bool async);
+  bool chCacheFlushGroup(objects_cache_t *ocp, uint32_t group);
+  bool chCacheFlushAll(objects_cache_t *ocp);
+#if CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE
+  void chCacheSetWatermarks(objects_cache_t *ocp, ucnt_t high, ucnt_t low);
+  msg_t chCacheFlusherDispatchTimeout(objects_cache_t *ocp,
+                                      sysinterval_t timeout);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -271,6 +426,58 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the cache statistics.
+ * @note    Counters are updated under the kernel lock, the returned values
+ *          could be inconsistent if read while the cache is in use.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @return              Pointer to the statistics structure.
+ *
+ * @xclass
+ */
+static inline const oc_stats_t *chCacheGetStatsX(objects_cache_t *ocp) {
+
+  return &ocp->stats;
+}
+
+/**
+ * @brief   Sets the batch writer function of a cache.
+ * @details The batch writer is used by flush operations for writing
+ *          objects with consecutive keys in a single operation, if not
+ *          set then objects are written one by one.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] writebf   pointer to an objects batch writer function or
+ *                      @p NULL
+ *
+ * @xclass
+ */
+static inline void chCacheSetBatchWriterX(objects_cache_t *ocp,
+                                          oc_writebf_t writebf) {
+
+  ocp->writebf = writebf;
+}
+
+#if (CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for the high watermark then cleans the dirty objects.
+ * @note    This function is meant to be called in a loop by a thread
+ *          dedicated to the cache.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @return              The operation status.
+ * @retval MSG_OK       if the dirty objects have been written.
+ * @retval MSG_RESET    if one or more write operations failed.
+ *
+ * @api
+ */
+static inline msg_t chCacheFlusherDispatch(objects_cache_t *ocp) {
+
+  return chCacheFlusherDispatchTimeout(ocp, TIME_INFINITE);
+}
+#endif
+
 /**
  * @brief   Releases an object into the cache.
  * @note    This function gives a meaning to the following flags:
@@ -57,7 +57,12 @@ typedef struct {
   uint8_t               *wrptr;         /**< @brief Write pointer.          */
   uint8_t               *rdptr;         /**< @brief Read pointer.           */
   size_t                cnt;            /**< @brief Bytes in the pipe.      */
+  volatile size_t       wrcnt;          /**< @brief Bytes written counter,
+                                                    SPSC mode only.         */
+  volatile size_t       rdcnt;          /**< @brief Bytes read counter,
+                                                    SPSC mode only.         */
   bool                  reset;          /**< @brief True if in reset state. */
+  bool                  spsc;           /**< @brief True if in SPSC mode.   */
   thread_reference_t    wtr;            /**< @brief Waiting writer.         */
   thread_reference_t    rtr;            /**< @brief Waiting reader.         */
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
@@ -71,6 +76,19 @@ typedef struct {
 #endif
 } pipe_t;
 
+/**
+ * @brief   Structure representing a pipe buffer area.
+ * @details Because of the circular nature of the pipe buffer an area can
+ *          be split in two contiguous spans, the second span is empty
+ *          when the area does not cross the buffer boundary.
+ */
+typedef struct {
+  uint8_t               *p1;            /**< @brief First span pointer.     */
+  size_t                n1;             /**< @brief First span size.        */
+  uint8_t               *p2;            /**< @brief Second span pointer.    */
+  size_t                n2;             /**< @brief Second span size.       */
+} pipe_span_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -91,6 +109,9 @@ typedef struct {
   (uint8_t *)(buffer),                                                      \
   (uint8_t *)(buffer),                                                      \
   (size_t)0,                                                                \
+  (size_t)0,                                                                \
+  (size_t)0,                                                                \
+  false,                                                                    \
   false,                                                                    \
   NULL,                                                                     \
   NULL,                                                                     \
@@ -105,6 +126,9 @@ typedef struct {
   (uint8_t *)(buffer),                                                      \
   (uint8_t *)(buffer),                                                      \
   (size_t)0,                                                                \
+  (size_t)0,                                                                \
+  (size_t)0,                                                                \
+  false,                                                                    \
   false,                                                                    \
   NULL,                                                                     \
   NULL,                                                                     \
@@ -134,11 +158,18 @@ typedef struct {
 extern "C" {
 #endif
   void chPipeObjectInit(pipe_t *pp, uint8_t *buf, size_t n);
+  void chPipeObjectInitSPSC(pipe_t *pp, uint8_t *buf, size_t n);
   void chPipeReset(pipe_t *pp);
   size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
                             size_t n, sysinterval_t timeout);
   size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
                            size_t n, sysinterval_t timeout);
+  size_t chPipeReserveTimeout(pipe_t *pp, size_t n, pipe_span_t *sp,
+                              sysinterval_t timeout);
+  void chPipeCommit(pipe_t *pp, size_t n);
+  size_t chPipePeekTimeout(pipe_t *pp, size_t n, pipe_span_t *sp,
+                           sysinterval_t timeout);
+  void chPipeConsume(pipe_t *pp, size_t n);
 #ifdef __cplusplus
 }
 #endif
@@ -173,6 +204,10 @@ static inline size_t chPipeGetSize(const pipe_t *pp) {
  */
 static inline size_t chPipeGetUsedCount(const pipe_t *pp) {
 
+  if (pp->spsc) {
+    return pp->wrcnt - pp->rdcnt;
+  }
+
   return pp->cnt;
 }
 
@@ -29,6 +29,10 @@
  *          library functions. The main difference is that the OS heap APIs
  *          are guaranteed to be thread safe and there is the ability to
  *          return memory blocks aligned to arbitrary powers of two.<br>
+ *          Optionally, heaps initialized using @p chHeapObjectInitTLSF()
+ *          use a two-level segregated fit allocator instead, allocation
+ *          and release are O(1) and the fragmentation is bounded, the
+ *          API is the same for both kinds of heap.<br>
  * @pre     In order to use the heap APIs the @p CH_CFG_USE_HEAP option must
  *          be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -74,6 +78,45 @@
   ((size_t)((p1) - (p2)))                                                   \
   /*lint -restore*/
 
+#if (CH_CFG_HEAP_USE_TLSF == TRUE) || defined(__DOXYGEN__)
+/*
+ * TLSF block status flags, stored in the lower bits of the size field.
+ */
+#define TLSF_FREE       1U
+#define TLSF_PREV_FREE  2U
+#define TLSF_FLAGS      (TLSF_FREE | TLSF_PREV_FREE)
+
+/*
+ * Size of the fields in front of the block area.
+ */
+#define TLSF_BHDR_SIZE  offsetof(heap_tlsf_block_t, u)
+
+/*
+ * Minimum size of a block area, a free block must be able to contain the
+ * free list links.
+ */
+#define TLSF_MIN_SIZE                                                       \
+  MEM_ALIGN_NEXT(sizeof (heap_header_t), CH_HEAP_ALIGNMENT)
+
+/*
+ * Size of the control structure placed in front of the heap area.
+ */
+#define TLSF_CTL_SIZE                                                       \
+  MEM_ALIGN_NEXT(sizeof (heap_tlsf_t), CH_HEAP_ALIGNMENT)
+
+/*
+ * Maximum size of a block area.
+ */
+#define TLSF_MAX_SIZE                                                       \
+  (((size_t)1 << CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2) - CH_HEAP_ALIGNMENT)
+
+#define T_SIZE(bp)      ((bp)->size & ~(size_t)TLSF_FLAGS)
+
+#define T_AREA(bp)      ((uint8_t *)(bp) + TLSF_BHDR_SIZE)
+
+#define T_NEXT(bp)      ((heap_tlsf_block_t *)(T_AREA(bp) + T_SIZE(bp)))
+#endif /* CH_CFG_HEAP_USE_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -95,6 +138,388 @@ static memory_heap_t default_heap;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_HEAP_USE_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Computes the free list indexes for a block size.
+ *
+ * @param[in] size      block area size
+ * @param[out] flp      first level index
+ * @param[out] slp      second level index
+ *
+ * @notapi
+ */
+static void tlsf_mapping(size_t size, unsigned *flp, unsigned *slp) {
+
+  if (size < ((size_t)1 << CH_HEAP_TLSF_FL_SHIFT)) {
+    *flp = 0U;
+    *slp = (unsigned)(size >> CH_HEAP_ALIGN_SHIFT);
+  }
+  else {
+    unsigned msb = 31U - port_clz32((uint32_t)size);
+
+    *flp = (msb - CH_HEAP_TLSF_FL_SHIFT) + 1U;
+    *slp = (unsigned)(size >> (msb - CH_CFG_HEAP_TLSF_SL_BITS)) &
+           (CH_HEAP_TLSF_SL_COUNT - 1U);
+  }
+}
+
+/**
+ * @brief   Inserts a free block in its segregated list.
+ *
+ * @param[in] ctlp      pointer to the TLSF control structure
+ * @param[in] bp        pointer to the block
+ *
+ * @notapi
+ */
+static void tlsf_insert(heap_tlsf_t *ctlp, heap_tlsf_block_t *bp) {
+  unsigned fl, sl;
+
+  tlsf_mapping(T_SIZE(bp), &fl, &sl);
+  bp->u.free.prev = NULL;
+  bp->u.free.next = ctlp->lists[fl][sl];
+  if (bp->u.free.next != NULL) {
+    bp->u.free.next->u.free.prev = bp;
+  }
+  ctlp->lists[fl][sl] = bp;
+  ctlp->fl_map    |= 1U << fl;
+  ctlp->sl_map[fl] |= 1U << sl;
+}
+
+/**
+ * @brief   Removes a free block from its segregated list.
+ *
+ * @param[in] ctlp      pointer to the TLSF control structure
+ * @param[in] bp        pointer to the block
+ *
+ * @notapi
+ */
+static void tlsf_remove(heap_tlsf_t *ctlp, heap_tlsf_block_t *bp) {
+  unsigned fl, sl;
+
+  tlsf_mapping(T_SIZE(bp), &fl, &sl);
+  if (bp->u.free.next != NULL) {
+    bp->u.free.next->u.free.prev = bp->u.free.prev;
+  }
+  if (bp->u.free.prev != NULL) {
+    bp->u.free.prev->u.free.next = bp->u.free.next;
+  }
+  else {
+    ctlp->lists[fl][sl] = bp->u.free.next;
+    if (bp->u.free.next == NULL) {
+      ctlp->sl_map[fl] &= ~(1U << sl);
+      if (ctlp->sl_map[fl] == 0U) {
+        ctlp->fl_map &= ~(1U << fl);
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Finds a free block of at least the specified size.
+ * @details The size is rounded up to the next list boundary so that any
+ *          block in the found list is large enough, if there is no such
+ *          list then the head of the list containing the size is tried.
+ *
+ * @param[in] ctlp      pointer to the TLSF control structure
+ * @param[in] size      required block area size
+ * @return              A pointer to the found block, still in its list.
+ * @retval NULL         if a suitable block is not available.
+ *
+ * @notapi
+ */
+static heap_tlsf_block_t *tlsf_find(heap_tlsf_t *ctlp, size_t size) {
+  heap_tlsf_block_t *bp;
+  unsigned fl, sl;
+  uint32_t map;
+
+  /* Rounding up to the next list boundary.*/
+  if (size >= ((size_t)1 << CH_HEAP_TLSF_FL_SHIFT)) {
+    unsigned msb = 31U - port_clz32((uint32_t)size);
+    size_t rsize = size + (((size_t)1 << (msb - CH_CFG_HEAP_TLSF_SL_BITS)) -
+                           (size_t)1);
+
+    if (rsize <= TLSF_MAX_SIZE) {
+      tlsf_mapping(rsize, &fl, &sl);
+    }
+    else {
+      fl = CH_HEAP_TLSF_FL_COUNT;
+      sl = 0U;
+    }
+  }
+  else {
+    tlsf_mapping(size, &fl, &sl);
+  }
+
+  if (fl < CH_HEAP_TLSF_FL_COUNT) {
+    /* Non-empty list in the same first level.*/
+    map = ctlp->sl_map[fl] & (~0U << sl);
+    if (map == 0U) {
+      /* Non-empty list in the next first levels.*/
+      map = ctlp->fl_map & (~0U << (fl + 1U));
+      if (map != 0U) {
+        fl = port_ctz32(map);
+        map = ctlp->sl_map[fl];
+      }
+    }
+    if (map != 0U) {
+      return ctlp->lists[fl][port_ctz32(map)];
+    }
+  }
+
+  /* Last chance, a block in the list containing the size could fit.*/
+  tlsf_mapping(size, &fl, &sl);
+  bp = ctlp->lists[fl][sl];
+  if ((bp != NULL) && (T_SIZE(bp) >= size)) {
+    return bp;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Splits a block keeping the first @p size bytes.
+ * @details The excess is made a free block and inserted in its list if
+ *          it is large enough, the block next to the excess is known to
+ *          be in use.
+ *
+ * @param[in] ctlp      pointer to the TLSF control structure
+ * @param[in] bp        pointer to the block
+ * @param[in] size      area size to be kept
+ *
+ * @notapi
+ */
+static void tlsf_trim(heap_tlsf_t *ctlp, heap_tlsf_block_t *bp, size_t size) {
+  heap_tlsf_block_t *np;
+
+  if (T_SIZE(bp) >= size + TLSF_BHDR_SIZE + TLSF_MIN_SIZE) {
+    heap_tlsf_block_t *rp = (heap_tlsf_block_t *)(T_AREA(bp) + size);
+
+    rp->size  = (T_SIZE(bp) - size - TLSF_BHDR_SIZE) | TLSF_FREE;
+    bp->size  = size | (bp->size & TLSF_FLAGS);
+    np        = T_NEXT(rp);
+    np->prev  = rp;
+    np->size |= TLSF_PREV_FREE;
+    tlsf_insert(ctlp, rp);
+  }
+}
+
+/**
+ * @brief   Allocates a block from a TLSF heap.
+ *
+ * @param[in] heapp     pointer to a heap descriptor
+ * @param[in] size      the size of the block to be allocated
+ * @param[in] align     desired memory alignment
+ * @return              A pointer to the aligned allocated block.
+ * @retval NULL         if the block cannot be allocated.
+ *
+ * @notapi
+ */
+static void *tlsf_alloc(memory_heap_t *heapp, size_t size, unsigned align) {
+  heap_tlsf_t *ctlp = heapp->tlsf;
+  heap_tlsf_block_t *bp;
+  size_t bsize, asize;
+  heap_header_t *hp;
+
+  /* Sizes that cannot be represented fail immediately, this also
+     prevents numeric overflows in the following calculations.*/
+  if (size > TLSF_MAX_SIZE - sizeof (heap_header_t) - (size_t)align) {
+    return NULL;
+  }
+
+  /* Size of the block area, it includes the used block header.*/
+  bsize = sizeof (heap_header_t) + MEM_ALIGN_NEXT(size, CH_HEAP_ALIGNMENT);
+
+  /* Blocks with stricter alignment require space for a leading free
+     block.*/
+  if (align > CH_HEAP_ALIGNMENT) {
+    asize = bsize + (size_t)align + TLSF_BHDR_SIZE + TLSF_MIN_SIZE;
+  }
+  else {
+    asize = bsize;
+  }
+
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  bp = tlsf_find(ctlp, asize);
+  if (bp != NULL) {
+    tlsf_remove(ctlp, bp);
+
+    if (align > CH_HEAP_ALIGNMENT) {
+      uint8_t *up = T_AREA(bp) + sizeof (heap_header_t);
+      size_t gap = (size_t)((uint8_t *)MEM_ALIGN_NEXT(up, align) - up);
+
+      if (gap > 0U) {
+        heap_tlsf_block_t *ap;
+
+        /* The gap must be able to contain a free block.*/
+        while (gap < TLSF_BHDR_SIZE + TLSF_MIN_SIZE) {
+          gap += (size_t)align;
+        }
+
+        /* The leading part becomes a free block, the previous block is
+           in use because free blocks are always merged.*/
+        ap = (heap_tlsf_block_t *)((uint8_t *)bp + gap);
+        ap->size = (T_SIZE(bp) - gap) | TLSF_PREV_FREE;
+        ap->prev = bp;
+        bp->size = (gap - TLSF_BHDR_SIZE) | (bp->size & TLSF_FLAGS);
+        tlsf_insert(ctlp, bp);
+        bp = ap;
+      }
+    }
+
+    /* Excess space returned to the free lists.*/
+    tlsf_trim(ctlp, bp, bsize);
+
+    /* Marking the block as used.*/
+    bp->size &= ~(size_t)TLSF_FREE;
+    T_NEXT(bp)->size &= ~(size_t)TLSF_PREV_FREE;
+
+    /* Setting in the block owner heap and size.*/
+    hp = &bp->u.header;
+    H_SIZE(hp) = size;
+    H_HEAP(hp) = heapp;
+
+    /* Releasing heap mutex/semaphore.*/
+    H_UNLOCK(heapp);
+
+    /*lint -save -e9087 [11.3] Safe cast.*/
+    return (void *)H_BLOCK(hp);
+    /*lint -restore*/
+  }
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+
+  /* More memory is required, tries to get it from the associated provider
+     else fails. The obtained area is made a block followed by a terminator
+     block, it will join the free lists when released.*/
+  if (heapp->provider != NULL) {
+    uint8_t *p;
+
+    p = heapp->provider((bsize - sizeof (heap_header_t)) + TLSF_BHDR_SIZE,
+                        align,
+                        TLSF_BHDR_SIZE + sizeof (heap_header_t));
+    if (p != NULL) {
+      heap_tlsf_block_t *np;
+
+      bp = (heap_tlsf_block_t *)(p - TLSF_BHDR_SIZE - sizeof (heap_header_t));
+      bp->prev = NULL;
+      bp->size = bsize;
+      np = T_NEXT(bp);
+      np->prev = bp;
+      np->size = 0U;
+
+      hp = &bp->u.header;
+      H_SIZE(hp) = size;
+      H_HEAP(hp) = heapp;
+
+      return (void *)p;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Returns a block to a TLSF heap.
+ *
+ * @param[in] heapp     pointer to the owner heap descriptor
+ * @param[in] hp        pointer to the used block header
+ *
+ * @notapi
+ */
+static void tlsf_free(memory_heap_t *heapp, heap_header_t *hp) {
+  heap_tlsf_t *ctlp = heapp->tlsf;
+  heap_tlsf_block_t *bp, *np;
+
+  bp = (heap_tlsf_block_t *)((uint8_t *)hp - TLSF_BHDR_SIZE);
+
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  chDbgAssert((bp->size & TLSF_FREE) == 0U, "not in use");
+
+  /* Merging with the previous block.*/
+  if ((bp->size & TLSF_PREV_FREE) != 0U) {
+    heap_tlsf_block_t *pp = bp->prev;
+
+    tlsf_remove(ctlp, pp);
+    pp->size += TLSF_BHDR_SIZE + T_SIZE(bp);
+    bp = pp;
+  }
+
+  /* Merging with the next block.*/
+  np = T_NEXT(bp);
+  if ((np->size & TLSF_FREE) != 0U) {
+    tlsf_remove(ctlp, np);
+    bp->size += TLSF_BHDR_SIZE + T_SIZE(np);
+    np = T_NEXT(bp);
+  }
+
+  /* Inserting the resulting block.*/
+  bp->size |= TLSF_FREE;
+  np->prev  = bp;
+  np->size |= TLSF_PREV_FREE;
+  tlsf_insert(ctlp, bp);
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+}
+
+/**
+ * @brief   Reports the status of a TLSF heap.
+ *
+ * @param[in] heapp     pointer to a heap descriptor
+ * @param[in] totalp    pointer to a variable that will receive the total
+ *                      fragmented free space or @p NULL
+ * @param[in] largestp  pointer to a variable that will receive the largest
+ *                      free free block found space or @p NULL
+ * @return              The number of fragments in the heap.
+ *
+ * @notapi
+ */
+static size_t tlsf_status(memory_heap_t *heapp,
+                          size_t *totalp, size_t *largestp) {
+  heap_tlsf_t *ctlp = heapp->tlsf;
+  size_t n, total, largest;
+  unsigned fl, sl;
+
+  H_LOCK(heapp);
+  n = 0U;
+  total = 0U;
+  largest = 0U;
+  for (fl = 0U; fl < CH_HEAP_TLSF_FL_COUNT; fl++) {
+    for (sl = 0U; sl < CH_HEAP_TLSF_SL_COUNT; sl++) {
+      heap_tlsf_block_t *bp = ctlp->lists[fl][sl];
+
+      while (bp != NULL) {
+        /* Space usable by an allocation.*/
+        size_t size = T_SIZE(bp) - sizeof (heap_header_t);
+
+        n++;
+        total += size;
+        if (size > largest) {
+          largest = size;
+        }
+        bp = bp->u.free.next;
+      }
+    }
+  }
+
+  if (totalp != NULL) {
+    *totalp = total;
+  }
+
+  if (largestp != NULL) {
+    *largestp = largest;
+  }
+  H_UNLOCK(heapp);
+
+  return n;
+}
+#endif /* CH_CFG_HEAP_USE_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -109,6 +534,9 @@ void __heap_init(void) {
   default_heap.provider = chCoreAllocAlignedWithOffset;
   H_NEXT(&default_heap.header) = NULL;
   H_PAGES(&default_heap.header) = 0;
+#if CH_CFG_HEAP_USE_TLSF == TRUE
+  default_heap.tlsf = NULL;
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&default_heap.mtx);
 #else
@@ -145,16 +573,89 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
   H_PAGES(&heapp->header) = 0;
   H_NEXT(hp) = NULL;
   H_PAGES(hp) = (size - sizeof (heap_header_t)) / CH_HEAP_ALIGNMENT;
+#if CH_CFG_HEAP_USE_TLSF == TRUE
+  heapp->tlsf = NULL;
+#endif
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+  chMtxObjectInit(&heapp->mtx);
+#else
+  chSemObjectInit(&heapp->sem, (cnt_t)1);
+#endif
+}
+
+#if (CH_CFG_HEAP_USE_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a TLSF memory heap from a static memory area.
+ * @details The TLSF control structure is placed at the beginning of the
+ *          memory area, the remaining space forms the initial free block.
+ *          The optional provider is used when the heap space is exhausted,
+ *          the obtained blocks join the heap when released.
+ * @note    The heap buffer base and size are adjusted if the passed buffer
+ *          is not aligned to @p CH_HEAP_ALIGNMENT. This mean that the
+ *          effective heap size can be less than @p size.
+ * @note    Space exceeding the maximum TLSF block size is not used.
+ *
+ * @param[out] heapp    pointer to the memory heap descriptor to be initialized
+ * @param[in] buf       heap buffer base
+ * @param[in] size      heap size
+ * @param[in] provider  memory blocks provider for this heap or @p NULL
+ *
+ * @init
+ */
+void chHeapObjectInitTLSF(memory_heap_t *heapp, void *buf, size_t size,
+                          memgetfunc2_t provider) {
+  uint8_t *p = (uint8_t *)MEM_ALIGN_NEXT(buf, CH_HEAP_ALIGNMENT);
+  heap_tlsf_block_t *bp, *np;
+  unsigned fl, sl;
+
+  chDbgCheck((heapp != NULL) && (buf != NULL));
+
+  /* Adjusting the size in case the initial block was not correctly
+     aligned.*/
+  /*lint -save -e9033 [10.8] Required cast operations.*/
+  size -= (size_t)(p - (uint8_t *)buf);
+  /*lint restore*/
+  size = MEM_ALIGN_PREV(size, CH_HEAP_ALIGNMENT);
+
+  chDbgCheck(size >= TLSF_CTL_SIZE + (TLSF_BHDR_SIZE * 2U) + TLSF_MIN_SIZE);
+
+  /* Control structure at the beginning of the area.*/
+  heapp->provider = provider;
+  H_NEXT(&heapp->header) = NULL;
+  H_PAGES(&heapp->header) = 0;
+  heapp->tlsf = (heap_tlsf_t *)p;
+  heapp->tlsf->fl_map = 0U;
+  for (fl = 0U; fl < CH_HEAP_TLSF_FL_COUNT; fl++) {
+    heapp->tlsf->sl_map[fl] = 0U;
+    for (sl = 0U; sl < CH_HEAP_TLSF_SL_COUNT; sl++) {
+      heapp->tlsf->lists[fl][sl] = NULL;
+    }
+  }
+
+  /* Initial free block followed by a terminator block, the terminator
+     is marked as used so it is never merged.*/
+  size -= TLSF_CTL_SIZE + (TLSF_BHDR_SIZE * 2U);
+  if (size > TLSF_MAX_SIZE) {
+    size = TLSF_MAX_SIZE;
+  }
+  bp = (heap_tlsf_block_t *)(p + TLSF_CTL_SIZE);
+  bp->prev = NULL;
+  bp->size = size | TLSF_FREE;
+  np = T_NEXT(bp);
+  np->prev = bp;
+  np->size = TLSF_PREV_FREE;
+  tlsf_insert(heapp->tlsf, bp);
+
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&heapp->mtx);
 #else
   chSemObjectInit(&heapp->sem, (cnt_t)1);
 #endif
 }
+#endif /* CH_CFG_HEAP_USE_TLSF == TRUE */
 
 /**
- * @brief   Allocates a block of memory from the heap by using the first-fit
- *          algorithm.
+ * @brief   Allocates a block of memory from the heap.
  * @details The allocated block is guaranteed to be properly aligned to the
  *          specified alignment.
  *
@@ -185,6 +686,12 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
     align = CH_HEAP_ALIGNMENT;
   }
 
+#if CH_CFG_HEAP_USE_TLSF == TRUE
+  if (heapp->tlsf != NULL) {
+    return tlsf_alloc(heapp, size, align);
+  }
+#endif
+
   /* Size is converted in number of elementary allocation units.*/
   pages = MEM_ALIGN_NEXT(size, CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
 
@@ -300,6 +807,14 @@ void chHeapFree(void *p) {
   hp = (heap_header_t *)p - 1U;
   /*lint -restore*/
   heapp = H_HEAP(hp);
+
+#if CH_CFG_HEAP_USE_TLSF == TRUE
+  if (heapp->tlsf != NULL) {
+    tlsf_free(heapp, hp);
+    return;
+  }
+#endif
+
   qp = &heapp->header;
 
   /* Size is converted in number of elementary allocation units.*/
@@ -362,6 +877,12 @@ size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
     heapp = &default_heap;
   }
 
+#if CH_CFG_HEAP_USE_TLSF == TRUE
+  if (heapp->tlsf != NULL) {
+    return tlsf_status(heapp, totalp, largestp);
+  }
+#endif
+
   H_LOCK(heapp);
   tpages = 0U;
   lpages = 0U;
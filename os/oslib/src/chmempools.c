@@ -29,7 +29,10 @@
  *          problems.<br>
  *          Memory Pools do not enforce any alignment constraint on the
  *          contained object however the objects must be properly aligned
- *          to contain a pointer to void.
+ *          to contain a pointer to void.<br>
+ *          Optionally, threads can access a pool through a private
+ *          magazine, a small cache of objects accessed without locking
+ *          the kernel, objects are exchanged with the pool in batches.
  * @pre     In order to use the memory pools APIs the @p CH_CFG_USE_MEMPOOLS option
  *          must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -56,6 +59,94 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Checks the magazine ownership.
+ * @details The magazine is bound to the first thread using it.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ *
+ * @notapi
+ */
+static inline void mag_check_owner(pool_magazine_t *mgp) {
+
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+  if (mgp->owner == NULL) {
+    mgp->owner = chThdGetSelfX();
+  }
+  chDbgAssert(mgp->owner == chThdGetSelfX(), "not owner");
+#else
+  (void)mgp;
+#endif
+}
+
+/**
+ * @brief   Moves a batch of objects from the pool into the magazine.
+ * @note    The pool provider is used if the pool runs out of objects.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ *
+ * @notapi
+ */
+static void mag_refill(pool_magazine_t *mgp) {
+  struct pool_header *php;
+  size_t n = 0U;
+
+  chSysLock();
+  while (n < mgp->batch) {
+    php = chPoolAllocI(mgp->pool);
+    if (php == NULL) {
+      break;
+    }
+    php->next = mgp->next;
+    mgp->next = php;
+    n++;
+  }
+  chSysUnlock();
+
+  if (n > 0U) {
+    mgp->cnt += n;
+    mgp->stats.n_refill++;
+  }
+}
+
+/**
+ * @brief   Moves a batch of objects from the magazine into the pool.
+ * @details The batch is detached without locking then linked to the pool
+ *          in a single short critical section.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @param[in] n         number of objects to be moved
+ *
+ * @notapi
+ */
+static void mag_drain(pool_magazine_t *mgp, size_t n) {
+  struct pool_header *first, *last;
+  size_t i;
+
+  if (n == 0U) {
+    return;
+  }
+
+  /* Detaching the first n objects.*/
+  first = mgp->next;
+  last = first;
+  for (i = 1U; i < n; i++) {
+    last = last->next;
+  }
+  mgp->next = last->next;
+  mgp->cnt -= n;
+
+  /* Linking the batch in front of the pool list.*/
+  chSysLock();
+  last->next = mgp->pool->next;
+  mgp->pool->next = first;
+  chSysUnlock();
+
+  mgp->stats.n_drain++;
+}
+#endif /* CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -331,6 +422,133 @@ void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp) {
 }
 #endif
 
+#if (CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a memory pool magazine.
+ * @details The magazine is initially empty, it gets objects from the
+ *          pool on the first allocation.
+ *
+ * @param[out] mgp      pointer to a @p pool_magazine_t structure
+ * @param[in] mp        pointer to the associated @p memory_pool_t structure
+ * @param[in] size      maximum number of cached objects
+ * @param[in] batch     number of objects exchanged with the pool in a
+ *                      single operation, must be between one and @p size
+ *
+ * @init
+ */
+void chPoolMagazineObjectInit(pool_magazine_t *mgp, memory_pool_t *mp,
+                              size_t size, size_t batch) {
+
+  chDbgCheck((mgp != NULL) && (mp != NULL) &&
+             (batch > 0U) && (batch <= size));
+
+  mgp->pool     = mp;
+  mgp->next     = NULL;
+  mgp->cnt      = (size_t)0;
+  mgp->size     = size;
+  mgp->batch    = batch;
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+  mgp->owner    = NULL;
+#endif
+  mgp->stats.n_alloc     = (ucnt_t)0;
+  mgp->stats.n_alloc_hit = (ucnt_t)0;
+  mgp->stats.n_free      = (ucnt_t)0;
+  mgp->stats.n_free_hit  = (ucnt_t)0;
+  mgp->stats.n_refill    = (ucnt_t)0;
+  mgp->stats.n_drain     = (ucnt_t)0;
+}
+
+/**
+ * @brief   Allocates an object through a magazine.
+ * @details The object is taken from the magazine without locking, if the
+ *          magazine is empty then a batch of objects is obtained from the
+ *          pool first.
+ * @note    The magazine must only be used by its owner thread.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if both the magazine and the pool are empty.
+ *
+ * @api
+ */
+void *chPoolMagazineAlloc(pool_magazine_t *mgp) {
+  struct pool_header *php;
+
+  chDbgCheck(mgp != NULL);
+  mag_check_owner(mgp);
+
+  mgp->stats.n_alloc++;
+  if (mgp->next != NULL) {
+    mgp->stats.n_alloc_hit++;
+  }
+  else {
+    mag_refill(mgp);
+    if (mgp->next == NULL) {
+      return NULL;
+    }
+  }
+
+  php = mgp->next;
+  mgp->next = php->next;
+  mgp->cnt--;
+
+  return (void *)php;
+}
+
+/**
+ * @brief   Releases an object through a magazine.
+ * @details The object is put in the magazine without locking, if the
+ *          magazine is full then a batch of objects is returned to the
+ *          pool first.
+ * @note    The magazine must only be used by its owner thread.
+ * @pre     The freed object must belong to the pool associated to the
+ *          magazine.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @api
+ */
+void chPoolMagazineFree(pool_magazine_t *mgp, void *objp) {
+  struct pool_header *php = objp;
+
+  chDbgCheck((mgp != NULL) && (objp != NULL) &&
+             MEM_IS_ALIGNED(objp, mgp->pool->align));
+  mag_check_owner(mgp);
+
+  mgp->stats.n_free++;
+  if (mgp->cnt < mgp->size) {
+    mgp->stats.n_free_hit++;
+  }
+  else {
+    mag_drain(mgp, mgp->batch);
+  }
+
+  php->next = mgp->next;
+  mgp->next = php;
+  mgp->cnt++;
+}
+
+/**
+ * @brief   Returns all the cached objects to the pool.
+ * @note    The magazine is also unbound from its owner thread.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ *
+ * @api
+ */
+void chPoolMagazineFlush(pool_magazine_t *mgp) {
+
+  chDbgCheck(mgp != NULL);
+  mag_check_owner(mgp);
+
+  mag_drain(mgp, mgp->cnt);
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+  mgp->owner = NULL;
+#endif
+}
+#endif /* CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE */
+
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
 /** @} */
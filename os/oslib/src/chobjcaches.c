@@ -34,6 +34,20 @@
  *          should be dimensioned to minimize the risk of hash collisions,
  *          a factor of two is usually acceptable, it depends on the specific
  *          application requirements.<br>
+ *          If @p CH_CFG_OBJ_CACHES_USE_OPEN_HASH is enabled then the hash
+ *          table is an open addressing table of compact tags probed
+ *          linearly, lookups scan a contiguous memory area and objects
+ *          are only accessed when their tag matches. The table must be
+ *          large enough to respect @p CH_CFG_OBJ_CACHES_LOAD_FACTOR.<br>
+ *          Hit, miss and eviction counters are kept in the cache object
+ *          and can be used for tuning the cache size.<br>
+ *          Objects marked for lazy write can be written back explicitly
+ *          using the flush functions, objects with consecutive keys are
+ *          written in batches if a batch writer function is set.<br>
+ *          If @p CH_CFG_OBJ_CACHES_USE_FLUSHER is enabled then a dedicated
+ *          thread can clean dirty objects in background when their number
+ *          exceeds an high watermark, meanwhile the allocation path takes
+ *          clean objects from the LRU list skipping the dirty ones.<br>
  *          Operations defined for caches:
  *          - <b>Get Object</b>: Retrieves an object from cache, if not
  *            present then an empty buffer is returned.
@@ -59,6 +73,7 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_OBJ_CACHES_USE_OPEN_HASH == FALSE) || defined(__DOXYGEN__)
 /* Default hash function.*/
 #if !defined(OC_HASH_FUNCTION) || defined(__DOXYGEN__)
 #define OC_HASH_FUNCTION(ocp, group, key)                                   \
@@ -76,11 +91,32 @@
 }
 
 /* Removal of an object from the hash.*/
-#define HASH_REMOVE(objp) {                                                 \
+#define HASH_REMOVE(ocp, objp) {                                            \
   (objp)->hash_prev->hash_next = (objp)->hash_next;                         \
   (objp)->hash_next->hash_prev = (objp)->hash_prev;                         \
 }
 
+#else /* CH_CFG_OBJ_CACHES_USE_OPEN_HASH == TRUE */
+/* Default tag function.*/
+#if !defined(OC_HASH_TAG_FUNCTION)
+#define OC_HASH_TAG_FUNCTION(group, key)                                    \
+  (((uint32_t)(key) ^ ((uint32_t)(group) * 0x9E3779B1U)) * 0x85EBCA6BU)
+#endif
+
+/* Home slot of a tag, the lower bits of a product only depend on the lower
+   bits of the operands so the upper half is folded in before masking.*/
+#define HASH_SLOT(ocp, tag)                                                 \
+  ((ucnt_t)((uint32_t)(tag) ^ ((uint32_t)(tag) >> 16)) &                    \
+   ((ocp)->hashn - (ucnt_t)1))
+
+/* Insertion into the hash table.*/
+#define HASH_INSERT(ocp, objp, group, key)                                  \
+  hash_insert_s(ocp, objp, OC_HASH_TAG_FUNCTION(group, key))
+
+/* Removal of an object from the hash.*/
+#define HASH_REMOVE(ocp, objp) hash_remove_s(ocp, objp)
+#endif /* CH_CFG_OBJ_CACHES_USE_OPEN_HASH == TRUE */
+
 /* Insertion on LRU list head (newer objects).*/
 #define LRU_INSERT_HEAD(ocp, objp) {                                        \
   (objp)->lru_next = (ocp)->lru.lru_next;                                   \
@@ -97,12 +133,25 @@
   (ocp)->lru.lru_prev = (objp);                                             \
 }
 
+/* Insertion on LRU list after a newer object.*/
+#define LRU_INSERT_AFTER(posp, objp) {                                      \
+  (objp)->lru_prev = (posp);                                                \
+  (objp)->lru_next = (posp)->lru_next;                                      \
+  (posp)->lru_next->lru_prev = (objp);                                      \
+  (posp)->lru_next = (objp);                                                \
+}
+
 /* Removal of an object from the LRU list.*/
 #define LRU_REMOVE(objp) {                                                  \
   (objp)->lru_prev->lru_next = (objp)->lru_next;                            \
   (objp)->lru_next->lru_prev = (objp)->lru_prev;                            \
 }
 
+/* Checks if an object is in the LRU list and requires a lazy write.*/
+#define OBJ_IS_DIRTY(objp)                                                  \
+  (((objp)->obj_flags & (OC_FLAG_INLRU | OC_FLAG_LAZYWRITE)) ==             \
+   (OC_FLAG_INLRU | OC_FLAG_LAZYWRITE))
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -119,6 +168,7 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_OBJ_CACHES_USE_OPEN_HASH == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Returns an object pointer from the cache, if present.
  *
@@ -154,6 +204,98 @@ static oc_object_t *hash_get_s(objects_cache_t *ocp,
   return NULL;
 }
 
+#else /* CH_CFG_OBJ_CACHES_USE_OPEN_HASH == TRUE */
+static oc_object_t *hash_get_s(objects_cache_t *ocp,
+                               uint32_t group,
+                               uint32_t key) {
+  uint32_t tag = OC_HASH_TAG_FUNCTION(group, key);
+  ucnt_t i = HASH_SLOT(ocp, tag);
+
+  /* Linear probing until a free slot, the load factor guarantees that
+     free slots exist. Objects are only accessed on tag match.*/
+  while (ocp->hashp[i].objp != NULL) {
+    if (ocp->hashp[i].tag == tag) {
+      oc_object_t *objp = ocp->hashp[i].objp;
+
+      if ((objp->obj_key == key) && (objp->obj_group == group)) {
+
+        /* Cache hit.*/
+        return objp;
+      }
+    }
+    i = (i + (ucnt_t)1) & (ocp->hashn - (ucnt_t)1);
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Inserts an object in the open addressing hash table.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the object to be inserted
+ * @param[in] tag       hash tag of the object
+ *
+ * @notapi
+ */
+static void hash_insert_s(objects_cache_t *ocp,
+                          oc_object_t *objp,
+                          uint32_t tag) {
+  ucnt_t i = HASH_SLOT(ocp, tag);
+
+  while (ocp->hashp[i].objp != NULL) {
+    i = (i + (ucnt_t)1) & (ocp->hashn - (ucnt_t)1);
+  }
+
+  ocp->hashp[i].tag  = tag;
+  ocp->hashp[i].objp = objp;
+}
+
+/**
+ * @brief   Removes an object from the open addressing hash table.
+ * @details The slots following the removed one are shifted back in order
+ *          to keep probe sequences unbroken, no tombstones are required.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the object to be removed
+ *
+ * @notapi
+ */
+static void hash_remove_s(objects_cache_t *ocp, oc_object_t *objp) {
+  ucnt_t mask = ocp->hashn - (ucnt_t)1;
+  ucnt_t i, j;
+
+  /* Searching for the object slot, it is in the table for sure.*/
+  i = HASH_SLOT(ocp, OC_HASH_TAG_FUNCTION(objp->obj_group, objp->obj_key));
+  while (ocp->hashp[i].objp != objp) {
+    chDbgAssert(ocp->hashp[i].objp != NULL, "not in hash");
+
+    i = (i + (ucnt_t)1) & mask;
+  }
+
+  /* Backward shift of the slots following the freed one.*/
+  j = i;
+  while (true) {
+    ucnt_t home;
+
+    j = (j + (ucnt_t)1) & mask;
+    if (ocp->hashp[j].objp == NULL) {
+      break;
+    }
+
+    /* An element can fill the hole only if its home slot does not lie
+       cyclically in (i, j].*/
+    home = HASH_SLOT(ocp, ocp->hashp[j].tag);
+    if (((j - home) & mask) >= ((j - i) & mask)) {
+      ocp->hashp[i] = ocp->hashp[j];
+      i = j;
+    }
+  }
+
+  ocp->hashp[i].objp = NULL;
+}
+#endif /* CH_CFG_OBJ_CACHES_USE_OPEN_HASH == TRUE */
+
 /**
  * @brief   Gets the least recently used object buffer from the LRU list.
  *
@@ -169,10 +311,33 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
     /* Waiting for an object buffer to become available in the LRU.*/
     (void) chSemWaitS(&ocp->lru_sem);
 
+    /* The object signaled to this thread could have been taken by a cache
+       hit before this thread could run, waiting again in that case.*/
+    if (ocp->lru.lru_prev == (oc_object_t *)&ocp->lru) {
+      continue;
+    }
+
     /* Now an object buffer is in the LRU for sure, taking it from the
        LRU tail.*/
     objp = ocp->lru.lru_prev;
 
+#if CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE
+    /* Dirty objects are left to the flusher, taking the least recently
+       used clean object instead, if any.*/
+    if ((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) {
+      oc_object_t *cobjp = objp->lru_prev;
+
+      while ((cobjp != (oc_object_t *)&ocp->lru) &&
+             ((cobjp->obj_flags & OC_FLAG_LAZYWRITE) != 0U)) {
+        cobjp = cobjp->lru_prev;
+      }
+      if (cobjp != (oc_object_t *)&ocp->lru) {
+        objp = cobjp;
+      }
+      chThdResumeI(&ocp->flusher, MSG_OK);
+    }
+#endif
+
     chDbgAssert((objp->obj_flags & OC_FLAG_INLRU) == OC_FLAG_INLRU,
                 "not in LRU");
     chDbgAssert(chSemGetCounterI(&objp->obj_sem) == (cnt_t)1,
@@ -180,6 +345,9 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
 
     LRU_REMOVE(objp);
     objp->obj_flags &= ~OC_FLAG_INLRU;
+    if ((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) {
+      ocp->dirtyn--;
+    }
 
     /* Getting the object semaphore, we know there is no wait so
        using the "fast" variant.*/
@@ -191,7 +359,8 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
 
       /* Removing from hash table if required.*/
       if ((objp->obj_flags & OC_FLAG_INHASH) != 0U) {
-        HASH_REMOVE(objp);
+        HASH_REMOVE(ocp, objp);
+        ocp->stats.n_evict++;
       }
 
       /* Removing all flags, it is "new" now.*/
@@ -201,6 +370,11 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
     }
 
 
+#if CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE
+    /* The flusher could have been awakened.*/
+    chSchRescheduleS();
+#endif
+
     /* Out of critical section.*/
     chSysUnlock();
 
@@ -215,6 +389,161 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
   }
 }
 
+/**
+ * @brief   Writes a batch of objects.
+ * @note    Objects that cannot be written are marked for lazy write again.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objpp     array of pointers to the objects to be written
+ * @param[in] n         number of objects in the array
+ * @return              The operation status.
+ * @retval false        if the operation succeeded.
+ * @retval true         if one or more write operations failed.
+ *
+ * @notapi
+ */
+static bool flush_write(objects_cache_t *ocp,
+                        oc_object_t *objpp[],
+                        ucnt_t n) {
+  bool err = false;
+  ucnt_t i;
+
+  if ((ocp->writebf != NULL) && (n > (ucnt_t)1)) {
+    if (ocp->writebf(ocp, objpp, n)) {
+      for (i = (ucnt_t)0; i < n; i++) {
+        objpp[i]->obj_flags |= OC_FLAG_LAZYWRITE;
+      }
+      err = true;
+    }
+  }
+  else {
+    for (i = (ucnt_t)0; i < n; i++) {
+      if (ocp->writef(ocp, objpp[i], false)) {
+        objpp[i]->obj_flags |= OC_FLAG_LAZYWRITE;
+        err = true;
+      }
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Writes the dirty objects in the LRU list.
+ * @details Dirty objects with consecutive keys are taken from the LRU list
+ *          and written together, then released.
+ * @note    Objects owned by threads are not written.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] all       flushes all groups if @p true
+ * @param[in] group     group to be flushed if @p all is @p false
+ * @param[in] target    number of dirty objects stopping the operation
+ * @return              The operation status.
+ * @retval false        if the operation succeeded.
+ * @retval true         if one or more write operations failed.
+ *
+ * @notapi
+ */
+static bool flush_s(objects_cache_t *ocp,
+                    bool all,
+                    uint32_t group,
+                    ucnt_t target) {
+  oc_object_t *batch[CH_CFG_OBJ_CACHES_FLUSH_BATCH];
+  oc_object_t *pos[CH_CFG_OBJ_CACHES_FLUSH_BATCH];
+  bool err = false;
+  ucnt_t i, j, n;
+
+  for (i = (ucnt_t)0; (i < ocp->objn) && (ocp->dirtyn > target); i++) {
+    oc_object_t *objp = (oc_object_t *)((uint8_t *)ocp->objvp +
+                                        ((size_t)i * ocp->objsz));
+    uint32_t key;
+
+    if (!OBJ_IS_DIRTY(objp) || (!all && (objp->obj_group != group))) {
+      continue;
+    }
+
+    /* Searching backward for the first key of the run.*/
+    key = objp->obj_key;
+    while (key > 0U) {
+      oc_object_t *prevp = hash_get_s(ocp, objp->obj_group, key - 1U);
+
+      if ((prevp == NULL) || !OBJ_IS_DIRTY(prevp)) {
+        break;
+      }
+      objp = prevp;
+      key--;
+    }
+
+    /* Taking ownership of the objects with consecutive keys, the newer
+       neighbor of each object is recorded in order to put it back in the
+       same LRU position.*/
+    n = (ucnt_t)0;
+    do {
+      /* If a thread has been woken on the LRU semaphore but did not run
+         yet then the LRU objects are reserved to it.*/
+      if (chSemGetCounterI(&ocp->lru_sem) <= (cnt_t)0) {
+        break;
+      }
+
+      pos[n] = objp->lru_prev;
+      LRU_REMOVE(objp);
+      objp->obj_flags &= ~(OC_FLAG_INLRU | OC_FLAG_LAZYWRITE);
+      ocp->dirtyn--;
+      chSemFastWaitI(&ocp->lru_sem);
+      chSemFastWaitI(&objp->obj_sem);
+      batch[n++] = objp;
+
+      key++;
+      objp = NULL;
+      if ((key != 0U) && (n < (ucnt_t)CH_CFG_OBJ_CACHES_FLUSH_BATCH)) {
+        objp = hash_get_s(ocp, batch[0]->obj_group, key);
+      }
+    } while ((objp != NULL) && OBJ_IS_DIRTY(objp));
+
+    if (n == (ucnt_t)0) {
+      continue;
+    }
+
+    /* Writing outside the critical section.*/
+    chSysUnlock();
+    if (flush_write(ocp, batch, n)) {
+      err = true;
+    }
+    chSysLock();
+
+    /* Returning the objects to the cache in reverse order, so the newer
+       neighbors that were part of the batch are back in the LRU.*/
+    for (j = n; j > (ucnt_t)0; j--) {
+      oc_object_t *posp = pos[j - (ucnt_t)1];
+
+      objp = batch[j - (ucnt_t)1];
+
+      /* The original position is kept if there are no threads waiting for
+         the object and the newer neighbor is still in the LRU, else it is
+         released normally.*/
+      if ((chSemGetCounterI(&objp->obj_sem) == (cnt_t)0) &&
+          ((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U) &&
+          ((posp == (oc_object_t *)&ocp->lru) ||
+           ((posp->obj_flags & OC_FLAG_INLRU) != 0U))) {
+        LRU_INSERT_AFTER(posp, objp);
+        objp->obj_flags &= OC_FLAG_INHASH | OC_FLAG_LAZYWRITE;
+        objp->obj_flags |= OC_FLAG_INLRU;
+        if ((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) {
+          ocp->dirtyn++;
+        }
+        chSemSignalI(&ocp->lru_sem);
+        chSemFastSignalI(&objp->obj_sem);
+      }
+      else {
+        chCacheReleaseObjectI(ocp, objp);
+      }
+    }
+    chSchRescheduleS();
+  }
+
+  return err;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -225,7 +554,8 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
  * @param[out] ocp      pointer to the @p objects_cache_t structure to be
  *                      initialized
  * @param[in] hashn     number of elements in the hash table array, must be
- *                      a power of two and not lower than @p objn
+ *                      a power of two and not lower than
+ *                      <tt>OC_HASH_MIN_SIZE(objn)</tt>
  * @param[in] hashp     pointer to the hash table as an array of
  *                      @p oc_hash_header_t
  * @param[in] objn      number of elements in the objects table array
@@ -249,7 +579,7 @@ void chCacheObjectInit(objects_cache_t *ocp,
 
   chDbgCheck((ocp != NULL) && (hashp != NULL) && (objvp != NULL) &&
              ((hashn & (hashn - (ucnt_t)1)) == (ucnt_t)0) &&
-             (objn > (ucnt_t)0) && (hashn >= objn) &&
+             (objn > (ucnt_t)0) && (hashn >= OC_HASH_MIN_SIZE(objn)) &&
              (objsz >= sizeof (oc_object_t)) &&
              ((objsz & (PORT_NATURAL_ALIGN - 1U)) == 0U));
 
@@ -258,18 +588,36 @@ void chCacheObjectInit(objects_cache_t *ocp,
   ocp->hashn            = hashn;
   ocp->hashp            = hashp;
   ocp->objn             = objn;
+  ocp->objsz            = objsz;
   ocp->objvp            = objvp;
   ocp->readf            = readf;
   ocp->writef           = writef;
+  ocp->writebf          = NULL;
+  ocp->dirtyn           = (ucnt_t)0;
+#if CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE
+  ocp->flusher          = NULL;
+  ocp->high_wm          = objn / (ucnt_t)2;
+  ocp->low_wm           = objn / (ucnt_t)4;
+#endif
+  ocp->stats.n_hit      = (ucnt_t)0;
+  ocp->stats.n_miss     = (ucnt_t)0;
+  ocp->stats.n_evict    = (ucnt_t)0;
+#if CH_CFG_OBJ_CACHES_USE_OPEN_HASH == FALSE
   ocp->lru.hash_next    = NULL;
   ocp->lru.hash_prev    = NULL;
+#endif
   ocp->lru.lru_next     = (oc_object_t *)&ocp->lru;
   ocp->lru.lru_prev     = (oc_object_t *)&ocp->lru;
 
   /* Hash headers initialization.*/
   do {
+#if CH_CFG_OBJ_CACHES_USE_OPEN_HASH == FALSE
     hashp->hash_next = (oc_object_t *)hashp;
     hashp->hash_prev = (oc_object_t *)hashp;
+#else
+    hashp->tag       = 0U;
+    hashp->objp      = NULL;
+#endif
     hashp++;
   } while (hashp < &ocp->hashp[ocp->hashn]);
 
@@ -312,6 +660,7 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
   /* Checking the cache for a hit.*/
   objp = hash_get_s(ocp, group, key);
   if (objp != NULL) {
+    ocp->stats.n_hit++;
 
     chDbgAssert((objp->obj_flags & OC_FLAG_INHASH) == OC_FLAG_INHASH,
                 "not in hash");
@@ -327,6 +676,16 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
       /* Removing the object from LRU, now it is "owned".*/
       LRU_REMOVE(objp);
       objp->obj_flags &= ~OC_FLAG_INLRU;
+      if ((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) {
+        ocp->dirtyn--;
+      }
+
+      /* If a thread has been woken on the LRU semaphore but did not run
+         yet then the counter is not decreased, that thread will find one
+         object less in the LRU and will wait again.*/
+      if (chSemGetCounterI(&ocp->lru_sem) > (cnt_t)0) {
+        chSemFastWaitI(&ocp->lru_sem);
+      }
 
       /* Getting the object semaphore, we know there is no wait so
          using the "fast" variant.*/
@@ -344,6 +703,7 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
   }
   else {
     /* Cache miss, getting an object buffer from the LRU list.*/
+    ocp->stats.n_miss++;
     objp = lru_get_last_s(ocp);
 
     /* Naming this object and publishing it in the hash table.*/
@@ -351,6 +711,11 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     objp->obj_key   = key;
     objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_NOTSYNC;
     HASH_INSERT(ocp, objp, group, key);
+
+#if CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE
+    /* The flusher could have been awakened.*/
+    chSchRescheduleS();
+#endif
   }
 
   /* Out of critical section and returning the object.*/
@@ -401,7 +766,7 @@ void chCacheReleaseObjectI(objects_cache_t *ocp,
   /* If the object specifies OC_FLAG_NOTSYNC then it must be invalidated
      and removed from the hash table.*/
   if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
-    HASH_REMOVE(objp);
+    HASH_REMOVE(ocp, objp);
     LRU_INSERT_TAIL(ocp, objp);
     objp->obj_group = 0U;
     objp->obj_key   = 0U;
@@ -419,6 +784,16 @@ void chCacheReleaseObjectI(objects_cache_t *ocp,
     }
     objp->obj_flags &= OC_FLAG_INHASH | OC_FLAG_LAZYWRITE;
     objp->obj_flags |= OC_FLAG_INLRU;
+
+    /* Accounting of objects needing a write.*/
+    if ((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) {
+      ocp->dirtyn++;
+#if CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE
+      if (ocp->dirtyn > ocp->high_wm) {
+        chThdResumeI(&ocp->flusher, MSG_OK);
+      }
+#endif
+    }
   }
 
   /* Increasing the LRU counter semaphore.*/
@@ -486,6 +861,120 @@ bool chCacheWriteObject(objects_cache_t *ocp,
   return ocp->writef(ocp, objp, async);
 }
 
+/**
+ * @brief   Writes back the dirty objects of a group.
+ * @details Objects marked with @p OC_FLAG_LAZYWRITE and belonging to the
+ *          specified group are written, objects with consecutive keys are
+ *          written in batches if a batch writer is set.
+ * @note    Objects currently owned by threads are not written.
+ * @note    Objects that cannot be written remain marked for lazy write.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] group     object group identifier
+ * @return              The operation status.
+ * @retval false        if the operation succeeded.
+ * @retval true         if one or more write operations failed.
+ *
+ * @api
+ */
+bool chCacheFlushGroup(objects_cache_t *ocp, uint32_t group) {
+  bool err;
+
+  chSysLock();
+  err = flush_s(ocp, false, group, (ucnt_t)0);
+  chSysUnlock();
+
+  return err;
+}
+
+/**
+ * @brief   Writes back all the dirty objects.
+ * @details Objects marked with @p OC_FLAG_LAZYWRITE are written, objects
+ *          with consecutive keys are written in batches if a batch writer
+ *          is set.
+ * @note    Objects currently owned by threads are not written.
+ * @note    Objects that cannot be written remain marked for lazy write.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @return              The operation status.
+ * @retval false        if the operation succeeded.
+ * @retval true         if one or more write operations failed.
+ *
+ * @api
+ */
+bool chCacheFlushAll(objects_cache_t *ocp) {
+  bool err;
+
+  chSysLock();
+  err = flush_s(ocp, true, 0U, (ucnt_t)0);
+  chSysUnlock();
+
+  return err;
+}
+
+#if (CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sets the flusher watermarks.
+ * @note    The default watermarks are one half and one quarter of the
+ *          number of objects.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] high      number of dirty objects waking up the flusher
+ * @param[in] low       number of dirty objects stopping the flusher
+ *
+ * @api
+ */
+void chCacheSetWatermarks(objects_cache_t *ocp, ucnt_t high, ucnt_t low) {
+
+  chDbgCheck((ocp != NULL) && (low <= high));
+
+  chSysLock();
+  ocp->high_wm = high;
+  ocp->low_wm  = low;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Waits for the high watermark then cleans the dirty objects.
+ * @details The calling thread is suspended until the number of dirty
+ *          objects exceeds the high watermark or a clean object is not
+ *          found by an allocation, then dirty objects are written until
+ *          the low watermark is reached.
+ * @note    This function is meant to be called in a loop by a thread
+ *          dedicated to the cache, only one flusher thread is allowed.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the dirty objects have been written.
+ * @retval MSG_TIMEOUT  if the operation timed out.
+ * @retval MSG_RESET    if one or more write operations failed.
+ *
+ * @api
+ */
+msg_t chCacheFlusherDispatchTimeout(objects_cache_t *ocp,
+                                    sysinterval_t timeout) {
+  msg_t msg = MSG_OK;
+
+  chSysLock();
+  if (ocp->dirtyn <= ocp->high_wm) {
+    msg = chThdSuspendTimeoutS(&ocp->flusher, timeout);
+  }
+  if (msg == MSG_OK) {
+    if (flush_s(ocp, true, 0U, ocp->low_wm)) {
+      msg = MSG_RESET;
+    }
+  }
+  chSysUnlock();
+
+  return msg;
+}
+#endif /* CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE */
+
 #endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
 
 /** @} */
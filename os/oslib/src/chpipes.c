@@ -28,7 +28,19 @@
  *          - <b>Read</b>: A buffer of data is read from the read and removed.
  *          - <b>Reset</b>: The pipe is emptied and all the stored data
  *            is lost.
+ *          - <b>Reserve/Commit</b>: An area of free space is exposed to the
+ *            writer which fills it in place and then commits it.
+ *          - <b>Peek/Consume</b>: An area of queued data is exposed to the
+ *            reader which parses it in place and then consumes it.
  *          .
+ *          <h2>SPSC mode</h2>
+ *          Pipes initialized using @p chPipeObjectInitSPSC() support a
+ *          single writer thread and a single reader thread. The data path
+ *          uses free running counters updated by one side only, no mutexes
+ *          are taken and the other side is awakened only if it is waiting
+ *          because the pipe was empty or full. The counters are published
+ *          with release/acquire ordering so the mode is also safe on
+ *          multi-core ports when GCC atomics are available.
  * @pre     In order to use the pipes APIs the @p CH_CFG_USE_PIPES
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -72,6 +84,34 @@
 #define PR_UNLOCK(p)     chSemSignal(&(p)->rsem)
 #endif
 
+/*
+ * Accessors for the SPSC counters. Each counter is stored with release
+ * semantics by its owner side after the buffer accesses and loaded with
+ * acquire semantics by the other side before accessing the buffer, this
+ * also covers ports having multiple cores or weakly ordered memory.
+ * The full fence orders a counter store before the load of the other
+ * side thread reference, and vice versa. On single core ports the other
+ * side can only run between instructions so a compiler barrier is enough.
+ */
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#define PIPE_LOAD_ACQUIRE(v)      __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define PIPE_STORE_RELEASE(v, x)  __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+#if PORT_CORES_NUMBER > 1
+#define PIPE_FULL_FENCE()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define PIPE_FULL_FENCE()         __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#endif
+#else
+/* Without the compiler atomics only the volatile qualifier of the counters
+   orders the accesses, this is enough on single core ports only.*/
+#if defined(PORT_CORES_NUMBER) && (PORT_CORES_NUMBER > 1)
+#error "SPSC pipes require GCC atomics on multi-core ports"
+#endif
+#define PIPE_LOAD_ACQUIRE(v)      (v)
+#define PIPE_STORE_RELEASE(v, x)  ((v) = (x))
+#define PIPE_FULL_FENCE()
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -111,7 +151,6 @@ static size_t pipe_write(pipe_t *pp, const uint8_t *bp, size_t n) {
   if (n > chPipeGetFreeCount(pp)) {
     n = chPipeGetFreeCount(pp);
   }
-  pp->cnt += n;
 
   /* Number of bytes before buffer limit.*/
   /*lint -save -e9033 [10.8] Checked to be safe.*/
@@ -134,6 +173,10 @@ static size_t pipe_write(pipe_t *pp, const uint8_t *bp, size_t n) {
     pp->wrptr = pp->buffer;
   }
 
+  /* The counter is updated after the copy, readers peeking the pipe
+     without the common lock must not see data not yet copied.*/
+  pp->cnt += n;
+
   PC_UNLOCK(pp);
 
   return n;
@@ -162,7 +205,6 @@ static size_t pipe_read(pipe_t *pp, uint8_t *bp, size_t n) {
   if (n > chPipeGetUsedCount(pp)) {
     n = chPipeGetUsedCount(pp);
   }
-  pp->cnt -= n;
 
   /* Number of bytes before buffer limit.*/
   /*lint -save -e9033 [10.8] Checked to be safe.*/
@@ -185,11 +227,310 @@ static size_t pipe_read(pipe_t *pp, uint8_t *bp, size_t n) {
     pp->rdptr = pp->buffer;
   }
 
+  /* The counter is updated after the copy, writers reserving space
+     without the common lock must not get space still being read.*/
+  pp->cnt -= n;
+
   PC_UNLOCK(pp);
 
   return n;
 }
 
+/**
+ * @brief   Describes a buffer area as spans.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] p         pointer to the start of the area
+ * @param[in] n         size of the area
+ * @param[out] sp       pointer to the spans to be filled
+ *
+ * @notapi
+ */
+static void pipe_spans(pipe_t *pp, uint8_t *p, size_t n, pipe_span_t *sp) {
+  size_t s1;
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - p);
+  /*lint -restore*/
+
+  sp->p1 = p;
+  if (n <= s1) {
+    sp->n1 = n;
+    sp->p2 = NULL;
+    sp->n2 = (size_t)0;
+  }
+  else {
+    sp->n1 = s1;
+    sp->p2 = pp->buffer;
+    sp->n2 = n - s1;
+  }
+}
+
+/**
+ * @brief   Advances a buffer pointer with wrap around.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] p         the pointer to be advanced
+ * @param[in] n         number of bytes
+ * @return              The advanced pointer.
+ *
+ * @notapi
+ */
+static uint8_t *pipe_advance(pipe_t *pp, uint8_t *p, size_t n) {
+
+  p += n;
+  if (p >= pp->top) {
+    p -= chPipeGetSize(pp);
+  }
+
+  return p;
+}
+
+/**
+ * @brief   Returns the number of used byte slots in a SPSC pipe.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @return              The number of queued bytes.
+ *
+ * @notapi
+ */
+static inline size_t pipe_spsc_used(pipe_t *pp) {
+
+  return PIPE_LOAD_ACQUIRE(pp->wrcnt) - PIPE_LOAD_ACQUIRE(pp->rdcnt);
+}
+
+/**
+ * @brief   Returns the number of free byte slots in a SPSC pipe.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @return              The number of empty byte slots.
+ *
+ * @notapi
+ */
+static inline size_t pipe_spsc_free(pipe_t *pp) {
+
+  return chPipeGetSize(pp) - pipe_spsc_used(pp);
+}
+
+/**
+ * @brief   Checks for data or space in a SPSC pipe.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] wr        @p true if the caller is the writer
+ * @param[in] n         the number of bytes or slots required
+ * @return              The check result.
+ * @retval true         if the required bytes or slots are available.
+ *
+ * @notapi
+ */
+static inline bool pipe_spsc_ready(pipe_t *pp, bool wr, size_t n) {
+
+  return (wr ? pipe_spsc_free(pp) : pipe_spsc_used(pp)) >= n;
+}
+
+/**
+ * @brief   Waits for data or space in a SPSC pipe.
+ * @note    The kernel is only locked if the pipe has to be waited for.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] wr        @p true if the caller is the writer
+ * @param[in] n         the number of bytes or slots to be waited for
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The wait result.
+ *
+ * @notapi
+ */
+static msg_t pipe_spsc_wait(pipe_t *pp, bool wr, size_t n,
+                            sysinterval_t timeout) {
+  thread_reference_t *trp = wr ? &pp->wtr : &pp->rtr;
+  thread_t *currtp = chThdGetSelfX();
+  msg_t msg = MSG_OK;
+
+  if (pipe_spsc_ready(pp, wr, n)) {
+    return MSG_OK;
+  }
+
+  chSysLock();
+  while (true) {
+    if (pp->reset) {
+      msg = MSG_RESET;
+      break;
+    }
+
+    /* The reference is published before checking the counters again, the
+       other side updates the counter before checking the reference so
+       either the update is seen here or the reference is seen there.*/
+    chDbgAssert(*trp == NULL, "not NULL");
+    *trp = currtp;
+    PIPE_FULL_FENCE();
+    if (pipe_spsc_ready(pp, wr, n)) {
+      *trp = NULL;
+      break;
+    }
+    if (timeout == TIME_IMMEDIATE) {
+      *trp = NULL;
+      msg = MSG_TIMEOUT;
+      break;
+    }
+
+    /* Same as chThdSuspendTimeoutS() with the reference already set.*/
+    currtp->u.wttrp = trp;
+    msg = chSchGoSleepTimeoutS(CH_STATE_SUSPENDED, timeout);
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Wakes the other side of a SPSC pipe, if waiting.
+ * @note    The kernel is only locked if there is a thread to be resumed.
+ *
+ * @param[in] trp       a pointer to the other side thread reference
+ *
+ * @notapi
+ */
+static void pipe_spsc_wakeup(thread_reference_t *trp) {
+
+  /* The counter update must be visible before checking the reference.*/
+  PIPE_FULL_FENCE();
+  if (*trp != NULL) {
+    chSysLock();
+    chThdResumeS(trp, MSG_OK);
+    chSysUnlock();
+  }
+}
+
+/**
+ * @brief   Publishes written data in a SPSC pipe.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes written
+ *
+ * @notapi
+ */
+static void pipe_spsc_commit(pipe_t *pp, size_t n) {
+
+  pp->wrptr = pipe_advance(pp, pp->wrptr, n);
+  PIPE_STORE_RELEASE(pp->wrcnt, pp->wrcnt + n);
+  pipe_spsc_wakeup(&pp->rtr);
+}
+
+/**
+ * @brief   Releases read space in a SPSC pipe.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes read
+ *
+ * @notapi
+ */
+static void pipe_spsc_consume(pipe_t *pp, size_t n) {
+
+  pp->rdptr = pipe_advance(pp, pp->rdptr, n);
+  PIPE_STORE_RELEASE(pp->rdcnt, pp->rdcnt + n);
+  pipe_spsc_wakeup(&pp->wtr);
+}
+
+/**
+ * @brief   SPSC pipe write with timeout.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the number of bytes to be written
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The number of bytes effectively transferred.
+ *
+ * @notapi
+ */
+static size_t pipe_spsc_write(pipe_t *pp, const uint8_t *bp,
+                              size_t n, sysinterval_t timeout) {
+  size_t max = n;
+
+  while (n > 0U) {
+    size_t done;
+
+    done = pipe_spsc_free(pp);
+    if (done == (size_t)0) {
+
+      /* Anything except MSG_OK causes the operation to stop.*/
+      if (pipe_spsc_wait(pp, true, (size_t)1, timeout) != MSG_OK) {
+        break;
+      }
+    }
+    else {
+      pipe_span_t span;
+
+      if (done > n) {
+        done = n;
+      }
+
+      pipe_spans(pp, pp->wrptr, done, &span);
+      memcpy((void *)span.p1, (const void *)bp, span.n1);
+      if (span.n2 > (size_t)0) {
+        memcpy((void *)span.p2, (const void *)(bp + span.n1), span.n2);
+      }
+      pipe_spsc_commit(pp, done);
+
+      n  -= done;
+      bp += done;
+    }
+  }
+
+  return max - n;
+}
+
+/**
+ * @brief   SPSC pipe read with timeout.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the number of bytes to be read
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The number of bytes effectively transferred.
+ *
+ * @notapi
+ */
+static size_t pipe_spsc_read(pipe_t *pp, uint8_t *bp,
+                             size_t n, sysinterval_t timeout) {
+  size_t max = n;
+
+  while (n > 0U) {
+    size_t done;
+
+    done = pipe_spsc_used(pp);
+    if (done == (size_t)0) {
+
+      /* Anything except MSG_OK causes the operation to stop.*/
+      if (pipe_spsc_wait(pp, false, (size_t)1, timeout) != MSG_OK) {
+        break;
+      }
+    }
+    else {
+      pipe_span_t span;
+
+      if (done > n) {
+        done = n;
+      }
+
+      pipe_spans(pp, pp->rdptr, done, &span);
+      memcpy((void *)bp, (const void *)span.p1, span.n1);
+      if (span.n2 > (size_t)0) {
+        memcpy((void *)(bp + span.n1), (const void *)span.p2, span.n2);
+      }
+      pipe_spsc_consume(pp, done);
+
+      n  -= done;
+      bp += done;
+    }
+  }
+
+  return max - n;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -213,7 +554,10 @@ void chPipeObjectInit(pipe_t *pp, uint8_t *buf, size_t n) {
   pp->wrptr  = buf;
   pp->top    = &buf[n];
   pp->cnt    = (size_t)0;
+  pp->wrcnt  = (size_t)0;
+  pp->rdcnt  = (size_t)0;
   pp->reset  = false;
+  pp->spsc   = false;
   pp->wtr    = NULL;
   pp->rtr    = NULL;
   PC_INIT(pp);
@@ -221,6 +565,29 @@ void chPipeObjectInit(pipe_t *pp, uint8_t *buf, size_t n) {
   PR_INIT(pp);
 }
 
+/**
+ * @brief   Initializes a @p pipe_t object in SPSC mode.
+ * @details In SPSC mode the pipe can be used by a single writer thread
+ *          and a single reader thread, the data transfers do not require
+ *          mutual exclusion and the other side is awakened only when it is
+ *          waiting for data or space.
+ * @note    In SPSC mode the pipe can be reset only while both the writer
+ *          and the reader are not in the middle of an operation or are
+ *          waiting for the pipe.
+ *
+ * @param[out] pp       the pointer to the @p pipe_t structure to be
+ *                      initialized
+ * @param[in] buf       pointer to the pipe buffer as an array of @p uint8_t
+ * @param[in] n         number of elements in the buffer array
+ *
+ * @init
+ */
+void chPipeObjectInitSPSC(pipe_t *pp, uint8_t *buf, size_t n) {
+
+  chPipeObjectInit(pp, buf, n);
+  pp->spsc = true;
+}
+
 /**
  * @brief   Resets a @p pipe_t object.
  * @details All the waiting threads are resumed with status @p MSG_RESET and
@@ -242,6 +609,8 @@ void chPipeReset(pipe_t *pp) {
   pp->wrptr = pp->buffer;
   pp->rdptr = pp->buffer;
   pp->cnt   = (size_t)0;
+  pp->wrcnt = (size_t)0;
+  pp->rdcnt = (size_t)0;
   pp->reset = true;
 
   chSysLock();
@@ -286,6 +655,10 @@ size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
     return (size_t)0;
   }
 
+  if (pp->spsc) {
+    return pipe_spsc_write(pp, bp, n, timeout);
+  }
+
   PW_LOCK(pp);
 
   while (n > 0U) {
@@ -351,6 +724,10 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
     return (size_t)0;
   }
 
+  if (pp->spsc) {
+    return pipe_spsc_read(pp, bp, n, timeout);
+  }
+
   PR_LOCK(pp);
 
   while (n > 0U) {
@@ -383,6 +760,252 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Reserves space into a pipe.
+ * @details The function waits until at least @p n bytes are free into
+ *          the pipe then returns the whole free space as one or two
+ *          contiguous spans. The writer can fill the spans in place and
+ *          then make the data visible to the reader using
+ *          @p chPipeCommit().
+ * @note    The write side of the pipe stays locked until
+ *          @p chPipeCommit() is invoked by the same thread, if mutexes are
+ *          used then any other mutex taken in between must be released
+ *          before the commit.
+ *          In SPSC mode no mutex is taken.
+ * @note    The pipe must not be reset and resumed while a reservation is
+ *          pending, reset alone is allowed and makes the commit do nothing.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the minimum number of bytes to be reserved, the
+ *                      value 0 is reserved
+ * @param[out] sp       pointer to a @p pipe_span_t structure receiving the
+ *                      reserved area
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes reserved, it can be larger
+ *                      than @p n.
+ * @retval 0            if a timeout occurred or the pipe went in reset
+ *                      state, in this case @p chPipeCommit() must not be
+ *                      invoked.
+ *
+ * @api
+ */
+size_t chPipeReserveTimeout(pipe_t *pp, size_t n, pipe_span_t *sp,
+                            sysinterval_t timeout) {
+  size_t free;
+
+  chDbgCheck((pp != NULL) && (n > 0U) && (n <= chPipeGetSize(pp)) &&
+             (sp != NULL));
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  if (pp->spsc) {
+    if (pipe_spsc_wait(pp, true, n, timeout) != MSG_OK) {
+      return (size_t)0;
+    }
+
+    free = pipe_spsc_free(pp);
+    pipe_spans(pp, pp->wrptr, free, sp);
+
+    return free;
+  }
+
+  PW_LOCK(pp);
+
+  /* The write side is locked so the free space can only grow while the
+     reader operates on the pipe. The counter is only updated after the
+     data has been moved so a snapshot taken under the kernel lock is
+     enough and the common lock is not required here.*/
+  chSysLock();
+  while (chPipeGetFreeCount(pp) < n) {
+    msg_t msg = chThdSuspendTimeoutS(&pp->wtr, timeout);
+
+    /* Anything except MSG_OK causes the operation to stop.*/
+    if (msg != MSG_OK) {
+      chSysUnlock();
+      PW_UNLOCK(pp);
+      return (size_t)0;
+    }
+  }
+  free = chPipeGetFreeCount(pp);
+  pipe_spans(pp, pp->wrptr, free, sp);
+  chSysUnlock();
+
+  return free;
+}
+
+/**
+ * @brief   Commits data into a pipe.
+ * @details The first @p n bytes of the area previously returned by
+ *          @p chPipeReserveTimeout() are made available to the reader
+ *          and the write side of the pipe is unlocked.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be committed, it can be zero
+ *                      in order to just cancel the reservation
+ *
+ * @api
+ */
+void chPipeCommit(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  if (pp->spsc) {
+    if (!pp->reset && (n > 0U)) {
+      chDbgAssert(n <= pipe_spsc_free(pp), "commit exceeds reservation");
+
+      pipe_spsc_commit(pp, n);
+    }
+    return;
+  }
+
+  PC_LOCK(pp);
+
+  /* If the pipe has been reset in the meanwhile then the data is lost.*/
+  if (!pp->reset && (n > 0U)) {
+    chDbgAssert(n <= chPipeGetFreeCount(pp), "commit exceeds reservation");
+
+    pp->wrptr = pipe_advance(pp, pp->wrptr, n);
+    pp->cnt  += n;
+  }
+
+  PC_UNLOCK(pp);
+
+  /* Resuming the reader, if present.*/
+  chThdResume(&pp->rtr, MSG_OK);
+
+  PW_UNLOCK(pp);
+}
+
+/**
+ * @brief   Peeks data from a pipe.
+ * @details The function waits until at least @p n bytes are queued into
+ *          the pipe then returns all the queued data as one or two
+ *          contiguous spans. The reader can parse the spans in place and
+ *          then release the space to the writer using @p chPipeConsume().
+ * @note    The read side of the pipe stays locked until
+ *          @p chPipeConsume() is invoked by the same thread, if mutexes are
+ *          used then any other mutex taken in between must be released
+ *          before consuming.
+ *          In SPSC mode no mutex is taken.
+ * @note    The pipe must not be reset and resumed while a peek is
+ *          pending, reset alone is allowed and makes the consume do
+ *          nothing.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the minimum number of bytes to be peeked, the
+ *                      value 0 is reserved
+ * @param[out] sp       pointer to a @p pipe_span_t structure receiving the
+ *                      queued data area
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes available, it can be larger
+ *                      than @p n.
+ * @retval 0            if a timeout occurred or the pipe went in reset
+ *                      state, in this case @p chPipeConsume() must not be
+ *                      invoked.
+ *
+ * @api
+ */
+size_t chPipePeekTimeout(pipe_t *pp, size_t n, pipe_span_t *sp,
+                         sysinterval_t timeout) {
+  size_t used;
+
+  chDbgCheck((pp != NULL) && (n > 0U) && (n <= chPipeGetSize(pp)) &&
+             (sp != NULL));
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  if (pp->spsc) {
+    if (pipe_spsc_wait(pp, false, n, timeout) != MSG_OK) {
+      return (size_t)0;
+    }
+
+    used = pipe_spsc_used(pp);
+    pipe_spans(pp, pp->rdptr, used, sp);
+
+    return used;
+  }
+
+  PR_LOCK(pp);
+
+  /* The read side is locked so the queued data can only grow while the
+     writer operates on the pipe. The counter is only updated after the
+     data has been moved so a snapshot taken under the kernel lock is
+     enough and the common lock is not required here.*/
+  chSysLock();
+  while (chPipeGetUsedCount(pp) < n) {
+    msg_t msg = chThdSuspendTimeoutS(&pp->rtr, timeout);
+
+    /* Anything except MSG_OK causes the operation to stop.*/
+    if (msg != MSG_OK) {
+      chSysUnlock();
+      PR_UNLOCK(pp);
+      return (size_t)0;
+    }
+  }
+  used = chPipeGetUsedCount(pp);
+  pipe_spans(pp, pp->rdptr, used, sp);
+  chSysUnlock();
+
+  return used;
+}
+
+/**
+ * @brief   Consumes data from a pipe.
+ * @details The first @p n bytes of the area previously returned by
+ *          @p chPipePeekTimeout() are released to the writer and the read
+ *          side of the pipe is unlocked.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be consumed, it can be zero
+ *                      in order to leave the data into the pipe
+ *
+ * @api
+ */
+void chPipeConsume(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  if (pp->spsc) {
+    if (!pp->reset && (n > 0U)) {
+      chDbgAssert(n <= pipe_spsc_used(pp), "consume exceeds peek");
+
+      pipe_spsc_consume(pp, n);
+    }
+    return;
+  }
+
+  PC_LOCK(pp);
+
+  /* If the pipe has been reset in the meanwhile then nothing to do.*/
+  if (!pp->reset && (n > 0U)) {
+    chDbgAssert(n <= chPipeGetUsedCount(pp), "consume exceeds peek");
+
+    pp->rdptr = pipe_advance(pp, pp->rdptr, n);
+    pp->cnt  -= n;
+  }
+
+  PC_UNLOCK(pp);
+
+  /* Resuming the writer, if present.*/
+  chThdResume(&pp->wtr, MSG_OK);
+
+  PR_UNLOCK(pp);
+}
+
 #endif /* CH_CFG_USE_PIPES == TRUE */
 
 /** @} */
@@ -41,6 +41,20 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Broadcast wait morphing.
+ * @details If enabled then @p chCondBroadcast() and @p chCondBroadcastI()
+ *          move the waiting threads directly on the queue of the associated
+ *          mutex instead of making all of them ready, the threads are then
+ *          woken one at time by the mutex unlock operations.
+ * @note    Threads waiting with a timeout are always made ready.
+ * @note    All the threads waiting on a condition variable must use the
+ *          same mutex.
+ */
+#if !defined(CH_CFG_USE_CONDVARS_REQUEUE) || defined(__DOXYGEN__)
+#define CH_CFG_USE_CONDVARS_REQUEUE         FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -59,6 +73,10 @@
 typedef struct condition_variable {
   ch_queue_t            queue;              /**< @brief Condition variable
                                                  threads queue.             */
+#if (CH_CFG_USE_CONDVARS_REQUEUE == TRUE) || defined(__DOXYGEN__)
+  mutex_t               *mutex;             /**< @brief Mutex associated to
+                                                 the waiting threads.       */
+#endif
 } condition_variable_t;
 
 /*===========================================================================*/
@@ -72,7 +90,11 @@ typedef struct condition_variable {
  *
  * @param[in] name      the name of the condition variable
  */
+#if (CH_CFG_USE_CONDVARS_REQUEUE == TRUE) || defined(__DOXYGEN__)
+#define __CONDVAR_DATA(name) {__CH_QUEUE_DATA(name.queue), NULL}
+#else
 #define __CONDVAR_DATA(name) {__CH_QUEUE_DATA(name.queue)}
+#endif
 
 /**
  * @brief Static condition variable initializer.
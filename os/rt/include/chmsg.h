@@ -46,6 +46,14 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a buffer message segment.
+ */
+typedef struct {
+  void                  *buf;               /**< @brief Segment base.       */
+  size_t                size;               /**< @brief Segment size.       */
+} msg_segment_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -58,10 +66,13 @@
 extern "C" {
 #endif
   msg_t chMsgSend(thread_t *tp, msg_t msg);
+  msg_t chMsgSendBuffer(thread_t *tp, const msg_segment_t *segs, unsigned n);
   thread_t *chMsgWaitS(void);
   thread_t *chMsgWaitTimeoutS(sysinterval_t timeout);
   thread_t *chMsgPollS(void);
   void chMsgRelease(thread_t *tp, msg_t msg);
+  size_t chMsgReceiveBuffer(thread_t *tp, const msg_segment_t *segs,
+                            unsigned n);
 #ifdef __cplusplus
 }
 #endif
@@ -184,10 +195,30 @@ static inline bool chMsgIsPendingI(thread_t *tp) {
 static inline msg_t chMsgGet(thread_t *tp) {
 
   chDbgAssert(tp->state == CH_STATE_SNDMSG, "invalid state");
+  chDbgAssert((tp->flags & CH_FLAG_MSG_BUFFER) == (tmode_t)0,
+              "buffer message");
 
   return tp->u.sentmsg;
 }
 
+/**
+ * @brief   Evaluates to @p true if the specified thread is carrying a
+ *          buffer message.
+ * @pre     This function must be invoked immediately after exiting a call
+ *          to @p chMsgWait().
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The buffer message status.
+ *
+ * @api
+ */
+static inline bool chMsgIsBuffer(thread_t *tp) {
+
+  chDbgAssert(tp->state == CH_STATE_SNDMSG, "invalid state");
+
+  return (bool)((tp->flags & CH_FLAG_MSG_BUFFER) != (tmode_t)0);
+}
+
 /**
  * @brief   Releases the thread waiting on top of the messages queue.
  * @pre     Invoke this function only after a message has been received
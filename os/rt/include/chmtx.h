@@ -108,6 +108,11 @@ extern "C" {
   void chMtxUnlockS(mutex_t *mp);
   void chMtxUnlockAll(void);
   void chMtxUnlockAllS(void);
+#if (CH_CFG_USE_CONDVARS == TRUE) &&                                       \
+    defined(CH_CFG_USE_CONDVARS_REQUEUE) &&                               \
+    (CH_CFG_USE_CONDVARS_REQUEUE == TRUE)
+  void chMtxRequeueI(mutex_t *mp, thread_t *tp, msg_t msg);
+#endif
 #ifdef __cplusplus
 }
 #endif
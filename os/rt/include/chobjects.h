@@ -36,10 +36,76 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Virtual timers settings
+ * @{
+ */
+/**
+ * @brief   Virtual timers timing wheel.
+ * @details If enabled then the virtual timers are kept in a hierarchical
+ *          timing wheel instead of the delta list.
+ */
+#if !defined(CH_CFG_VT_USE_WHEEL) || defined(__DOXYGEN__)
+#define CH_CFG_VT_USE_WHEEL                 FALSE
+#endif
+
+/**
+ * @brief   Timing wheel slots per level, as a power of two.
+ */
+#if !defined(CH_CFG_VT_WHEEL_BITS) || defined(__DOXYGEN__)
+#define CH_CFG_VT_WHEEL_BITS                5
+#endif
+/** @} */
+
+/**
+ * @name    Scheduler settings
+ * @{
+ */
+/**
+ * @brief   Bitmap-indexed ready list.
+ * @details If enabled then the ready list is kept as per-priority FIFO
+ *          queues indexed by a priority bitmap.
+ */
+#if !defined(CH_CFG_RLIST_USE_BITMAP) || defined(__DOXYGEN__)
+#define CH_CFG_RLIST_USE_BITMAP             FALSE
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_VT_USE_WHEEL == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_VT_WHEEL_BITS < 1) || (CH_CFG_VT_WHEEL_BITS > 5)
+#error "invalid CH_CFG_VT_WHEEL_BITS value"
+#endif
+
+/**
+ * @brief   Number of slots in each timing wheel level.
+ */
+#define CH_VT_WHEEL_SLOTS                   (1U << CH_CFG_VT_WHEEL_BITS)
+
+/**
+ * @brief   Number of timing wheel levels.
+ * @note    The levels cover the whole @p sysinterval_t range, the last
+ *          level can have less than @p CH_VT_WHEEL_SLOTS usable slots.
+ */
+#define CH_VT_WHEEL_LEVELS                                                  \
+  ((CH_CFG_INTERVALS_SIZE + CH_CFG_VT_WHEEL_BITS - 1) / CH_CFG_VT_WHEEL_BITS)
+#endif
+
+#if (CH_CFG_RLIST_USE_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of priority levels in the ready list.
+ */
+#define CH_RLIST_PRIO_LEVELS                256U
+
+/**
+ * @brief   Number of 32 bits words in the ready list priority bitmap.
+ */
+#define CH_RLIST_PRIO_WORDS                 (CH_RLIST_PRIO_LEVELS / 32U)
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -79,9 +145,36 @@ typedef struct ch_virtual_timer {
  * @note    The timers list is implemented as a double link bidirectional list
  *          in order to make the unlink time constant, the reset of a virtual
  *          timer is often used in the code.
+ * @note    When the timing wheel is enabled the @p delta field of the armed
+ *          timers contains their absolute expiration time in wheel time
+ *          units and the slots are bidirectional lists of timers.
  */
 typedef struct ch_virtual_timers_list {
+#if (CH_CFG_VT_USE_WHEEL == FALSE) || defined(__DOXYGEN__)
   delta_list_t          dlist;      /**< @brief Delta list header.          */
+#endif
+#if (CH_CFG_VT_USE_WHEEL == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Timing wheel slots headers, level-major order.
+   */
+  delta_list_t          slots[CH_VT_WHEEL_LEVELS * CH_VT_WHEEL_SLOTS];
+  /**
+   * @brief   Timers being expired, callbacks are invoked from this list.
+   */
+  delta_list_t          expired;
+  /**
+   * @brief   Non-empty slots masks, one per level.
+   */
+  uint32_t              slotsmap[CH_VT_WHEEL_LEVELS];
+  /**
+   * @brief   Non-empty levels mask.
+   */
+  uint32_t              levelsmap;
+  /**
+   * @brief   Wheel time of the last processed tick.
+   */
+  sysinterval_t         wtime;
+#endif
 #if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
   volatile systime_t    systime;    /**< @brief System Time counter.        */
 #endif
@@ -282,6 +375,12 @@ struct ch_thread {
    */
   time_measurement_t    stats;
 #endif
+#if (CH_DBG_STATISTICS_LATENCY == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Thread ready to running latency statistics.
+   */
+  thread_latency_t      latency;
+#endif
 #if defined(CH_CFG_THREAD_EXTRA_FIELDS)
   /* Extra fields defined in chconf.h.*/
   CH_CFG_THREAD_EXTRA_FIELDS
@@ -297,6 +396,9 @@ typedef struct ch_ready_list {
   /**
    * @brief     Threads ordered queues header.
    * @note      The priority field must be initialized to zero.
+   * @note      When the bitmap is enabled only the @p next field is used,
+   *            it points to the highest priority ready thread or to the
+   *            header itself if there are no ready threads.
    */
   ch_priority_queue_t   pqueue;
 #if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
@@ -314,6 +416,20 @@ typedef struct ch_ready_list {
    * @brief     The currently running thread.
    */
   thread_t              *current;
+#if (CH_CFG_RLIST_USE_BITMAP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief     Per-priority threads FIFO queues headers.
+   */
+  ch_queue_t            queues[CH_RLIST_PRIO_LEVELS];
+  /**
+   * @brief     Non-empty queues bitmap.
+   */
+  uint32_t              prmap[CH_RLIST_PRIO_WORDS];
+  /**
+   * @brief     Non-zero @p prmap words mask.
+   */
+  uint32_t              grmap;
+#endif
 } ready_list_t;
 
 /**
@@ -153,6 +153,65 @@
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+#if !defined(port_ctz32) || defined(__DOXYGEN__)
+/**
+ * @brief   Counts the trailing zero bits of a 32 bits word.
+ * @note    The port layer can override this function with a macro using
+ *          a dedicated instruction, the default uses compiler builtins
+ *          if available.
+ *
+ * @param[in] x         the word to be scanned, must not be zero
+ * @return              The index of the least significant bit set.
+ *
+ * @xclass
+ */
+static inline unsigned port_ctz32(uint32_t x) {
+
+#if defined(__GNUC__)
+  return (unsigned)__builtin_ctz(x);
+#else
+  unsigned n = 0U;
+
+  while ((x & 1U) == 0U) {
+    x >>= 1;
+    n++;
+  }
+
+  return n;
+#endif
+}
+#endif
+
+#if !defined(port_clz32) || defined(__DOXYGEN__)
+/**
+ * @brief   Counts the leading zero bits of a 32 bits word.
+ * @note    The port layer can override this function with a macro using
+ *          a dedicated instruction, the default uses compiler builtins
+ *          if available.
+ *
+ * @param[in] x         the word to be scanned, must not be zero
+ * @return              The number of zero bits above the most significant
+ *                      bit set.
+ *
+ * @xclass
+ */
+static inline unsigned port_clz32(uint32_t x) {
+
+#if defined(__GNUC__)
+  return (unsigned)__builtin_clz(x);
+#else
+  unsigned n = 0U;
+
+  while ((x & 0x80000000U) == 0U) {
+    x <<= 1;
+    n++;
+  }
+
+  return n;
+#endif
+}
+#endif
+
 #endif /* CHPORT_H */
 
 /** @} */
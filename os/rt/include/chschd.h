@@ -104,6 +104,10 @@
                                                  from a Memory Pool.        */
 #define CH_FLAG_TERMINATE   (tmode_t)4U     /**< @brief Termination requested
                                                  flag.                      */
+#define CH_FLAG_TIMED_WAIT  (tmode_t)8U     /**< @brief Waiting on a condition
+                                                 variable with timeout.     */
+#define CH_FLAG_MSG_BUFFER  (tmode_t)16U    /**< @brief Sending a buffer
+                                                 message.                   */
 /** @} */
 
 /*===========================================================================*/
@@ -166,6 +170,9 @@ extern "C" {
 #if CH_CFG_OPTIMIZE_SPEED == FALSE
   void ch_sch_prio_insert(ch_queue_t *tp, ch_queue_t *qp);
 #endif /* CH_CFG_OPTIMIZE_SPEED == FALSE */
+#if CH_CFG_RLIST_USE_BITMAP == TRUE
+  thread_t *__sch_ready_remove(os_instance_t *oip, thread_t *tp);
+#endif /* CH_CFG_RLIST_USE_BITMAP == TRUE */
 #ifdef __cplusplus
 }
 #endif
@@ -191,6 +198,24 @@ static inline void ch_sch_prio_insert(ch_queue_t *tp, ch_queue_t *qp) {
 }
 #endif /* CH_CFG_OPTIMIZE_SPEED == TRUE */
 
+#if (CH_CFG_RLIST_USE_BITMAP == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Removes a thread from the ready list.
+ *
+ * @param[in] oip       pointer to the OS instance
+ * @param[in] tp        the thread to be removed, it must be in the ready list
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+static inline thread_t *__sch_ready_remove(os_instance_t *oip, thread_t *tp) {
+
+  (void)oip;
+
+  return (thread_t *)ch_queue_dequeue(&tp->hdr.queue);
+}
+#endif /* CH_CFG_RLIST_USE_BITMAP == FALSE */
+
 #endif /* CHSCHD_H */
 
 /** @} */
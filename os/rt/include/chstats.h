@@ -38,6 +38,25 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Threads latency statistics.
+ * @details If enabled then the time between a thread becoming ready and
+ *          being switched in is measured for each thread.
+ */
+#if !defined(CH_DBG_STATISTICS_LATENCY) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_LATENCY           FALSE
+#endif
+
+/**
+ * @brief   Number of buckets in the latency histograms.
+ * @details Bucket @p n counts the latencies between 2^n and 2^(n+1)-1
+ *          realtime counter cycles, the last bucket also counts all the
+ *          larger latencies.
+ */
+#if !defined(CH_DBG_STATISTICS_LATENCY_BUCKETS) || defined(__DOXYGEN__)
+#define CH_DBG_STATISTICS_LATENCY_BUCKETS   16
+#endif
+
 #if CH_CFG_USE_TM == FALSE
 #error "CH_DBG_STATISTICS requires CH_CFG_USE_TM"
 #endif
@@ -46,6 +65,11 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_DBG_STATISTICS_LATENCY_BUCKETS < 1) ||                              \
+    (CH_DBG_STATISTICS_LATENCY_BUCKETS > 32)
+#error "invalid CH_DBG_STATISTICS_LATENCY_BUCKETS value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -62,6 +86,33 @@ typedef struct {
                                                 zones duration.             */
 } kernel_stats_t;
 
+#if (CH_DBG_STATISTICS_LATENCY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a thread latency statistics structure.
+ */
+typedef struct {
+  rtcnt_t               ready;      /**< @brief Time stamp of the last
+                                                ready event.                */
+  rtcnt_t               worst;      /**< @brief Worst latency.              */
+  ucnt_t                n;          /**< @brief Number of switches in.      */
+  ucnt_t                histogram[CH_DBG_STATISTICS_LATENCY_BUCKETS];
+                                    /**< @brief Logarithmic latency
+                                                histogram.                  */
+} thread_latency_t;
+#endif
+
+/**
+ * @brief   Type of a thread statistics snapshot.
+ */
+typedef struct {
+  time_measurement_t    run;        /**< @brief Measurement of the thread
+                                                run time.                   */
+#if (CH_DBG_STATISTICS_LATENCY == TRUE) || defined(__DOXYGEN__)
+  thread_latency_t      latency;    /**< @brief Ready to running latency
+                                                statistics.                 */
+#endif
+} thread_stats_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -76,14 +127,22 @@ extern "C" {
   void __stats_init(void);
   void __stats_increase_irq(void);
   void __stats_ctxswc(thread_t *ntp, thread_t *otp);
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+  void __stats_ready(thread_t *tp);
+#endif
   void __stats_start_measure_crit_thd(void);
   void __stats_stop_measure_crit_thd(void);
   void __stats_start_measure_crit_isr(void);
   void __stats_stop_measure_crit_isr(void);
+  void chStatsGetThreadStats(thread_t *tp, thread_stats_t *tsp);
 #ifdef __cplusplus
 }
 #endif
 
+#if CH_DBG_STATISTICS_LATENCY == FALSE
+#define __stats_ready(tp)
+#endif
+
 /*===========================================================================*/
 /* Module inline functions.                                                  */
 /*===========================================================================*/
@@ -104,11 +163,42 @@ static inline void __stats_object_init(kernel_stats_t *ksp) {
   chTMObjectInit(&ksp->m_crit_isr);
 }
 
+#if (CH_DBG_STATISTICS_LATENCY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Thread latency statistics initialization.
+ * @note    Internal use only.
+ *
+ * @param[out] tlp      pointer to the @p thread_latency_t structure
+ *
+ * @notapi
+ */
+static inline void __stats_latency_object_init(thread_latency_t *tlp) {
+  unsigned i;
+
+  tlp->ready = (rtcnt_t)0;
+  tlp->worst = (rtcnt_t)0;
+  tlp->n     = (ucnt_t)0;
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_LATENCY_BUCKETS; i++) {
+    tlp->histogram[i] = (ucnt_t)0;
+  }
+}
+#endif
+
 #else /* CH_DBG_STATISTICS == FALSE */
 
+/* Latency statistics require the statistics module.*/
+#if !defined(CH_DBG_STATISTICS_LATENCY)
+#define CH_DBG_STATISTICS_LATENCY           FALSE
+#endif
+
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+#error "CH_DBG_STATISTICS_LATENCY requires CH_DBG_STATISTICS"
+#endif
+
 /* Stub functions for when the statistics module is disabled. */
 #define __stats_increase_irq()
 #define __stats_ctxswc(old, new)
+#define __stats_ready(tp)
 #define __stats_start_measure_crit_thd()
 #define __stats_stop_measure_crit_thd()
 #define __stats_start_measure_crit_isr()
@@ -477,7 +477,12 @@ static inline void chSysUnconditionalUnlock(void) {
  */
 static inline thread_t *chSysGetIdleThreadX(void) {
 
+#if CH_CFG_RLIST_USE_BITMAP == TRUE
+  /* Priority one is IDLEPRIO, not yet defined at this point.*/
+  return (thread_t *)currcore->rlist.queues[1].prev;
+#else
   return (thread_t *)currcore->rlist.pqueue.prev;
+#endif
 }
 #endif /* CH_CFG_NO_IDLE_THREAD == FALSE */
 
@@ -38,6 +38,24 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Histograms precision.
+ * @details Each power of two range is divided in 2^N linear buckets, the
+ *          relative error of the percentiles is below 2^-N.
+ */
+#if !defined(CH_CFG_TM_HISTOGRAM_PRECISION) || defined(__DOXYGEN__)
+#define CH_CFG_TM_HISTOGRAM_PRECISION       3
+#endif
+
+/**
+ * @brief   Histograms range.
+ * @details Measurements up to 2^N-1 realtime counter cycles are classified,
+ *          larger measurements are counted in the last bucket.
+ */
+#if !defined(CH_CFG_TM_HISTOGRAM_RANGE) || defined(__DOXYGEN__)
+#define CH_CFG_TM_HISTOGRAM_RANGE           24
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -46,6 +64,23 @@
 #error "CH_CFG_USE_TM requires PORT_SUPPORTS_RT"
 #endif
 
+#if (CH_CFG_TM_HISTOGRAM_PRECISION < 0) ||                                  \
+    (CH_CFG_TM_HISTOGRAM_PRECISION > 8)
+#error "invalid CH_CFG_TM_HISTOGRAM_PRECISION value"
+#endif
+
+#if (CH_CFG_TM_HISTOGRAM_RANGE <= CH_CFG_TM_HISTOGRAM_PRECISION) ||         \
+    (CH_CFG_TM_HISTOGRAM_RANGE > 32)
+#error "invalid CH_CFG_TM_HISTOGRAM_RANGE value"
+#endif
+
+/**
+ * @brief   Number of buckets in a histogram.
+ */
+#define TM_HISTOGRAM_BUCKETS                                                \
+  ((CH_CFG_TM_HISTOGRAM_RANGE - CH_CFG_TM_HISTOGRAM_PRECISION + 1) <<       \
+   CH_CFG_TM_HISTOGRAM_PRECISION)
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -77,6 +112,19 @@ typedef struct {
   rttime_t              cumulative;     /**< @brief Cumulative measurement. */
 } time_measurement_t;
 
+/**
+ * @brief   Type of a Time Histogram object.
+ * @details A time measurement also classifying each measurement in
+ *          log-linear buckets, the buckets of values below
+ *          2^CH_CFG_TM_HISTOGRAM_PRECISION are one cycle wide, the width of
+ *          the other buckets doubles at each power of two.
+ */
+typedef struct {
+  time_measurement_t    tm;             /**< @brief Measurement summary.    */
+  ucnt_t                buckets[TM_HISTOGRAM_BUCKETS];
+                                        /**< @brief Measurements counters.  */
+} time_histogram_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -94,6 +142,14 @@ extern "C" {
   NOINLINE void chTMStopMeasurementX(time_measurement_t *tmp);
   NOINLINE void chTMChainMeasurementToX(time_measurement_t *tmp1,
                                         time_measurement_t *tmp2);
+  void chTMHistogramObjectInit(time_histogram_t *thp);
+  NOINLINE void chTMHistogramStartMeasurementX(time_histogram_t *thp);
+  NOINLINE void chTMHistogramStopMeasurementX(time_histogram_t *thp);
+  void chTMHistogramAddX(time_histogram_t *thp, rtcnt_t t);
+  void chTMHistogramMergeX(time_histogram_t *dthp,
+                           const time_histogram_t *sthp);
+  rtcnt_t chTMHistogramGetPercentileX(const time_histogram_t *thp,
+                                      unsigned permyriad);
 #ifdef __cplusplus
 }
 #endif
@@ -102,6 +158,18 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+/**
+ * @brief   Resets a @p time_histogram_t object.
+ *
+ * @param[out] thp      pointer to a @p time_histogram_t structure
+ *
+ * @xclass
+ */
+static inline void chTMHistogramResetX(time_histogram_t *thp) {
+
+  chTMHistogramObjectInit(thp);
+}
+
 #endif /* CH_CFG_USE_TM == TRUE */
 
 #endif /* CHTM_H */
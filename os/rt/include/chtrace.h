@@ -90,12 +90,26 @@
 #if !defined(CH_DBG_TRACE_BUFFER_SIZE) || defined(__DOXYGEN__)
 #define CH_DBG_TRACE_BUFFER_SIZE            128
 #endif
+
+/**
+ * @brief   Trace streaming mode.
+ * @details If enabled the trace buffer does not wrap, records are removed
+ *          by a consumer using @p chDbgReadTraceX() and new records are
+ *          dropped while the buffer is full.
+ */
+#if !defined(CH_DBG_TRACE_STREAM) || defined(__DOXYGEN__)
+#define CH_DBG_TRACE_STREAM                 FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_DBG_TRACE_BUFFER_SIZE < 2) || (CH_DBG_TRACE_BUFFER_SIZE > 65535)
+#error "invalid CH_DBG_TRACE_BUFFER_SIZE value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -202,6 +216,17 @@ typedef struct {
    * @brief   Pointer to the buffer front.
    */
   trace_event_t         *ptr;
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Pointer to the buffer back.
+   * @note    Only written by the records consumer.
+   */
+  trace_event_t * volatile rdptr;
+  /**
+   * @brief   Number of records dropped because the buffer was full.
+   */
+  volatile uint32_t     dropped;
+#endif
   /**
    * @brief   Ring buffer.
    */
@@ -260,6 +285,10 @@ extern "C" {
   void chDbgSuspendTrace(uint16_t mask);
   void chDbgResumeTraceI(uint16_t mask);
   void chDbgResumeTrace(uint16_t mask);
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+  size_t chDbgReadTraceX(trace_event_t *tep, size_t n);
+  uint32_t chDbgGetTraceDroppedX(void);
+#endif
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 #ifdef __cplusplus
 }
@@ -79,6 +79,9 @@ extern "C" {
   systimestamp_t chVTGetTimeStampI(void);
   void chVTResetTimeStampI(void);
 #endif
+#if CH_CFG_VT_USE_WHEEL == TRUE
+  sysinterval_t __vt_wheel_next(virtual_timers_list_t *vtlp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -212,6 +215,7 @@ static inline bool chVTIsSystemTimeWithin(systime_t start, systime_t end) {
  */
 static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
   virtual_timers_list_t *vtlp = &currcore->vtlist;
+#if CH_CFG_VT_USE_WHEEL == FALSE
   delta_list_t *dlp = &vtlp->dlist;
 
   chDbgCheckClassI();
@@ -228,6 +232,25 @@ static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
              chTimeDiffX(vtlp->lasttime, chVTGetSystemTimeX());
 #endif
   }
+#else /* CH_CFG_VT_USE_WHEEL == TRUE */
+
+  chDbgCheckClassI();
+
+  if (vtlp->levelsmap == 0U) {
+    return false;
+  }
+
+  /* Note, the next wheel event can be a cascade point preceding the
+     actual timer expiration.*/
+  if (timep != NULL) {
+#if CH_CFG_ST_TIMEDELTA == 0
+    *timep = __vt_wheel_next(vtlp);
+#else
+    *timep = (__vt_wheel_next(vtlp) + (sysinterval_t)CH_CFG_ST_TIMEDELTA) -
+             chTimeDiffX(vtlp->lasttime, chVTGetSystemTimeX());
+#endif
+  }
+#endif /* CH_CFG_VT_USE_WHEEL == TRUE */
 
   return true;
 }
@@ -417,9 +440,27 @@ static inline void chVTResetTimeStamp(void) {
  */
 static inline void __vt_object_init(virtual_timers_list_t *vtlp) {
 
+#if CH_CFG_VT_USE_WHEEL == FALSE
   vtlp->dlist.next  = &vtlp->dlist;
   vtlp->dlist.prev  = &vtlp->dlist;
   vtlp->dlist.delta = (sysinterval_t)-1;
+#else /* CH_CFG_VT_USE_WHEEL == TRUE */
+  unsigned i;
+
+  for (i = 0U; i < (CH_VT_WHEEL_LEVELS * CH_VT_WHEEL_SLOTS); i++) {
+    vtlp->slots[i].next  = &vtlp->slots[i];
+    vtlp->slots[i].prev  = &vtlp->slots[i];
+    vtlp->slots[i].delta = (sysinterval_t)0;
+  }
+  for (i = 0U; i < CH_VT_WHEEL_LEVELS; i++) {
+    vtlp->slotsmap[i] = 0U;
+  }
+  vtlp->expired.next  = &vtlp->expired;
+  vtlp->expired.prev  = &vtlp->expired;
+  vtlp->expired.delta = (sysinterval_t)0;
+  vtlp->levelsmap     = 0U;
+  vtlp->wtime         = (sysinterval_t)0;
+#endif /* CH_CFG_VT_USE_WHEEL == TRUE */
 #if CH_CFG_ST_TIMEDELTA == 0
   vtlp->systime = (systime_t)0;
 #else /* CH_CFG_ST_TIMEDELTA > 0 */
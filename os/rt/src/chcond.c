@@ -32,6 +32,12 @@
  *          The condition variable is a synchronization object meant to be
  *          used inside a zone protected by a mutex. Mutexes and condition
  *          variables together can implement a Monitor construct.
+ *          <h2>Wait morphing</h2>
+ *          If the option @p CH_CFG_USE_CONDVARS_REQUEUE is enabled then a
+ *          broadcast does not make all the waiting threads ready at once,
+ *          the threads would immediately contend for the same mutex. The
+ *          threads are moved on the mutex queue instead and are woken one
+ *          at time as the mutex is passed from owner to owner.
  * @pre     In order to use the condition variable APIs the @p CH_CFG_USE_CONDVARS
  *          option must be enabled in @p chconf.h.
  * @{
@@ -77,6 +83,9 @@ void chCondObjectInit(condition_variable_t *cp) {
   chDbgCheck(cp != NULL);
 
   ch_queue_init(&cp->queue);
+#if CH_CFG_USE_CONDVARS_REQUEUE == TRUE
+  cp->mutex = NULL;
+#endif
 }
 
 /**
@@ -155,7 +164,22 @@ void chCondBroadcastI(condition_variable_t *cp) {
      ready list in FIFO order. The wakeup message is set to @p MSG_RESET in
      order to make a chCondBroadcast() detectable from a chCondSignal().*/
   while (ch_queue_notempty(&cp->queue)) {
+#if CH_CFG_USE_CONDVARS_REQUEUE == TRUE
+    thread_t *tp = (thread_t *)ch_queue_fifo_remove(&cp->queue);
+
+    /* Wait morphing, threads are moved on the mutex queue in the same
+       order, only the first one is woken when the mutex is unlocked. The
+       timer of timed waits cannot be stopped here so those threads are
+       made ready as usual.*/
+    if ((tp->flags & CH_FLAG_TIMED_WAIT) == (tmode_t)0) {
+      chMtxRequeueI(cp->mutex, tp, MSG_RESET);
+    }
+    else {
+      chSchReadyI(tp)->u.rdymsg = MSG_RESET;
+    }
+#else
     chSchReadyI((thread_t *)ch_queue_fifo_remove(&cp->queue))->u.rdymsg = MSG_RESET;
+#endif
   }
 }
 
@@ -214,11 +238,24 @@ msg_t chCondWaitS(condition_variable_t *cp) {
   /* Releasing "current" mutex.*/
   chMtxUnlockS(mp);
 
+#if CH_CFG_USE_CONDVARS_REQUEUE == TRUE
+  chDbgAssert((cp->mutex == NULL) || (cp->mutex == mp) ||
+              ch_queue_isempty(&cp->queue), "different mutexes");
+  cp->mutex = mp;
+#endif
+
   /* Start waiting on the condition variable, on exit the mutex is taken
      again.*/
   currtp->u.wtobjp = cp;
   ch_sch_prio_insert(&currtp->hdr.queue, &cp->queue);
   chSchGoSleepS(CH_STATE_WTCOND);
+#if CH_CFG_USE_CONDVARS_REQUEUE == TRUE
+  /* After a broadcast the mutex has already been assigned to this thread
+     by the unlock operation, the message field is no more valid.*/
+  if (mp->owner == currtp) {
+    return MSG_RESET;
+  }
+#endif
   msg = currtp->u.rdymsg;
   chMtxLockS(mp);
 
@@ -304,11 +341,31 @@ msg_t chCondWaitTimeoutS(condition_variable_t *cp, sysinterval_t timeout) {
   /* Releasing "current" mutex.*/
   chMtxUnlockS(mp);
 
+#if CH_CFG_USE_CONDVARS_REQUEUE == TRUE
+  chDbgAssert((cp->mutex == NULL) || (cp->mutex == mp) ||
+              ch_queue_isempty(&cp->queue), "different mutexes");
+  cp->mutex = mp;
+
+  /* Timed waits cannot be moved on the mutex queue by a broadcast.*/
+  if (timeout != TIME_INFINITE) {
+    currtp->flags |= CH_FLAG_TIMED_WAIT;
+  }
+#endif
+
   /* Start waiting on the condition variable, on exit the mutex is taken
      again.*/
   currtp->u.wtobjp = cp;
   ch_sch_prio_insert(&currtp->hdr.queue, &cp->queue);
   msg = chSchGoSleepTimeoutS(CH_STATE_WTCOND, timeout);
+#if CH_CFG_USE_CONDVARS_REQUEUE == TRUE
+  currtp->flags &= (tmode_t)~CH_FLAG_TIMED_WAIT;
+
+  /* After a broadcast the mutex has already been assigned to this thread
+     by the unlock operation, the message field is no more valid.*/
+  if (mp->owner == currtp) {
+    return MSG_RESET;
+  }
+#endif
   if (msg != MSG_TIMEOUT) {
     chMtxLockS(mp);
   }
@@ -36,6 +36,10 @@
  *          Messages are usually processed in FIFO order but it is possible to
  *          process them in priority order by enabling the
  *          @p CH_CFG_USE_MESSAGES_PRIORITY option in @p chconf.h.<br>
+ *          Buffer messages carry a payload described by a list of
+ *          segments, the payload is copied by the receiver directly from
+ *          the sender segments into its own segments while the sender is
+ *          suspended, no shared buffers are required.<br>
  * @pre     In order to use the message APIs the @p CH_CFG_USE_MESSAGES option
  *          must be enabled in @p chconf.h.
  * @post    Enabling messages requires 6-12 (depending on the architecture)
@@ -43,6 +47,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "ch.h"
 
 #if (CH_CFG_USE_MESSAGES == TRUE) || defined(__DOXYGEN__)
@@ -55,6 +61,15 @@
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+/**
+ * @brief   Buffer message descriptor.
+ * @note    It is allocated on the sender stack.
+ */
+typedef struct {
+  const msg_segment_t   *segs;
+  unsigned              n;
+} msg_buffer_t;
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
@@ -102,6 +117,47 @@ msg_t chMsgSend(thread_t *tp, msg_t msg) {
   return msg;
 }
 
+/**
+ * @brief   Sends a buffer message to the specified thread.
+ * @details The sender is stopped until the receiver executes a
+ *          @p chMsgRelease() after receiving the message, the payload is
+ *          gathered from the specified segments by the receiver using
+ *          @p chMsgReceiveBuffer().
+ * @note    The segments array and the segments themselves must stay
+ *          valid until the function returns.
+ *
+ * @param[in] tp        the pointer to the thread
+ * @param[in] segs      array of payload segments
+ * @param[in] n         number of segments, it can be zero
+ * @return              The answer message from @p chMsgRelease().
+ *
+ * @api
+ */
+msg_t chMsgSendBuffer(thread_t *tp, const msg_segment_t *segs, unsigned n) {
+  thread_t *currtp = chThdGetSelfX();
+  msg_buffer_t mb;
+  msg_t msg;
+
+  chDbgCheck((tp != NULL) && ((n == 0U) || (segs != NULL)));
+
+  mb.segs = segs;
+  mb.n    = n;
+
+  chSysLock();
+  currtp->flags |= CH_FLAG_MSG_BUFFER;
+  currtp->u.sentmsg = (msg_t)(void *)&mb;
+  msg_insert(currtp, &tp->msgqueue);
+  if (tp->state == CH_STATE_WTMSG) {
+    (void) chSchReadyI(tp);
+  }
+  chSchGoSleepS(CH_STATE_SNDMSGQ);
+  currtp->flags &= (tmode_t)~CH_FLAG_MSG_BUFFER;
+  msg = currtp->u.rdymsg;
+  chSysUnlock();
+
+  return msg;
+}
+
 /**
  * @brief   Suspends the thread and waits for an incoming message.
  * @post    After receiving a message the function @p chMsgGet() must be
@@ -219,6 +275,72 @@ void chMsgRelease(thread_t *tp, msg_t msg) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Copies the payload of a buffer message.
+ * @details The sender segments are scattered into the specified segments,
+ *          the copy is bounded by the total size of the receiver segments,
+ *          any excess data is not copied.
+ * @pre     Invoke this function only after a buffer message has been
+ *          received using @p chMsgWait() and before releasing it.
+ * @note    The copy is performed outside the kernel critical zone, the
+ *          sender is suspended so its segments are stable. The function
+ *          can be called more than once, each call copies from the start
+ *          of the payload.
+ *
+ * @param[in] tp        pointer to the thread carrying the message
+ * @param[in] segs      array of destination segments
+ * @param[in] n         number of segments, it can be zero
+ * @return              The number of bytes copied.
+ *
+ * @api
+ */
+size_t chMsgReceiveBuffer(thread_t *tp, const msg_segment_t *segs,
+                          unsigned n) {
+  const msg_buffer_t *mbp;
+  const msg_segment_t *txp;
+  unsigned txn;
+  size_t txoffs, rxoffs, total;
+
+  chDbgCheck((tp != NULL) && ((n == 0U) || (segs != NULL)));
+  chDbgAssert(tp->state == CH_STATE_SNDMSG, "invalid state");
+  chDbgAssert((tp->flags & CH_FLAG_MSG_BUFFER) != (tmode_t)0,
+              "not a buffer message");
+
+  mbp    = (const msg_buffer_t *)(void *)tp->u.sentmsg;
+  txp    = mbp->segs;
+  txn    = mbp->n;
+  txoffs = (size_t)0;
+  rxoffs = (size_t)0;
+  total  = (size_t)0;
+  while ((txn > 0U) && (n > 0U)) {
+    size_t size = txp->size - txoffs;
+
+    if (size > (segs->size - rxoffs)) {
+      size = segs->size - rxoffs;
+    }
+    memcpy((void *)((uint8_t *)segs->buf + rxoffs),
+           (const void *)((const uint8_t *)txp->buf + txoffs), size);
+    total  += size;
+    txoffs += size;
+    rxoffs += size;
+
+    /* Moving to the next segment on each side when the current one
+       has been fully used, empty segments are just skipped.*/
+    if (txoffs >= txp->size) {
+      txp++;
+      txn--;
+      txoffs = (size_t)0;
+    }
+    if (rxoffs >= segs->size) {
+      segs++;
+      n--;
+      rxoffs = (size_t)0;
+    }
+  }
+
+  return total;
+}
+
 #endif /* CH_CFG_USE_MESSAGES == TRUE */
 
 /** @} */
@@ -89,6 +89,68 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Priority inheritance protocol.
+ * @details Explores the thread-mutex dependencies boosting the priority of
+ *          all the affected threads to equal the priority of a thread
+ *          requesting the mutex.
+ *
+ * @param[in] tp        pointer to the thread owning the mutex
+ * @param[in] prio      priority of the thread requesting the mutex
+ */
+static void mtx_inherit_priority(thread_t *tp, tprio_t prio) {
+
+  /* Does the waiting thread have higher priority than the mutex
+     owning thread? */
+  while (tp->hdr.pqueue.prio < prio) {
+    /* Make priority of thread tp match the waiting thread's priority.*/
+    tp->hdr.pqueue.prio = prio;
+
+    /* The following states need priority queues reordering.*/
+    switch (tp->state) {
+    case CH_STATE_WTMTX:
+      /* Re-enqueues the mutex owner with its new priority.*/
+      ch_sch_prio_insert(ch_queue_dequeue(&tp->hdr.queue),
+                         &tp->u.wtmtxp->queue);
+      tp = tp->u.wtmtxp->owner;
+      /*lint -e{9042} [16.1] Continues the while.*/
+      continue;
+#if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
+    ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
+     (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)) ||                           \
+    ((CH_CFG_USE_MESSAGES == TRUE) &&                                       \
+     (CH_CFG_USE_MESSAGES_PRIORITY == TRUE))
+#if CH_CFG_USE_CONDVARS == TRUE
+    case CH_STATE_WTCOND:
+#endif
+#if (CH_CFG_USE_SEMAPHORES == TRUE) &&                                      \
+    (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)
+    case CH_STATE_WTSEM:
+#endif
+#if (CH_CFG_USE_MESSAGES == TRUE) && (CH_CFG_USE_MESSAGES_PRIORITY == TRUE)
+    case CH_STATE_SNDMSGQ:
+#endif
+      /* Re-enqueues tp with its new priority on the queue.*/
+      ch_sch_prio_insert(ch_queue_dequeue(&tp->hdr.queue),
+                         &tp->u.wtmtxp->queue);
+      break;
+#endif
+    case CH_STATE_READY:
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+      /* Prevents an assertion in chSchReadyI().*/
+      tp->state = CH_STATE_CURRENT;
+#endif
+      /* Re-enqueues tp with its new priority on the ready list.*/
+      (void) chSchReadyI(__sch_ready_remove(currcore, tp));
+      break;
+    default:
+      /* Nothing to do for other states.*/
+      break;
+    }
+    break;
+  }
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -158,57 +220,7 @@ void chMtxLockS(mutex_t *mp) {
       /* Priority inheritance protocol; explores the thread-mutex dependencies
          boosting the priority of all the affected threads to equal the
          priority of the running thread requesting the mutex.*/
-      thread_t *tp = mp->owner;
-
-      /* Does the running thread have higher priority than the mutex
-         owning thread? */
-      while (tp->hdr.pqueue.prio < currtp->hdr.pqueue.prio) {
-        /* Make priority of thread tp match the running thread's priority.*/
-        tp->hdr.pqueue.prio = currtp->hdr.pqueue.prio;
-
-        /* The following states need priority queues reordering.*/
-        switch (tp->state) {
-        case CH_STATE_WTMTX:
-          /* Re-enqueues the mutex owner with its new priority.*/
-          ch_sch_prio_insert(ch_queue_dequeue(&tp->hdr.queue),
-                             &tp->u.wtmtxp->queue);
-          tp = tp->u.wtmtxp->owner;
-          /*lint -e{9042} [16.1] Continues the while.*/
-          continue;
-#if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
-    ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
-     (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)) ||                           \
-    ((CH_CFG_USE_MESSAGES == TRUE) &&                                       \
-     (CH_CFG_USE_MESSAGES_PRIORITY == TRUE))
-#if CH_CFG_USE_CONDVARS == TRUE
-        case CH_STATE_WTCOND:
-#endif
-#if (CH_CFG_USE_SEMAPHORES == TRUE) &&                                      \
-    (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)
-        case CH_STATE_WTSEM:
-#endif
-#if (CH_CFG_USE_MESSAGES == TRUE) && (CH_CFG_USE_MESSAGES_PRIORITY == TRUE)
-        case CH_STATE_SNDMSGQ:
-#endif
-          /* Re-enqueues tp with its new priority on the queue.*/
-          ch_sch_prio_insert(ch_queue_dequeue(&tp->hdr.queue),
-                             &tp->u.wtmtxp->queue);
-          break;
-#endif
-        case CH_STATE_READY:
-#if CH_DBG_ENABLE_ASSERTS == TRUE
-          /* Prevents an assertion in chSchReadyI().*/
-          tp->state = CH_STATE_CURRENT;
-#endif
-          /* Re-enqueues tp with its new priority on the ready list.*/
-          (void) chSchReadyI((thread_t *)ch_queue_dequeue(&tp->hdr.queue));
-          break;
-        default:
-          /* Nothing to do for other states.*/
-          break;
-        }
-        break;
-      }
+      mtx_inherit_priority(mp->owner, currtp->hdr.pqueue.prio);
 
       /* Sleep on the mutex.*/
       ch_sch_prio_insert(&currtp->hdr.queue, &mp->queue);
@@ -535,6 +547,55 @@ void chMtxUnlockAll(void) {
   chSysUnlock();
 }
 
+#if ((CH_CFG_USE_CONDVARS == TRUE) &&                                       \
+     (CH_CFG_USE_CONDVARS_REQUEUE == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves a waiting thread on the queue of a mutex.
+ * @details The thread is enqueued as if it invoked @p chMtxLockS(), the
+ *          priority inheritance is applied to the mutex owner. If the
+ *          mutex is not owned then it is assigned to the thread and the
+ *          thread is made ready with the specified message.
+ * @note    The thread must have already been removed from the queue it
+ *          was waiting on, this is used for condition variables wait
+ *          morphing.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] mp        pointer to the @p mutex_t structure
+ * @param[in] tp        pointer to the waiting thread
+ * @param[in] msg       message for the thread if made ready
+ *
+ * @iclass
+ */
+void chMtxRequeueI(mutex_t *mp, thread_t *tp, msg_t msg) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (tp != NULL));
+
+  if (mp->owner != NULL) {
+    chDbgAssert(mp->owner != tp, "already owner");
+
+    /* Same as chMtxLockS() but on behalf of the waiting thread.*/
+    mtx_inherit_priority(mp->owner, tp->hdr.pqueue.prio);
+    ch_sch_prio_insert(&tp->hdr.queue, &mp->queue);
+    tp->u.wtmtxp = mp;
+    tp->state = CH_STATE_WTMTX;
+  }
+  else {
+#if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
+    chDbgAssert(mp->cnt == (cnt_t)0, "counter is not zero");
+
+    mp->cnt++;
+#endif
+    /* It was not owned, assigned to the thread that is made ready.*/
+    mp->owner = tp;
+    mp->next = tp->mtxlist;
+    tp->mtxlist = mp;
+    chSchReadyI(tp)->u.rdymsg = msg;
+  }
+}
+#endif /* CH_CFG_USE_CONDVARS_REQUEUE == TRUE */
+
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
 /** @} */
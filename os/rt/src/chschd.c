@@ -48,6 +48,158 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_RLIST_USE_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Marks a priority level as non-empty in the ready list bitmap.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] prio      the priority level
+ *
+ * @notapi
+ */
+static inline void __rl_bitmap_set(ready_list_t *rlp, tprio_t prio) {
+
+  rlp->prmap[prio >> 5] |= (uint32_t)1U << (prio & 31U);
+  rlp->grmap            |= (uint32_t)1U << (prio >> 5);
+}
+
+/**
+ * @brief   Marks a priority level as empty in the ready list bitmap.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] prio      the priority level
+ *
+ * @notapi
+ */
+static inline void __rl_bitmap_clear(ready_list_t *rlp, tprio_t prio) {
+
+  rlp->prmap[prio >> 5] &= ~((uint32_t)1U << (prio & 31U));
+  if (rlp->prmap[prio >> 5] == 0U) {
+    rlp->grmap &= ~((uint32_t)1U << (prio >> 5));
+  }
+}
+
+/**
+ * @brief   Finds the highest priority thread in the ready list.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @return              The first thread of the highest priority non-empty
+ *                      queue or the ready list header if there are no
+ *                      ready threads.
+ *
+ * @notapi
+ */
+static inline ch_priority_queue_t *__rl_find_highest(ready_list_t *rlp) {
+  unsigned w, b;
+
+  if (rlp->grmap == 0U) {
+    return &rlp->pqueue;
+  }
+
+  w = 31U - port_clz32(rlp->grmap);
+  b = 31U - port_clz32(rlp->prmap[w]);
+
+  return (ch_priority_queue_t *)rlp->queues[(w << 5) + b].next;
+}
+#endif /* CH_CFG_RLIST_USE_BITMAP == TRUE */
+
+/**
+ * @brief   Inserts a thread in the ready list behind its peers.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] tp        the thread to be inserted
+ * @return              The thread pointer.
+ *
+ * @notapi
+ */
+static inline thread_t *__rl_insert_behind(ready_list_t *rlp, thread_t *tp) {
+
+#if CH_CFG_RLIST_USE_BITMAP == TRUE
+  tprio_t prio = tp->hdr.pqueue.prio;
+
+  /* Insertion at the end of the priority level queue.*/
+  ch_queue_insert(&tp->hdr.queue, &rlp->queues[prio]);
+  __rl_bitmap_set(rlp, prio);
+
+  /* Updating the cached highest priority thread, peers remain ahead.*/
+  if (prio > rlp->pqueue.next->prio) {
+    rlp->pqueue.next = &tp->hdr.pqueue;
+  }
+
+  return tp;
+#else
+  return (thread_t *)ch_pqueue_insert_behind(&rlp->pqueue, &tp->hdr.pqueue);
+#endif
+}
+
+/**
+ * @brief   Inserts a thread in the ready list ahead of its peers.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] tp        the thread to be inserted
+ * @return              The thread pointer.
+ *
+ * @notapi
+ */
+static inline thread_t *__rl_insert_ahead(ready_list_t *rlp, thread_t *tp) {
+
+#if CH_CFG_RLIST_USE_BITMAP == TRUE
+  tprio_t prio = tp->hdr.pqueue.prio;
+  ch_queue_t *qp = &rlp->queues[prio];
+
+  /* Insertion at the start of the priority level queue.*/
+  tp->hdr.queue.next       = qp->next;
+  tp->hdr.queue.prev       = qp;
+  tp->hdr.queue.next->prev = &tp->hdr.queue;
+  qp->next                 = &tp->hdr.queue;
+  __rl_bitmap_set(rlp, prio);
+
+  /* Updating the cached highest priority thread, it goes ahead of peers.*/
+  if (prio >= rlp->pqueue.next->prio) {
+    rlp->pqueue.next = &tp->hdr.pqueue;
+  }
+
+  return tp;
+#else
+  return (thread_t *)ch_pqueue_insert_ahead(&rlp->pqueue, &tp->hdr.pqueue);
+#endif
+}
+
+/**
+ * @brief   Removes the highest priority thread from the ready list.
+ * @pre     The ready list must not be empty.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+static inline thread_t *__rl_remove_highest(ready_list_t *rlp) {
+
+#if CH_CFG_RLIST_USE_BITMAP == TRUE
+  thread_t *tp = (thread_t *)rlp->pqueue.next;
+  ch_queue_t *qp = &rlp->queues[tp->hdr.pqueue.prio];
+
+  /* The cached thread is always the first of its priority level queue.*/
+  qp->next       = tp->hdr.queue.next;
+  qp->next->prev = qp;
+
+  if (qp->next != qp) {
+    /* Next peer becomes the highest priority thread.*/
+    rlp->pqueue.next = (ch_priority_queue_t *)qp->next;
+  }
+  else {
+    /* Level emptied, looking up the next non-empty one.*/
+    __rl_bitmap_clear(rlp, tp->hdr.pqueue.prio);
+    rlp->pqueue.next = __rl_find_highest(rlp);
+  }
+
+  return tp;
+#else
+  return (thread_t *)ch_pqueue_remove_highest(&rlp->pqueue);
+#endif
+}
+
 #if (CH_CFG_NO_IDLE_THREAD == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   This function implements the idle thread infinite loop.
@@ -98,13 +250,13 @@ static thread_t *__sch_ready_behind(os_instance_t *oip, thread_t *tp) {
 
   /* Tracing the event.*/
   __trace_ready(tp, tp->u.rdymsg);
+  __stats_ready(tp);
 
   /* The thread is marked ready.*/
   tp->state = CH_STATE_READY;
 
-  /* Insertion in the priority queue.*/
-  return (thread_t *)ch_pqueue_insert_behind(&oip->rlist.pqueue,
-                                             &tp->hdr.pqueue);
+  /* Insertion in the ready list.*/
+  return __rl_insert_behind(&oip->rlist, tp);
 }
 
 /**
@@ -132,13 +284,13 @@ static thread_t *__sch_ready_ahead(os_instance_t *oip, thread_t *tp) {
 
   /* Tracing the event.*/
   __trace_ready(tp, tp->u.rdymsg);
+  __stats_ready(tp);
 
   /* The thread is marked ready.*/
   tp->state = CH_STATE_READY;
 
-  /* Insertion in the priority queue.*/
-  return (thread_t *)ch_pqueue_insert_ahead(&oip->rlist.pqueue,
-                                            &tp->hdr.pqueue);
+  /* Insertion in the ready list.*/
+  return __rl_insert_ahead(&oip->rlist, tp);
 }
 
 /**
@@ -158,7 +310,7 @@ static void __sch_reschedule_behind(os_instance_t *oip) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = (thread_t *)ch_pqueue_remove_highest(&oip->rlist.pqueue);
+  ntp = __rl_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __sch_set_currthread(oip, ntp);
 
@@ -195,7 +347,7 @@ static void __sch_reschedule_ahead(os_instance_t *oip) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = (thread_t *)ch_pqueue_remove_highest(&oip->rlist.pqueue);
+  ntp = __rl_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __sch_set_currthread(oip, ntp);
 
@@ -282,6 +434,39 @@ void ch_sch_prio_insert(ch_queue_t *tp, ch_queue_t *qp) {
 }
 #endif /* CH_CFG_OPTIMIZE_SPEED */
 
+#if (CH_CFG_RLIST_USE_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Removes a thread from the ready list.
+ * @note    The thread priority field is not used so it can be modified
+ *          before removing the thread, this is required by the priority
+ *          inheritance code.
+ *
+ * @param[in] oip       pointer to the OS instance
+ * @param[in] tp        the thread to be removed, it must be in the ready list
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+thread_t *__sch_ready_remove(os_instance_t *oip, thread_t *tp) {
+  ready_list_t *rlp = &oip->rlist;
+
+  (void) ch_queue_dequeue(&tp->hdr.queue);
+
+  /* If the thread was the last one of its queue then both links point to
+     the queue header, the header position gives the priority level.*/
+  if (tp->hdr.queue.next == tp->hdr.queue.prev) {
+    __rl_bitmap_clear(rlp, (tprio_t)(tp->hdr.queue.next - &rlp->queues[0]));
+  }
+
+  /* Removing the cached thread requires a new lookup.*/
+  if (rlp->pqueue.next == &tp->hdr.pqueue) {
+    rlp->pqueue.next = __rl_find_highest(rlp);
+  }
+
+  return tp;
+}
+#endif /* CH_CFG_RLIST_USE_BITMAP == TRUE */
+
 /**
  * @brief   Initializes a system instance.
  * @note    The system instance is in I-Lock state after initialization.
@@ -299,6 +484,19 @@ void chSchObjectInit(os_instance_t *oip,
 
   /* Ready list initialization.*/
   ch_pqueue_init(&oip->rlist.pqueue);
+#if CH_CFG_RLIST_USE_BITMAP == TRUE
+  {
+    unsigned i;
+
+    for (i = 0U; i < CH_RLIST_PRIO_LEVELS; i++) {
+      ch_queue_init(&oip->rlist.queues[i]);
+    }
+    for (i = 0U; i < CH_RLIST_PRIO_WORDS; i++) {
+      oip->rlist.prmap[i] = 0U;
+    }
+    oip->rlist.grmap = 0U;
+  }
+#endif
 
   /* Registry initialization.*/
 #if CH_CFG_USE_REGISTRY == TRUE
@@ -423,7 +621,7 @@ void chSchGoSleepS(tstate_t newstate) {
 #endif
 
   /* Next thread in ready list becomes current.*/
-  ntp = (thread_t *)ch_pqueue_remove_highest(&oip->rlist.pqueue);
+  ntp = __rl_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __sch_set_currthread(oip, ntp);
 
@@ -526,6 +724,9 @@ void chSchWakeupS(thread_t *ntp, msg_t msg) {
       CH_CFG_IDLE_LEAVE_HOOK();
     }
 
+    /* The waken thread skips the ready list, its latency starts now.*/
+    __stats_ready(ntp);
+
     /* The extracted thread is marked as current.*/
     ntp->state = CH_STATE_CURRENT;
     __sch_set_currthread(oip, ntp);
@@ -607,7 +808,7 @@ void chSchDoPreemption(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = (thread_t *)ch_pqueue_remove_highest(&oip->rlist.pqueue);
+  ntp = __rl_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __sch_set_currthread(oip, ntp);
 
@@ -713,7 +914,7 @@ thread_t *chSchSelectFirstI(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = (thread_t *)ch_pqueue_remove_highest(&oip->rlist.pqueue);
+  ntp = __rl_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __sch_set_currthread(oip, ntp);
 
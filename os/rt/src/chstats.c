@@ -50,6 +50,28 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_DBG_STATISTICS_LATENCY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Histogram bucket of a latency value.
+ *
+ * @param[in] t         the latency in realtime counter cycles
+ * @return              The bucket index, the integer part of the base 2
+ *                      logarithm of the latency clamped to the histogram
+ *                      size.
+ */
+static unsigned latency_bucket(rtcnt_t t) {
+  unsigned i = 0U;
+
+  while ((t > (rtcnt_t)1) &&
+         (i < ((unsigned)CH_DBG_STATISTICS_LATENCY_BUCKETS - 1U))) {
+    t >>= 1;
+    i++;
+  }
+
+  return i;
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -74,7 +96,31 @@ void __stats_ctxswc(thread_t *ntp, thread_t *otp) {
 
   currcore->kernel_stats.n_ctxswc++;
   chTMChainMeasurementToX(&otp->stats, &ntp->stats);
+
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+  {
+    rtcnt_t t = chSysGetRealtimeCounterX() - ntp->latency.ready;
+
+    if (t > ntp->latency.worst) {
+      ntp->latency.worst = t;
+    }
+    ntp->latency.n++;
+    ntp->latency.histogram[latency_bucket(t)]++;
+  }
+#endif
+}
+
+#if (CH_DBG_STATISTICS_LATENCY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Records the time a thread becomes ready.
+ *
+ * @param[in] tp        the thread made ready
+ */
+void __stats_ready(thread_t *tp) {
+
+  tp->latency.ready = chSysGetRealtimeCounterX();
 }
+#endif
 
 /**
  * @brief   Starts the measurement of a thread critical zone.
@@ -108,6 +154,26 @@ void __stats_stop_measure_crit_isr(void) {
   chTMStopMeasurementX(&currcore->kernel_stats.m_crit_isr);
 }
 
+/**
+ * @brief   Returns a snapshot of the statistics of a thread.
+ * @note    The run time measurement of the current thread does not include
+ *          the time elapsed since it has been switched in.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[out] tsp      pointer to a @p thread_stats_t structure
+ *
+ * @api
+ */
+void chStatsGetThreadStats(thread_t *tp, thread_stats_t *tsp) {
+
+  chSysLock();
+  tsp->run     = tp->stats;
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+  tsp->latency = tp->latency;
+#endif
+  chSysUnlock();
+}
+
 #endif /* CH_DBG_STATISTICS == TRUE */
 
 /** @} */
@@ -175,6 +175,7 @@ bool chSysIntegrityCheckI(unsigned testmask) {
 
   /* Ready List integrity check.*/
   if ((testmask & CH_INTEGRITY_RLIST) != 0U) {
+#if CH_CFG_RLIST_USE_BITMAP == FALSE
     ch_priority_queue_t *pqp;
 
     /* Scanning the ready list forward.*/
@@ -196,10 +197,68 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+#else /* CH_CFG_RLIST_USE_BITMAP == TRUE */
+    ch_priority_queue_t *highest = &oip->rlist.pqueue;
+    unsigned i;
+
+    /* Scanning all the priority levels, the queues must be consistent
+       and the bitmap must reflect the queues state.*/
+    for (i = 0U; i < CH_RLIST_PRIO_LEVELS; i++) {
+      ch_queue_t *hp = &oip->rlist.queues[i];
+      ch_queue_t *qp;
+      bool used;
+
+      /* Scanning the queue forward, all threads must have the queue
+         priority.*/
+      n = (cnt_t)0;
+      qp = hp->next;
+      while (qp != hp) {
+        if (((thread_t *)qp)->hdr.pqueue.prio != (tprio_t)i) {
+          return true;
+        }
+        n++;
+        qp = qp->next;
+      }
+      used = (bool)(n > (cnt_t)0);
+
+      /* Scanning the queue backward.*/
+      qp = hp->prev;
+      while (qp != hp) {
+        n--;
+        qp = qp->prev;
+      }
+
+      /* The number of elements must match.*/
+      if (n != (cnt_t)0) {
+        return true;
+      }
+
+      /* The queue state must match the bitmaps.*/
+      if (used != (bool)((oip->rlist.prmap[i / 32U] &
+                          (1U << (i % 32U))) != 0U)) {
+        return true;
+      }
+      if ((oip->rlist.prmap[i / 32U] != 0U) !=
+          ((oip->rlist.grmap & (1U << (i / 32U))) != 0U)) {
+        return true;
+      }
+
+      if (used) {
+        highest = (ch_priority_queue_t *)hp->next;
+      }
+    }
+
+    /* The cached highest priority thread must be the first thread of the
+       highest non-empty queue.*/
+    if (oip->rlist.pqueue.next != highest) {
+      return true;
+    }
+#endif /* CH_CFG_RLIST_USE_BITMAP == TRUE */
   }
 
   /* Timers list integrity check.*/
   if ((testmask & CH_INTEGRITY_VTLIST) != 0U) {
+#if CH_CFG_VT_USE_WHEEL == FALSE
     delta_list_t *dlp;
 
     /* Scanning the timers list forward.*/
@@ -221,6 +280,44 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+#else /* CH_CFG_VT_USE_WHEEL == TRUE */
+    unsigned i;
+
+    /* Scanning all the wheel slots, the slot lists must be consistent
+       and the slots mask must reflect the slots state.*/
+    for (i = 0U; i < (CH_VT_WHEEL_LEVELS * CH_VT_WHEEL_SLOTS); i++) {
+      delta_list_t *hp = &oip->vtlist.slots[i];
+      delta_list_t *dlp;
+      bool used;
+
+      /* Scanning the slot list forward.*/
+      n = (cnt_t)0;
+      dlp = hp->next;
+      while (dlp != hp) {
+        n++;
+        dlp = dlp->next;
+      }
+      used = (bool)(n > (cnt_t)0);
+
+      /* Scanning the slot list backward.*/
+      dlp = hp->prev;
+      while (dlp != hp) {
+        n--;
+        dlp = dlp->prev;
+      }
+
+      /* The number of elements must match.*/
+      if (n != (cnt_t)0) {
+        return true;
+      }
+
+      /* The slot state must match the mask.*/
+      if (used != (bool)((oip->vtlist.slotsmap[i / CH_VT_WHEEL_SLOTS] &
+                          (1U << (i % CH_VT_WHEEL_SLOTS))) != 0U)) {
+        return true;
+      }
+    }
+#endif /* CH_CFG_VT_USE_WHEEL == TRUE */
   }
 
 #if CH_CFG_USE_REGISTRY == TRUE
@@ -125,6 +125,9 @@ thread_t *__thd_object_init(os_instance_t *oip,
 #endif
 #if CH_DBG_STATISTICS == TRUE
   chTMObjectInit(&tp->stats);
+#endif
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+  __stats_latency_object_init(&tp->latency);
 #endif
   CH_CFG_THREAD_INIT_HOOK(tp);
   return tp;
@@ -72,6 +72,50 @@ static inline void tm_stop(time_measurement_t *tmp,
   }
 }
 
+/**
+ * @brief   Histogram bucket of a measurement.
+ * @note    Constant time, it is used in the measurements critical path.
+ *
+ * @param[in] t         the measurement in realtime counter cycles
+ * @return              The bucket index.
+ */
+static inline unsigned tm_bucket(rtcnt_t t) {
+  unsigned msb;
+
+  if (t < ((rtcnt_t)1 << CH_CFG_TM_HISTOGRAM_PRECISION)) {
+    return (unsigned)t;
+  }
+  if (t >= (rtcnt_t)(((uint64_t)1 << CH_CFG_TM_HISTOGRAM_RANGE) - 1U)) {
+    return (unsigned)TM_HISTOGRAM_BUCKETS - 1U;
+  }
+
+  /* Buckets group from the most significant bit position, position in
+     the group from the following bits.*/
+  msb = 31U - port_clz32((uint32_t)t);
+  return ((msb - (unsigned)CH_CFG_TM_HISTOGRAM_PRECISION + 1U) <<
+          CH_CFG_TM_HISTOGRAM_PRECISION) +
+         (((unsigned)t >> (msb - (unsigned)CH_CFG_TM_HISTOGRAM_PRECISION)) -
+          (1U << CH_CFG_TM_HISTOGRAM_PRECISION));
+}
+
+/**
+ * @brief   Highest measurement classified in a bucket.
+ *
+ * @param[in] b         the bucket index
+ * @return              The bucket upper bound.
+ */
+static rtcnt_t tm_bucket_limit(unsigned b) {
+  unsigned group = b >> CH_CFG_TM_HISTOGRAM_PRECISION;
+  unsigned sub = b & ((1U << CH_CFG_TM_HISTOGRAM_PRECISION) - 1U);
+
+  if (group == 0U) {
+    return (rtcnt_t)sub;
+  }
+
+  return (rtcnt_t)((((uint64_t)((1U << CH_CFG_TM_HISTOGRAM_PRECISION) + sub +
+                                1U)) << (group - 1U)) - 1U);
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -166,6 +210,142 @@ NOINLINE void chTMChainMeasurementToX(time_measurement_t *tmp1,
   tm_stop(tmp1, tmp2->last, (rtcnt_t)0);
 }
 
+/**
+ * @brief   Initializes a @p time_histogram_t object.
+ *
+ * @param[out] thp      pointer to a @p time_histogram_t structure
+ *
+ * @init
+ */
+void chTMHistogramObjectInit(time_histogram_t *thp) {
+  unsigned i;
+
+  chTMObjectInit(&thp->tm);
+  for (i = 0U; i < (unsigned)TM_HISTOGRAM_BUCKETS; i++) {
+    thp->buckets[i] = (ucnt_t)0;
+  }
+}
+
+/**
+ * @brief   Starts a histogram measurement.
+ * @pre     The @p time_histogram_t structure must be initialized.
+ *
+ * @param[in,out] thp   pointer to a @p time_histogram_t structure
+ *
+ * @xclass
+ */
+NOINLINE void chTMHistogramStartMeasurementX(time_histogram_t *thp) {
+
+  thp->tm.last = chSysGetRealtimeCounterX();
+}
+
+/**
+ * @brief   Stops a histogram measurement.
+ * @pre     The @p time_histogram_t structure must be initialized.
+ *
+ * @param[in,out] thp   pointer to a @p time_histogram_t structure
+ *
+ * @xclass
+ */
+NOINLINE void chTMHistogramStopMeasurementX(time_histogram_t *thp) {
+
+  tm_stop(&thp->tm, chSysGetRealtimeCounterX(), currcore->tmc.offset);
+  thp->buckets[tm_bucket(thp->tm.last)]++;
+}
+
+/**
+ * @brief   Adds a measurement performed by other means to an histogram.
+ * @pre     The @p time_histogram_t structure must be initialized.
+ *
+ * @param[in,out] thp   pointer to a @p time_histogram_t structure
+ * @param[in] t         the measurement in realtime counter cycles
+ *
+ * @xclass
+ */
+void chTMHistogramAddX(time_histogram_t *thp, rtcnt_t t) {
+
+  thp->tm.n++;
+  thp->tm.last = t;
+  thp->tm.cumulative += (rttime_t)t;
+  if (t > thp->tm.worst) {
+    thp->tm.worst = t;
+  }
+  if (t < thp->tm.best) {
+    thp->tm.best = t;
+  }
+  thp->buckets[tm_bucket(t)]++;
+}
+
+/**
+ * @brief   Merges an histogram into another.
+ * @note    Histograms must not be updated while merged.
+ *
+ * @param[in,out] dthp  pointer to the destination @p time_histogram_t
+ *                      structure
+ * @param[in] sthp      pointer to the @p time_histogram_t structure to be
+ *                      added to the destination
+ *
+ * @xclass
+ */
+void chTMHistogramMergeX(time_histogram_t *dthp,
+                         const time_histogram_t *sthp) {
+  unsigned i;
+
+  dthp->tm.n          += sthp->tm.n;
+  dthp->tm.cumulative += sthp->tm.cumulative;
+  if (sthp->tm.worst > dthp->tm.worst) {
+    dthp->tm.worst = sthp->tm.worst;
+  }
+  if (sthp->tm.best < dthp->tm.best) {
+    dthp->tm.best = sthp->tm.best;
+  }
+  for (i = 0U; i < (unsigned)TM_HISTOGRAM_BUCKETS; i++) {
+    dthp->buckets[i] += sthp->buckets[i];
+  }
+}
+
+/**
+ * @brief   Returns a percentile of the measurements.
+ * @details The returned value is the upper bound of the bucket containing
+ *          the percentile, limited to the worst measurement.
+ * @note    The histogram must not be updated while scanned.
+ *
+ * @param[in] thp       pointer to a @p time_histogram_t structure
+ * @param[in] permyriad the percentile in hundredths of percent, 9990 is
+ *                      the 99.9th percentile
+ * @return              The percentile in realtime counter cycles, zero if
+ *                      there are no measurements.
+ *
+ * @xclass
+ */
+rtcnt_t chTMHistogramGetPercentileX(const time_histogram_t *thp,
+                                    unsigned permyriad) {
+  uint64_t target, count;
+  unsigned i;
+
+  if (thp->tm.n == (ucnt_t)0) {
+    return (rtcnt_t)0;
+  }
+
+  /* Rank of the percentile, at least the first measurement.*/
+  target = (((uint64_t)thp->tm.n * (uint64_t)permyriad) + 9999U) / 10000U;
+  if (target == 0U) {
+    target = 1U;
+  }
+
+  count = 0U;
+  for (i = 0U; i < (unsigned)TM_HISTOGRAM_BUCKETS - 1U; i++) {
+    count += (uint64_t)thp->buckets[i];
+    if (count >= target) {
+      rtcnt_t limit = tm_bucket_limit(i);
+
+      return limit < thp->tm.worst ? limit : thp->tm.worst;
+    }
+  }
+
+  return thp->tm.worst;
+}
+
 #endif /* CH_CFG_USE_TM == TRUE */
 
 /** @} */
@@ -32,6 +32,12 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/*
+ * Compiler barrier, record accesses must not be moved across the update of
+ * the buffer pointers.
+ */
+#define TRACE_BARRIER()     __asm volatile ("" : : : "memory")
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -55,6 +61,9 @@
  * @notapi
  */
 NOINLINE static void trace_next(os_instance_t *oip) {
+#if CH_DBG_TRACE_STREAM == TRUE
+  trace_event_t *tep;
+#endif
 
   oip->trace_buffer.ptr->time    = chVTGetSystemTimeX();
 #if PORT_SUPPORTS_RT == TRUE
@@ -66,9 +75,27 @@ NOINLINE static void trace_next(os_instance_t *oip) {
   /* Trace hook, useful in order to interface debug tools.*/
   CH_CFG_TRACE_HOOK(oip->trace_buffer.ptr);
 
+#if CH_DBG_TRACE_STREAM == TRUE
+  tep = oip->trace_buffer.ptr + 1;
+  if (tep >= &oip->trace_buffer.buffer[CH_DBG_TRACE_BUFFER_SIZE]) {
+    tep = &oip->trace_buffer.buffer[0];
+  }
+
+  /* If the buffer is full then the record is not published, it will be
+     overwritten by the next one.*/
+  if (tep == oip->trace_buffer.rdptr) {
+    oip->trace_buffer.dropped++;
+    return;
+  }
+
+  /* The record must be complete before becoming visible to the consumer.*/
+  TRACE_BARRIER();
+  oip->trace_buffer.ptr = tep;
+#else
   if (++oip->trace_buffer.ptr >= &oip->trace_buffer.buffer[CH_DBG_TRACE_BUFFER_SIZE]) {
     oip->trace_buffer.ptr = &oip->trace_buffer.buffer[0];
   }
+#endif
 }
 #endif
 
@@ -91,6 +118,10 @@ void __trace_init(os_instance_t *oip) {
   oip->trace_buffer.suspended = (uint16_t)~CH_DBG_TRACE_MASK;
   oip->trace_buffer.size      = CH_DBG_TRACE_BUFFER_SIZE;
   oip->trace_buffer.ptr       = &oip->trace_buffer.buffer[0];
+#if CH_DBG_TRACE_STREAM == TRUE
+  oip->trace_buffer.rdptr     = &oip->trace_buffer.buffer[0];
+  oip->trace_buffer.dropped   = 0U;
+#endif
   for (i = 0U; i < (unsigned)CH_DBG_TRACE_BUFFER_SIZE; i++) {
     oip->trace_buffer.buffer[i].type = CH_TRACE_TYPE_UNUSED;
   }
@@ -286,6 +317,60 @@ void chDbgResumeTrace(uint16_t mask) {
   chDbgResumeTraceI(mask);
   chSysUnlock();
 }
+
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Removes records from the trace buffer.
+ * @details Records are returned in the same order they have been written.
+ * @note    This function does not lock the kernel, writers are never
+ *          delayed by the consumer.
+ * @note    There must be a single consumer and it must run on the same
+ *          core owning the trace buffer.
+ *
+ * @param[out] tep      pointer to an array of trace records
+ * @param[in] n         maximum number of records to be returned
+ * @return              The number of records returned.
+ *
+ * @xclass
+ */
+size_t chDbgReadTraceX(trace_event_t *tep, size_t n) {
+  trace_buffer_t *tbp = &currcore->trace_buffer;
+  trace_event_t *rdp, *wrp;
+  size_t i;
+
+  rdp = tbp->rdptr;
+  wrp = *(trace_event_t * volatile *)&tbp->ptr;
+  TRACE_BARRIER();
+
+  for (i = 0U; (i < n) && (rdp != wrp); i++) {
+    tep[i] = *rdp;
+    if (++rdp >= &tbp->buffer[CH_DBG_TRACE_BUFFER_SIZE]) {
+      rdp = &tbp->buffer[0];
+    }
+  }
+
+  /* Copies must be complete before the records are released to the
+     writers.*/
+  TRACE_BARRIER();
+  tbp->rdptr = rdp;
+
+  return i;
+}
+
+/**
+ * @brief   Returns the number of records dropped because the trace buffer
+ *          was full.
+ * @note    The counter is free running, it is never reset.
+ *
+ * @return              The number of dropped records.
+ *
+ * @xclass
+ */
+uint32_t chDbgGetTraceDroppedX(void) {
+
+  return currcore->trace_buffer.dropped;
+}
+#endif /* CH_DBG_TRACE_STREAM == TRUE */
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
 /** @} */
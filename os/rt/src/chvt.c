@@ -48,6 +48,7 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_VT_USE_WHEEL == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   List empty check.
  *
@@ -127,12 +128,311 @@ static void vt_list_compress(virtual_timers_list_t *vtlp,
     dlp->delta -= deltanow;
   }
 }
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#endif /* CH_CFG_VT_USE_WHEEL == FALSE */
+
+#if (CH_CFG_VT_USE_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of usable slots in a wheel level.
+ * @note    Only the last level can be narrower than @p CH_VT_WHEEL_SLOTS.
+ *
+ * @param[in] level     the wheel level
+ * @return              The number of slots, a power of two.
+ *
+ * @notapi
+ */
+static inline unsigned wheel_level_size(unsigned level) {
+  unsigned bits = (unsigned)CH_CFG_INTERVALS_SIZE -
+                  (level * (unsigned)CH_CFG_VT_WHEEL_BITS);
+
+  if (bits < (unsigned)CH_CFG_VT_WHEEL_BITS) {
+    return 1U << bits;
+  }
+
+  return CH_VT_WHEEL_SLOTS;
+}
+
+/**
+ * @brief   Wheel level hosting a timer expiring after the specified delta.
+ *
+ * @param[in] delta     the interval between the wheel time and the timer
+ *                      expiration time
+ * @return              The wheel level.
+ *
+ * @notapi
+ */
+static inline unsigned wheel_level(sysinterval_t delta) {
+  unsigned msb;
+
+  if (delta < (sysinterval_t)CH_VT_WHEEL_SLOTS) {
+    return 0U;
+  }
+
+#if CH_CFG_INTERVALS_SIZE > 32
+  if ((delta >> 32) != (sysinterval_t)0) {
+    msb = 63U - port_clz32((uint32_t)(delta >> 32));
+  }
+  else
 #endif
+  {
+    msb = 31U - port_clz32((uint32_t)delta);
+  }
+
+  return msb / (unsigned)CH_CFG_VT_WHEEL_BITS;
+}
+
+/**
+ * @brief   Rotates right a slots mask.
+ *
+ * @param[in] map       the slots mask
+ * @param[in] n         number of positions to rotate
+ * @param[in] size      size of the mask in bits
+ * @return              The rotated mask.
+ *
+ * @notapi
+ */
+static inline uint32_t wheel_rotate(uint32_t map, unsigned n, unsigned size) {
+
+  n &= size - 1U;
+  if (n == 0U) {
+    return map;
+  }
+
+  return ((map >> n) | (map << (size - n))) & ((uint32_t)-1 >> (32U - size));
+}
+
+/**
+ * @brief   Inserts a timer in the wheel.
+ *
+ * @param[in] vtlp      pointer to the timers list header
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ * @param[in] delta     the interval between the wheel time and the timer
+ *                      expiration time
+ *
+ * @notapi
+ */
+static void wheel_insert(virtual_timers_list_t *vtlp,
+                         virtual_timer_t *vtp,
+                         sysinterval_t delta) {
+  unsigned level, slot;
+  delta_list_t *hp;
+
+  /* The timer expiration time is stored as absolute wheel time, the slot
+     is the digit of the expiration time at the level selected by the
+     magnitude of the delta.*/
+  vtp->dlist.delta = vtlp->wtime + delta;
+  level = wheel_level(delta);
+  slot  = (unsigned)((vtp->dlist.delta >>
+                      (level * (unsigned)CH_CFG_VT_WHEEL_BITS)) &
+                     ((sysinterval_t)CH_VT_WHEEL_SLOTS - (sysinterval_t)1));
+
+  /* Timers in the same slot are kept in insertion order.*/
+  hp = &vtlp->slots[(level * CH_VT_WHEEL_SLOTS) + slot];
+  vtp->dlist.next = hp;
+  vtp->dlist.prev = hp->prev;
+  hp->prev->next  = &vtp->dlist;
+  hp->prev        = &vtp->dlist;
+
+  vtlp->slotsmap[level] |= 1U << slot;
+  vtlp->levelsmap       |= 1U << level;
+}
+
+/**
+ * @brief   Removes a timer from the wheel or from the expired timers list.
+ *
+ * @param[in] vtlp      pointer to the timers list header
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ *
+ * @notapi
+ */
+static void wheel_remove(virtual_timers_list_t *vtlp, virtual_timer_t *vtp) {
+  delta_list_t *dlp = &vtp->dlist;
+
+  /* If the timer is alone in its list then its neighbor is the list header,
+     a slot becoming empty is removed from the masks.*/
+  if ((dlp->next == dlp->prev) && (dlp->next != &vtlp->expired)) {
+    unsigned n = (unsigned)(dlp->next - &vtlp->slots[0]);
+    unsigned level = n / CH_VT_WHEEL_SLOTS;
+
+    vtlp->slotsmap[level] &= ~(1U << (n % CH_VT_WHEEL_SLOTS));
+    if (vtlp->slotsmap[level] == 0U) {
+      vtlp->levelsmap &= ~(1U << level);
+    }
+  }
+
+  dlp->prev->next = dlp->next;
+  dlp->next->prev = dlp->prev;
+}
+
+/**
+ * @brief   Processes the wheel at the current wheel time.
+ * @details The upper levels slots reaching their turn are cascaded toward
+ *          the lower levels then the timers in the current slot of the
+ *          first level are moved into the expired timers list.
+ *
+ * @param[in] vtlp      pointer to the timers list header
+ *
+ * @notapi
+ */
+static void wheel_expire(virtual_timers_list_t *vtlp) {
+  unsigned level, slot;
+  delta_list_t *hp;
+
+  /* A level is cascaded when all the lower digits of the wheel time are
+     zero, finding the highest one.*/
+  level = 0U;
+  while ((level < (CH_VT_WHEEL_LEVELS - 1U)) &&
+         ((vtlp->wtime & (((sysinterval_t)1 <<
+                           ((level + 1U) * (unsigned)CH_CFG_VT_WHEEL_BITS)) -
+                          (sysinterval_t)1)) == (sysinterval_t)0)) {
+    level++;
+  }
+
+  /* Cascading from the highest level down, timers are re-inserted relative
+     to the current wheel time so they always land in lower levels.*/
+  while (level > 0U) {
+    if ((vtlp->levelsmap & (1U << level)) != 0U) {
+      slot = (unsigned)((vtlp->wtime >>
+                         (level * (unsigned)CH_CFG_VT_WHEEL_BITS)) &
+                        ((sysinterval_t)CH_VT_WHEEL_SLOTS - (sysinterval_t)1));
+      hp = &vtlp->slots[(level * CH_VT_WHEEL_SLOTS) + slot];
+      while (hp->next != hp) {
+        virtual_timer_t *vtp = (virtual_timer_t *)hp->next;
+
+        wheel_remove(vtlp, vtp);
+        wheel_insert(vtlp, vtp, vtp->dlist.delta - vtlp->wtime);
+      }
+    }
+    level--;
+  }
+
+  /* The whole current slot of the first level is expired.*/
+  slot = (unsigned)(vtlp->wtime &
+                    ((sysinterval_t)CH_VT_WHEEL_SLOTS - (sysinterval_t)1));
+  hp = &vtlp->slots[slot];
+  if (hp->next != hp) {
+    vtlp->expired.next       = hp->next;
+    vtlp->expired.prev       = hp->prev;
+    hp->next->prev           = &vtlp->expired;
+    hp->prev->next           = &vtlp->expired;
+    hp->next                 = hp;
+    hp->prev                 = hp;
+    vtlp->slotsmap[0]       &= ~(1U << slot);
+    if (vtlp->slotsmap[0] == 0U) {
+      vtlp->levelsmap &= ~1U;
+    }
+  }
+}
+
+/**
+ * @brief   Invokes the callbacks of the expired timers.
+ * @note    The callbacks are invoked outside the kernel critical zone.
+ *
+ * @param[in] vtlp      pointer to the timers list header
+ *
+ * @notapi
+ */
+static void wheel_fire(virtual_timers_list_t *vtlp) {
+
+  while (vtlp->expired.next != &vtlp->expired) {
+    virtual_timer_t *vtp = (virtual_timer_t *)vtlp->expired.next;
+    vtfunc_t fn;
+
+    /* Removing the timer from the list and marking it as non active.*/
+    vtp->dlist.next->prev = &vtlp->expired;
+    vtlp->expired.next    = vtp->dlist.next;
+    fn = vtp->func;
+    vtp->func = NULL;
+
+    chSysUnlockFromISR();
+    fn(vtp->par);
+    chSysLockFromISR();
+  }
+}
+
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Alarm programming.
+ * @details The alarm is set at the specified distance from now, the
+ *          distance is constrained in the range supported by the system
+ *          timer, a spurious alarm is harmless.
+ *
+ * @param[in] now       the current system time
+ * @param[in] delta     the distance of the next wheel event from now
+ * @param[in] start     @p true if the alarm is not active yet
+ *
+ * @notapi
+ */
+static void wheel_alarm(systime_t now, sysinterval_t delta, bool start) {
+
+  if (delta < (sysinterval_t)CH_CFG_ST_TIMEDELTA) {
+    delta = (sysinterval_t)CH_CFG_ST_TIMEDELTA;
+  }
+#if CH_CFG_INTERVALS_SIZE > CH_CFG_ST_RESOLUTION
+  /* The delta could be too large for the physical timer to handle.*/
+  else if (delta > (sysinterval_t)TIME_MAX_SYSTIME) {
+    delta = (sysinterval_t)TIME_MAX_SYSTIME;
+  }
+#endif
+
+  if (start) {
+    port_timer_start_alarm(chTimeAddX(now, delta));
+  }
+  else {
+    port_timer_set_alarm(chTimeAddX(now, delta));
+  }
+}
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#endif /* CH_CFG_VT_USE_WHEEL == TRUE */
 
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+#if (CH_CFG_VT_USE_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Interval until the next timing wheel event.
+ * @details The next event is either the expiration of the timers in a
+ *          slot of the first level or the cascade of a slot of an upper
+ *          level.
+ * @pre     The wheel must not be empty.
+ *
+ * @param[in] vtlp      pointer to the timers list header
+ * @return              The interval between the wheel time and the next
+ *                      event, it is never zero.
+ *
+ * @notapi
+ */
+sysinterval_t __vt_wheel_next(virtual_timers_list_t *vtlp) {
+  sysinterval_t next = (sysinterval_t)-1;
+  uint32_t lmap = vtlp->levelsmap;
+
+  while (lmap != 0U) {
+    unsigned level = port_ctz32(lmap);
+    unsigned size  = wheel_level_size(level);
+    unsigned shift = level * (unsigned)CH_CFG_VT_WHEEL_BITS;
+    sysinterval_t base = vtlp->wtime >> shift;
+    unsigned cur   = (unsigned)(base & (sysinterval_t)(size - 1U));
+    sysinterval_t delta;
+    unsigned n;
+
+    /* Distance, in slots, of the first non-empty slot after the current
+       one, the current slot itself is at the maximum distance.*/
+    n = port_ctz32(wheel_rotate(vtlp->slotsmap[level], cur + 1U, size)) + 1U;
+
+    /* The slot is processed when the wheel time reaches its start.*/
+    delta = ((base + (sysinterval_t)n) << shift) - vtlp->wtime;
+    if (delta < next) {
+      next = delta;
+    }
+
+    lmap &= lmap - 1U;
+  }
+
+  return next;
+}
+#endif /* CH_CFG_VT_USE_WHEEL == TRUE */
+
 /**
  * @brief   Enables a virtual timer.
  * @details The timer is enabled and programmed to trigger after the delay
@@ -158,7 +458,9 @@ static void vt_list_compress(virtual_timers_list_t *vtlp,
 void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                 vtfunc_t vtfunc, void *par) {
   virtual_timers_list_t *vtlp = &currcore->vtlist;
+#if CH_CFG_VT_USE_WHEEL == FALSE
   delta_list_t *dlp;
+#endif
   sysinterval_t delta;
 
   chDbgCheckClassI();
@@ -167,6 +469,60 @@ void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
   vtp->par = par;
   vtp->func = vtfunc;
 
+#if CH_CFG_VT_USE_WHEEL == TRUE
+#if CH_CFG_ST_TIMEDELTA > 0
+  {
+    systime_t now = chVTGetSystemTimeX();
+    sysinterval_t nowdelta, next;
+
+    /* If the requested delay is lower than the minimum safe delta then it
+       is raised to the minimum safe value.*/
+    if (delay < (sysinterval_t)CH_CFG_ST_TIMEDELTA) {
+      delay = (sysinterval_t)CH_CFG_ST_TIMEDELTA;
+    }
+
+    /* Special case where the wheel is empty, the current time becomes the
+       new wheel base time.*/
+    if (vtlp->levelsmap == 0U) {
+      vtlp->lasttime = now;
+      wheel_insert(vtlp, vtp, delay);
+      wheel_alarm(now, __vt_wheel_next(vtlp), true);
+
+      return;
+    }
+
+    /* If no wheel events are due between the last tick event and now then
+       the wheel time can be brought up to date.*/
+    nowdelta = chTimeDiffX(vtlp->lasttime, now);
+    next     = __vt_wheel_next(vtlp);
+    if (nowdelta < next) {
+      vtlp->wtime   += nowdelta;
+      vtlp->lasttime = now;
+      next          -= nowdelta;
+      nowdelta       = (sysinterval_t)0;
+    }
+
+    /* Delay as delta from the wheel time, it is saturated if it exceeds
+       the numeric range.*/
+    delta = nowdelta + delay;
+    if (delta < nowdelta) {
+      delta = (sysinterval_t)-1;
+    }
+    wheel_insert(vtlp, vtp, delta);
+
+    /* If the new timer anticipates the next wheel event then the alarm is
+       moved earlier.*/
+    delta = __vt_wheel_next(vtlp);
+    if (delta < next) {
+      wheel_alarm(now, delta > nowdelta ? delta - nowdelta : (sysinterval_t)0,
+                  false);
+    }
+  }
+#else /* CH_CFG_ST_TIMEDELTA == 0 */
+  (void)delta;
+  wheel_insert(vtlp, vtp, delay);
+#endif /* CH_CFG_ST_TIMEDELTA == 0 */
+#else /* CH_CFG_VT_USE_WHEEL == FALSE */
 #if CH_CFG_ST_TIMEDELTA > 0
   {
     systime_t now = chVTGetSystemTimeX();
@@ -258,6 +614,7 @@ void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
   /* Special case when the timer is in last position in the list, the
      value in the header must be restored.*/
   vtlp->dlist.delta = (sysinterval_t)-1;
+#endif /* CH_CFG_VT_USE_WHEEL == FALSE */
 }
 
 /**
@@ -275,7 +632,25 @@ void chVTDoResetI(virtual_timer_t *vtp) {
   chDbgCheck(vtp != NULL);
   chDbgAssert(vtp->func != NULL, "timer not set or already triggered");
 
-#if CH_CFG_ST_TIMEDELTA == 0
+#if CH_CFG_VT_USE_WHEEL == TRUE
+#if CH_CFG_ST_TIMEDELTA > 0
+  {
+    bool active = (bool)(vtlp->levelsmap != 0U);
+
+    wheel_remove(vtlp, vtp);
+    vtp->func = NULL;
+
+    /* If the wheel became empty then the alarm is stopped, else it is left
+       as it is, a spurious alarm is harmless.*/
+    if (active && (vtlp->levelsmap == 0U)) {
+      port_timer_stop_alarm();
+    }
+  }
+#else /* CH_CFG_ST_TIMEDELTA == 0 */
+  wheel_remove(vtlp, vtp);
+  vtp->func = NULL;
+#endif /* CH_CFG_ST_TIMEDELTA == 0 */
+#elif CH_CFG_ST_TIMEDELTA == 0
 
   /* The delta of the timer is added to the next timer.*/
   vtp->dlist.next->delta += vtp->dlist.delta;
@@ -371,7 +746,43 @@ void chVTDoTickI(void) {
 
   chDbgCheckClassI();
 
+#if CH_CFG_VT_USE_WHEEL == TRUE
 #if CH_CFG_ST_TIMEDELTA == 0
+  vtlp->systime++;
+  vtlp->wtime++;
+  if (vtlp->levelsmap != 0U) {
+    wheel_expire(vtlp);
+    wheel_fire(vtlp);
+  }
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+  while (vtlp->levelsmap != 0U) {
+    systime_t now = chVTGetSystemTimeX();
+    sysinterval_t nowdelta = chTimeDiffX(vtlp->lasttime, now);
+    sysinterval_t next = __vt_wheel_next(vtlp);
+
+    /* If the next wheel event is in the future then the wheel time is
+       brought up to date and the alarm is programmed for the event.*/
+    if (next > nowdelta) {
+      vtlp->wtime   += nowdelta;
+      vtlp->lasttime = now;
+      wheel_alarm(now, next - nowdelta, false);
+      break;
+    }
+
+    /* Advancing to the event and processing it.*/
+    vtlp->wtime   += next;
+    vtlp->lasttime = chTimeAddX(vtlp->lasttime, next);
+    wheel_expire(vtlp);
+
+    /* If the wheel becomes empty then the alarm is stopped.*/
+    if (vtlp->levelsmap == 0U) {
+      port_timer_stop_alarm();
+    }
+
+    wheel_fire(vtlp);
+  }
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#elif CH_CFG_ST_TIMEDELTA == 0
   vtlp->systime++;
   if (!is_vtlist_empty(&vtlp->dlist)) {
     /* The list is not empty, processing elements on top.*/
@@ -83,6 +83,27 @@
 #define CH_CFG_ST_TIMEDELTA                 2
 #endif
 
+/**
+ * @brief   Virtual timers timing wheel.
+ * @details If enabled then the virtual timers are kept in a hierarchical
+ *          timing wheel instead of the delta list. Arming and disarming
+ *          a timer become constant time operations regardless of the
+ *          number of armed timers at the cost of a larger timers list
+ *          structure.
+ */
+#if !defined(CH_CFG_VT_USE_WHEEL)
+#define CH_CFG_VT_USE_WHEEL                 FALSE
+#endif
+
+/**
+ * @brief   Timing wheel slots per level, as a power of two.
+ * @note    Allowed values are 1..5, each level has 2^N slots. The number
+ *          of levels is derived from @p CH_CFG_INTERVALS_SIZE.
+ */
+#if !defined(CH_CFG_VT_WHEEL_BITS)
+#define CH_CFG_VT_WHEEL_BITS                5
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -140,6 +161,19 @@
 #define CH_CFG_OPTIMIZE_SPEED               TRUE
 #endif
 
+/**
+ * @brief   Bitmap-indexed ready list.
+ * @details If enabled then the ready list is organized as per-priority
+ *          FIFO queues indexed by a priority bitmap, insertion and removal
+ *          of ready threads become constant time operations regardless of
+ *          the number of ready threads.
+ * @note    The ready list structure size increases by about 2kB because
+ *          there is a queue header for each one of the 256 priority levels.
+ */
+#if !defined(CH_CFG_RLIST_USE_BITMAP)
+#define CH_CFG_RLIST_USE_BITMAP             FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -160,6 +194,22 @@
 #define CH_CFG_USE_TM                       TRUE
 #endif
 
+/**
+ * @brief   Time Measurement histograms precision.
+ * @details Each power of two range is divided in 2^N linear buckets.
+ */
+#if !defined(CH_CFG_TM_HISTOGRAM_PRECISION)
+#define CH_CFG_TM_HISTOGRAM_PRECISION       3
+#endif
+
+/**
+ * @brief   Time Measurement histograms range.
+ * @details Measurements up to 2^N-1 realtime counter cycles are classified.
+ */
+#if !defined(CH_CFG_TM_HISTOGRAM_RANGE)
+#define CH_CFG_TM_HISTOGRAM_RANGE           24
+#endif
+
 /**
  * @brief   Time Stamps APIs.
  * @details If enabled then the time time stamps APIs are included in
@@ -261,6 +311,17 @@
 #define CH_CFG_USE_CONDVARS_TIMEOUT         TRUE
 #endif
 
+/**
+ * @brief   Conditional Variables wait morphing.
+ * @details If enabled then a broadcast moves the waiting threads on the
+ *          mutex queue instead of making all of them ready.
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_CONDVARS.
+ */
+#if !defined(CH_CFG_USE_CONDVARS_REQUEUE)
+#define CH_CFG_USE_CONDVARS_REQUEUE         FALSE
+#endif
+
 /**
  * @brief   Events Flags APIs.
  * @details If enabled then the event flags APIs are included in the kernel.
@@ -381,6 +442,42 @@
 #define CH_CFG_USE_HEAP                     TRUE
 #endif
 
+/**
+ * @brief   TLSF heap engine.
+ * @details If enabled then heaps can be initialized using
+ *          @p chHeapObjectInitTLSF() in order to use a two-level
+ *          segregated fit allocator, O(1) allocation and release with
+ *          bounded fragmentation.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP.
+ */
+#if !defined(CH_CFG_HEAP_USE_TLSF)
+#define CH_CFG_HEAP_USE_TLSF                FALSE
+#endif
+
+/**
+ * @brief   TLSF second level index bits.
+ * @details Each power of two size range is split in 2^N free lists.
+ *
+ * @note    The default is 3.
+ * @note    Allowed values are 1..5.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_SL_BITS)
+#define CH_CFG_HEAP_TLSF_SL_BITS            3
+#endif
+
+/**
+ * @brief   TLSF maximum block size as a power of two.
+ * @details The size of the TLSF control structure is proportional to
+ *          this value.
+ *
+ * @note    The default is 20.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2)
+#define CH_CFG_HEAP_TLSF_MAX_BLOCK_LOG2     20
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -392,6 +489,19 @@
 #define CH_CFG_USE_MEMPOOLS                 TRUE
 #endif
 
+/**
+ * @brief   Memory pool magazines.
+ * @details If enabled then per-thread magazines can be placed in front of
+ *          memory pools, objects are allocated and released through a
+ *          magazine without locking the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ */
+#if !defined(CH_CFG_MEMPOOLS_USE_MAGAZINES)
+#define CH_CFG_MEMPOOLS_USE_MAGAZINES       FALSE
+#endif
+
 /**
  * @brief   Objects FIFOs APIs.
  * @details If enabled then the objects FIFOs APIs are included
@@ -425,6 +535,50 @@
 #define CH_CFG_USE_OBJ_CACHES               TRUE
 #endif
 
+/**
+ * @brief   Objects Caches open addressing hash table.
+ * @details If enabled then the objects caches index is an open addressing
+ *          hash table of compact tags probed linearly.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_USE_OPEN_HASH)
+#define CH_CFG_OBJ_CACHES_USE_OPEN_HASH     FALSE
+#endif
+
+/**
+ * @brief   Objects Caches hash table load factor.
+ * @details Maximum percentage of occupied slots in the open addressing
+ *          hash table, valid values are between 10 and 90.
+ *
+ * @note    The default is 50.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_LOAD_FACTOR)
+#define CH_CFG_OBJ_CACHES_LOAD_FACTOR       50
+#endif
+
+/**
+ * @brief   Objects Caches flush batch size.
+ * @details Maximum number of objects with consecutive keys written in a
+ *          single batch by flush operations.
+ *
+ * @note    The default is 8.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_FLUSH_BATCH)
+#define CH_CFG_OBJ_CACHES_FLUSH_BATCH       8
+#endif
+
+/**
+ * @brief   Objects Caches write-back flusher.
+ * @details If enabled then a thread can be dedicated to writing back
+ *          dirty objects above an high watermark.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_USE_FLUSHER)
+#define CH_CFG_OBJ_CACHES_USE_FLUSHER       FALSE
+#endif
+
 /**
  * @brief   Delegate threads APIs.
  * @details If enabled then the delegate threads APIs are included
@@ -536,6 +690,24 @@
 #define CH_DBG_STATISTICS                   FALSE
 #endif
 
+/**
+ * @brief   Debug option, threads latency statistics.
+ * @details If enabled then the ready to running latency of each thread is
+ *          measured, requires @p CH_DBG_STATISTICS.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_STATISTICS_LATENCY)
+#define CH_DBG_STATISTICS_LATENCY           FALSE
+#endif
+
+/**
+ * @brief   Number of buckets in the threads latency histograms.
+ */
+#if !defined(CH_DBG_STATISTICS_LATENCY_BUCKETS)
+#define CH_DBG_STATISTICS_LATENCY_BUCKETS   16
+#endif
+
 /**
  * @brief   Debug option, system state check.
  * @details If enabled the correct call protocol for system APIs is checked
@@ -589,6 +761,18 @@
 #define CH_DBG_TRACE_BUFFER_SIZE            128
 #endif
 
+/**
+ * @brief   Trace streaming mode.
+ * @details If enabled the trace buffer does not wrap, records are removed
+ *          by a consumer using @p chDbgReadTraceX() and new records are
+ *          dropped while the buffer is full.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_TRACE_STREAM)
+#define CH_DBG_TRACE_STREAM                 FALSE
+#endif
+
 /**
  * @brief   Debug option, stack checks.
  * @details If enabled then a runtime stack check is performed.
@@ -5,6 +5,8 @@
 /* disk I/O modules and attach it to FatFs module with common interface. */
 /*-----------------------------------------------------------------------*/
 
+#include <string.h>
+
 #include "hal.h"
 #include "ffconf.h"
 #include "ff.h"
@@ -14,11 +16,16 @@
 #error "cannot specify both MMC_SPI and SDC drivers"
 #endif
 
+/* Without the MMC_SPI and SDC drivers the device can be any object
+   implementing the BaseBlockDevice interface, FATFS_HAL_DEVICE must then
+   be defined in ffconf.h and the object declared there.*/
 #if !defined(FATFS_HAL_DEVICE)
 #if HAL_USE_MMC_SPI
 #define FATFS_HAL_DEVICE MMCD1
-#else
+#elif HAL_USE_SDC
 #define FATFS_HAL_DEVICE SDCD1
+#else
+#error "MMC_SPI or SDC driver must be specified"
 #endif
 #endif
 
@@ -26,9 +33,60 @@
 extern MMCDriver FATFS_HAL_DEVICE;
 #elif HAL_USE_SDC
 extern SDCDriver FATFS_HAL_DEVICE;
+#endif
+
+/*
+ * Sectors cache settings, can be overridden in ffconf.h.
+ */
+
+/* Enables a sectors cache between FatFS and the block device, the cache
+   is built on the OS library objects caches.*/
+#if !defined(FATFS_USE_CACHE)
+#define FATFS_USE_CACHE             FALSE
+#endif
+
+/* Number of sectors in the cache.*/
+#if !defined(FATFS_CACHE_SECTORS)
+#define FATFS_CACHE_SECTORS         32
+#endif
+
+/* Number of elements in the cache hash table, it must be a power of two.*/
+#if !defined(FATFS_CACHE_HASH_SIZE)
+#define FATFS_CACHE_HASH_SIZE       64
+#endif
+
+/* Maximum number of sectors fetched by a single multi-block read, a miss
+   following the previous read fetches up to this number of sectors.*/
+#if !defined(FATFS_CACHE_READ_AHEAD)
+#define FATFS_CACHE_READ_AHEAD      8
+#endif
+
+#if FATFS_USE_CACHE
+#if CH_CFG_USE_OBJ_CACHES == FALSE
+#error "FATFS_USE_CACHE requires CH_CFG_USE_OBJ_CACHES"
+#endif
+
+#if FF_MAX_SS != FF_MIN_SS
+#error "FATFS_USE_CACHE requires a fixed sector size"
+#endif
+
+#if (FATFS_CACHE_READ_AHEAD < 1) ||                                         \
+    (FATFS_CACHE_READ_AHEAD >= FATFS_CACHE_SECTORS)
+#error "invalid FATFS_CACHE_READ_AHEAD value"
+#endif
+
+#if ((FATFS_CACHE_HASH_SIZE & (FATFS_CACHE_HASH_SIZE - 1)) != 0) ||         \
+    (FATFS_CACHE_HASH_SIZE < OC_HASH_MIN_SIZE(FATFS_CACHE_SECTORS))
+#error "invalid FATFS_CACHE_HASH_SIZE value"
+#endif
+
+/* Size of the buffer used for multi-block transfers, in sectors.*/
+#if FATFS_CACHE_READ_AHEAD > CH_CFG_OBJ_CACHES_FLUSH_BATCH
+#define FATFS_CACHE_BUFFER_SECTORS  FATFS_CACHE_READ_AHEAD
 #else
-#error "MMC_SPI or SDC driver must be specified"
+#define FATFS_CACHE_BUFFER_SECTORS  CH_CFG_OBJ_CACHES_FLUSH_BATCH
 #endif
+#endif /* FATFS_USE_CACHE */
 
 #if HAL_USE_RTC
 extern RTCDriver RTCD1;
@@ -39,6 +97,193 @@ extern RTCDriver RTCD1;
 
 #define MMC     0
 #define SDC     0
+#define BLK     0
+
+/* The device seen through its block device interface.*/
+static BaseBlockDevice * const blkp = (BaseBlockDevice *)&FATFS_HAL_DEVICE;
+
+#if FATFS_USE_CACHE
+/*-----------------------------------------------------------------------*/
+/* Sectors cache.                                                        */
+/* Sectors are cached objects, the group is the physical drive and the   */
+/* key is the sector address. Written sectors are kept dirty in cache,   */
+/* adjacent dirty sectors are written back by multi-block operations on  */
+/* CTRL_SYNC or when half of the cache is dirty. Only one physical drive */
+/* is supported and accesses are expected to be serialized by FatFS.     */
+
+typedef struct {
+  oc_object_t       header;
+  uint8_t           data[FF_MIN_SS];
+} cached_sector_t;
+
+static struct {
+  objects_cache_t   cache;
+  oc_hash_header_t  hash[FATFS_CACHE_HASH_SIZE];
+  cached_sector_t   sectors[FATFS_CACHE_SECTORS];
+  /* Sector following the last one fetched from the device.*/
+  DWORD             next;
+  /* Buffer for multi-block transfers.*/
+  uint8_t           buf[FATFS_CACHE_BUFFER_SECTORS * FF_MIN_SS];
+} fscache;
+
+static bool cache_readf(objects_cache_t *ocp, oc_object_t *objp,
+                        bool async) {
+  bool err;
+
+  err = blkRead(blkp, objp->obj_key, ((cached_sector_t *)objp)->data, 1);
+  if (!err)
+    objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+  if (async)
+    chCacheReleaseObject(ocp, objp);
+  return err;
+}
+
+/* Asynchronous writes are performed when a dirty sector is evicted, an
+   error cannot be reported in that case.*/
+static bool cache_writef(objects_cache_t *ocp, oc_object_t *objp,
+                         bool async) {
+  bool err;
+
+  err = blkWrite(blkp, objp->obj_key, ((cached_sector_t *)objp)->data, 1);
+  if (async)
+    chCacheReleaseObject(ocp, objp);
+  return err;
+}
+
+static bool cache_writebf(objects_cache_t *ocp, oc_object_t *objpp[],
+                          ucnt_t n) {
+  ucnt_t i;
+
+  (void)ocp;
+
+  for (i = 0; i < n; i++)
+    memcpy(&fscache.buf[i * FF_MIN_SS],
+           ((cached_sector_t *)objpp[i])->data, FF_MIN_SS);
+  return blkWrite(blkp, objpp[0]->obj_key, fscache.buf, n);
+}
+
+/* Any cached content is discarded, volumes must be synchronized before
+   being mounted again.*/
+static void cache_init(void) {
+
+  chCacheObjectInit(&fscache.cache, FATFS_CACHE_HASH_SIZE, fscache.hash,
+                    FATFS_CACHE_SECTORS, sizeof (cached_sector_t),
+                    fscache.sectors, cache_readf, cache_writef);
+  chCacheSetBatchWriterX(&fscache.cache, cache_writebf);
+  fscache.next = 0;
+}
+
+static DRESULT cache_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count) {
+  oc_object_t *run[FATFS_CACHE_READ_AHEAD];
+  DWORD end = sector + count;
+  UINT i, n, m;
+
+  while (sector < end) {
+    DWORD limit = end;
+    oc_object_t *objp;
+
+    objp = chCacheGetObject(&fscache.cache, (uint32_t)pdrv, (uint32_t)sector);
+    if ((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U) {
+      /* Cache hit.*/
+      memcpy(buff, ((cached_sector_t *)objp)->data, FF_MIN_SS);
+      chCacheReleaseObject(&fscache.cache, objp);
+      buff += FF_MIN_SS;
+      sector++;
+      continue;
+    }
+
+    /* Cache miss, a miss on the sector following the previous fetch is
+       assumed to be part of a sequential read and the fetch is extended
+       beyond the requested sectors.*/
+    if (sector == fscache.next) {
+      BlockDeviceInfo bdi;
+
+      if ((blkGetInfo(blkp, &bdi) == HAL_SUCCESS) && (bdi.blk_num > end))
+        limit = bdi.blk_num;
+    }
+
+    /* Taking the following missing sectors, they are fetched with a
+       single multi-block read.*/
+    run[0] = objp;
+    n = 1;
+    while ((n < FATFS_CACHE_READ_AHEAD) && (sector + n < limit)) {
+      objp = chCacheGetObject(&fscache.cache, (uint32_t)pdrv,
+                              (uint32_t)(sector + n));
+      if ((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U) {
+        chCacheReleaseObject(&fscache.cache, objp);
+        break;
+      }
+      run[n++] = objp;
+    }
+
+    if (blkRead(blkp, sector, fscache.buf, n) != HAL_SUCCESS) {
+      /* The sectors are still marked as not in sync, releasing them
+         invalidates them.*/
+      for (i = 0; i < n; i++)
+        chCacheReleaseObject(&fscache.cache, run[i]);
+      fscache.next = 0;
+      return RES_ERROR;
+    }
+
+    for (i = 0; i < n; i++) {
+      memcpy(((cached_sector_t *)run[i])->data,
+             &fscache.buf[i * FF_MIN_SS], FF_MIN_SS);
+      run[i]->obj_flags &= ~OC_FLAG_NOTSYNC;
+      chCacheReleaseObject(&fscache.cache, run[i]);
+    }
+
+    /* Copying the requested part of the fetched sectors.*/
+    m = (end - sector) < n ? (UINT)(end - sector) : n;
+    memcpy(buff, fscache.buf, m * FF_MIN_SS);
+    fscache.next = sector + n;
+    buff += m * FF_MIN_SS;
+    sector += m;
+  }
+  return RES_OK;
+}
+
+#if !FF_FS_READONLY
+static DRESULT cache_write(BYTE pdrv, const BYTE *buff, DWORD sector,
+                           UINT count) {
+
+  while (count > 0) {
+    oc_object_t *objp;
+
+    /* Sectors are overwritten entirely, no need to read them.*/
+    objp = chCacheGetObject(&fscache.cache, (uint32_t)pdrv, (uint32_t)sector);
+    memcpy(((cached_sector_t *)objp)->data, buff, FF_MIN_SS);
+    objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+    objp->obj_flags |= OC_FLAG_LAZYWRITE;
+    chCacheReleaseObject(&fscache.cache, objp);
+    buff += FF_MIN_SS;
+    sector++;
+    count--;
+
+    /* Writing back before the dirty sectors start to be evicted one
+       by one.*/
+    if (fscache.cache.dirtyn >= FATFS_CACHE_SECTORS / 2) {
+      if (chCacheFlushGroup(&fscache.cache, (uint32_t)pdrv))
+        return RES_ERROR;
+    }
+  }
+  return RES_OK;
+}
+#endif /* !FF_FS_READONLY */
+#endif /* FATFS_USE_CACHE */
+
+/* Writes back the cached sectors then synchronizes the device.*/
+static DRESULT disk_sync(BYTE pdrv)
+{
+#if FATFS_USE_CACHE
+  if (chCacheFlushGroup(&fscache.cache, (uint32_t)pdrv))
+    return RES_ERROR;
+#else
+  (void)pdrv;
+#endif
+  if (blkSync(blkp) != HAL_SUCCESS)
+    return RES_ERROR;
+  return RES_OK;
+}
 
 
 
@@ -60,8 +305,11 @@ DSTATUS disk_initialize (
       stat |= STA_NOINIT;
     if (mmcIsWriteProtected(&FATFS_HAL_DEVICE))
       stat |=  STA_PROTECT;
+#if FATFS_USE_CACHE
+    cache_init();
+#endif
     return stat;
-#else
+#elif HAL_USE_SDC
   case SDC:
     stat = 0;
     /* It is initialized externally, just reads the status.*/
@@ -69,6 +317,21 @@ DSTATUS disk_initialize (
       stat |= STA_NOINIT;
     if (sdcIsWriteProtected(&FATFS_HAL_DEVICE))
       stat |=  STA_PROTECT;
+#if FATFS_USE_CACHE
+    cache_init();
+#endif
+    return stat;
+#else
+  case BLK:
+    stat = 0;
+    /* It is initialized externally, just reads the status.*/
+    if (blkGetDriverState(blkp) != BLK_READY)
+      stat |= STA_NOINIT;
+    if (blkIsWriteProtected(blkp))
+      stat |=  STA_PROTECT;
+#if FATFS_USE_CACHE
+    cache_init();
+#endif
     return stat;
 #endif
   }
@@ -96,7 +359,7 @@ DSTATUS disk_status (
     if (mmcIsWriteProtected(&FATFS_HAL_DEVICE))
       stat |= STA_PROTECT;
     return stat;
-#else
+#elif HAL_USE_SDC
   case SDC:
     stat = 0;
     /* It is initialized externally, just reads the status.*/
@@ -105,6 +368,15 @@ DSTATUS disk_status (
     if (sdcIsWriteProtected(&FATFS_HAL_DEVICE))
       stat |= STA_PROTECT;
     return stat;
+#else
+  case BLK:
+    stat = 0;
+    /* It is initialized externally, just reads the status.*/
+    if (blkGetDriverState(blkp) != BLK_READY)
+      stat |= STA_NOINIT;
+    if (blkIsWriteProtected(blkp))
+      stat |= STA_PROTECT;
+    return stat;
 #endif
   }
   return STA_NOINIT;
@@ -122,6 +394,13 @@ DRESULT disk_read (
     UINT count        /* Number of sectors to read (1..255) */
 )
 {
+#if FATFS_USE_CACHE
+  if (pdrv == 0) {
+    if (blkGetDriverState(blkp) != BLK_READY)
+      return RES_NOTRDY;
+    return cache_read(pdrv, buff, sector, count);
+  }
+#else
   switch (pdrv) {
 #if HAL_USE_MMC_SPI
   case MMC:
@@ -138,15 +417,23 @@ DRESULT disk_read (
     if (mmcStopSequentialRead(&FATFS_HAL_DEVICE))
         return RES_ERROR;
     return RES_OK;
-#else
+#elif HAL_USE_SDC
   case SDC:
     if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
       return RES_NOTRDY;
     if (sdcRead(&FATFS_HAL_DEVICE, sector, buff, count))
       return RES_ERROR;
     return RES_OK;
+#else
+  case BLK:
+    if (blkGetDriverState(blkp) != BLK_READY)
+      return RES_NOTRDY;
+    if (blkRead(blkp, sector, buff, count))
+      return RES_ERROR;
+    return RES_OK;
 #endif
   }
+#endif /* !FATFS_USE_CACHE */
   return RES_PARERR;
 }
 
@@ -163,6 +450,15 @@ DRESULT disk_write (
     UINT count        /* Number of sectors to write (1..255) */
 )
 {
+#if FATFS_USE_CACHE
+  if (pdrv == 0) {
+    if (blkGetDriverState(blkp) != BLK_READY)
+      return RES_NOTRDY;
+    if (blkIsWriteProtected(blkp))
+      return RES_WRPRT;
+    return cache_write(pdrv, buff, sector, count);
+  }
+#else
   switch (pdrv) {
 #if HAL_USE_MMC_SPI
   case MMC:
@@ -181,15 +477,25 @@ DRESULT disk_write (
     if (mmcStopSequentialWrite(&FATFS_HAL_DEVICE))
         return RES_ERROR;
     return RES_OK;
-#else
+#elif HAL_USE_SDC
   case SDC:
     if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
       return RES_NOTRDY;
     if (sdcWrite(&FATFS_HAL_DEVICE, sector, buff, count))
       return RES_ERROR;
     return RES_OK;
+#else
+  case BLK:
+    if (blkGetDriverState(blkp) != BLK_READY)
+      return RES_NOTRDY;
+    if (blkIsWriteProtected(blkp))
+      return RES_WRPRT;
+    if (blkWrite(blkp, sector, buff, count))
+      return RES_ERROR;
+    return RES_OK;
 #endif
   }
+#endif /* !FATFS_USE_CACHE */
   return RES_PARERR;
 }
 #endif /* _FS_READONLY */
@@ -212,7 +518,7 @@ DRESULT disk_ioctl (
   case MMC:
     switch (cmd) {
     case CTRL_SYNC:
-        return RES_OK;
+        return disk_sync(pdrv);
 #if FF_MAX_SS > FF_MIN_SS
     case GET_SECTOR_SIZE:
         *((WORD *)buff) = MMCSD_BLOCK_SIZE;
@@ -226,11 +532,11 @@ DRESULT disk_ioctl (
     default:
         return RES_PARERR;
     }
-#else
+#elif HAL_USE_SDC
   case SDC:
     switch (cmd) {
     case CTRL_SYNC:
-        return RES_OK;
+        return disk_sync(pdrv);
     case GET_SECTOR_COUNT:
         *((DWORD *)buff) = mmcsdGetCardCapacity(&FATFS_HAL_DEVICE);
         return RES_OK;
@@ -250,6 +556,35 @@ DRESULT disk_ioctl (
     default:
         return RES_PARERR;
     }
+#else
+  case BLK:
+    switch (cmd) {
+    case CTRL_SYNC:
+        return disk_sync(pdrv);
+    case GET_SECTOR_COUNT: {
+        BlockDeviceInfo bdi;
+
+        if (blkGetInfo(blkp, &bdi))
+            return RES_ERROR;
+        *((DWORD *)buff) = bdi.blk_num;
+        return RES_OK;
+    }
+#if FF_MAX_SS > FF_MIN_SS
+    case GET_SECTOR_SIZE: {
+        BlockDeviceInfo bdi;
+
+        if (blkGetInfo(blkp, &bdi))
+            return RES_ERROR;
+        *((WORD *)buff) = (WORD)bdi.blk_size;
+        return RES_OK;
+    }
+#endif
+    case GET_BLOCK_SIZE:
+        *((DWORD *)buff) = 1; /* Unknown erase block size */
+        return RES_OK;
+    default:
+        return RES_PARERR;
+    }
 #endif
   }
   return RES_PARERR;
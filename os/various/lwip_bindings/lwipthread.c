@@ -63,12 +63,14 @@
 #include <lwip/opt.h>
 #include <lwip/def.h>
 #include <lwip/mem.h>
+#include <lwip/memp.h>
 #include <lwip/pbuf.h>
 #include <lwip/sys.h>
 #include <lwip/stats.h>
 #include <lwip/snmp.h>
 #include <lwip/tcpip.h>
 #include <netif/etharp.h>
+#include <netif/ethernet.h>
 #include <lwip/netifapi.h>
 
 #if LWIP_DHCP
@@ -79,6 +81,22 @@
 #include <lwip/autoip.h>
 #endif
 
+#if LWIP_USE_ZERO_COPY == TRUE
+#if MAC_USE_ZERO_COPY == FALSE
+#error "LWIP_USE_ZERO_COPY requires MAC_USE_ZERO_COPY"
+#endif
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "LWIP_USE_ZERO_COPY requires LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+#if ETH_PAD_SIZE
+#error "LWIP_USE_ZERO_COPY requires ETH_PAD_SIZE == 0"
+#endif
+#endif
+
+#if (LWIP_RX_BATCH_SIZE > 1) && !LWIP_TCPIP_CORE_LOCKING
+#error "LWIP_RX_BATCH_SIZE > 1 requires LWIP_TCPIP_CORE_LOCKING"
+#endif
+
 #define PERIODIC_TIMER_ID       1
 #define FRAME_RECEIVED_ID       2
 
@@ -92,6 +110,56 @@ thread_reference_t lwip_trp = NULL;
  */
 static THD_WORKING_AREA(wa_lwip_thread, LWIP_THREAD_STACK_SIZE);
 
+#if LWIP_USE_ZERO_COPY == TRUE
+/*
+ * Received frame lent to the stack, the MAC descriptor is released when
+ * the pbuf is freed.
+ */
+typedef struct {
+  struct pbuf_custom    pc;
+  MACReceiveDescriptor  rd;
+} lwip_rx_pbuf_t;
+
+LWIP_MEMPOOL_DECLARE(LWIP_RX_PBUFS, LWIP_ZERO_COPY_RX_PBUFS,
+                     sizeof (lwip_rx_pbuf_t), "Zero-copy RX");
+
+/*
+ * Custom free function of the lent pbufs.
+ */
+static void lwip_rx_pbuf_free(struct pbuf *p) {
+  lwip_rx_pbuf_t *rxp = (lwip_rx_pbuf_t *)p;
+
+  macReleaseReceiveDescriptor(&rxp->rd);
+  LWIP_MEMPOOL_FREE(LWIP_RX_PBUFS, rxp);
+}
+
+/*
+ * Wraps the MAC buffer of a received frame into a PBUF_REF pbuf.
+ * Returns NULL if there are no free wrappers or if the frame spans
+ * multiple buffers, in that case the descriptor is left untouched.
+ */
+static struct pbuf *low_level_input_ref(MACReceiveDescriptor *rdp, u16_t len) {
+  lwip_rx_pbuf_t *rxp;
+  const uint8_t *bp;
+  size_t size;
+
+  rxp = (lwip_rx_pbuf_t *)LWIP_MEMPOOL_ALLOC(LWIP_RX_PBUFS);
+  if (rxp == NULL)
+    return NULL;
+
+  rxp->rd = *rdp;
+  bp = macGetNextReceiveBuffer(&rxp->rd, &size);
+  if ((bp == NULL) || (size != (size_t)len)) {
+    LWIP_MEMPOOL_FREE(LWIP_RX_PBUFS, rxp);
+    return NULL;
+  }
+
+  rxp->pc.custom_free_function = lwip_rx_pbuf_free;
+  return pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &rxp->pc,
+                             (void *)bp, len);
+}
+#endif /* LWIP_USE_ZERO_COPY == TRUE */
+
 /*
  * Initialization.
  */
@@ -125,7 +193,11 @@ static void low_level_init(struct netif *netif) {
  *       dropped because of memory failure (except for the TCP timers).
  */
 static err_t low_level_output(struct netif *netif, struct pbuf *p) {
+#if LWIP_USE_ZERO_COPY == TRUE
+  size_t offset;
+#else
   struct pbuf *q;
+#endif
   MACTransmitDescriptor td;
 
   (void)netif;
@@ -136,9 +208,21 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p) {
   pbuf_header(p, -ETH_PAD_SIZE);        /* drop the padding word */
 #endif
 
+#if LWIP_USE_ZERO_COPY == TRUE
+  /* Gathers the pbuf chain directly into the MAC buffers. */
+  offset = 0;
+  while (offset < p->tot_len) {
+    size_t size;
+    uint8_t *bp = macGetNextTransmitBuffer(&td, p->tot_len - offset, &size);
+    if (bp == NULL)
+      break;
+    offset += pbuf_copy_partial(p, bp, (u16_t)size, (u16_t)offset);
+  }
+#else
   /* Iterates through the pbuf chain. */
   for(q = p; q != NULL; q = q->next)
     macWriteTransmitDescriptor(&td, (uint8_t *)q->payload, (size_t)q->len);
+#endif
   macReleaseTransmitDescriptor(&td);
 
   MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
@@ -164,7 +248,8 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p) {
 /*
  * Receives a frame.
  * Allocates a pbuf and transfers the bytes of the incoming
- * packet from the interface into the pbuf.
+ * packet from the interface into the pbuf. In zero-copy mode the
+ * pbuf references the MAC buffer instead, if possible.
  *
  * @param netif the lwip network interface structure for this ethernetif
  * @return a pbuf filled with the received packet (including MAC header)
@@ -184,14 +269,28 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
 
   len = (u16_t)rd.size;
 
+#if LWIP_USE_ZERO_COPY == TRUE
+  *pbuf = low_level_input_ref(&rd, len);
+#else
+  *pbuf = NULL;
+#endif
+
+  if (*pbuf == NULL) {
 #if ETH_PAD_SIZE
-  len += ETH_PAD_SIZE;        /* allow room for Ethernet padding */
+    len += ETH_PAD_SIZE;        /* allow room for Ethernet padding */
 #endif
 
-  /* We allocate a pbuf chain of pbufs from the pool. */
-  *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+    /* We allocate a pbuf chain of pbufs from the pool. */
+    *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+
+    if (*pbuf == NULL) {
+      macReleaseReceiveDescriptor(&rd);     // Drop packet
+      LINK_STATS_INC(link.memerr);
+      LINK_STATS_INC(link.drop);
+      MIB2_STATS_NETIF_INC(netif, ifindiscards);
+      return true;
+    }
 
-  if (*pbuf != NULL) {
 #if ETH_PAD_SIZE
     pbuf_header(*pbuf, -ETH_PAD_SIZE); /* drop the padding word */
 #endif
@@ -201,33 +300,49 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
       macReadReceiveDescriptor(&rd, (uint8_t *)q->payload, (size_t)q->len);
     macReleaseReceiveDescriptor(&rd);
 
-    MIB2_STATS_NETIF_ADD(netif, ifinoctets, (*pbuf)->tot_len);
-
-    if (*(uint8_t *)((*pbuf)->payload) & 1) {
-      /* broadcast or multicast packet*/
-      MIB2_STATS_NETIF_INC(netif, ifinnucastpkts);
-    } 
-    else {
-      /* unicast packet*/
-      MIB2_STATS_NETIF_INC(netif, ifinucastpkts);
-    }
-
 #if ETH_PAD_SIZE
     pbuf_header(*pbuf, ETH_PAD_SIZE); /* reclaim the padding word */
 #endif
+  }
+
+  MIB2_STATS_NETIF_ADD(netif, ifinoctets, (*pbuf)->tot_len - ETH_PAD_SIZE);
 
-    LINK_STATS_INC(link.recv);
+  if (((uint8_t *)(*pbuf)->payload)[ETH_PAD_SIZE] & 1) {
+    /* broadcast or multicast packet*/
+    MIB2_STATS_NETIF_INC(netif, ifinnucastpkts);
   }
   else {
-    macReleaseReceiveDescriptor(&rd);     // Drop packet
-    LINK_STATS_INC(link.memerr);
-    LINK_STATS_INC(link.drop);
-    MIB2_STATS_NETIF_INC(netif, ifindiscards);
+    /* unicast packet*/
+    MIB2_STATS_NETIF_INC(netif, ifinucastpkts);
   }
-  
+
+  LINK_STATS_INC(link.recv);
+
   return true;
 }
 
+/*
+ * Passes a received frame to the stack using the specified input
+ * function, frames of unsupported types are discarded.
+ */
+static void ethernetif_dispatch(struct netif *netif, struct pbuf *p,
+                                netif_input_fn input) {
+  struct eth_hdr *ethhdr = p->payload;
+
+  switch (htons(ethhdr->type)) {
+    /* IP or ARP packet? */
+    case ETHTYPE_IP:
+    case ETHTYPE_ARP:
+      /* full packet send to tcpip_thread to process */
+      if (input(p, netif) == ERR_OK)
+        break;
+      LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: IP input error\n"));
+      /* Falls through */
+    default:
+      pbuf_free(p);
+  }
+}
+
 /*
  * Called at the beginning of the program to set up the
  * network interface. It calls the function low_level_init() to do the
@@ -366,6 +481,10 @@ static THD_FUNCTION(lwip_thread, p) {
     thisif.hostname = LWIP_NETIF_HOSTNAME_STRING;
 #endif
 
+#if LWIP_USE_ZERO_COPY == TRUE
+  LWIP_MEMPOOL_INIT(LWIP_RX_PBUFS);
+#endif
+
   macStart(&ETHD1, &mac_config);
 
   MIB2_INIT_NETIF(&thisif, snmp_ifType_ethernet_csmacd, 0);
@@ -412,23 +531,35 @@ static THD_FUNCTION(lwip_thread, p) {
 
     if (mask & FRAME_RECEIVED_ID) {
       struct pbuf *p;
-      while (low_level_input(&thisif, &p)) {
-        if (p != NULL) {
-          struct eth_hdr *ethhdr = p->payload;
-          switch (htons(ethhdr->type)) {
-            /* IP or ARP packet? */
-            case ETHTYPE_IP:
-            case ETHTYPE_ARP:
-              /* full packet send to tcpip_thread to process */
-              if (thisif.input(p, &thisif) == ERR_OK)
-                break;
-              LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: IP input error\n"));
-          /* Falls through */
-            default:
-              pbuf_free(p);
-          }
+#if LWIP_RX_BATCH_SIZE > 1
+      struct pbuf *batch[LWIP_RX_BATCH_SIZE];
+      unsigned i, n;
+      bool more = true;
+
+      /* Received frames are fed to the stack directly, all the frames
+         of a batch under a single core lock.*/
+      while (more) {
+        n = 0;
+        while (n < LWIP_RX_BATCH_SIZE) {
+          more = low_level_input(&thisif, &p);
+          if (!more)
+            break;
+          if (p != NULL)
+            batch[n++] = p;
+        }
+        if (n > 0) {
+          LOCK_TCPIP_CORE();
+          for (i = 0; i < n; i++)
+            ethernetif_dispatch(&thisif, batch[i], ethernet_input);
+          UNLOCK_TCPIP_CORE();
         }
       }
+#else
+      while (low_level_input(&thisif, &p)) {
+        if (p != NULL)
+          ethernetif_dispatch(&thisif, p, thisif.input);
+      }
+#endif
     }
   }
 }
@@ -103,6 +103,39 @@
 #define LWIP_LINK_SPEED                     100000000
 #endif
 
+/**
+ * @brief   Enables the zero-copy MAC interface.
+ * @details If enabled, received frames are passed to the stack as pbufs
+ *          referencing the MAC buffers and transmitted frames are gathered
+ *          directly into the MAC buffers.
+ * @note    Requires @p MAC_USE_ZERO_COPY, @p LWIP_SUPPORT_CUSTOM_PBUF and
+ *          an @p ETH_PAD_SIZE of zero.
+ */
+#if !defined(LWIP_USE_ZERO_COPY) || defined(__DOXYGEN__)
+#define LWIP_USE_ZERO_COPY                  FALSE
+#endif
+
+/**
+ * @brief   Number of receive buffers that can be lent to the stack.
+ * @details When all of them are in use, received frames are copied into
+ *          pool pbufs so that the MAC is never starved of buffers.
+ * @note    Must be lower than the number of MAC receive buffers.
+ */
+#if !defined(LWIP_ZERO_COPY_RX_PBUFS) || defined(__DOXYGEN__)
+#define LWIP_ZERO_COPY_RX_PBUFS             4
+#endif
+
+/**
+ * @brief   Maximum number of frames passed to the stack per core lock.
+ * @details Values greater than one make the MAC thread feed the received
+ *          frames directly to the stack, in batches, while holding the
+ *          core lock instead of posting each frame to the tcpip thread.
+ * @note    Values greater than one require @p LWIP_TCPIP_CORE_LOCKING.
+ */
+#if !defined(LWIP_RX_BATCH_SIZE) || defined(__DOXYGEN__)
+#define LWIP_RX_BATCH_SIZE                  1
+#endif
+
 /**
  * @brief   MAC Address byte 0.
  */
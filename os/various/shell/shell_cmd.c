@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "ch.h"
@@ -171,6 +172,173 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 #endif
 
+#if ((SHELL_CMD_TOP_ENABLED == TRUE) && !defined(_CHIBIOS_NIL_) &&          \
+     (CH_DBG_STATISTICS == TRUE)) || defined(__DOXYGEN__)
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+/*
+ * Upper bound of the latency bucket containing the specified percentile.
+ */
+static uint32_t top_percentile(const thread_latency_t *tlp, ucnt_t pct) {
+  ucnt_t count = (ucnt_t)0;
+  ucnt_t limit = (ucnt_t)(((uint64_t)tlp->n * pct + 99U) / 100U);
+  unsigned i;
+
+  if (tlp->n == (ucnt_t)0) {
+    return 0U;
+  }
+
+  for (i = 0U; i < (unsigned)CH_DBG_STATISTICS_LATENCY_BUCKETS - 1U; i++) {
+    count += tlp->histogram[i];
+    if (count >= limit) {
+      return (uint32_t)2U << i;
+    }
+  }
+
+  return (uint32_t)tlp->worst;
+}
+#endif
+
+static void cmd_top(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static const char *states[] = {CH_STATE_NAMES};
+  struct {
+    thread_t            *tp;
+    rttime_t            run;
+    ucnt_t              switches;
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+    thread_latency_t    latency;
+#endif
+    bool                delta;
+  } samples[SHELL_CMD_TOP_MAX_THREADS];
+  thread_stats_t ts;
+  thread_t *tp;
+  rtcnt_t last, now;
+  rttime_t elapsed = (rttime_t)0;
+  unsigned i, n = 0U;
+  uint32_t interval = 1000U;
+
+  if (argc > 1) {
+    shellUsage(chp, "top [milliseconds]");
+    return;
+  }
+  if (argc == 1) {
+    interval = (uint32_t)atoi(argv[0]);
+    if (interval == 0U) {
+      shellUsage(chp, "top [milliseconds]");
+      return;
+    }
+  }
+
+  /* Sampling the statistics of all threads at the start of the interval.*/
+  tp = chRegFirstThread();
+  do {
+    if (n < (unsigned)SHELL_CMD_TOP_MAX_THREADS) {
+      chStatsGetThreadStats(tp, &ts);
+      samples[n].tp       = tp;
+      samples[n].run      = ts.run.cumulative;
+      samples[n].switches = ts.run.n;
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+      samples[n].latency  = ts.latency;
+#endif
+      samples[n].delta    = false;
+      n++;
+    }
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+  last = chSysGetRealtimeCounterX();
+
+  /* The interval is slept in steps shorter than the realtime counter
+     period, the elapsed time is accumulated on 64 bits.*/
+  do {
+    uint32_t step = interval > 1000U ? 1000U : interval;
+
+    chThdSleepMilliseconds(step);
+    now      = chSysGetRealtimeCounterX();
+    elapsed += (rttime_t)(now - last);
+    last     = now;
+    interval -= step;
+  } while (interval > 0U);
+
+  /* Deltas are computed before printing, the output could block the shell
+     thread and alter the measurement. The worst latency is not a counter
+     and is reported since the thread creation.*/
+  if (elapsed == (rttime_t)0) {
+    elapsed = (rttime_t)1;
+  }
+  tp = chRegFirstThread();
+  do {
+    for (i = 0U; i < n; i++) {
+      if (samples[i].tp == tp) {
+        chStatsGetThreadStats(tp, &ts);
+        samples[i].run      = ts.run.cumulative - samples[i].run;
+        samples[i].switches = ts.run.n - samples[i].switches;
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+        {
+          unsigned j;
+
+          samples[i].latency.n     = ts.latency.n - samples[i].latency.n;
+          samples[i].latency.worst = ts.latency.worst;
+          for (j = 0U; j < (unsigned)CH_DBG_STATISTICS_LATENCY_BUCKETS; j++) {
+            samples[i].latency.histogram[j] = ts.latency.histogram[j] -
+                                              samples[i].latency.histogram[j];
+          }
+        }
+#endif
+        samples[i].delta    = true;
+        break;
+      }
+    }
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+  chprintf(chp, "    addr prio     state    cpu%%   switches  p50 cyc  p99 cyc  worst cyc  name" SHELL_NEWLINE_STR);
+#else
+  chprintf(chp, "    addr prio     state    cpu%%   switches  name" SHELL_NEWLINE_STR);
+#endif
+  tp = chRegFirstThread();
+  do {
+    uint32_t permille = 0U;
+    ucnt_t switches;
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+    const thread_latency_t *tlp;
+#endif
+
+    /* Threads created during the interval have all their statistics
+       within the interval.*/
+    chStatsGetThreadStats(tp, &ts);
+    switches = ts.run.n;
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+    tlp = &ts.latency;
+#endif
+    for (i = 0U; i < n; i++) {
+      if ((samples[i].tp == tp) && samples[i].delta) {
+        permille = (uint32_t)((samples[i].run * 1000U) / elapsed);
+        switches = samples[i].switches;
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+        tlp      = &samples[i].latency;
+#endif
+        break;
+      }
+    }
+    chprintf(chp, "%08lx %4lu %9s %5lu.%lu %10lu",
+             (uint32_t)tp, (uint32_t)tp->hdr.pqueue.prio, states[tp->state],
+             permille / 10U, permille % 10U, (uint32_t)switches);
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+    chprintf(chp, " %8lu %8lu %10lu",
+             top_percentile(tlp, 50U),
+             top_percentile(tlp, 99U),
+             (uint32_t)tlp->worst);
+#endif
+    chprintf(chp, "  %s" SHELL_NEWLINE_STR, tp->name == NULL ? "" : tp->name);
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+#if CH_DBG_STATISTICS_LATENCY == TRUE
+  chprintf(chp, "latencies in realtime counter cycles, worst since thread creation"
+                SHELL_NEWLINE_STR);
+#endif
+}
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 static THD_FUNCTION(test_rt, arg) {
   BaseSequentialStream *chp = (BaseSequentialStream *)arg;
@@ -238,6 +406,10 @@ const ShellCommand shell_local_commands[] = {
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads", cmd_threads},
 #endif
+#if (SHELL_CMD_TOP_ENABLED == TRUE) && !defined(_CHIBIOS_NIL_) &&           \
+    (CH_DBG_STATISTICS == TRUE)
+  {"top", cmd_top},
+#endif
 #if SHELL_CMD_TEST_ENABLED == TRUE
   {"test", cmd_test},
 #endif
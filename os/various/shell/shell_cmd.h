@@ -57,6 +57,14 @@
 #define SHELL_CMD_THREADS_ENABLED           TRUE
 #endif
 
+#if !defined(SHELL_CMD_TOP_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_TOP_ENABLED               TRUE
+#endif
+
+#if !defined(SHELL_CMD_TOP_MAX_THREADS) || defined(__DOXYGEN__)
+#define SHELL_CMD_TOP_MAX_THREADS           16
+#endif
+
 #if !defined(SHELL_CMD_TEST_ENABLED) || defined(__DOXYGEN__)
 #define SHELL_CMD_TEST_ENABLED              TRUE
 #endif
@@ -81,6 +89,11 @@
 #error "SHELL_CMD_THREADS_ENABLED requires CH_CFG_USE_REGISTRY"
 #endif
 
+#if (SHELL_CMD_TOP_ENABLED == TRUE) && !defined(_CHIBIOS_NIL_) &&           \
+    (CH_DBG_STATISTICS == TRUE) && (CH_CFG_USE_REGISTRY == FALSE)
+#error "SHELL_CMD_TOP_ENABLED requires CH_CFG_USE_REGISTRY"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -0,0 +1,341 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_streamer.c
+ * @brief   Trace streamer code.
+ *
+ * @addtogroup TRACE_STREAMER
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "trace_streamer.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Mask of the realtime stamps stored in trace records.
+ */
+#define RTSTAMP_MASK                0x00FFFFFFU
+
+/**
+ * @brief   Maximum length of a name.
+ */
+#define NAME_MAX_LENGTH             63U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static trace_event_t records[TRACE_STREAMER_BATCH_SIZE];
+static uint8_t outbuf[TRACE_STREAMER_BUFFER_SIZE];
+static size_t outn;
+static const void *names[TRACE_STREAMER_NAMES_SIZE];
+static bool synced;
+static sysinterval_t sync_interval;
+static systime_t last_time;
+static uint32_t last_rtstamp;
+static uint32_t last_dropped;
+static trace_streamer_stats_t stats;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void out_flush(const TraceStreamerConfig *tscp) {
+
+  if (outn > 0U) {
+    (void) streamWrite(tscp->tsc_stream, outbuf, outn);
+    chSysLock();
+    stats.bytes += (uint32_t)outn;
+    chSysUnlock();
+    outn = 0U;
+  }
+}
+
+static void out_byte(const TraceStreamerConfig *tscp, uint8_t b) {
+
+  if (outn >= sizeof (outbuf)) {
+    out_flush(tscp);
+  }
+  outbuf[outn++] = b;
+}
+
+static void out_number(const TraceStreamerConfig *tscp, uint64_t n) {
+
+  while (n >= 0x80U) {
+    out_byte(tscp, (uint8_t)(n | 0x80U));
+    n >>= 7;
+  }
+  out_byte(tscp, (uint8_t)n);
+}
+
+static void out_pointer(const TraceStreamerConfig *tscp, const void *p) {
+
+  out_number(tscp, (uint64_t)(uintptr_t)p);
+}
+
+static void out_tag(const TraceStreamerConfig *tscp,
+                    uint32_t type, uint32_t state) {
+
+  out_byte(tscp, (uint8_t)((type & 7U) | (state << 3)));
+}
+
+/*
+ * Sends the name associated to an identifier unless it has already been
+ * sent recently.
+ */
+static void out_name(const TraceStreamerConfig *tscp,
+                     const void *id, const char *name) {
+  unsigned i = (unsigned)(((uintptr_t)id >> 2) % TRACE_STREAMER_NAMES_SIZE);
+  size_t n;
+
+  if (names[i] == id) {
+    return;
+  }
+  names[i] = id;
+
+  if (name == NULL) {
+    name = "";
+  }
+  n = strlen(name);
+  if (n > NAME_MAX_LENGTH) {
+    n = NAME_MAX_LENGTH;
+  }
+  out_tag(tscp, CH_TRACE_TYPE_UNUSED, TRACE_STREAMER_NAME);
+  out_pointer(tscp, id);
+  out_number(tscp, (uint64_t)n);
+  while (n > 0U) {
+    out_byte(tscp, (uint8_t)*name++);
+    n--;
+  }
+}
+
+/*
+ * Sends the name of a thread, the thread could have been terminated in the
+ * meanwhile so the registry is checked first.
+ */
+static void out_thread_name(const TraceStreamerConfig *tscp, thread_t *tp) {
+  const char *name = NULL;
+  unsigned i = (unsigned)(((uintptr_t)tp >> 2) % TRACE_STREAMER_NAMES_SIZE);
+
+  if (names[i] == (const void *)tp) {
+    return;
+  }
+
+#if CH_CFG_USE_REGISTRY == TRUE
+  if (chRegFindThreadByPointer(tp) != NULL) {
+    name = chRegGetThreadNameX(tp);
+#if CH_CFG_USE_DYNAMIC == TRUE
+    chThdRelease(tp);
+#endif
+  }
+#endif
+
+  out_name(tscp, tp, name);
+}
+
+static void out_record(const TraceStreamerConfig *tscp,
+                       const trace_event_t *tep) {
+  uint32_t dt;
+
+  /* Names used by the record are sent first.*/
+  switch (tep->type) {
+  case CH_TRACE_TYPE_READY:
+    out_thread_name(tscp, tep->u.rdy.tp);
+    break;
+  case CH_TRACE_TYPE_SWITCH:
+    out_thread_name(tscp, tep->u.sw.ntp);
+    break;
+  case CH_TRACE_TYPE_ISR_ENTER:
+  case CH_TRACE_TYPE_ISR_LEAVE:
+    out_name(tscp, tep->u.isr.name, tep->u.isr.name);
+    break;
+  case CH_TRACE_TYPE_HALT:
+    out_name(tscp, tep->u.halt.reason, tep->u.halt.reason);
+    break;
+  default:
+    break;
+  }
+
+  /* The absolute time is sent when the delta could be ambiguous.*/
+  if (!synced || (chTimeDiffX(last_time, tep->time) >= sync_interval)) {
+    synced = true;
+    out_tag(tscp, CH_TRACE_TYPE_UNUSED, TRACE_STREAMER_SYNC);
+    out_number(tscp, (uint64_t)tep->time);
+    out_number(tscp, (uint64_t)tep->rtstamp);
+    dt = 0U;
+  }
+  else if (tscp->tsc_rtfreq > 0U) {
+    dt = ((uint32_t)tep->rtstamp - last_rtstamp) & RTSTAMP_MASK;
+  }
+  else {
+    dt = (uint32_t)chTimeDiffX(last_time, tep->time);
+  }
+  last_time    = tep->time;
+  last_rtstamp = (uint32_t)tep->rtstamp;
+
+  out_tag(tscp, tep->type, tep->state);
+  out_number(tscp, (uint64_t)dt);
+  switch (tep->type) {
+  case CH_TRACE_TYPE_READY:
+    out_pointer(tscp, tep->u.rdy.tp);
+    /* Zig-zag encoding of the message.*/
+    out_number(tscp, ((uint64_t)(int64_t)tep->u.rdy.msg << 1) ^
+                     (uint64_t)((int64_t)tep->u.rdy.msg >> 63));
+    break;
+  case CH_TRACE_TYPE_SWITCH:
+    out_pointer(tscp, tep->u.sw.ntp);
+    out_pointer(tscp, tep->u.sw.wtobjp);
+    break;
+  case CH_TRACE_TYPE_ISR_ENTER:
+  case CH_TRACE_TYPE_ISR_LEAVE:
+    out_pointer(tscp, tep->u.isr.name);
+    break;
+  case CH_TRACE_TYPE_HALT:
+    out_pointer(tscp, tep->u.halt.reason);
+    break;
+  case CH_TRACE_TYPE_USER:
+    out_pointer(tscp, tep->u.user.up1);
+    out_pointer(tscp, tep->u.user.up2);
+    break;
+  default:
+    break;
+  }
+}
+
+static void out_header(const TraceStreamerConfig *tscp) {
+  uint32_t stfreq = (uint32_t)CH_CFG_ST_FREQUENCY;
+  unsigned i;
+
+  out_byte(tscp, (uint8_t)'C');
+  out_byte(tscp, (uint8_t)'H');
+  out_byte(tscp, (uint8_t)'T');
+  out_byte(tscp, (uint8_t)'S');
+  out_byte(tscp, (uint8_t)TRACE_STREAMER_VERSION);
+  out_byte(tscp, (uint8_t)sizeof (systime_t));
+  for (i = 0U; i < 32U; i += 8U) {
+    out_byte(tscp, (uint8_t)(tscp->tsc_rtfreq >> i));
+  }
+  for (i = 0U; i < 32U; i += 8U) {
+    out_byte(tscp, (uint8_t)(stfreq >> i));
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Trace streamer thread function.
+ * @details The thread periodically moves the records of the trace buffer
+ *          to the output stream. It should run at a low priority, records
+ *          are dropped by the kernel if the streamer cannot keep up with
+ *          the events rate.
+ * @note    The thread terminates, after draining the trace buffer, when
+ *          @p chThdTerminate() is invoked on it.
+ *
+ * @param[in] p         pointer to a @p TraceStreamerConfig object
+ */
+THD_FUNCTION(traceStreamerThread, p) {
+  const TraceStreamerConfig *tscp = (const TraceStreamerConfig *)p;
+  uint32_t dropped;
+  size_t i, n;
+
+  chRegSetThreadName(TRACE_STREAMER_THREAD_NAME);
+
+  outn   = 0U;
+  synced = false;
+  memset(names, 0, sizeof (names));
+  memset(&stats, 0, sizeof (stats));
+  last_dropped = chDbgGetTraceDroppedX();
+
+  /* Largest interval not making the 24 bits realtime stamps wrap.*/
+  if (tscp->tsc_rtfreq > 0U) {
+    sync_interval = (sysinterval_t)(((uint64_t)1U << 23) *
+                                    (uint64_t)CH_CFG_ST_FREQUENCY /
+                                    (uint64_t)tscp->tsc_rtfreq);
+    if (sync_interval == (sysinterval_t)0) {
+      sync_interval = (sysinterval_t)1;
+    }
+  }
+  else {
+    sync_interval = TIME_MAX_INTERVAL;
+  }
+
+  out_header(tscp);
+
+  while (true) {
+    n = chDbgReadTraceX(records, TRACE_STREAMER_BATCH_SIZE);
+    for (i = 0U; i < n; i++) {
+      out_record(tscp, &records[i]);
+    }
+
+    /* Reporting records lost since the previous report.*/
+    dropped = chDbgGetTraceDroppedX();
+    if (dropped != last_dropped) {
+      out_tag(tscp, CH_TRACE_TYPE_UNUSED, TRACE_STREAMER_DROPPED);
+      out_number(tscp, (uint64_t)(dropped - last_dropped));
+      chSysLock();
+      stats.dropped += dropped - last_dropped;
+      chSysUnlock();
+      last_dropped = dropped;
+    }
+
+    chSysLock();
+    stats.records += (uint32_t)n;
+    chSysUnlock();
+
+    /* Waiting for more records only if the buffer has been emptied.*/
+    if (n < TRACE_STREAMER_BATCH_SIZE) {
+      out_flush(tscp);
+      if (chThdShouldTerminateX()) {
+        break;
+      }
+      chThdSleepMilliseconds(TRACE_STREAMER_INTERVAL);
+    }
+  }
+}
+
+/**
+ * @brief   Returns the trace streamer statistics.
+ *
+ * @param[out] tssp     pointer to a @p trace_streamer_stats_t structure
+ *
+ * @api
+ */
+void traceStreamerGetStats(trace_streamer_stats_t *tssp) {
+
+  chSysLock();
+  *tssp = stats;
+  chSysUnlock();
+}
+
+/** @} */
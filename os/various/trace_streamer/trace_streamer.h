@@ -0,0 +1,175 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_streamer.h
+ * @brief   Trace streamer macros and structures.
+ * @details The streamer thread drains the kernel trace buffer and writes
+ *          the records on a stream in a compact binary format:
+ *          - Header: the "CHTS" magic, a version byte, the size of
+ *            @p systime_t in bytes, the realtime counter frequency and the
+ *            system tick frequency, both as 32 bits little endian values.
+ *          - Records: a tag byte containing the record type in bits 0..2 and
+ *            the thread state in bits 3..7, a time delta and the record
+ *            payload. Numbers are encoded as LEB128 variable length
+ *            integers, messages use the zig-zag encoding.
+ *          .
+ *          Time deltas are expressed in realtime counter cycles, modulo
+ *          2^24, or in system ticks if the realtime counter frequency is
+ *          zero. Records of type zero are generated by the streamer, they
+ *          have no time delta and the state field specifies their kind:
+ *          - @p TRACE_STREAMER_SYNC, absolute system time and realtime
+ *            counter value of the next record.
+ *          - @p TRACE_STREAMER_DROPPED, number of records dropped by the
+ *            kernel since the previous report.
+ *          - @p TRACE_STREAMER_NAME, an identifier followed by the length
+ *            and the characters of its name.
+ *          .
+ *
+ * @addtogroup TRACE_STREAMER
+ * @{
+ */
+
+#ifndef TRACE_STREAMER_H
+#define TRACE_STREAMER_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Stream format version.
+ */
+#define TRACE_STREAMER_VERSION      1U
+
+/**
+ * @name    Streamer records kinds
+ * @{
+ */
+#define TRACE_STREAMER_SYNC         0U
+#define TRACE_STREAMER_DROPPED      1U
+#define TRACE_STREAMER_NAME         2U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of records fetched from the trace buffer at once.
+ */
+#if !defined(TRACE_STREAMER_BATCH_SIZE) || defined(__DOXYGEN__)
+#define TRACE_STREAMER_BATCH_SIZE   16
+#endif
+
+/**
+ * @brief   Size of the output buffer.
+ */
+#if !defined(TRACE_STREAMER_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define TRACE_STREAMER_BUFFER_SIZE  256
+#endif
+
+/**
+ * @brief   Number of entries in the cache of the already sent names.
+ */
+#if !defined(TRACE_STREAMER_NAMES_SIZE) || defined(__DOXYGEN__)
+#define TRACE_STREAMER_NAMES_SIZE   32
+#endif
+
+/**
+ * @brief   Polling interval, in milliseconds, when the trace buffer is
+ *          empty.
+ */
+#if !defined(TRACE_STREAMER_INTERVAL) || defined(__DOXYGEN__)
+#define TRACE_STREAMER_INTERVAL     10
+#endif
+
+/**
+ * @brief   Default streamer thread name.
+ */
+#if !defined(TRACE_STREAMER_THREAD_NAME) || defined(__DOXYGEN__)
+#define TRACE_STREAMER_THREAD_NAME  "trace"
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_DBG_TRACE_STREAM != TRUE
+#error "trace streamer requires CH_DBG_TRACE_STREAM"
+#endif
+
+#if TRACE_STREAMER_BATCH_SIZE < 1
+#error "invalid TRACE_STREAMER_BATCH_SIZE value"
+#endif
+
+#if TRACE_STREAMER_BUFFER_SIZE < 64
+#error "invalid TRACE_STREAMER_BUFFER_SIZE value"
+#endif
+
+#if TRACE_STREAMER_NAMES_SIZE < 1
+#error "invalid TRACE_STREAMER_NAMES_SIZE value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Trace streamer configuration type.
+ */
+typedef struct {
+  BaseSequentialStream  *tsc_stream;        /**< @brief Output stream.      */
+  uint32_t              tsc_rtfreq;         /**< @brief Realtime counter
+                                                 frequency, zero if time
+                                                 deltas are in system
+                                                 ticks.                     */
+} TraceStreamerConfig;
+
+/**
+ * @brief   Trace streamer statistics type.
+ */
+typedef struct {
+  uint32_t              records;            /**< @brief Records sent.       */
+  uint32_t              dropped;            /**< @brief Records dropped by
+                                                 the kernel.                */
+  uint32_t              bytes;              /**< @brief Bytes written.      */
+} trace_streamer_stats_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  THD_FUNCTION(traceStreamerThread, p);
+  void traceStreamerGetStats(trace_streamer_stats_t *tssp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* TRACE_STREAMER_H */
+
+/** @} */
@@ -0,0 +1,8 @@
+# Trace streamer files.
+TRSTREAMSRC = $(CHIBIOS)/os/various/trace_streamer/trace_streamer.c
+
+TRSTREAMINC = $(CHIBIOS)/os/various/trace_streamer
+
+# Shared variables
+ALLCSRC += $(TRSTREAMSRC)
+ALLINC  += $(TRSTREAMINC)
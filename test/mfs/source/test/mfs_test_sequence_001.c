@@ -37,6 +37,10 @@
  * - @subpage mfs_test_001_005
  * - @subpage mfs_test_001_006
  * - @subpage mfs_test_001_007
+ * - @subpage mfs_test_001_008
+ * - @subpage mfs_test_001_009
+ * - @subpage mfs_test_001_010
+ * - @subpage mfs_test_001_011
  * .
  */
 
@@ -378,6 +382,7 @@ static const testcase_t mfs_test_001_004 = {
   mfs_test_001_004_execute
 };
 
+#if (MFS_CFG_CHECKPOINT_INTERVAL == 0) || defined(__DOXYGEN__)
 /**
  * @page mfs_test_001_005 [1.5] Testing storage size limit
  *
@@ -385,6 +390,12 @@ static const testcase_t mfs_test_001_004 = {
  * The storage is entirely filled with different records and the final
  * error is tested.
  *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_CHECKPOINT_INTERVAL == 0
+ * .
+ *
  * <h2>Test Steps</h2>
  * - [1.5.1] Filling up the storage by writing records with increasing
  *   IDs, MFS_NO_ERROR is expected.
@@ -411,7 +422,7 @@ static void mfs_test_001_005_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_RECORDS_OFFSET +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -438,7 +449,7 @@ static void mfs_test_001_005_execute(void) {
   test_set_step(2);
   {
     mfs_error_t err;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_RECORDS_OFFSET +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -492,7 +503,9 @@ static const testcase_t mfs_test_001_005 = {
   mfs_test_001_005_teardown,
   mfs_test_001_005_execute
 };
+#endif /* MFS_CFG_CHECKPOINT_INTERVAL == 0 */
 
+#if (MFS_CFG_CHECKPOINT_INTERVAL == 0) || defined(__DOXYGEN__)
 /**
  * @page mfs_test_001_006 [1.6] Testing garbage collection by writing
  *
@@ -500,6 +513,12 @@ static const testcase_t mfs_test_001_005 = {
  * The garbage collection procedure is triggeredby a write operation
  * and the state of both banks is checked.
  *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_CHECKPOINT_INTERVAL == 0
+ * .
+ *
  * <h2>Test Steps</h2>
  * - [1.6.1] Filling up the storage by writing records with increasing
  *   IDs, MFS_NO_ERROR is expected.
@@ -534,7 +553,7 @@ static void mfs_test_001_006_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_RECORDS_OFFSET +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -598,7 +617,7 @@ static void mfs_test_001_006_execute(void) {
   test_set_step(4);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_RECORDS_OFFSET +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -665,7 +684,7 @@ static void mfs_test_001_006_execute(void) {
   test_set_step(7);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_RECORDS_OFFSET +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -697,7 +716,9 @@ static const testcase_t mfs_test_001_006 = {
   mfs_test_001_006_teardown,
   mfs_test_001_006_execute
 };
+#endif /* MFS_CFG_CHECKPOINT_INTERVAL == 0 */
 
+#if (MFS_CFG_CHECKPOINT_INTERVAL == 0) || defined(__DOXYGEN__)
 /**
  * @page mfs_test_001_007 [1.7] Testing garbage collection by erasing
  *
@@ -705,6 +726,12 @@ static const testcase_t mfs_test_001_006 = {
  * The garbage collection procedure is triggered by an erase operation
  * and the state of both banks is checked.
  *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_CHECKPOINT_INTERVAL == 0
+ * .
+ *
  * <h2>Test Steps</h2>
  * - [1.7.1] Filling up the storage by writing records with increasing
  *   IDs, MFS_NO_ERROR is expected.
@@ -731,7 +758,7 @@ static void mfs_test_001_007_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_RECORDS_OFFSET +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
 
@@ -757,10 +784,10 @@ static void mfs_test_001_007_execute(void) {
     mfs_error_t err;
     size_t size;
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_RECORDS_OFFSET +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
-    mfs_id_t n = ((mfscfg1.bank_size - sizeof (mfs_bank_header_t)) -
+    mfs_id_t n = ((mfscfg1.bank_size - MFS_RECORDS_OFFSET) -
                   (id_max * (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4)))) /
                  sizeof (mfs_data_header_t);
 
@@ -781,7 +808,7 @@ static void mfs_test_001_007_execute(void) {
   {
     mfs_error_t err;
     size_t size;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_RECORDS_OFFSET +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
 
@@ -804,6 +831,464 @@ static const testcase_t mfs_test_001_007 = {
   mfs_test_001_007_teardown,
   mfs_test_001_007_execute
 };
+#endif /* MFS_CFG_CHECKPOINT_INTERVAL == 0 */
+
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_001_008 [1.8] Testing checkpoints
+ *
+ * <h2>Description</h2>
+ * A checkpoint is written, more records are written after it and the
+ * storage is re-mounted, records must be restored from the checkpoint
+ * and the following records.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_USE_CHECKPOINTS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [1.8.1] Creating records 1, 2 and 3 then writing a checkpoint,
+ *   MFS_NO_ERROR is expected.
+ * - [1.8.2] Updating record 2 and erasing record 3 after the
+ *   checkpoint, MFS_NO_ERROR is expected.
+ * - [1.8.3] Re-mounting, records must be restored from the checkpoint
+ *   and the following records.
+ * - [1.8.4] Performing a garbage collection, the checkpoint slots are
+ *   freed and records must still exist.
+ * .
+ */
+
+static void mfs_test_001_008_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_008_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_008_execute(void) {
+  mfs_error_t err;
+  size_t size;
+
+  /* [1.8.1] Creating records 1, 2 and 3 then writing a checkpoint,
+     MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    uint32_t slot;
+
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error creating record 1");
+    err = mfsWriteRecord(&mfs1, 2, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_NO_ERROR, "error creating record 2");
+    err = mfsWriteRecord(&mfs1, 3, sizeof mfs_pattern10, mfs_pattern10);
+    test_assert(err == MFS_NO_ERROR, "error creating record 3");
+    slot = mfs1.cp_slot;
+    err = mfsWriteCheckpoint(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "error writing the checkpoint");
+    test_assert(mfs1.cp_slot == slot + 1U, "slot not used");
+  }
+  test_end_step(1);
+
+  /* [1.8.2] Updating record 2 and erasing record 3 after the
+     checkpoint, MFS_NO_ERROR is expected.*/
+  test_set_step(2);
+  {
+    err = mfsWriteRecord(&mfs1, 2, sizeof mfs_pattern10, mfs_pattern10);
+    test_assert(err == MFS_NO_ERROR, "error updating record 2");
+    err = mfsEraseRecord(&mfs1, 3);
+    test_assert(err == MFS_NO_ERROR, "error erasing record 3");
+  }
+  test_end_step(2);
+
+  /* [1.8.3] Re-mounting, records must be restored from the checkpoint
+     and the following records.*/
+  test_set_step(3);
+  {
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "re-mount failed");
+    test_assert(mfs1.cp_slot > 0U, "checkpoint not found");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 1 not present");
+    test_assert(size == sizeof mfs_pattern16, "unexpected record length");
+    test_assert(memcmp(mfs_pattern16, mfs_buffer, size) == 0, "wrong record content");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 2, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 2 not present");
+    test_assert(size == sizeof mfs_pattern10, "unexpected record length");
+    test_assert(memcmp(mfs_pattern10, mfs_buffer, size) == 0, "wrong record content");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 3, &size, mfs_buffer);
+    test_assert(err == MFS_ERR_NOT_FOUND, "record 3 still present");
+  }
+  test_end_step(3);
+
+  /* [1.8.4] Performing a garbage collection, the checkpoint slots are
+     freed and records must still exist.*/
+  test_set_step(4);
+  {
+    err = mfsPerformGarbageCollection(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "garbage collection failed");
+    test_assert(mfs1.cp_slot == 0U, "slots not freed");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 1 not present");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 2, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 2 not present");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t mfs_test_001_008 = {
+  "Testing checkpoints",
+  mfs_test_001_008_setup,
+  mfs_test_001_008_teardown,
+  mfs_test_001_008_execute
+};
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
+#if (MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_001_009 [1.9] Testing sparse record identifiers
+ *
+ * <h2>Description</h2>
+ * The descriptors table is filled with records having sparse
+ * identifiers, creating one more record must fail until a record is
+ * erased.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [1.9.1] Filling the descriptors table with records having sparse
+ *   identifiers, MFS_NO_ERROR is expected.
+ * - [1.9.2] Creating one more record, MFS_ERR_OUT_OF_MEM is expected.
+ * - [1.9.3] Erasing one record then creating the new record,
+ *   MFS_NO_ERROR is expected.
+ * - [1.9.4] Re-mounting, records must still exist.
+ * .
+ */
+
+static void mfs_test_001_009_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_009_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_009_execute(void) {
+  mfs_id_t id, step = MFS_CFG_MAX_ID / MFS_CFG_MAX_RECORDS;
+  mfs_error_t err;
+  size_t size;
+
+  /* [1.9.1] Filling the descriptors table with records having sparse
+     identifiers, MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    for (id = 0; id < MFS_CFG_MAX_RECORDS; id++) {
+      err = mfsWriteRecord(&mfs1, MFS_CFG_MAX_ID - (id * step),
+                           sizeof mfs_pattern16, mfs_pattern16);
+      test_assert(err == MFS_NO_ERROR, "error creating the record");
+    }
+  }
+  test_end_step(1);
+
+  /* [1.9.2] Creating one more record, MFS_ERR_OUT_OF_MEM is expected.*/
+  test_set_step(2);
+  {
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_ERR_OUT_OF_MEM, "creation didn't fail");
+  }
+  test_end_step(2);
+
+  /* [1.9.3] Erasing one record then creating the new record,
+     MFS_NO_ERROR is expected.*/
+  test_set_step(3);
+  {
+    err = mfsEraseRecord(&mfs1, MFS_CFG_MAX_ID);
+    test_assert(err == MFS_NO_ERROR, "error erasing the record");
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_NO_ERROR, "error creating the record");
+  }
+  test_end_step(3);
+
+  /* [1.9.4] Re-mounting, records must still exist.*/
+  test_set_step(4);
+  {
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "re-mount failed");
+    for (id = 1; id < MFS_CFG_MAX_RECORDS; id++) {
+      size = sizeof mfs_buffer;
+      err = mfsReadRecord(&mfs1, MFS_CFG_MAX_ID - (id * step), &size, mfs_buffer);
+      test_assert(err == MFS_NO_ERROR, "record not found");
+      test_assert(size == sizeof mfs_pattern16, "unexpected record length");
+      test_assert(memcmp(mfs_pattern16, mfs_buffer, size) == 0, "wrong record content");
+    }
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, MFS_CFG_MAX_ID, &size, mfs_buffer);
+    test_assert(err == MFS_ERR_NOT_FOUND, "record not erased");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof mfs_pattern32, "unexpected record length");
+    test_assert(memcmp(mfs_pattern32, mfs_buffer, size) == 0, "wrong record content");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t mfs_test_001_009 = {
+  "Testing sparse record identifiers",
+  mfs_test_001_009_setup,
+  mfs_test_001_009_teardown,
+  mfs_test_001_009_execute
+};
+#endif /* MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS */
+
+/**
+ * @page mfs_test_001_010 [1.10] Testing incremental garbage collection
+ *
+ * <h2>Description</h2>
+ * The garbage collection is performed in steps, records are updated and
+ * erased between steps. After the bank swap and after re-mounting the
+ * records must have the expected content.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.10.1] Creating records 1, 2 and 3 then updating them,
+ *   MFS_NO_ERROR is expected.
+ * - [1.10.2] Performing a garbage collection step moving a single
+ *   record, MFS_WARN_GC_PENDING is expected.
+ * - [1.10.3] Updating record 1 and erasing record 2 during the garbage
+ *   collection, MFS_NO_ERROR is expected.
+ * - [1.10.4] Completing the garbage collection in steps, the banks must
+ *   be swapped.
+ * - [1.10.5] Reading records, then re-mounting and reading them again,
+ *   records must have the expected content.
+ * .
+ */
+
+static void mfs_test_001_010_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_010_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_010_execute(void) {
+  mfs_error_t err;
+  size_t size;
+  unsigned i;
+
+  /* [1.10.1] Creating records 1, 2 and 3 then updating them,
+     MFS_NO_ERROR is expected.*/
+  test_set_step(1);
+  {
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error creating record 1");
+    err = mfsWriteRecord(&mfs1, 2, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error creating record 2");
+    err = mfsWriteRecord(&mfs1, 3, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error creating record 3");
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_NO_ERROR, "error updating record 1");
+    err = mfsWriteRecord(&mfs1, 2, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_NO_ERROR, "error updating record 2");
+    err = mfsWriteRecord(&mfs1, 3, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_NO_ERROR, "error updating record 3");
+  }
+  test_end_step(1);
+
+  /* [1.10.2] Performing a garbage collection step moving a single
+     record, MFS_WARN_GC_PENDING is expected.*/
+  test_set_step(2);
+  {
+    err = mfsPerformGarbageCollectionStep(&mfs1, 1);
+    test_assert(err == MFS_WARN_GC_PENDING, "unexpected result");
+    test_assert(mfs1.current_bank == MFS_BANK_0, "unexpected bank swap");
+  }
+  test_end_step(2);
+
+  /* [1.10.3] Updating record 1 and erasing record 2 during the garbage
+     collection, MFS_NO_ERROR is expected.*/
+  test_set_step(3);
+  {
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern10, mfs_pattern10);
+    test_assert(err == MFS_NO_ERROR, "error updating record 1");
+    err = mfsEraseRecord(&mfs1, 2);
+    test_assert(err == MFS_NO_ERROR, "error erasing record 2");
+  }
+  test_end_step(3);
+
+  /* [1.10.4] Completing the garbage collection in steps, the banks must
+     be swapped.*/
+  test_set_step(4);
+  {
+    do {
+      err = mfsPerformGarbageCollectionStep(&mfs1, 16);
+      test_assert(!MFS_IS_ERROR(err), "garbage collection step failed");
+    } while (err == MFS_WARN_GC_PENDING);
+    test_assert(mfs1.current_bank == MFS_BANK_1, "banks not swapped");
+  }
+  test_end_step(4);
+
+  /* [1.10.5] Reading records, then re-mounting and reading them again,
+     records must have the expected content.*/
+  test_set_step(5);
+  {
+    for (i = 0; i < 2; i++) {
+      size = sizeof mfs_buffer;
+      err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+      test_assert(err == MFS_NO_ERROR, "record 1 not present");
+      test_assert(size == sizeof mfs_pattern10, "unexpected record length");
+      test_assert(memcmp(mfs_pattern10, mfs_buffer, size) == 0, "wrong record content");
+      size = sizeof mfs_buffer;
+      err = mfsReadRecord(&mfs1, 2, &size, mfs_buffer);
+      test_assert(err == MFS_ERR_NOT_FOUND, "record 2 still present");
+      size = sizeof mfs_buffer;
+      err = mfsReadRecord(&mfs1, 3, &size, mfs_buffer);
+      test_assert(err == MFS_NO_ERROR, "record 3 not present");
+      test_assert(size == sizeof mfs_pattern32, "unexpected record length");
+      test_assert(memcmp(mfs_pattern32, mfs_buffer, size) == 0, "wrong record content");
+
+      mfsStop(&mfs1);
+      err = mfsStart(&mfs1, &mfscfg1);
+      test_assert(err == MFS_NO_ERROR, "re-mount failed");
+    }
+  }
+  test_end_step(5);
+}
+
+static const testcase_t mfs_test_001_010 = {
+  "Testing incremental garbage collection",
+  mfs_test_001_010_setup,
+  mfs_test_001_010_teardown,
+  mfs_test_001_010_execute
+};
+
+#if ((MFS_CFG_USE_CHECKPOINTS == TRUE) && (MFS_CFG_CHECKPOINT_INTERVAL > 0)) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_001_011 [1.11] Testing automatic checkpoints
+ *
+ * <h2>Description</h2>
+ * Records are written until the checkpoint interval is reached, a
+ * checkpoint must be written without an explicit request and the
+ * records must be restored from it on re-mount.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (MFS_CFG_USE_CHECKPOINTS == TRUE) && (MFS_CFG_CHECKPOINT_INTERVAL > 0)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [1.11.1] Writing one record less than the checkpoint interval, no
+ *   checkpoint is expected.
+ * - [1.11.2] Writing one more record, a checkpoint is expected.
+ * - [1.11.3] Updating record 2 after the checkpoint then re-mounting,
+ *   records must be restored from the checkpoint and the following
+ *   records.
+ * - [1.11.4] Performing a garbage collection, the checkpoint slots are
+ *   freed and records must still exist.
+ * .
+ */
+
+static void mfs_test_001_011_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_011_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_011_execute(void) {
+  mfs_error_t err;
+  size_t size;
+  unsigned i;
+
+  /* [1.11.1] Writing one record less than the checkpoint interval, no
+     checkpoint is expected.*/
+  test_set_step(1);
+  {
+    for (i = 1U; i < (unsigned)MFS_CFG_CHECKPOINT_INTERVAL; i++) {
+      err = mfsWriteRecord(&mfs1, (mfs_id_t)((i & 1U) + 1U),
+                           sizeof mfs_pattern16, mfs_pattern16);
+      test_assert(err == MFS_NO_ERROR, "error writing the record");
+    }
+    test_assert(mfs1.cp_slot == 0U, "unexpected checkpoint");
+  }
+  test_end_step(1);
+
+  /* [1.11.2] Writing one more record, a checkpoint is expected.*/
+  test_set_step(2);
+  {
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_NO_ERROR, "error writing record 1");
+    test_assert(mfs1.cp_slot == 1U, "checkpoint not written");
+    test_assert(mfs1.cp_records == 0U, "records counter not reset");
+  }
+  test_end_step(2);
+
+  /* [1.11.3] Updating record 2 after the checkpoint then re-mounting,
+     records must be restored from the checkpoint and the following
+     records.*/
+  test_set_step(3);
+  {
+    err = mfsWriteRecord(&mfs1, 2, sizeof mfs_pattern10, mfs_pattern10);
+    test_assert(err == MFS_NO_ERROR, "error writing record 2");
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "re-mount failed");
+    test_assert(mfs1.cp_slot > 0U, "checkpoint not found");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 1 not present");
+    test_assert(size == sizeof mfs_pattern32, "unexpected record length");
+    test_assert(memcmp(mfs_pattern32, mfs_buffer, size) == 0, "wrong record content");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 2, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 2 not present");
+    test_assert(size == sizeof mfs_pattern10, "unexpected record length");
+    test_assert(memcmp(mfs_pattern10, mfs_buffer, size) == 0, "wrong record content");
+  }
+  test_end_step(3);
+
+  /* [1.11.4] Performing a garbage collection, the checkpoint slots are
+     freed and records must still exist.*/
+  test_set_step(4);
+  {
+    err = mfsPerformGarbageCollection(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "garbage collection failed");
+    test_assert(mfs1.cp_slot == 0U, "slots not freed");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 1 not present");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 2, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record 2 not present");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t mfs_test_001_011 = {
+  "Testing automatic checkpoints",
+  mfs_test_001_011_setup,
+  mfs_test_001_011_teardown,
+  mfs_test_001_011_execute
+};
+#endif /* (MFS_CFG_USE_CHECKPOINTS == TRUE) && (MFS_CFG_CHECKPOINT_INTERVAL > 0) */
 
 /****************************************************************************
  * Exported data.
@@ -817,9 +1302,25 @@ const testcase_t * const mfs_test_sequence_001_array[] = {
   &mfs_test_001_002,
   &mfs_test_001_003,
   &mfs_test_001_004,
+#if (MFS_CFG_CHECKPOINT_INTERVAL == 0) || defined(__DOXYGEN__)
   &mfs_test_001_005,
+#endif
+#if (MFS_CFG_CHECKPOINT_INTERVAL == 0) || defined(__DOXYGEN__)
   &mfs_test_001_006,
+#endif
+#if (MFS_CFG_CHECKPOINT_INTERVAL == 0) || defined(__DOXYGEN__)
   &mfs_test_001_007,
+#endif
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  &mfs_test_001_008,
+#endif
+#if (MFS_CFG_MAX_ID > MFS_CFG_MAX_RECORDS) || defined(__DOXYGEN__)
+  &mfs_test_001_009,
+#endif
+  &mfs_test_001_010,
+#if ((MFS_CFG_USE_CHECKPOINTS == TRUE) && (MFS_CFG_CHECKPOINT_INTERVAL > 0)) || defined(__DOXYGEN__)
+  &mfs_test_001_011,
+#endif
   NULL
 };
 
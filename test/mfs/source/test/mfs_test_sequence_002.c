@@ -442,6 +442,7 @@ static const testcase_t mfs_test_002_002 = {
   mfs_test_002_002_execute
 };
 
+#if (MFS_CFG_CHECKPOINT_INTERVAL == 0) || defined(__DOXYGEN__)
 /**
  * @page mfs_test_002_003 [2.3] Transaction triggering an early garbage collect
  *
@@ -449,6 +450,12 @@ static const testcase_t mfs_test_002_002 = {
  * A transaction is started with sufficient space but not contiguous, a
  * garbage collection is triggered.
  *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_CHECKPOINT_INTERVAL == 0
+ * .
+ *
  * <h2>Test Steps</h2>
  * - [2.3.1] Filling up the storage by writing records with increasing
  *   IDs, MFS_NO_ERROR is expected.
@@ -480,7 +487,7 @@ static void mfs_test_002_003_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_RECORDS_OFFSET +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -569,6 +576,7 @@ static const testcase_t mfs_test_002_003 = {
   mfs_test_002_003_teardown,
   mfs_test_002_003_execute
 };
+#endif /* MFS_CFG_CHECKPOINT_INTERVAL == 0 */
 
 /****************************************************************************
  * Exported data.
@@ -580,7 +588,9 @@ static const testcase_t mfs_test_002_003 = {
 const testcase_t * const mfs_test_sequence_002_array[] = {
   &mfs_test_002_001,
   &mfs_test_002_002,
+#if (MFS_CFG_CHECKPOINT_INTERVAL == 0) || defined(__DOXYGEN__)
   &mfs_test_002_003,
+#endif
   NULL
 };
 
@@ -38,6 +38,9 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_003_001
  * - @subpage oslib_test_003_002
+ * - @subpage oslib_test_003_003
+ * - @subpage oslib_test_003_004
+ * - @subpage oslib_test_003_005
  * .
  */
 
@@ -56,6 +59,43 @@ static PIPE_DECL(pipe1, buffer, PIPE_SIZE);
 
 static const uint8_t pipe_pattern[] = "0123456789ABCDEF";
 
+#define PIPE_BENCH_SIZE     256
+#define PIPE_BENCH_CHUNK    48
+
+static uint8_t bench_buffer[PIPE_BENCH_SIZE];
+
+static uint8_t bench_fill(uint8_t *p, size_t n, uint8_t seq) {
+
+  while (n > 0U) {
+    *p++ = seq++;
+    n--;
+  }
+
+  return seq;
+}
+
+static uint32_t bench_parse(const uint8_t *p, size_t n) {
+  uint32_t sum = 0U;
+
+  while (n > 0U) {
+    sum += *p++;
+    n--;
+  }
+
+  return sum;
+}
+
+static THD_WORKING_AREA(waWriter, 256);
+static THD_FUNCTION(Writer, arg) {
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0U; i < 4U; i++) {
+    (void) chPipeWriteTimeout(&pipe1, pipe_pattern, PIPE_SIZE, TIME_INFINITE);
+  }
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -356,6 +396,421 @@ static const testcase_t oslib_test_003_002 = {
   oslib_test_003_002_execute
 };
 
+/**
+ * @page oslib_test_003_003 [3.3] Pipes zero-copy API
+ *
+ * <h2>Description</h2>
+ * The reserve/commit and peek/consume functions are tested, the
+ * returned spans are checked when the data is contiguous and when it
+ * wraps across the buffer boundary.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] Reserving space into an empty pipe, the whole buffer is
+ *   returned as a single span. Ten bytes are written in place and
+ *   committed.
+ * - [3.3.2] Reserving more space than available, must fail.
+ * - [3.3.3] Peeking the data, the content is checked in place and eight
+ *   bytes are consumed.
+ * - [3.3.4] Reserving space wrapping the buffer boundary, two spans are
+ *   returned. The spans are filled and committed.
+ * - [3.3.5] Peeking data wrapping the buffer boundary, two spans are
+ *   returned. The content is checked in place and everything is
+ *   consumed.
+ * - [3.3.6] Peeking an empty pipe, must fail. Reserving and committing
+ *   nothing, the pipe state is unchanged.
+ * - [3.3.7] Resetting the pipe, reserve and peek must fail.
+ * .
+ */
+
+static void oslib_test_003_003_setup(void) {
+  chPipeObjectInit(&pipe1, buffer, PIPE_SIZE);
+}
+
+static void oslib_test_003_003_execute(void) {
+  size_t n;
+  pipe_span_t span;
+
+  /* [3.3.1] Reserving space into an empty pipe, the whole buffer is
+     returned as a single span. Ten bytes are written in place and
+     committed.*/
+  test_set_step(1);
+  {
+    n = chPipeReserveTimeout(&pipe1, 4, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert((span.p1 == pipe1.buffer) && (span.n1 == PIPE_SIZE) &&
+                (span.p2 == NULL) && (span.n2 == 0),
+                "wrong span");
+    memcpy(span.p1, pipe_pattern, 10);
+    chPipeCommit(&pipe1, 10);
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer + 10) &&
+                (pipe1.cnt == 10),
+                "invalid pipe state");
+  }
+  test_end_step(1);
+
+  /* [3.3.2] Reserving more space than available, must fail.*/
+  test_set_step(2);
+  {
+    n = chPipeReserveTimeout(&pipe1, PIPE_SIZE - 4, &span, TIME_IMMEDIATE);
+    test_assert(n == 0, "wrong size");
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer + 10) &&
+                (pipe1.cnt == 10),
+                "invalid pipe state");
+  }
+  test_end_step(2);
+
+  /* [3.3.3] Peeking the data, the content is checked in place and eight
+     bytes are consumed.*/
+  test_set_step(3);
+  {
+    n = chPipePeekTimeout(&pipe1, 4, &span, TIME_IMMEDIATE);
+    test_assert(n == 10, "wrong size");
+    test_assert((span.p1 == pipe1.buffer) && (span.n1 == 10) &&
+                (span.p2 == NULL) && (span.n2 == 0),
+                "wrong span");
+    test_assert(memcmp(pipe_pattern, span.p1, 10) == 0, "content mismatch");
+    chPipeConsume(&pipe1, 8);
+    test_assert((pipe1.rdptr == pipe1.buffer + 8) &&
+                (pipe1.wrptr == pipe1.buffer + 10) &&
+                (pipe1.cnt == 2),
+                "invalid pipe state");
+  }
+  test_end_step(3);
+
+  /* [3.3.4] Reserving space wrapping the buffer boundary, two spans are
+     returned. The spans are filled and committed.*/
+  test_set_step(4);
+  {
+    n = chPipeReserveTimeout(&pipe1, 12, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE - 2, "wrong size");
+    test_assert((span.p1 == pipe1.buffer + 10) && (span.n1 == 6) &&
+                (span.p2 == pipe1.buffer) && (span.n2 == 8),
+                "wrong spans");
+    memcpy(span.p1, pipe_pattern, span.n1);
+    memcpy(span.p2, pipe_pattern + span.n1, span.n2);
+    chPipeCommit(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer + 8) &&
+                (pipe1.wrptr == pipe1.buffer + 8) &&
+                (pipe1.cnt == PIPE_SIZE),
+                "invalid pipe state");
+  }
+  test_end_step(4);
+
+  /* [3.3.5] Peeking data wrapping the buffer boundary, two spans are
+     returned. The content is checked in place and everything is
+     consumed.*/
+  test_set_step(5);
+  {
+    n = chPipePeekTimeout(&pipe1, PIPE_SIZE, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert((span.p1 == pipe1.buffer + 8) && (span.n1 == 8) &&
+                (span.p2 == pipe1.buffer) && (span.n2 == 8),
+                "wrong spans");
+    test_assert(memcmp(pipe_pattern + 8, span.p1, 2) == 0, "content mismatch");
+    test_assert(memcmp(pipe_pattern, span.p1 + 2, 6) == 0, "content mismatch");
+    test_assert(memcmp(pipe_pattern + 6, span.p2, 8) == 0, "content mismatch");
+    chPipeConsume(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer + 8) &&
+                (pipe1.wrptr == pipe1.buffer + 8) &&
+                (pipe1.cnt == 0),
+                "invalid pipe state");
+  }
+  test_end_step(5);
+
+  /* [3.3.6] Peeking an empty pipe, must fail. Reserving and committing
+     nothing, the pipe state is unchanged.*/
+  test_set_step(6);
+  {
+    n = chPipePeekTimeout(&pipe1, 1, &span, TIME_IMMEDIATE);
+    test_assert(n == 0, "wrong size");
+    n = chPipeReserveTimeout(&pipe1, 1, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    chPipeCommit(&pipe1, 0);
+    test_assert((pipe1.rdptr == pipe1.buffer + 8) &&
+                (pipe1.wrptr == pipe1.buffer + 8) &&
+                (pipe1.cnt == 0),
+                "invalid pipe state");
+  }
+  test_end_step(6);
+
+  /* [3.3.7] Resetting the pipe, reserve and peek must fail.*/
+  test_set_step(7);
+  {
+    chPipeReset(&pipe1);
+    n = chPipeReserveTimeout(&pipe1, 1, &span, TIME_IMMEDIATE);
+    test_assert(n == 0, "not reset");
+    n = chPipePeekTimeout(&pipe1, 1, &span, TIME_IMMEDIATE);
+    test_assert(n == 0, "not reset");
+  }
+  test_end_step(7);
+}
+
+static const testcase_t oslib_test_003_003 = {
+  "Pipes zero-copy API",
+  oslib_test_003_003_setup,
+  NULL,
+  oslib_test_003_003_execute
+};
+
+/**
+ * @page oslib_test_003_004 [3.4] Pipes throughput
+ *
+ * <h2>Description</h2>
+ * Chunks of data are produced and parsed through a pipe using the
+ * copying API first and then the zero-copy API. The throughput is
+ * calculated by measuring the number of bytes transferred after a
+ * second of continuous operations.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.4.1] Chunks are formatted into a local buffer, written into the
+ *   pipe then read into another buffer and parsed. The operation is
+ *   repeated continuously in a one-second time window.
+ * - [3.4.2] Score is printed.
+ * - [3.4.3] Chunks are formatted directly into the pipe buffer then
+ *   parsed in place. The operation is repeated continuously in a
+ *   one-second time window.
+ * - [3.4.4] Score is printed.
+ * .
+ */
+
+static void oslib_test_003_004_setup(void) {
+  chPipeObjectInit(&pipe1, bench_buffer, PIPE_BENCH_SIZE);
+}
+
+static void oslib_test_003_004_execute(void) {
+  uint32_t n, sum;
+  uint8_t seq;
+  systime_t start, end;
+
+  /* [3.4.1] Chunks are formatted into a local buffer, written into the
+     pipe then read into another buffer and parsed. The operation is
+     repeated continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    uint8_t wrbuf[PIPE_BENCH_CHUNK];
+    uint8_t rdbuf[PIPE_BENCH_CHUNK];
+
+    n = 0;
+    sum = 0;
+    seq = 0;
+    chThdSleep(1);
+    start = chVTGetSystemTime();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      seq = bench_fill(wrbuf, PIPE_BENCH_CHUNK, seq);
+      (void) chPipeWriteTimeout(&pipe1, wrbuf, PIPE_BENCH_CHUNK, TIME_INFINITE);
+      (void) chPipeReadTimeout(&pipe1, rdbuf, PIPE_BENCH_CHUNK, TIME_INFINITE);
+      sum += bench_parse(rdbuf, PIPE_BENCH_CHUNK);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    (void)sum;
+  }
+  test_end_step(1);
+
+  /* [3.4.2] Score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n * PIPE_BENCH_CHUNK);
+    test_println(" bytes/S (copy)");
+  }
+  test_end_step(2);
+
+  /* [3.4.3] Chunks are formatted directly into the pipe buffer then
+     parsed in place. The operation is repeated continuously in a
+     one-second time window.*/
+  test_set_step(3);
+  {
+    pipe_span_t span;
+
+    n = 0;
+    sum = 0;
+    seq = 0;
+    chThdSleep(1);
+    start = chVTGetSystemTime();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void) chPipeReserveTimeout(&pipe1, PIPE_BENCH_CHUNK, &span, TIME_INFINITE);
+      if (span.n1 >= PIPE_BENCH_CHUNK) {
+        seq = bench_fill(span.p1, PIPE_BENCH_CHUNK, seq);
+      }
+      else {
+        seq = bench_fill(span.p1, span.n1, seq);
+        seq = bench_fill(span.p2, PIPE_BENCH_CHUNK - span.n1, seq);
+      }
+      chPipeCommit(&pipe1, PIPE_BENCH_CHUNK);
+      (void) chPipePeekTimeout(&pipe1, PIPE_BENCH_CHUNK, &span, TIME_INFINITE);
+      if (span.n1 >= PIPE_BENCH_CHUNK) {
+        sum += bench_parse(span.p1, PIPE_BENCH_CHUNK);
+      }
+      else {
+        sum += bench_parse(span.p1, span.n1);
+        sum += bench_parse(span.p2, PIPE_BENCH_CHUNK - span.n1);
+      }
+      chPipeConsume(&pipe1, PIPE_BENCH_CHUNK);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    (void)sum;
+  }
+  test_end_step(3);
+
+  /* [3.4.4] Score is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n * PIPE_BENCH_CHUNK);
+    test_println(" bytes/S (zero-copy)");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_003_004 = {
+  "Pipes throughput",
+  oslib_test_003_004_setup,
+  NULL,
+  oslib_test_003_004_execute
+};
+
+/**
+ * @page oslib_test_003_005 [3.5] Pipes SPSC mode
+ *
+ * <h2>Description</h2>
+ * The pipe is initialized in SPSC mode then the normal and zero-copy
+ * APIs are tested, a writer thread transfers data to the reader through
+ * the pipe.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.5.1] Filling whole pipe, a further write must fail.
+ * - [3.5.2] Small read then a write wrapping the buffer boundary, the
+ *   whole content is read back and checked.
+ * - [3.5.3] Reserving space, two spans are returned. The spans are
+ *   filled, committed and peeked back.
+ * - [3.5.4] Starting a writer thread at higher priority, the data is
+ *   read and checked while the writer waits for space.
+ * - [3.5.5] Resetting the pipe, read must fail.
+ * .
+ */
+
+static void oslib_test_003_005_setup(void) {
+  chPipeObjectInitSPSC(&pipe1, buffer, PIPE_SIZE);
+}
+
+static void oslib_test_003_005_execute(void) {
+  size_t n;
+  uint8_t buf[PIPE_SIZE * 4];
+
+  /* [3.5.1] Filling whole pipe, a further write must fail.*/
+  test_set_step(1);
+  {
+    n = chPipeWriteTimeout(&pipe1, pipe_pattern, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    n = chPipeWriteTimeout(&pipe1, pipe_pattern, 1, TIME_IMMEDIATE);
+    test_assert(n == 0, "not full");
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE),
+                "invalid pipe state");
+  }
+  test_end_step(1);
+
+  /* [3.5.2] Small read then a write wrapping the buffer boundary, the
+     whole content is read back and checked.*/
+  test_set_step(2);
+  {
+    n = chPipeReadTimeout(&pipe1, buf, 4, TIME_IMMEDIATE);
+    test_assert(n == 4, "wrong size");
+    test_assert(memcmp(pipe_pattern, buf, 4) == 0, "content mismatch");
+    n = chPipeWriteTimeout(&pipe1, pipe_pattern, 4, TIME_IMMEDIATE);
+    test_assert(n == 4, "wrong size");
+    n = chPipeReadTimeout(&pipe1, buf, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert(memcmp(pipe_pattern + 4, buf, PIPE_SIZE - 4) == 0, "content mismatch");
+    test_assert(memcmp(pipe_pattern, buf + PIPE_SIZE - 4, 4) == 0, "content mismatch");
+    test_assert((pipe1.rdptr == pipe1.buffer + 4) &&
+                (pipe1.wrptr == pipe1.buffer + 4) &&
+                (chPipeGetUsedCount(&pipe1) == 0),
+                "invalid pipe state");
+    n = chPipeReadTimeout(&pipe1, buf, 1, TIME_IMMEDIATE);
+    test_assert(n == 0, "not empty");
+  }
+  test_end_step(2);
+
+  /* [3.5.3] Reserving space, two spans are returned. The spans are
+     filled, committed and peeked back.*/
+  test_set_step(3);
+  {
+    pipe_span_t span;
+
+    n = chPipeReserveTimeout(&pipe1, 1, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert((span.p1 == pipe1.buffer + 4) && (span.n1 == PIPE_SIZE - 4) &&
+                (span.p2 == pipe1.buffer) && (span.n2 == 4),
+                "wrong spans");
+    memcpy(span.p1, pipe_pattern, span.n1);
+    memcpy(span.p2, pipe_pattern + span.n1, span.n2);
+    chPipeCommit(&pipe1, n);
+    n = chPipePeekTimeout(&pipe1, PIPE_SIZE, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert(memcmp(pipe_pattern, span.p1, span.n1) == 0, "content mismatch");
+    test_assert(memcmp(pipe_pattern + span.n1, span.p2, span.n2) == 0, "content mismatch");
+    chPipeConsume(&pipe1, n);
+    test_assert(chPipeGetUsedCount(&pipe1) == 0, "not empty");
+  }
+  test_end_step(3);
+
+  /* [3.5.4] Starting a writer thread at higher priority, the data is
+     read and checked while the writer waits for space.*/
+  test_set_step(4);
+  {
+    thread_t *tp;
+    unsigned i;
+
+    thread_descriptor_t td = {
+      .name  = "writer",
+      .wbase = waWriter,
+      .wend  = THD_WORKING_AREA_END(waWriter),
+      .prio  = chThdGetPriorityX() + 1,
+      .funcp = Writer,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+    test_assert(chPipeGetUsedCount(&pipe1) == PIPE_SIZE, "not full");
+    n = chPipeReadTimeout(&pipe1, buf, PIPE_SIZE * 4, TIME_MS2I(1000));
+    test_assert(n == PIPE_SIZE * 4, "wrong size");
+    for (i = 0U; i < 4U; i++) {
+      test_assert(memcmp(pipe_pattern, buf + (i * PIPE_SIZE), PIPE_SIZE) == 0,
+                  "content mismatch");
+    }
+    chThdWait(tp);
+  }
+  test_end_step(4);
+
+  /* [3.5.5] Resetting the pipe, read must fail.*/
+  test_set_step(5);
+  {
+    chPipeReset(&pipe1);
+    n = chPipeReadTimeout(&pipe1, buf, 1, TIME_IMMEDIATE);
+    test_assert(n == 0, "not reset");
+    test_assert(chPipeGetUsedCount(&pipe1) == 0, "not empty");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_003_005 = {
+  "Pipes SPSC mode",
+  oslib_test_003_005_setup,
+  NULL,
+  oslib_test_003_005_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -366,6 +821,9 @@ static const testcase_t oslib_test_003_002 = {
 const testcase_t * const oslib_test_sequence_003_array[] = {
   &oslib_test_003_001,
   &oslib_test_003_002,
+  &oslib_test_003_003,
+  &oslib_test_003_004,
+  &oslib_test_003_005,
   NULL
 };
 
@@ -37,6 +37,9 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_006_001
+ * - @subpage oslib_test_006_002
+ * - @subpage oslib_test_006_003
+ * - @subpage oslib_test_006_004
  * .
  */
 
@@ -88,6 +91,29 @@ static bool obj_write(objects_cache_t *ocp,
   return false;
 }
 
+static bool obj_write_batch(objects_cache_t *ocp,
+                            oc_object_t *objpp[],
+                            ucnt_t n) {
+  ucnt_t i;
+  (void)ocp;
+
+  test_emit_token('(');
+  for (i = 0; i < n; i++) {
+    test_emit_token('A' + objpp[i]->obj_key);
+  }
+  test_emit_token(')');
+
+  return false;
+}
+
+static void obj_dirty(uint32_t group, uint32_t key) {
+  oc_object_t *objp = chCacheGetObject(&cache1, group, key);
+
+  objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+  objp->obj_flags |= OC_FLAG_LAZYWRITE;
+  chCacheReleaseObject(&cache1, objp);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -243,6 +269,360 @@ static const testcase_t oslib_test_006_001 = {
   oslib_test_006_001_execute
 };
 
+/**
+ * @page oslib_test_006_002 [6.2] Cache statistics
+ *
+ * <h2>Description</h2>
+ * Objects are retrieved, released and invalidated, the hit, miss and
+ * eviction counters are checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.2.1] Checking initial statistics.
+ * - [6.2.2] Reading objects into the empty cache, misses are counted.
+ * - [6.2.3] Retrieving the same objects again, hits are counted.
+ * - [6.2.4] Reading objects from another group, cached objects are
+ *   evicted.
+ * - [6.2.5] Invalidating the cached objects then reading the first
+ *   group again, invalidated objects are not counted as evictions.
+ * .
+ */
+
+static void oslib_test_006_002_setup(void) {
+  chCacheObjectInit(&cache1,
+                    NUM_HASH_ENTRIES,
+                    hash_headers,
+                    NUM_OBJECTS,
+                    sizeof (cached_object_t),
+                    objects,
+                    obj_read,
+                    obj_write);
+}
+
+static void oslib_test_006_002_execute(void) {
+  const oc_stats_t *sp = chCacheGetStatsX(&cache1);
+  oc_object_t *objp;
+  uint32_t i;
+
+  /* [6.2.1] Checking initial statistics.*/
+  test_set_step(1);
+  {
+    test_assert(sp->n_hit == 0U, "wrong hits");
+    test_assert(sp->n_miss == 0U, "wrong misses");
+    test_assert(sp->n_evict == 0U, "wrong evictions");
+  }
+  test_end_step(1);
+
+  /* [6.2.2] Reading objects into the empty cache, misses are counted.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      objp = chCacheGetObject(&cache1, 0U, i);
+      (void) chCacheReadObject(&cache1, objp, false);
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert_sequence("abcd", "unexpected tokens");
+    test_assert(sp->n_hit == 0U, "wrong hits");
+    test_assert(sp->n_miss == NUM_OBJECTS, "wrong misses");
+    test_assert(sp->n_evict == 0U, "wrong evictions");
+  }
+  test_end_step(2);
+
+  /* [6.2.3] Retrieving the same objects again, hits are counted.*/
+  test_set_step(3);
+  {
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      objp = chCacheGetObject(&cache1, 0U, i);
+      test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U, "not in sync");
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert(sp->n_hit == NUM_OBJECTS, "wrong hits");
+    test_assert(sp->n_miss == NUM_OBJECTS, "wrong misses");
+    test_assert(sp->n_evict == 0U, "wrong evictions");
+  }
+  test_end_step(3);
+
+  /* [6.2.4] Reading objects from another group, cached objects are
+     evicted.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      objp = chCacheGetObject(&cache1, 1U, i);
+      (void) chCacheReadObject(&cache1, objp, false);
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert_sequence("abcd", "unexpected tokens");
+    test_assert(sp->n_miss == NUM_OBJECTS * 2, "wrong misses");
+    test_assert(sp->n_evict == NUM_OBJECTS, "wrong evictions");
+  }
+  test_end_step(4);
+
+  /* [6.2.5] Invalidating the cached objects then reading the first
+     group again, invalidated objects are not counted as evictions.*/
+  test_set_step(5);
+  {
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      objp = chCacheGetObject(&cache1, 1U, i);
+      objp->obj_flags |= OC_FLAG_NOTSYNC;
+      chCacheReleaseObject(&cache1, objp);
+    }
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      objp = chCacheGetObject(&cache1, 0U, i);
+      test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U, "in sync");
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert(sp->n_hit == NUM_OBJECTS * 2, "wrong hits");
+    test_assert(sp->n_miss == NUM_OBJECTS * 3, "wrong misses");
+    test_assert(sp->n_evict == NUM_OBJECTS, "wrong evictions");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_006_002 = {
+  "Cache statistics",
+  oslib_test_006_002_setup,
+  NULL,
+  oslib_test_006_002_execute
+};
+
+/**
+ * @page oslib_test_006_003 [6.3] Cache flush
+ *
+ * <h2>Description</h2>
+ * Objects are marked for lazy write then flushed by group and globally,
+ * objects with consecutive keys must be written in a single batch.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.3.1] Marking objects 2, 0, 1 of group 0 and object 3 of group 1
+ *   for lazy write.
+ * - [6.3.2] Flushing group 1, a single object is written.
+ * - [6.3.3] Flushing group 0, the objects are written in a single
+ *   batch.
+ * - [6.3.4] Flushing all groups, nothing is written.
+ * - [6.3.5] Removing the batch writer then flushing two consecutive
+ *   objects, the objects are written one by one.
+ * - [6.3.6] Making object 0 dirty then using objects 1, 2 and 3, after
+ *   flushing all groups object 0 must still be the least recently used.
+ * .
+ */
+
+static void oslib_test_006_003_setup(void) {
+  chCacheObjectInit(&cache1,
+                    NUM_HASH_ENTRIES,
+                    hash_headers,
+                    NUM_OBJECTS,
+                    sizeof (cached_object_t),
+                    objects,
+                    obj_read,
+                    obj_write);
+  chCacheSetBatchWriterX(&cache1, obj_write_batch);
+}
+
+static void oslib_test_006_003_execute(void) {
+  oc_object_t *objp;
+  bool error;
+
+  /* [6.3.1] Marking objects 2, 0, 1 of group 0 and object 3 of group 1
+     for lazy write.*/
+  test_set_step(1);
+  {
+    obj_dirty(0U, 2U);
+    obj_dirty(0U, 0U);
+    obj_dirty(0U, 1U);
+    obj_dirty(1U, 3U);
+
+    test_assert_sequence("", "unexpected tokens");
+    test_assert(cache1.dirtyn == 4U, "wrong dirty count");
+  }
+  test_end_step(1);
+
+  /* [6.3.2] Flushing group 1, a single object is written.*/
+  test_set_step(2);
+  {
+    error = chCacheFlushGroup(&cache1, 1U);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("D", "unexpected tokens");
+    test_assert(cache1.dirtyn == 3U, "wrong dirty count");
+  }
+  test_end_step(2);
+
+  /* [6.3.3] Flushing group 0, the objects are written in a single
+     batch.*/
+  test_set_step(3);
+  {
+    error = chCacheFlushGroup(&cache1, 0U);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("(ABC)", "unexpected tokens");
+    test_assert(cache1.dirtyn == 0U, "wrong dirty count");
+  }
+  test_end_step(3);
+
+  /* [6.3.4] Flushing all groups, nothing is written.*/
+  test_set_step(4);
+  {
+    error = chCacheFlushAll(&cache1);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(4);
+
+  /* [6.3.5] Removing the batch writer then flushing two consecutive
+     objects, the objects are written one by one.*/
+  test_set_step(5);
+  {
+    chCacheSetBatchWriterX(&cache1, NULL);
+    obj_dirty(0U, 0U);
+    obj_dirty(0U, 1U);
+    error = chCacheFlushAll(&cache1);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("AB", "unexpected tokens");
+
+    objp = chCacheGetObject(&cache1, 0U, 0U);
+    test_assert((objp->obj_flags & OC_FLAG_LAZYWRITE) == 0U, "still dirty");
+    chCacheReleaseObject(&cache1, objp);
+  }
+  test_end_step(5);
+
+  /* [6.3.6] Making object 0 dirty then using objects 1, 2 and 3, after
+     flushing all groups object 0 must still be the least recently used.*/
+  test_set_step(6);
+  {
+    unsigned i;
+
+    obj_dirty(0U, 0U);
+    for (i = 1U; i < 4U; i++) {
+      objp = chCacheGetObject(&cache1, 0U, i);
+      objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+      chCacheReleaseObject(&cache1, objp);
+    }
+    error = chCacheFlushAll(&cache1);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("A", "unexpected tokens");
+    test_assert(cache1.lru.lru_prev->obj_key == 0U, "LRU order changed");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_006_003 = {
+  "Cache flush",
+  oslib_test_006_003_setup,
+  NULL,
+  oslib_test_006_003_execute
+};
+
+#if (CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_006_004 [6.4] Write-back flusher
+ *
+ * <h2>Description</h2>
+ * The allocation path is checked to skip dirty objects, then the
+ * flusher function is invoked without waiting.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [6.4.1] Setting the watermarks and marking objects 0 and 1 for lazy
+ *   write, the flusher is not triggered.
+ * - [6.4.2] Reading objects 2 and 3, the dirty objects are now on the
+ *   LRU tail.
+ * - [6.4.3] Getting a new object, a clean object is reused without
+ *   writes.
+ * - [6.4.4] Marking object 3 for lazy write, the high watermark is
+ *   exceeded and all dirty objects are written.
+ * .
+ */
+
+static void oslib_test_006_004_setup(void) {
+  chCacheObjectInit(&cache1,
+                    NUM_HASH_ENTRIES,
+                    hash_headers,
+                    NUM_OBJECTS,
+                    sizeof (cached_object_t),
+                    objects,
+                    obj_read,
+                    obj_write);
+  chCacheSetBatchWriterX(&cache1, obj_write_batch);
+}
+
+static void oslib_test_006_004_execute(void) {
+  oc_object_t *objp;
+  msg_t msg;
+
+  /* [6.4.1] Setting the watermarks and marking objects 0 and 1 for lazy
+     write, the flusher is not triggered.*/
+  test_set_step(1);
+  {
+    chCacheSetWatermarks(&cache1, 2U, 0U);
+    obj_dirty(0U, 0U);
+    obj_dirty(0U, 1U);
+    msg = chCacheFlusherDispatchTimeout(&cache1, TIME_IMMEDIATE);
+
+    test_assert(msg == MSG_TIMEOUT, "wrong message");
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(1);
+
+  /* [6.4.2] Reading objects 2 and 3, the dirty objects are now on the
+     LRU tail.*/
+  test_set_step(2);
+  {
+    objp = chCacheGetObject(&cache1, 0U, 2U);
+    (void) chCacheReadObject(&cache1, objp, false);
+    chCacheReleaseObject(&cache1, objp);
+    objp = chCacheGetObject(&cache1, 0U, 3U);
+    (void) chCacheReadObject(&cache1, objp, false);
+    chCacheReleaseObject(&cache1, objp);
+
+    test_assert_sequence("cd", "unexpected tokens");
+  }
+  test_end_step(2);
+
+  /* [6.4.3] Getting a new object, a clean object is reused without
+     writes.*/
+  test_set_step(3);
+  {
+    objp = chCacheGetObject(&cache1, 0U, 4U);
+    chCacheReleaseObject(&cache1, objp);
+
+    test_assert_sequence("", "unexpected tokens");
+    test_assert(cache1.dirtyn == 2U, "wrong dirty count");
+  }
+  test_end_step(3);
+
+  /* [6.4.4] Marking object 3 for lazy write, the high watermark is
+     exceeded and all dirty objects are written.*/
+  test_set_step(4);
+  {
+    obj_dirty(0U, 3U);
+    msg = chCacheFlusherDispatchTimeout(&cache1, TIME_IMMEDIATE);
+
+    test_assert(msg == MSG_OK, "wrong message");
+    test_assert_sequence("(AB)D", "unexpected tokens");
+    test_assert(cache1.dirtyn == 0U, "wrong dirty count");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_006_004 = {
+  "Write-back flusher",
+  oslib_test_006_004_setup,
+  NULL,
+  oslib_test_006_004_execute
+};
+#endif /* CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -252,6 +632,11 @@ static const testcase_t oslib_test_006_001 = {
  */
 const testcase_t * const oslib_test_sequence_006_array[] = {
   &oslib_test_006_001,
+  &oslib_test_006_002,
+  &oslib_test_006_003,
+#if (CH_CFG_OBJ_CACHES_USE_FLUSHER == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_006_004,
+#endif
   NULL
 };
 
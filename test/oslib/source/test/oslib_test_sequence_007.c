@@ -39,6 +39,7 @@
  * - @subpage oslib_test_007_001
  * - @subpage oslib_test_007_002
  * - @subpage oslib_test_007_003
+ * - @subpage oslib_test_007_004
  * .
  */
 
@@ -57,6 +58,13 @@ static MEMORYPOOL_DECL(mp1, sizeof (uint32_t), PORT_NATURAL_ALIGN, NULL);
 static GUARDEDMEMORYPOOL_DECL(gmp1, sizeof (uint32_t), PORT_NATURAL_ALIGN);
 #endif
 
+#if CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE
+#define MAGAZINE_POOL_SIZE 8
+
+static void *mag_objects[MAGAZINE_POOL_SIZE];
+static pool_magazine_t mag1;
+#endif
+
 static void *null_provider(size_t size, unsigned align) {
 
   (void)size;
@@ -288,6 +296,119 @@ static const testcase_t oslib_test_007_003 = {
 };
 #endif /* CH_CFG_USE_SEMAPHORES */
 
+#if (CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_007_004 [7.4] Memory pool magazines
+ *
+ * <h2>Description</h2>
+ * A magazine is placed in front of a memory pool, objects are allocated
+ * and released through the magazine. The batch exchanges with the pool
+ * and the statistics are checked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.4.1] Adding the objects to the pool using chPoolLoadArray(), the
+ *   magazine must be empty.
+ * - [7.4.2] Allocating two objects, the first allocation refills the
+ *   magazine with a batch, the second is served by the magazine.
+ * - [7.4.3] Emptying the pool through the magazine, then the allocation
+ *   must fail.
+ * - [7.4.4] Releasing all the objects through the magazine, when the
+ *   magazine is full a batch is returned to the pool.
+ * - [7.4.5] Flushing the magazine, all the objects must be back in the
+ *   pool.
+ * .
+ */
+
+static void oslib_test_007_004_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (void *), NULL);
+  chPoolMagazineObjectInit(&mag1, &mp1, 4U, 2U);
+}
+
+static void oslib_test_007_004_execute(void) {
+  const pool_magazine_stats_t *sp = chPoolMagazineGetStatsX(&mag1);
+  void *objs[MAGAZINE_POOL_SIZE];
+  unsigned i;
+
+  /* [7.4.1] Adding the objects to the pool using chPoolLoadArray(), the
+     magazine must be empty.*/
+  test_set_step(1);
+  {
+    chPoolLoadArray(&mp1, mag_objects, MAGAZINE_POOL_SIZE);
+    test_assert(chPoolMagazineGetCountX(&mag1) == 0U, "not empty");
+  }
+  test_end_step(1);
+
+  /* [7.4.2] Allocating two objects, the first allocation refills the
+     magazine with a batch, the second is served by the magazine.*/
+  test_set_step(2);
+  {
+    objs[0] = chPoolMagazineAlloc(&mag1);
+    objs[1] = chPoolMagazineAlloc(&mag1);
+    test_assert((objs[0] != NULL) && (objs[1] != NULL), "allocation failed");
+    test_assert(sp->n_refill == 1U, "wrong refills");
+    test_assert(sp->n_alloc == 2U, "wrong allocations");
+    test_assert(sp->n_alloc_hit == 1U, "wrong hits");
+    test_assert(chPoolMagazineGetCountX(&mag1) == 0U, "not empty");
+  }
+  test_end_step(2);
+
+  /* [7.4.3] Emptying the pool through the magazine, then the allocation
+     must fail.*/
+  test_set_step(3);
+  {
+    for (i = 2U; i < MAGAZINE_POOL_SIZE; i++) {
+      objs[i] = chPoolMagazineAlloc(&mag1);
+      test_assert(objs[i] != NULL, "allocation failed");
+    }
+    test_assert(chPoolMagazineAlloc(&mag1) == NULL, "allocation not failed");
+    test_assert(chPoolAlloc(&mp1) == NULL, "pool not empty");
+    test_assert(sp->n_refill == MAGAZINE_POOL_SIZE / 2U, "wrong refills");
+    test_assert(sp->n_alloc_hit == MAGAZINE_POOL_SIZE / 2U, "wrong hits");
+  }
+  test_end_step(3);
+
+  /* [7.4.4] Releasing all the objects through the magazine, when the
+     magazine is full a batch is returned to the pool.*/
+  test_set_step(4);
+  {
+    for (i = 0U; i < MAGAZINE_POOL_SIZE; i++) {
+      chPoolMagazineFree(&mag1, objs[i]);
+    }
+    test_assert(chPoolMagazineGetCountX(&mag1) == 4U, "wrong count");
+    test_assert(sp->n_free == MAGAZINE_POOL_SIZE, "wrong releases");
+    test_assert(sp->n_drain == 2U, "wrong drains");
+    test_assert(sp->n_free_hit == MAGAZINE_POOL_SIZE - 2U, "wrong hits");
+  }
+  test_end_step(4);
+
+  /* [7.4.5] Flushing the magazine, all the objects must be back in the
+     pool.*/
+  test_set_step(5);
+  {
+    chPoolMagazineFlush(&mag1);
+    test_assert(chPoolMagazineGetCountX(&mag1) == 0U, "not empty");
+    for (i = 0U; i < MAGAZINE_POOL_SIZE; i++) {
+      test_assert(chPoolAlloc(&mp1) != NULL, "list empty");
+    }
+    test_assert(chPoolAlloc(&mp1) == NULL, "list not empty");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_007_004 = {
+  "Memory pool magazines",
+  oslib_test_007_004_setup,
+  NULL,
+  oslib_test_007_004_execute
+};
+#endif /* CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -302,6 +423,9 @@ const testcase_t * const oslib_test_sequence_007_array[] = {
 #endif
 #if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
   &oslib_test_007_003,
+#endif
+#if (CH_CFG_MEMPOOLS_USE_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_007_004,
 #endif
   NULL
 };
@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_008_001
  * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
  * .
  */
 
@@ -53,6 +54,11 @@
 static memory_heap_t test_heap;
 static uint8_t test_heap_buffer[HEAP_SIZE];
 
+#if CH_CFG_HEAP_USE_TLSF == TRUE
+static memory_heap_t test_tlsf_heap;
+static CH_HEAP_AREA(test_tlsf_buffer, sizeof (heap_tlsf_t) + (ALLOC_SIZE * 32));
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -268,6 +274,200 @@ static const testcase_t oslib_test_008_002 = {
   oslib_test_008_002_execute
 };
 
+#if (CH_CFG_HEAP_USE_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_008_003 [8.3] TLSF allocation and fragmentation
+ *
+ * <h2>Description</h2>
+ * The same kind of allocation sequences is performed on a heap using
+ * the TLSF engine. The released blocks must always be merged with the
+ * free neighbors and reused, the heap must return to its initial status
+ * after each sequence.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_HEAP_USE_TLSF == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Testing initial conditions, the heap must not be fragmented
+ *   and one free block present.
+ * - [8.3.2] Trying to allocate an block bigger than available space, an
+ *   error is expected.
+ * - [8.3.3] Allocating then freeing in the same order.
+ * - [8.3.4] Allocating then freeing in reverse order.
+ * - [8.3.5] Interleaved release, the released blocks cannot be merged
+ *   until their neighbors are released too.
+ * - [8.3.6] Reusing a released block, a block of the same size must be
+ *   allocated in the same position.
+ * - [8.3.7] Aligned allocation, the leading space must be returned to
+ *   the heap.
+ * - [8.3.8] Allocating the whole available space.
+ * - [8.3.9] Testing final conditions. The heap geometry must be the
+ *   same than the one registered at beginning.
+ * - [8.3.10] Exhausting the heap with a provider, the allocation must
+ *   succeed and the block must join the heap when released.
+ * .
+ */
+
+static void oslib_test_008_003_execute(void) {
+  void *p1, *p2, *p3;
+  size_t n, sz;
+
+  /* [8.3.1] Testing initial conditions, the heap must not be fragmented
+     and one free block present.*/
+  test_set_step(1);
+  {
+    chHeapObjectInitTLSF(&test_tlsf_heap, test_tlsf_buffer,
+                         sizeof(test_tlsf_buffer), NULL);
+    test_assert(chHeapStatus(&test_tlsf_heap, &sz, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(1);
+
+  /* [8.3.2] Trying to allocate an block bigger than available space, an
+     error is expected.*/
+  test_set_step(2);
+  {
+    p1 = chHeapAlloc(&test_tlsf_heap, sizeof test_tlsf_buffer);
+    test_assert(p1 == NULL, "allocation not failed");
+  }
+  test_end_step(2);
+
+  /* [8.3.3] Allocating then freeing in the same order.*/
+  test_set_step(3);
+  {
+    p1 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    p2 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    p3 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    test_assert((p1 != NULL) && (p2 != NULL) && (p3 != NULL), "allocation failed");
+    test_assert(chHeapGetSize(p2) == ALLOC_SIZE, "wrong size");
+    chHeapFree(p1);                                 /* Does not merge.*/
+    chHeapFree(p2);                                 /* Merges backward.*/
+    chHeapFree(p3);                                 /* Merges both sides.*/
+    test_assert(chHeapStatus(&test_tlsf_heap, &n, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(3);
+
+  /* [8.3.4] Allocating then freeing in reverse order.*/
+  test_set_step(4);
+  {
+    p1 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    p2 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    p3 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    chHeapFree(p3);                                 /* Merges forward.*/
+    chHeapFree(p2);                                 /* Merges forward.*/
+    chHeapFree(p1);                                 /* Merges forward.*/
+    test_assert(chHeapStatus(&test_tlsf_heap, &n, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(4);
+
+  /* [8.3.5] Interleaved release, the released blocks cannot be merged
+     until their neighbors are released too.*/
+  test_set_step(5);
+  {
+    void *pa[8];
+    unsigned i;
+
+    for (i = 0; i < 8; i++) {
+      pa[i] = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+      test_assert(pa[i] != NULL, "allocation failed");
+    }
+    for (i = 0; i < 8; i += 2) {
+      chHeapFree(pa[i]);
+    }
+    test_assert(chHeapStatus(&test_tlsf_heap, &n, NULL) == 5, "invalid state");
+    for (i = 1; i < 8; i += 2) {
+      chHeapFree(pa[i]);
+    }
+    test_assert(chHeapStatus(&test_tlsf_heap, &n, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(5);
+
+  /* [8.3.6] Reusing a released block, a block of the same size must be
+     allocated in the same position.*/
+  test_set_step(6);
+  {
+    p1 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    p2 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    p3 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    chHeapFree(p2);
+    test_assert(chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE) == p2, "not reused");
+    chHeapFree(p1);
+    chHeapFree(p2);
+    chHeapFree(p3);
+    test_assert(chHeapStatus(&test_tlsf_heap, &n, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(6);
+
+  /* [8.3.7] Aligned allocation, the leading space must be returned to
+     the heap.*/
+  test_set_step(7);
+  {
+    p1 = chHeapAllocAligned(&test_tlsf_heap, ALLOC_SIZE, 64U);
+    test_assert(p1 != NULL, "allocation failed");
+    test_assert(MEM_IS_ALIGNED(p1, 64U), "not aligned");
+    p2 = chHeapAllocAligned(&test_tlsf_heap, ALLOC_SIZE, 128U);
+    test_assert(p2 != NULL, "allocation failed");
+    test_assert(MEM_IS_ALIGNED(p2, 128U), "not aligned");
+    chHeapFree(p1);
+    chHeapFree(p2);
+    test_assert(chHeapStatus(&test_tlsf_heap, &n, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(7);
+
+  /* [8.3.8] Allocating the whole available space.*/
+  test_set_step(8);
+  {
+    (void)chHeapStatus(&test_tlsf_heap, &n, NULL);
+    p1 = chHeapAlloc(&test_tlsf_heap, n);
+    test_assert(p1 != NULL, "allocation failed");
+    test_assert(chHeapStatus(&test_tlsf_heap, NULL, NULL) == 0, "not empty");
+    chHeapFree(p1);
+  }
+  test_end_step(8);
+
+  /* [8.3.9] Testing final conditions. The heap geometry must be the
+     same than the one registered at beginning.*/
+  test_set_step(9);
+  {
+    test_assert(chHeapStatus(&test_tlsf_heap, &n, NULL) == 1, "heap fragmented");
+    test_assert(n == sz, "size changed");
+  }
+  test_end_step(9);
+
+  /* [8.3.10] Exhausting the heap with a provider, the allocation must
+     succeed and the block must join the heap when released.*/
+  test_set_step(10);
+  {
+    chHeapObjectInitTLSF(&test_tlsf_heap, test_tlsf_buffer,
+                         sizeof(test_tlsf_buffer), chCoreAllocAlignedWithOffset);
+    p1 = chHeapAlloc(&test_tlsf_heap, sz);
+    test_assert(p1 != NULL, "allocation failed");
+    test_assert(chHeapStatus(&test_tlsf_heap, NULL, NULL) == 0, "not empty");
+    p2 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    test_assert(p2 != NULL, "allocation failed");
+    chHeapFree(p2);
+    test_assert(chHeapStatus(&test_tlsf_heap, &n, NULL) == 1, "block not released");
+    test_assert(n >= ALLOC_SIZE, "wrong size");
+    p3 = chHeapAlloc(&test_tlsf_heap, ALLOC_SIZE);
+    test_assert(p3 == p2, "not reused");
+    chHeapFree(p3);
+    chHeapFree(p1);
+    test_assert(chHeapStatus(&test_tlsf_heap, &n, NULL) == 2, "invalid state");
+    test_assert(n >= sz + ALLOC_SIZE, "wrong size");
+  }
+  test_end_step(10);
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "TLSF allocation and fragmentation",
+  NULL,
+  NULL,
+  oslib_test_008_003_execute
+};
+#endif /* CH_CFG_HEAP_USE_TLSF == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -278,6 +478,9 @@ static const testcase_t oslib_test_008_002 = {
 const testcase_t * const oslib_test_sequence_008_array[] = {
   &oslib_test_008_001,
   &oslib_test_008_002,
+#if (CH_CFG_HEAP_USE_TLSF == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_008_003,
+#endif
   NULL
 };
 
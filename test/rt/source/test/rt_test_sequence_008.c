@@ -45,6 +45,8 @@
  * - @subpage rt_test_008_007
  * - @subpage rt_test_008_008
  * - @subpage rt_test_008_009
+ * - @subpage rt_test_008_010
+ * - @subpage rt_test_008_011
  * .
  */
 
@@ -226,6 +228,62 @@ static THD_FUNCTION(thread9, p) {
   test_emit_token(*(char *)p);
   chMtxUnlock(&m2);
 }
+
+#if CH_CFG_USE_CONDVARS_TIMEOUT || defined(__DOXYGEN__)
+static THD_FUNCTION(thread10, p) {
+
+  /* Timing out, the mutex is not taken again.*/
+  chMtxLock(&m1);
+  if ((chCondWaitTimeout(&c1, TIME_MS2I(10)) == MSG_TIMEOUT) &&
+      (chMtxGetNextMutexX() == NULL)) {
+    test_emit_token(*(char *)p);
+  }
+
+  /* Waiting again without timeout.*/
+  chMtxLock(&m1);
+  if ((chCondWait(&c1) == MSG_RESET) && (chMtxGetNextMutexX() == &m1)) {
+    test_emit_token(*(char *)p);
+  }
+  chMtxUnlock(&m1);
+}
+
+static THD_FUNCTION(thread11, p) {
+
+  chMtxLock(&m1);
+  if ((chCondWaitTimeout(&c1, TIME_MS2I(1000)) == MSG_RESET) &&
+      (chMtxGetNextMutexX() == &m1)) {
+    test_emit_token(*(char *)p);
+  }
+  chMtxUnlock(&m1);
+}
+#endif
+
+#if CH_CFG_USE_CONDVARS_REQUEUE || defined(__DOXYGEN__)
+/* Checks that the first n threads are waiting on the mutex in
+   decreasing priority order.*/
+static bool mutex_queue_check(mutex_t *mp, unsigned n) {
+  thread_t *tp;
+  bool b = true;
+
+  chSysLock();
+  tp = (thread_t *)mp->queue.next;
+  while (n > 0U) {
+    n--;
+    if ((tp != threads[n]) || (tp->state != CH_STATE_WTMTX) ||
+        (tp->u.wtmtxp != mp)) {
+      b = false;
+      break;
+    }
+    tp = (thread_t *)tp->hdr.queue.next;
+  }
+  if (tp != (thread_t *)&mp->queue) {
+    b = false;
+  }
+  chSysUnlock();
+
+  return b;
+}
+#endif
 #endif /* CH_CFG_USE_CONDVARS */
 
 /****************************************************************************
@@ -1078,6 +1136,214 @@ static const testcase_t rt_test_008_009 = {
 };
 #endif /* CH_CFG_USE_CONDVARS */
 
+#if (CH_CFG_USE_CONDVARS && CH_CFG_USE_CONDVARS_REQUEUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_010 [8.10] Condition Variable broadcast requeue test
+ *
+ * <h2>Description</h2>
+ * Five threads take a mutex and then enter a conditional variable
+ * queue, the tester thread, at higher priority, locks the mutex and
+ * broadcasts the conditional variable.<br> The test expects the threads
+ * to be moved on the mutex queue in priority order and the mutex to be
+ * passed to one thread at time when unlocked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_CONDVARS && CH_CFG_USE_CONDVARS_REQUEUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.10.1] Getting the initial priority then starting the five
+ *   threads with increasing priority, the threads will queue on the
+ *   condition variable.
+ * - [8.10.2] Raising the priority above the threads, locking the mutex
+ *   and broadcasting on the condition variable, the threads are moved
+ *   on the mutex queue in priority order without being made ready.
+ * - [8.10.3] Unlocking the mutex, the mutex is assigned to the highest
+ *   priority thread that is made ready, the other threads are still
+ *   waiting on the mutex.
+ * - [8.10.4] Restoring the initial priority then waiting for the
+ *   threads to terminate in priority order, the order and the previous
+ *   states are tested.
+ * .
+ */
+
+static void rt_test_008_010_setup(void) {
+  chCondObjectInit(&c1);
+  chMtxObjectInit(&m1);
+}
+
+static void rt_test_008_010_execute(void) {
+  tprio_t prio;
+  bool requeued, handed;
+
+  /* [8.10.1] Getting the initial priority then starting the five
+     threads with increasing priority, the threads will queue on the
+     condition variable.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread6, "E");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+2, thread6, "D");
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+3, thread6, "C");
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, prio+4, thread6, "B");
+    threads[4] = chThdCreateStatic(wa[4], WA_SIZE, prio+5, thread6, "A");
+  }
+  test_end_step(1);
+
+  /* [8.10.2] Raising the priority above the threads, locking the mutex
+     and broadcasting on the condition variable, the threads are moved
+     on the mutex queue in priority order without being made ready.*/
+  test_set_step(2);
+  {
+    chThdSetPriority(prio+6);
+    chMtxLock(&m1);
+    chCondBroadcast(&c1);
+    requeued = mutex_queue_check(&m1, 5U);
+  }
+  test_end_step(2);
+
+  /* [8.10.3] Unlocking the mutex, the mutex is assigned to the highest
+     priority thread that is made ready, the other threads are still
+     waiting on the mutex.*/
+  test_set_step(3);
+  {
+    chMtxUnlock(&m1);
+    handed = (m1.owner == threads[4]) &&
+             (threads[4]->state == CH_STATE_READY) &&
+             mutex_queue_check(&m1, 4U);
+  }
+  test_end_step(3);
+
+  /* [8.10.4] Restoring the initial priority then waiting for the
+     threads to terminate in priority order, the order and the previous
+     states are tested.*/
+  test_set_step(4);
+  {
+    chThdSetPriority(prio);
+    test_wait_threads();
+    test_assert(requeued, "not requeued in priority order");
+    test_assert(handed, "not woken one at time");
+    test_assert_sequence("ABCDE", "invalid sequence");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_008_010 = {
+  "Condition Variable broadcast requeue test",
+  rt_test_008_010_setup,
+  NULL,
+  rt_test_008_010_execute
+};
+#endif /* CH_CFG_USE_CONDVARS && CH_CFG_USE_CONDVARS_REQUEUE */
+
+#if (CH_CFG_USE_CONDVARS && CH_CFG_USE_CONDVARS_TIMEOUT) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_011 [8.11] Condition Variable timed wait and broadcast test
+ *
+ * <h2>Description</h2>
+ * A thread times out on a conditional variable then waits again without
+ * timeout, two more threads enter the conditional variable queue, one
+ * of them with a timeout, the tester thread then broadcasts the
+ * conditional variable.<br> The test expects the timed out thread to
+ * return without the mutex, the thread waiting with a timeout to be
+ * made ready and all threads to reach their goal in priority order.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_CONDVARS && CH_CFG_USE_CONDVARS_TIMEOUT
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.11.1] Getting the initial priority then starting a thread that
+ *   times out on the condition variable and then waits again without
+ *   timeout.
+ * - [8.11.2] Starting a thread waiting without timeout and a thread
+ *   waiting with a long timeout on the condition variable.
+ * - [8.11.3] Raising the priority above the threads, locking the mutex
+ *   and broadcasting on the condition variable. The thread waiting with
+ *   a timeout is made ready, if requeuing is enabled then the other
+ *   threads are moved on the mutex queue.
+ * - [8.11.4] Waiting for the threads to terminate in priority order,
+ *   the order and the states after the broadcast are tested.
+ * .
+ */
+
+static void rt_test_008_011_setup(void) {
+  chCondObjectInit(&c1);
+  chMtxObjectInit(&m1);
+}
+
+static void rt_test_008_011_execute(void) {
+  tprio_t prio;
+  bool states;
+
+  /* [8.11.1] Getting the initial priority then starting a thread that
+     times out on the condition variable and then waits again without
+     timeout.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+2, thread10, "B");
+    chThdSleepMilliseconds(50);
+    test_assert_sequence("B", "not timed out");
+    test_assert(threads[0]->state == CH_STATE_WTCOND, "not waiting");
+  }
+  test_end_step(1);
+
+  /* [8.11.2] Starting a thread waiting without timeout and a thread
+     waiting with a long timeout on the condition variable.*/
+  test_set_step(2);
+  {
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+3, thread6, "A");
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+1, thread11, "C");
+  }
+  test_end_step(2);
+
+  /* [8.11.3] Raising the priority above the threads, locking the mutex
+     and broadcasting on the condition variable. The thread waiting with
+     a timeout is made ready, if requeuing is enabled then the other
+     threads are moved on the mutex queue.*/
+  test_set_step(3);
+  {
+    chThdSetPriority(prio+4);
+    chMtxLock(&m1);
+    chCondBroadcast(&c1);
+#if CH_CFG_USE_CONDVARS_REQUEUE
+    states = (threads[0]->state == CH_STATE_WTMTX) &&
+             (threads[1]->state == CH_STATE_WTMTX) &&
+             (threads[2]->state == CH_STATE_READY);
+#else
+    states = (threads[0]->state == CH_STATE_READY) &&
+             (threads[1]->state == CH_STATE_READY) &&
+             (threads[2]->state == CH_STATE_READY);
+#endif
+    chMtxUnlock(&m1);
+    chThdSetPriority(prio);
+  }
+  test_end_step(3);
+
+  /* [8.11.4] Waiting for the threads to terminate in priority order,
+     the order and the states after the broadcast are tested.*/
+  test_set_step(4);
+  {
+    test_wait_threads();
+    test_assert(states, "invalid threads state");
+    test_assert_sequence("ABC", "invalid sequence");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_008_011 = {
+  "Condition Variable timed wait and broadcast test",
+  rt_test_008_011_setup,
+  NULL,
+  rt_test_008_011_execute
+};
+#endif /* CH_CFG_USE_CONDVARS && CH_CFG_USE_CONDVARS_TIMEOUT */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1108,6 +1374,12 @@ const testcase_t * const rt_test_sequence_008_array[] = {
 #endif
 #if (CH_CFG_USE_CONDVARS) || defined(__DOXYGEN__)
   &rt_test_008_009,
+#endif
+#if (CH_CFG_USE_CONDVARS && CH_CFG_USE_CONDVARS_REQUEUE) || defined(__DOXYGEN__)
+  &rt_test_008_010,
+#endif
+#if (CH_CFG_USE_CONDVARS && CH_CFG_USE_CONDVARS_TIMEOUT) || defined(__DOXYGEN__)
+  &rt_test_008_011,
 #endif
   NULL
 };
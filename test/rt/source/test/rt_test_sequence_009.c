@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage rt_test_009_001
+ * - @subpage rt_test_009_002
  * .
  */
 
@@ -54,6 +55,20 @@ static THD_FUNCTION(msg_thread1, p) {
   chMsgSend(p, 'D');
 }
 
+static uint8_t msg_payload[] = "ABCDEF";
+
+static THD_FUNCTION(msg_thread2, p) {
+  const msg_segment_t segs[4] = {
+    {&msg_payload[0], 2U},
+    {NULL,            0U},
+    {&msg_payload[2], 3U},
+    {&msg_payload[5], 1U}
+  };
+
+  (void) chMsgSendBuffer(p, segs, 4U);
+  (void) chMsgSendBuffer(p, segs, 4U);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -109,6 +124,84 @@ static const testcase_t rt_test_009_001 = {
   rt_test_009_001_execute
 };
 
+/**
+ * @page rt_test_009_002 [9.2] Messages buffer transfer
+ *
+ * <h2>Description</h2>
+ * A messenger thread is spawned that sends two buffer messages back to
+ * the tester thread, the payload is scattered over several segments
+ * including an empty one.<br> The test expects the payload to be
+ * gathered in the tester segments and the copy to be bounded by the
+ * size of the destination segments.
+ *
+ * <h2>Test Steps</h2>
+ * - [9.2.1] Starting the messenger thread.
+ * - [9.2.2] Receiving the first message into two segments, the whole
+ *   payload is expected.
+ * - [9.2.3] Receiving the second message into a smaller segment, the
+ *   copy is expected to be truncated.
+ * .
+ */
+
+static void rt_test_009_002_execute(void) {
+  thread_t *tp;
+  uint8_t buf[12];
+  size_t i, n;
+
+  /* [9.2.1] Starting the messenger thread.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   msg_thread2, chThdGetSelfX());
+  }
+  test_end_step(1);
+
+  /* [9.2.2] Receiving the first message into two segments, the whole
+     payload is expected.*/
+  test_set_step(2);
+  {
+    const msg_segment_t segs[2] = {
+      {&buf[0], 4U},
+      {&buf[4], 8U}
+    };
+
+    tp = chMsgWait();
+    test_assert(chMsgIsBuffer(tp), "not a buffer message");
+    n = chMsgReceiveBuffer(tp, segs, 2U);
+    chMsgRelease(tp, (msg_t)n);
+    test_assert(n == 6U, "wrong size");
+    for (i = 0U; i < n; i++) {
+      test_emit_token((char)buf[i]);
+    }
+  }
+  test_end_step(2);
+
+  /* [9.2.3] Receiving the second message into a smaller segment, the
+     copy is expected to be truncated.*/
+  test_set_step(3);
+  {
+    const msg_segment_t seg = {&buf[0], 4U};
+
+    tp = chMsgWait();
+    n = chMsgReceiveBuffer(tp, &seg, 1U);
+    chMsgRelease(tp, (msg_t)n);
+    test_assert(n == 4U, "wrong size");
+    for (i = 0U; i < n; i++) {
+      test_emit_token((char)buf[i]);
+    }
+    test_wait_threads();
+    test_assert_sequence("ABCDEFABCD", "invalid sequence");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_009_002 = {
+  "Messages buffer transfer",
+  NULL,
+  NULL,
+  rt_test_009_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -118,6 +211,7 @@ static const testcase_t rt_test_009_001 = {
  */
 const testcase_t * const rt_test_sequence_009_array[] = {
   &rt_test_009_001,
+  &rt_test_009_002,
   NULL
 };
 
@@ -46,6 +46,10 @@
  * - @subpage rt_test_012_010
  * - @subpage rt_test_012_011
  * - @subpage rt_test_012_012
+ * - @subpage rt_test_012_013
+ * - @subpage rt_test_012_014
+ * - @subpage rt_test_012_015
+ * - @subpage rt_test_012_016
  * .
  */
 
@@ -134,6 +138,53 @@ static THD_FUNCTION(bmk_thread8, p) {
   } while(!chThdShouldTerminateX());
 }
 
+#if CH_CFG_USE_CONDVARS || defined(__DOXYGEN__)
+static condition_variable_t c1;
+
+static THD_FUNCTION(bmk_thread9, p) {
+
+  (void)p;
+  chMtxLock(&mtx1);
+  while (!chThdShouldTerminateX()) {
+    (void) chCondWait(&c1);
+  }
+  chMtxUnlock(&mtx1);
+}
+#endif
+
+#if CH_CFG_USE_MESSAGES
+static THD_FUNCTION(bmk_thread10, p) {
+  uint8_t buf[64];
+  const msg_segment_t seg = {buf, sizeof (buf)};
+  thread_t *tp;
+
+  (void)p;
+  while (!chThdShouldTerminateX()) {
+    tp = chMsgWait();
+    chMsgRelease(tp, (msg_t)chMsgReceiveBuffer(tp, &seg, 1U));
+  }
+}
+#endif
+
+#if CH_CFG_USE_TM || defined(__DOXYGEN__)
+static time_histogram_t hist1;
+
+static void print_percentiles(const time_histogram_t *thp) {
+
+  test_print("p50 ");
+  test_printn(chTMHistogramGetPercentileX(thp, 5000U));
+  test_print(", p90 ");
+  test_printn(chTMHistogramGetPercentileX(thp, 9000U));
+  test_print(", p99 ");
+  test_printn(chTMHistogramGetPercentileX(thp, 9900U));
+  test_print(", p99.9 ");
+  test_printn(chTMHistogramGetPercentileX(thp, 9990U));
+  test_print(", worst ");
+  test_printn(thp->tm.worst);
+  test_println(" cycles");
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -1034,6 +1085,411 @@ static const testcase_t rt_test_012_012 = {
   rt_test_012_012_execute
 };
 
+/**
+ * @page rt_test_012_013 [12.13] Ready list wakeup performance
+ *
+ * <h2>Description</h2>
+ * A thread is made ready and removed from the ready list into a
+ * continuous loop while a variable number of higher priority threads
+ * are also ready, the thread structures are placed in the test buffer
+ * and never run.<br> The performance is calculated by measuring the
+ * number of iterations after a second of continuous operations for
+ * each ready list depth.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.13.1] The thread structures are prepared, the last one is the
+ *   thread being woken and has the lowest priority.
+ * - [12.13.2] For each ready list depth the higher priority threads
+ *   are made ready then the last thread is made ready and removed from
+ *   the ready list. The operation is repeated continuously in a
+ *   one-second time window then the score is printed.
+ * .
+ */
+
+static void rt_test_012_013_execute(void) {
+  thread_t *tp = (thread_t *)(void *)test_buffer;
+  unsigned i, j, depths[4], maxdepth;
+  uint32_t n;
+
+  /* [12.13.1] The thread structures are prepared, the last one is the
+     thread being woken and has the lowest priority.*/
+  test_set_step(1);
+  {
+    maxdepth = (unsigned)(sizeof (test_buffer) / sizeof (thread_t)) - 1U;
+    for (i = 0U; i <= maxdepth; i++) {
+      tp[i].hdr.pqueue.prio = chThdGetPriorityX() - (tprio_t)1 - (tprio_t)(i % 8U);
+      tp[i].state           = CH_STATE_SUSPENDED;
+      tp[i].u.rdymsg        = MSG_OK;
+    }
+    tp[maxdepth].hdr.pqueue.prio = chThdGetPriorityX() - (tprio_t)9;
+    depths[0] = 0U;
+    depths[1] = maxdepth / 4U;
+    depths[2] = maxdepth / 2U;
+    depths[3] = maxdepth;
+  }
+  test_end_step(1);
+
+  /* [12.13.2] For each ready list depth the higher priority threads
+     are made ready then the last thread is made ready and removed from
+     the ready list. The operation is repeated continuously in a
+     one-second time window then the score is printed.*/
+  test_set_step(2);
+  {
+    for (j = 0U; j < 4U; j++) {
+      systime_t start, end;
+
+      n = 0;
+      start = test_wait_tick();
+      end = chTimeAddX(start, TIME_MS2I(1000));
+
+      /* The current thread must not sleep while the fake threads are
+         in the ready list.*/
+      chSysLock();
+      for (i = 0U; i < depths[j]; i++) {
+        (void) chSchReadyI(&tp[i]);
+      }
+      chSysUnlock();
+
+      do {
+        chSysLock();
+        (void) chSchReadyI(&tp[maxdepth]);
+        (void) __sch_ready_remove(currcore, &tp[maxdepth]);
+        tp[maxdepth].state = CH_STATE_SUSPENDED;
+        chSysUnlock();
+        n++;
+#if defined(SIMULATOR)
+        _sim_check_for_interrupts();
+#endif
+      } while (chVTIsSystemTimeWithinX(start, end));
+
+      chSysLock();
+      for (i = 0U; i < depths[j]; i++) {
+        (void) __sch_ready_remove(currcore, &tp[i]);
+        tp[i].state = CH_STATE_SUSPENDED;
+      }
+      chSysUnlock();
+
+      test_print("--- Depth ");
+      test_printn(depths[j]);
+      test_print(": ");
+      test_printn(n);
+      test_println(" wakeups/S");
+    }
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_013 = {
+  "Ready list wakeup performance",
+  NULL,
+  NULL,
+  rt_test_012_013_execute
+};
+
+#if (CH_CFG_USE_TM && CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_014 [12.14] Context switch latency percentiles
+ *
+ * <h2>Description</h2>
+ * A thread is woken by signaling a semaphore and immediately waits
+ * again, the duration of each round trip, including two context
+ * switches, is recorded in a time histogram.<br> The percentiles of
+ * the distribution are printed, the tail latencies are not visible in
+ * the average throughput figures.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TM && CH_CFG_USE_SEMAPHORES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.14.1] A thread is created at higher priority that immediately
+ *   enqueues on a semaphore.
+ * - [12.14.2] The semaphore is signaled, the thread runs and enqueues
+ *   again before control returns, each round trip is measured into an
+ *   histogram. The operation is repeated continuously in a one-second
+ *   time window.
+ * - [12.14.3] The thread is terminated.
+ * - [12.14.4] The number of measurements and the percentiles are
+ *   printed.
+ * .
+ */
+
+static void rt_test_012_014_setup(void) {
+  chSemObjectInit(&sem1, 0);
+}
+
+static void rt_test_012_014_execute(void) {
+
+  /* [12.14.1] A thread is created at higher priority that immediately
+     enqueues on a semaphore.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread7, NULL);
+    chTMHistogramObjectInit(&hist1);
+  }
+  test_end_step(1);
+
+  /* [12.14.2] The semaphore is signaled, the thread runs and enqueues
+     again before control returns, each round trip is measured into an
+     histogram. The operation is repeated continuously in a one-second
+     time window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chTMHistogramStartMeasurementX(&hist1);
+      chSemSignal(&sem1);
+      chTMHistogramStopMeasurementX(&hist1);
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [12.14.3] The thread is terminated.*/
+  test_set_step(3);
+  {
+    test_terminate_threads();
+    chSemReset(&sem1, 0);
+    test_wait_threads();
+  }
+  test_end_step(3);
+
+  /* [12.14.4] The number of measurements and the percentiles are
+     printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Count : ");
+    test_printn(hist1.tm.n);
+    test_println(" round trips");
+    test_print("--- Round : ");
+    print_percentiles(&hist1);
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_012_014 = {
+  "Context switch latency percentiles",
+  rt_test_012_014_setup,
+  NULL,
+  rt_test_012_014_execute
+};
+#endif /* CH_CFG_USE_TM && CH_CFG_USE_SEMAPHORES */
+
+#if (CH_CFG_USE_CONDVARS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_015 [12.15] Condition variable broadcast performance
+ *
+ * <h2>Description</h2>
+ * Four threads wait on a condition variable with a mutex, a lower
+ * priority thread broadcasts the condition variable in a continuous
+ * loop, all the threads take the mutex in turn then wait again.<br> The
+ * performance is calculated by measuring the number of broadcasts after
+ * a second of continuous operations. The result depends on the
+ * CH_CFG_USE_CONDVARS_REQUEUE setting, with wait morphing the threads
+ * do not contend for the mutex.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_CONDVARS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.15.1] Four threads are created at higher priority, each one
+ *   locks the mutex and waits on the condition variable.
+ * - [12.15.2] The mutex is locked, the condition variable is broadcast
+ *   and the mutex is unlocked, all the threads take the mutex in turn
+ *   and wait again before control returns. The operation is repeated
+ *   continuously in a one-second time window.
+ * - [12.15.3] The threads are terminated.
+ * - [12.15.4] The score is printed, the number of context switches for
+ *   each broadcast is also printed if the kernel statistics are
+ *   enabled.
+ * .
+ */
+
+static void rt_test_012_015_setup(void) {
+  chMtxObjectInit(&mtx1);
+  chCondObjectInit(&c1);
+}
+
+static void rt_test_012_015_execute(void) {
+  uint32_t n;
+#if CH_DBG_STATISTICS == TRUE
+  ucnt_t nswc;
+#endif
+
+  /* [12.15.1] Four threads are created at higher priority, each one
+     locks the mutex and waits on the condition variable.*/
+  test_set_step(1);
+  {
+    tprio_t prio = chThdGetPriorityX() + 1;
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio, bmk_thread9, NULL);
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio, bmk_thread9, NULL);
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio, bmk_thread9, NULL);
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, prio, bmk_thread9, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.15.2] The mutex is locked, the condition variable is broadcast
+     and the mutex is unlocked, all the threads take the mutex in turn
+     and wait again before control returns. The operation is repeated
+     continuously in a one-second time window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+#if CH_DBG_STATISTICS == TRUE
+    nswc = currcore->kernel_stats.n_ctxswc;
+#endif
+    do {
+      chMtxLock(&mtx1);
+      chCondBroadcast(&c1);
+      chMtxUnlock(&mtx1);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+#if CH_DBG_STATISTICS == TRUE
+    nswc = currcore->kernel_stats.n_ctxswc - nswc;
+#endif
+  }
+  test_end_step(2);
+
+  /* [12.15.3] The threads are terminated.*/
+  test_set_step(3);
+  {
+    test_terminate_threads();
+    chCondBroadcast(&c1);
+    test_wait_threads();
+  }
+  test_end_step(3);
+
+  /* [12.15.4] The score is printed, the number of context switches for
+     each broadcast is also printed if the kernel statistics are
+     enabled.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" broadcasts/S");
+#if CH_DBG_STATISTICS == TRUE
+    test_print("--- Switch: ");
+    test_printn(nswc / n);
+    test_println(" ctxswc/broadcast");
+#endif
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_012_015 = {
+  "Condition variable broadcast performance",
+  rt_test_012_015_setup,
+  NULL,
+  rt_test_012_015_execute
+};
+#endif /* CH_CFG_USE_CONDVARS */
+
+#if (CH_CFG_USE_MESSAGES && CH_CFG_USE_TM) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_016 [12.16] Messages round trip latency
+ *
+ * <h2>Description</h2>
+ * A message server thread is created with a higher priority than the
+ * client thread, each message round trip, including two context
+ * switches, is recorded in a time histogram.<br> Empty messages are
+ * measured first then buffer messages carrying a 64 bytes payload split
+ * in two segments, the difference is the cost of the payload copy.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MESSAGES && CH_CFG_USE_TM
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.16.1] The server thread is created at higher priority.
+ * - [12.16.2] Empty messages then buffer messages are sent to the
+ *   server, each round trip is measured into an histogram. Each
+ *   measurement is repeated continuously in a one-second time window
+ *   then the percentiles are printed.
+ * - [12.16.3] The server thread is terminated.
+ * .
+ */
+
+static void rt_test_012_016_execute(void) {
+  uint8_t data[64];
+  const msg_segment_t segs[2] = {
+    {&data[0],  16U},
+    {&data[16], 48U}
+  };
+  unsigned i;
+
+  /* [12.16.1] The server thread is created at higher priority.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread10, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.16.2] Empty messages then buffer messages are sent to the
+     server, each round trip is measured into an histogram. Each
+     measurement is repeated continuously in a one-second time window
+     then the percentiles are printed.*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < 2U; i++) {
+      systime_t start, end;
+      msg_t msg = MSG_OK;
+
+      chTMHistogramObjectInit(&hist1);
+      start = test_wait_tick();
+      end = chTimeAddX(start, TIME_MS2I(1000));
+      do {
+        chTMHistogramStartMeasurementX(&hist1);
+        msg = chMsgSendBuffer(threads[0], segs, i * 2U);
+        chTMHistogramStopMeasurementX(&hist1);
+#if defined(SIMULATOR)
+        _sim_check_for_interrupts();
+#endif
+      } while (chVTIsSystemTimeWithinX(start, end));
+      test_assert(msg == (msg_t)(i * sizeof (data)), "wrong size");
+
+      test_print(i == 0U ? "--- Empty : " : "--- 64B   : ");
+      print_percentiles(&hist1);
+    }
+  }
+  test_end_step(2);
+
+  /* [12.16.3] The server thread is terminated.*/
+  test_set_step(3);
+  {
+    test_terminate_threads();
+    (void) chMsgSendBuffer(threads[0], NULL, 0U);
+    test_wait_threads();
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_016 = {
+  "Messages round trip latency",
+  NULL,
+  NULL,
+  rt_test_012_016_execute
+};
+#endif /* CH_CFG_USE_MESSAGES && CH_CFG_USE_TM */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1066,6 +1522,16 @@ const testcase_t * const rt_test_sequence_012_array[] = {
   &rt_test_012_011,
 #endif
   &rt_test_012_012,
+  &rt_test_012_013,
+#if (CH_CFG_USE_TM && CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &rt_test_012_014,
+#endif
+#if (CH_CFG_USE_CONDVARS) || defined(__DOXYGEN__)
+  &rt_test_012_015,
+#endif
+#if (CH_CFG_USE_MESSAGES && CH_CFG_USE_TM) || defined(__DOXYGEN__)
+  &rt_test_012_016,
+#endif
   NULL
 };
 
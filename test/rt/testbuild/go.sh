@@ -122,6 +122,26 @@ test cfg32 "-DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64"
 test cfg33 "-DCH_CFG_INTERVALS_SIZE=64"
 test cfg34 "-DCH_CFG_USE_OBJ_FIFOS=FALSE"
 test cfg35 "-DCH_CFG_USE_FACTORY=FALSE"
+test cfg36 "-DCH_CFG_VT_USE_WHEEL=TRUE"
+test cfg37 "-DCH_CFG_VT_USE_WHEEL=TRUE -DCH_CFG_VT_WHEEL_BITS=3 -DCH_CFG_INTERVALS_SIZE=64"
+test cfg38 "-DCH_CFG_VT_USE_WHEEL=TRUE -DCH_CFG_ST_RESOLUTION=16"
+test cfg39 "-DCH_CFG_RLIST_USE_BITMAP=TRUE"
+test cfg40 "-DCH_CFG_RLIST_USE_BITMAP=TRUE -DCH_DBG_SYSTEM_STATE_CHECK=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+test cfg41 "-DCH_CFG_HEAP_USE_TLSF=TRUE"
+test cfg42 "-DCH_CFG_HEAP_USE_TLSF=TRUE -DCH_CFG_HEAP_TLSF_SL_BITS=5 -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+test cfg43 "-DCH_CFG_MEMPOOLS_USE_MAGAZINES=TRUE"
+test cfg44 "-DCH_CFG_MEMPOOLS_USE_MAGAZINES=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+test cfg45 "-DCH_CFG_OBJ_CACHES_USE_OPEN_HASH=TRUE"
+test cfg46 "-DCH_CFG_OBJ_CACHES_USE_OPEN_HASH=TRUE -DCH_CFG_OBJ_CACHES_LOAD_FACTOR=90 -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+test cfg47 "-DCH_CFG_OBJ_CACHES_USE_FLUSHER=TRUE"
+test cfg48 "-DCH_CFG_OBJ_CACHES_USE_FLUSHER=TRUE -DCH_CFG_OBJ_CACHES_USE_OPEN_HASH=TRUE -DCH_CFG_OBJ_CACHES_FLUSH_BATCH=2 -DCH_DBG_SYSTEM_STATE_CHECK=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+test cfg49 "-DCH_CFG_USE_CONDVARS_REQUEUE=TRUE"
+test cfg50 "-DCH_CFG_USE_CONDVARS_REQUEUE=TRUE -DCH_CFG_USE_CONDVARS_TIMEOUT=FALSE -DCH_DBG_SYSTEM_STATE_CHECK=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+test cfg51 "-DCH_DBG_TRACE_MASK=CH_DBG_TRACE_MASK_ALL -DCH_DBG_TRACE_STREAM=TRUE"
+test cfg52 "-DCH_DBG_STATISTICS=TRUE -DCH_DBG_STATISTICS_LATENCY=TRUE"
+test cfg53 "-DCH_DBG_STATISTICS=TRUE -DCH_DBG_STATISTICS_LATENCY=TRUE -DCH_DBG_STATISTICS_LATENCY_BUCKETS=8 -DCH_DBG_SYSTEM_STATE_CHECK=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+test cfg54 "-DCH_CFG_TM_HISTOGRAM_PRECISION=0 -DCH_CFG_TM_HISTOGRAM_RANGE=32"
+test cfg55 "-DCH_CFG_TM_HISTOGRAM_PRECISION=8 -DCH_CFG_TM_HISTOGRAM_RANGE=16"
 
 rm *log.txt 2> /dev/null
 echo
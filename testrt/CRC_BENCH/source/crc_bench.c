@@ -0,0 +1,247 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    crc_bench.c
+ * @brief   CRC Bench benchmark code.
+ *
+ * @addtogroup CRC_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "hal_crc_engine.h"
+
+#include "crc_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*
+ * CRC implementation under test.
+ */
+typedef struct {
+  const char            *name;
+  uint32_t              (*crc)(uint32_t crc, const uint8_t *data, size_t n);
+  uint32_t              init;
+  uint32_t              check;
+} bench_engine_t;
+
+/*===========================================================================*/
+/* Module local functions prototypes.                                        */
+/*===========================================================================*/
+
+static uint32_t ref16(uint32_t crc, const uint8_t *data, size_t n);
+static uint32_t ref32(uint32_t crc, const uint8_t *data, size_t n);
+static uint32_t eng16(uint32_t crc, const uint8_t *data, size_t n);
+static uint32_t eng32(uint32_t crc, const uint8_t *data, size_t n);
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static const bench_engine_t engines[] = {
+  {"crc16-bit", ref16, CRC16_CCITT_INIT, 0x29B1U},
+  {"crc16",     eng16, CRC16_CCITT_INIT, 0x29B1U},
+  {"crc32-bit", ref32, CRC32_INIT,       0x340BC6D9U},
+  {"crc32",     eng32, CRC32_INIT,       0x340BC6D9U}
+};
+
+static const size_t sizes[] = {16U, 64U, 256U, 1024U, CRC_BENCH_CFG_BUFFER_SIZE};
+
+static uint8_t buffer[CRC_BENCH_CFG_BUFFER_SIZE];
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Bitwise reference implementations, no tables.
+ */
+static uint32_t ref16(uint32_t crc, const uint8_t *data, size_t n) {
+
+  while (n > 0U) {
+    unsigned i;
+
+    crc ^= (uint32_t)*data << 8;
+    for (i = 0U; i < 8U; i++) {
+      crc = (crc & 0x8000U) != 0U ? (crc << 1) ^ 0x1021U : crc << 1;
+    }
+    crc &= 0xFFFFU;
+    data++;
+    n--;
+  }
+
+  return crc;
+}
+
+static uint32_t ref32(uint32_t crc, const uint8_t *data, size_t n) {
+
+  while (n > 0U) {
+    unsigned i;
+
+    crc ^= (uint32_t)*data;
+    for (i = 0U; i < 8U; i++) {
+      crc = (crc & 1U) != 0U ? (crc >> 1) ^ 0xEDB88320U : crc >> 1;
+    }
+    data++;
+    n--;
+  }
+
+  return crc;
+}
+
+/*
+ * CRC engine wrappers.
+ */
+static uint32_t eng16(uint32_t crc, const uint8_t *data, size_t n) {
+
+  return (uint32_t)crc16((uint16_t)crc, data, n);
+}
+
+static uint32_t eng32(uint32_t crc, const uint8_t *data, size_t n) {
+
+  return crc32(crc, data, n);
+}
+
+/*
+ * Checks an engine against the standard check value and against the
+ * reference implementation on the whole buffer with all the possible
+ * alignments.
+ */
+static bool bench_check(const bench_engine_t *ep,
+                        const bench_engine_t *refp) {
+  size_t offset;
+
+  if (ep->crc(ep->init, (const uint8_t *)"123456789", 9U) != ep->check) {
+    return false;
+  }
+
+  for (offset = 0U; offset < 8U; offset++) {
+    size_t n = sizeof (buffer) - offset;
+
+    if (ep->crc(ep->init, &buffer[offset], n) !=
+        refp->crc(refp->init, &buffer[offset], n)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+ * Returns the throughput in kB/s processing blocks of the specified size.
+ */
+static uint32_t bench_run(const crc_bench_config_t *cfg,
+                          const bench_engine_t *ep, size_t size) {
+  volatile uint32_t crc = 0U;
+  uint32_t blocks = (uint32_t)(CRC_BENCH_CFG_TOTAL_BYTES / size);
+  uint32_t i;
+  rtcnt_t start, t;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < blocks; i++) {
+    crc ^= ep->crc(ep->init, buffer, size);
+  }
+  t = chSysGetRealtimeCounterX() - start;
+  if (t == (rtcnt_t)0) {
+    t = (rtcnt_t)1;
+  }
+
+  return (uint32_t)(((uint64_t)blocks * size * cfg->rtcfreq) /
+                    ((uint64_t)t * 1024U));
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   CRC bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void crc_bench_execute(const crc_bench_config_t *cfg) {
+  unsigned i, j;
+  uint32_t seed = 1U;
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT CRC-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+  chprintf(cfg->out, "*** CRC Slices:   %d\r\n", CRC_CFG_SLICES);
+  chprintf(cfg->out, "*** Total Bytes:  %d\r\n", CRC_BENCH_CFG_TOTAL_BYTES);
+  chprintf(cfg->out, "\r\n");
+
+  /* Pseudo-random data buffer.*/
+  for (i = 0U; i < sizeof (buffer); i++) {
+    seed = (seed * 1664525U) + 1013904223U;
+    buffer[i] = (uint8_t)(seed >> 24);
+  }
+
+  /* Checking the engine against the reference implementations.*/
+  for (i = 0U; i < sizeof (engines) / sizeof (engines[0]); i++) {
+    bool ok = bench_check(&engines[i], &engines[i & ~1U]);
+
+    chprintf(cfg->out, "Checking %-9s  %s\r\n",
+             engines[i].name, ok ? "OK" : "FAILED");
+  }
+
+  chprintf(cfg->out, "\r\nEngine     Size   kB/s\r\n");
+  for (i = 0U; i < sizeof (engines) / sizeof (engines[0]); i++) {
+    for (j = 0U; j < sizeof (sizes) / sizeof (sizes[0]); j++) {
+      chprintf(cfg->out, "%-9s  %4d  %7d\r\n",
+               engines[i].name, (int)sizes[j],
+               bench_run(cfg, &engines[i], sizes[j]));
+    }
+  }
+
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
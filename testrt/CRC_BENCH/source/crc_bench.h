@@ -0,0 +1,96 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    crc_bench.h
+ * @brief   CRC Bench benchmark header.
+ *
+ * @addtogroup CRC_BENCH
+ * @{
+ */
+
+#ifndef CRC_BENCH_H
+#define CRC_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the data buffer used during the test.
+ */
+#if !defined(CRC_BENCH_CFG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CRC_BENCH_CFG_BUFFER_SIZE           4096
+#endif
+
+/**
+ * @brief   Number of bytes processed for each measurement.
+ */
+#if !defined(CRC_BENCH_CFG_TOTAL_BYTES) || defined(__DOXYGEN__)
+#define CRC_BENCH_CFG_TOTAL_BYTES           16777216
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Realtime counter frequency.
+   */
+  uint32_t              rtcfreq;
+} crc_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void crc_bench_execute(const crc_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CRC_BENCH_H */
+
+/** @} */
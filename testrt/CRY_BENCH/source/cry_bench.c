@@ -0,0 +1,607 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    cry_bench.c
+ * @brief   Crypto Bench benchmark code.
+ *
+ * @addtogroup CRY_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "cry_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*
+ * Algorithm under test, the key is loaded by @p setup, @p run processes
+ * a single block of data.
+ */
+typedef struct {
+  const char            *name;
+  cryerror_t            (*setup)(void);
+  cryerror_t            (*run)(const uint8_t *in, uint8_t *out, size_t n);
+} bench_algo_t;
+
+#if HAL_CRY_USE_JOBS == TRUE
+/*
+ * Client of the multi-client test, each packet is encrypted using
+ * AES128-CTR then authenticated using HMAC-SHA256.
+ */
+typedef struct {
+  cry_job_t             jobs[2U + (CRY_BENCH_CFG_BATCH_SIZE * 2U)];
+  uint8_t               out[CRY_BENCH_CFG_PACKET_SIZE];
+  uint8_t               mac[32];
+  size_t                size;
+  uint32_t              packets;
+} bench_client_t;
+#endif
+
+/*===========================================================================*/
+/* Module local functions prototypes.                                        */
+/*===========================================================================*/
+
+static cryerror_t setup_aes128(void);
+static cryerror_t setup_aes256(void);
+static cryerror_t setup_des(void);
+static cryerror_t setup_tdes(void);
+static cryerror_t setup_hmac(void);
+static cryerror_t setup_none(void);
+static cryerror_t run_aes_ecb(const uint8_t *in, uint8_t *out, size_t n);
+static cryerror_t run_aes_cbc(const uint8_t *in, uint8_t *out, size_t n);
+static cryerror_t run_aes_ctr(const uint8_t *in, uint8_t *out, size_t n);
+static cryerror_t run_aes_gcm(const uint8_t *in, uint8_t *out, size_t n);
+static cryerror_t run_des_ecb(const uint8_t *in, uint8_t *out, size_t n);
+static cryerror_t run_sha1(const uint8_t *in, uint8_t *out, size_t n);
+static cryerror_t run_sha256(const uint8_t *in, uint8_t *out, size_t n);
+static cryerror_t run_sha512(const uint8_t *in, uint8_t *out, size_t n);
+static cryerror_t run_hmac256(const uint8_t *in, uint8_t *out, size_t n);
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static const bench_algo_t algos[] = {
+  {"aes128-ecb", setup_aes128, run_aes_ecb},
+  {"aes128-cbc", setup_aes128, run_aes_cbc},
+  {"aes128-ctr", setup_aes128, run_aes_ctr},
+  {"aes128-gcm", setup_aes128, run_aes_gcm},
+  {"aes256-ctr", setup_aes256, run_aes_ctr},
+  {"des-ecb",    setup_des,    run_des_ecb},
+  {"tdes-ecb",   setup_tdes,   run_des_ecb},
+  {"sha1",       setup_none,   run_sha1},
+  {"sha256",     setup_none,   run_sha256},
+  {"sha512",     setup_none,   run_sha512},
+  {"hmac256",    setup_hmac,   run_hmac256}
+};
+
+static const size_t sizes[] = {64U, CRY_BENCH_CFG_BUFFER_SIZE};
+
+/*
+ * Known answers, FIPS-197 C.1, the classic DES example and FIPS-180
+ * "abc" digests.
+ */
+static const uint8_t aes_key[16] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F
+};
+static const uint8_t aes_pt[16] = {
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+  0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+};
+static const uint8_t aes_ct[16] = {
+  0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+  0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A
+};
+static const uint8_t des_key[24] = {
+  0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+  0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0x01,
+  0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0x01, 0x23
+};
+static const uint8_t des_pt[8] = {
+  0x4E, 0x6F, 0x77, 0x20, 0x69, 0x73, 0x20, 0x74
+};
+static const uint8_t des_ct[8] = {
+  0x3F, 0xA4, 0x0E, 0x8A, 0x98, 0x4D, 0x48, 0x15
+};
+static const uint8_t sha1_abc[20] = {
+  0xA9, 0x99, 0x3E, 0x36, 0x47, 0x06, 0x81, 0x6A, 0xBA, 0x3E,
+  0x25, 0x71, 0x78, 0x50, 0xC2, 0x6C, 0x9C, 0xD0, 0xD8, 0x9D
+};
+static const uint8_t sha256_abc[32] = {
+  0xBA, 0x78, 0x16, 0xBF, 0x8F, 0x01, 0xCF, 0xEA,
+  0x41, 0x41, 0x40, 0xDE, 0x5D, 0xAE, 0x22, 0x23,
+  0xB0, 0x03, 0x61, 0xA3, 0x96, 0x17, 0x7A, 0x9C,
+  0xB4, 0x10, 0xFF, 0x61, 0xF2, 0x00, 0x15, 0xAD
+};
+static const uint8_t sha512_abc[64] = {
+  0xDD, 0xAF, 0x35, 0xA1, 0x93, 0x61, 0x7A, 0xBA,
+  0xCC, 0x41, 0x73, 0x49, 0xAE, 0x20, 0x41, 0x31,
+  0x12, 0xE6, 0xFA, 0x4E, 0x89, 0xA9, 0x7E, 0xA2,
+  0x0A, 0x9E, 0xEE, 0xE6, 0x4B, 0x55, 0xD3, 0x9A,
+  0x21, 0x92, 0x99, 0x2A, 0x27, 0x4F, 0xC1, 0xA8,
+  0x36, 0xBA, 0x3C, 0x23, 0xA3, 0xFE, 0xEB, 0xBD,
+  0x45, 0x4D, 0x44, 0x23, 0x64, 0x3C, 0xE8, 0x0E,
+  0x2A, 0x9A, 0xC9, 0x4F, 0xA5, 0x4C, 0xA4, 0x9F
+};
+
+static CRYDriver *cryp;
+static uint8_t iv[16];
+static uint8_t inbuf[CRY_BENCH_INBUF_SIZE];
+static uint8_t outbuf[CRY_BENCH_CFG_BUFFER_SIZE];
+
+#if HAL_CRY_USE_JOBS == TRUE
+static const size_t packets[] = {64U, CRY_BENCH_CFG_PACKET_SIZE};
+
+/*
+ * Clients serialize the synchronous API using this mutex.
+ */
+static mutex_t crymtx;
+
+static bench_client_t clients[CRY_BENCH_CFG_MAX_CLIENTS];
+
+static THD_WORKING_AREA(waClients[CRY_BENCH_CFG_MAX_CLIENTS],
+                        CRY_BENCH_CFG_WA_SIZE);
+static THD_WORKING_AREA(waDispatcher, CRY_BENCH_CFG_WA_SIZE);
+#endif
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Key setup functions.
+ */
+static cryerror_t setup_aes128(void) {
+
+  return cryLoadAESTransientKey(cryp, sizeof (aes_key), aes_key);
+}
+
+static cryerror_t setup_aes256(void) {
+  uint8_t key[32];
+
+  memcpy(&key[0], aes_key, 16U);
+  memcpy(&key[16], aes_key, 16U);
+
+  return cryLoadAESTransientKey(cryp, sizeof (key), key);
+}
+
+static cryerror_t setup_des(void) {
+
+  return cryLoadDESTransientKey(cryp, 8U, des_key);
+}
+
+static cryerror_t setup_tdes(void) {
+
+  return cryLoadDESTransientKey(cryp, sizeof (des_key), des_key);
+}
+
+static cryerror_t setup_hmac(void) {
+
+  return cryLoadHMACTransientKey(cryp, sizeof (aes_key), aes_key);
+}
+
+static cryerror_t setup_none(void) {
+
+  return CRY_NOERROR;
+}
+
+/*
+ * Algorithms wrappers, hashes process the whole block in a single update.
+ */
+static cryerror_t run_aes_ecb(const uint8_t *in, uint8_t *out, size_t n) {
+
+  return cryEncryptAES_ECB(cryp, 0U, n, in, out);
+}
+
+static cryerror_t run_aes_cbc(const uint8_t *in, uint8_t *out, size_t n) {
+
+  return cryEncryptAES_CBC(cryp, 0U, n, in, out, iv);
+}
+
+static cryerror_t run_aes_ctr(const uint8_t *in, uint8_t *out, size_t n) {
+
+  return cryEncryptAES_CTR(cryp, 0U, n, in, out, iv);
+}
+
+static cryerror_t run_aes_gcm(const uint8_t *in, uint8_t *out, size_t n) {
+  uint8_t tag[16];
+
+  return cryEncryptAES_GCM(cryp, 0U, 16U, aes_pt, n, in, out, iv,
+                           sizeof (tag), tag);
+}
+
+static cryerror_t run_des_ecb(const uint8_t *in, uint8_t *out, size_t n) {
+
+  return cryEncryptDES_ECB(cryp, 0U, n, in, out);
+}
+
+static cryerror_t run_sha1(const uint8_t *in, uint8_t *out, size_t n) {
+  SHA1Context ctx;
+  cryerror_t err;
+
+  err = crySHA1Init(cryp, &ctx);
+  if (err == CRY_NOERROR) {
+    err = crySHA1Update(cryp, &ctx, n, in);
+  }
+  if (err == CRY_NOERROR) {
+    err = crySHA1Final(cryp, &ctx, out);
+  }
+
+  return err;
+}
+
+static cryerror_t run_sha256(const uint8_t *in, uint8_t *out, size_t n) {
+  SHA256Context ctx;
+  cryerror_t err;
+
+  err = crySHA256Init(cryp, &ctx);
+  if (err == CRY_NOERROR) {
+    err = crySHA256Update(cryp, &ctx, n, in);
+  }
+  if (err == CRY_NOERROR) {
+    err = crySHA256Final(cryp, &ctx, out);
+  }
+
+  return err;
+}
+
+static cryerror_t run_sha512(const uint8_t *in, uint8_t *out, size_t n) {
+  SHA512Context ctx;
+  cryerror_t err;
+
+  err = crySHA512Init(cryp, &ctx);
+  if (err == CRY_NOERROR) {
+    err = crySHA512Update(cryp, &ctx, n, in);
+  }
+  if (err == CRY_NOERROR) {
+    err = crySHA512Final(cryp, &ctx, out);
+  }
+
+  return err;
+}
+
+static cryerror_t run_hmac256(const uint8_t *in, uint8_t *out, size_t n) {
+  HMACSHA256Context ctx;
+  cryerror_t err;
+
+  err = cryHMACSHA256Init(cryp, &ctx);
+  if (err == CRY_NOERROR) {
+    err = cryHMACSHA256Update(cryp, &ctx, n, in);
+  }
+  if (err == CRY_NOERROR) {
+    err = cryHMACSHA256Final(cryp, &ctx, out);
+  }
+
+  return err;
+}
+
+#if HAL_CRY_USE_JOBS == TRUE
+/*
+ * Client using the synchronous API, the driver is locked for each packet
+ * and the keys are reloaded because other clients could have changed them.
+ */
+static THD_FUNCTION(SyncClient, arg) {
+  bench_client_t *cp = (bench_client_t *)arg;
+  uint32_t i;
+
+  for (i = 0U; i < cp->packets; i++) {
+    chMtxLock(&crymtx);
+    (void) setup_aes128();
+    (void) run_aes_ctr(inbuf, cp->out, cp->size);
+    (void) setup_hmac();
+    (void) run_hmac256(cp->out, cp->mac, cp->size);
+    chMtxUnlock(&crymtx);
+  }
+}
+
+/*
+ * Client using the jobs API, the keys are loaded once per batch.
+ */
+static THD_FUNCTION(JobsClient, arg) {
+  bench_client_t *cp = (bench_client_t *)arg;
+  size_t n = sizeof (cp->jobs) / sizeof (cp->jobs[0]);
+  uint32_t i;
+
+  memset(cp->jobs, 0, sizeof (cp->jobs));
+  cp->jobs[0].op   = CRY_JOB_LOAD_AES_KEY;
+  cp->jobs[0].size = sizeof (aes_key);
+  cp->jobs[0].in   = aes_key;
+  cp->jobs[1].op   = CRY_JOB_LOAD_HMAC_KEY;
+  cp->jobs[1].size = sizeof (aes_key);
+  cp->jobs[1].in   = aes_key;
+  for (i = 2U; i < n; i += 2U) {
+    cp->jobs[i].op       = CRY_JOB_ENCRYPT_AES_CTR;
+    cp->jobs[i].size     = cp->size;
+    cp->jobs[i].in       = inbuf;
+    cp->jobs[i].out      = cp->out;
+    cp->jobs[i].iv       = iv;
+    cp->jobs[i + 1].op   = CRY_JOB_HMAC_SHA256;
+    cp->jobs[i + 1].size = cp->size;
+    cp->jobs[i + 1].in   = cp->out;
+    cp->jobs[i + 1].out  = cp->mac;
+  }
+
+  for (i = 0U; i < cp->packets; i += CRY_BENCH_CFG_BATCH_SIZE) {
+    cryPostJobs(cryp, cp->jobs, n);
+
+    /* Jobs are executed in order, the last one completes the batch.*/
+    (void) cryWaitJobTimeout(cryp, &cp->jobs[n - 1U], TIME_INFINITE);
+  }
+}
+
+/*
+ * Dispatcher thread, serves the jobs queue until terminated.
+ */
+static THD_FUNCTION(Dispatcher, arg) {
+
+  (void)arg;
+
+  while (!chThdShouldTerminateX()) {
+    (void) cryDispatchJobsTimeout(cryp, TIME_MS2I(10));
+  }
+}
+#endif /* HAL_CRY_USE_JOBS == TRUE */
+
+/*
+ * Known answer tests.
+ */
+static bool bench_check(void) {
+  uint8_t buf[64];
+
+  if ((setup_aes128() != CRY_NOERROR) ||
+      (run_aes_ecb(aes_pt, buf, 16U) != CRY_NOERROR) ||
+      (memcmp(buf, aes_ct, 16U) != 0)) {
+    return false;
+  }
+  if ((setup_des() != CRY_NOERROR) ||
+      (run_des_ecb(des_pt, buf, 8U) != CRY_NOERROR) ||
+      (memcmp(buf, des_ct, 8U) != 0)) {
+    return false;
+  }
+  if ((run_sha1((const uint8_t *)"abc", buf, 3U) != CRY_NOERROR) ||
+      (memcmp(buf, sha1_abc, 20U) != 0)) {
+    return false;
+  }
+  if ((run_sha256((const uint8_t *)"abc", buf, 3U) != CRY_NOERROR) ||
+      (memcmp(buf, sha256_abc, 32U) != 0)) {
+    return false;
+  }
+  if ((run_sha512((const uint8_t *)"abc", buf, 3U) != CRY_NOERROR) ||
+      (memcmp(buf, sha512_abc, 64U) != 0)) {
+    return false;
+  }
+#if HAL_CRY_USE_JOBS == TRUE
+  {
+    cry_job_t jobs[3];
+
+    /* The queue is served inline, there are jobs so there is no wait.*/
+    memset(jobs, 0, sizeof (jobs));
+    jobs[0].op   = CRY_JOB_LOAD_AES_KEY;
+    jobs[0].size = sizeof (aes_key);
+    jobs[0].in   = aes_key;
+    jobs[1].op   = CRY_JOB_ENCRYPT_AES_ECB;
+    jobs[1].size = 16U;
+    jobs[1].in   = aes_pt;
+    jobs[1].out  = &buf[0];
+    jobs[2].op   = CRY_JOB_SHA256;
+    jobs[2].size = 3U;
+    jobs[2].in   = (const uint8_t *)"abc";
+    jobs[2].out  = &buf[16];
+    cryPostJobs(cryp, jobs, 3U);
+    (void) cryDispatchJobsTimeout(cryp, TIME_IMMEDIATE);
+    if ((jobs[0].state != CRY_JOB_DONE) || (jobs[2].state != CRY_JOB_DONE) ||
+        (jobs[1].err != CRY_NOERROR) || (jobs[2].err != CRY_NOERROR) ||
+        (memcmp(&buf[0], aes_ct, 16U) != 0) ||
+        (memcmp(&buf[16], sha256_abc, 32U) != 0)) {
+      return false;
+    }
+  }
+#endif
+
+  return true;
+}
+
+/*
+ * Processes blocks of the specified size, returns the throughput in kB/s
+ * and the cost in hundredths of core cycles per byte.
+ */
+static uint32_t bench_run(const cry_bench_config_t *cfg,
+                          const bench_algo_t *ap, size_t size,
+                          uint32_t *cpbp) {
+  uint32_t blocks = (uint32_t)(CRY_BENCH_CFG_TOTAL_BYTES / size);
+  uint32_t i;
+  uint64_t bytes;
+  rtcnt_t start, t;
+
+  (void) ap->setup();
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < blocks; i++) {
+    (void) ap->run(inbuf, outbuf, size);
+  }
+  t = chSysGetRealtimeCounterX() - start;
+  if (t == (rtcnt_t)0) {
+    t = (rtcnt_t)1;
+  }
+
+  bytes = (uint64_t)blocks * size;
+  *cpbp = (uint32_t)(((uint64_t)t * cfg->cpufreq / cfg->rtcfreq * 100U) /
+                     bytes);
+
+  return (uint32_t)((bytes * cfg->rtcfreq) / ((uint64_t)t * 1024U));
+}
+
+#if HAL_CRY_USE_JOBS == TRUE
+/*
+ * Processes packets of the specified size using concurrent clients, returns
+ * the number of packets per second.
+ */
+static uint32_t bench_clients(const cry_bench_config_t *cfg,
+                              unsigned nclients, size_t size, bool jobs) {
+  uint32_t per_client, total;
+  thread_t *tps[CRY_BENCH_CFG_MAX_CLIENTS];
+  unsigned i;
+  rtcnt_t start, t;
+
+  /* Each client processes a whole number of batches.*/
+  per_client = (uint32_t)(CRY_BENCH_CFG_TOTAL_BYTES / size) / nclients;
+  per_client = (per_client / CRY_BENCH_CFG_BATCH_SIZE) *
+               CRY_BENCH_CFG_BATCH_SIZE;
+  if (per_client == 0U) {
+    per_client = CRY_BENCH_CFG_BATCH_SIZE;
+  }
+  total = per_client * nclients;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < nclients; i++) {
+    clients[i].size    = size;
+    clients[i].packets = per_client;
+    tps[i] = chThdCreateStatic(waClients[i], sizeof (waClients[i]),
+                               NORMALPRIO - 1,
+                               jobs ? JobsClient : SyncClient,
+                               &clients[i]);
+  }
+  for (i = 0U; i < nclients; i++) {
+    (void) chThdWait(tps[i]);
+  }
+  t = chSysGetRealtimeCounterX() - start;
+  if (t == (rtcnt_t)0) {
+    t = (rtcnt_t)1;
+  }
+
+  return (uint32_t)(((uint64_t)total * cfg->rtcfreq) / t);
+}
+#endif /* HAL_CRY_USE_JOBS == TRUE */
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Crypto bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void cry_bench_execute(const cry_bench_config_t *cfg) {
+  unsigned i, j;
+  uint32_t seed = 1U;
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT CRY-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+#if HAL_CRY_USE_FALLBACK == TRUE
+  chprintf(cfg->out, "*** AES Tables:   %d\r\n", CRY_FALLBACK_AES_TABLES);
+#endif
+  chprintf(cfg->out, "*** Core Clock:   %d\r\n", cfg->cpufreq);
+  chprintf(cfg->out, "*** Total Bytes:  %d\r\n", CRY_BENCH_CFG_TOTAL_BYTES);
+  chprintf(cfg->out, "\r\n");
+
+  /* Pseudo-random data buffer.*/
+  for (i = 0U; i < sizeof (inbuf); i++) {
+    seed = (seed * 1664525U) + 1013904223U;
+    inbuf[i] = (uint8_t)(seed >> 24);
+  }
+
+  cryp = cfg->cryp;
+  cryStart(cryp, NULL);
+
+  chprintf(cfg->out, "Known answers  %s\r\n", bench_check() ? "OK" : "FAILED");
+
+  chprintf(cfg->out, "\r\nAlgorithm   Size     kB/s   cycles/B\r\n");
+  for (i = 0U; i < sizeof (algos) / sizeof (algos[0]); i++) {
+    for (j = 0U; j < sizeof (sizes) / sizeof (sizes[0]); j++) {
+      uint32_t kbps, cpb;
+
+      kbps = bench_run(cfg, &algos[i], sizes[j], &cpb);
+      chprintf(cfg->out, "%-10s  %4d  %7d  %6d.%02d\r\n",
+               algos[i].name, (int)sizes[j], kbps, cpb / 100U, cpb % 100U);
+    }
+  }
+
+#if HAL_CRY_USE_JOBS == TRUE
+  {
+    thread_t *dtp;
+    unsigned n;
+
+    /* The dispatcher runs below the clients, batches posted by different
+       clients accumulate in the queue and are drained back to back.*/
+    chMtxObjectInit(&crymtx);
+    dtp = chThdCreateStatic(waDispatcher, sizeof (waDispatcher),
+                            NORMALPRIO - 2, Dispatcher, NULL);
+
+    chprintf(cfg->out, "\r\nAES128-CTR + HMAC-SHA256, %d packets per batch\r\n",
+             CRY_BENCH_CFG_BATCH_SIZE);
+    chprintf(cfg->out, "Clients  Size   sync ops/s   jobs ops/s\r\n");
+    for (n = 1U; n <= CRY_BENCH_CFG_MAX_CLIENTS; n *= 2U) {
+      for (j = 0U; j < sizeof (packets) / sizeof (packets[0]); j++) {
+        uint32_t sync_ops, jobs_ops;
+
+        sync_ops = bench_clients(cfg, n, packets[j], false);
+        jobs_ops = bench_clients(cfg, n, packets[j], true);
+        chprintf(cfg->out, "%7d  %4d  %11d  %11d\r\n",
+                 n, (int)packets[j], sync_ops, jobs_ops);
+      }
+    }
+
+    chThdTerminate(dtp);
+    (void) chThdWait(dtp);
+  }
+#endif
+
+  cryStop(cryp);
+
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
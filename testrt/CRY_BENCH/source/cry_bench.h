@@ -0,0 +1,139 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    cry_bench.h
+ * @brief   Crypto Bench benchmark header.
+ *
+ * @addtogroup CRY_BENCH
+ * @{
+ */
+
+#ifndef CRY_BENCH_H
+#define CRY_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the largest data block used during the test.
+ */
+#if !defined(CRY_BENCH_CFG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CRY_BENCH_CFG_BUFFER_SIZE           1024
+#endif
+
+/**
+ * @brief   Number of bytes processed for each measurement.
+ */
+#if !defined(CRY_BENCH_CFG_TOTAL_BYTES) || defined(__DOXYGEN__)
+#define CRY_BENCH_CFG_TOTAL_BYTES           1048576
+#endif
+
+/**
+ * @brief   Size of the large packets used by the multi-client test.
+ */
+#if !defined(CRY_BENCH_CFG_PACKET_SIZE) || defined(__DOXYGEN__)
+#define CRY_BENCH_CFG_PACKET_SIZE           1500
+#endif
+
+/**
+ * @brief   Maximum number of clients in the multi-client test.
+ */
+#if !defined(CRY_BENCH_CFG_MAX_CLIENTS) || defined(__DOXYGEN__)
+#define CRY_BENCH_CFG_MAX_CLIENTS           4
+#endif
+
+/**
+ * @brief   Number of packets posted in each jobs batch.
+ */
+#if !defined(CRY_BENCH_CFG_BATCH_SIZE) || defined(__DOXYGEN__)
+#define CRY_BENCH_CFG_BATCH_SIZE            8
+#endif
+
+/**
+ * @brief   Working area size of the client and dispatcher threads.
+ */
+#if !defined(CRY_BENCH_CFG_WA_SIZE) || defined(__DOXYGEN__)
+#define CRY_BENCH_CFG_WA_SIZE               2048
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CRY_BENCH_CFG_PACKET_SIZE > CRY_BENCH_CFG_BUFFER_SIZE
+#define CRY_BENCH_INBUF_SIZE                CRY_BENCH_CFG_PACKET_SIZE
+#else
+#define CRY_BENCH_INBUF_SIZE                CRY_BENCH_CFG_BUFFER_SIZE
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Cryptographic driver under test.
+   */
+  CRYDriver             *cryp;
+  /**
+   * @brief   Realtime counter frequency.
+   */
+  uint32_t              rtcfreq;
+  /**
+   * @brief   Core clock frequency.
+   * @note    Used to express the results in cycles per byte.
+   */
+  uint32_t              cpufreq;
+} cry_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void cry_bench_execute(const cry_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CRY_BENCH_H */
+
+/** @} */
@@ -0,0 +1,91 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    portab.h
+ * @brief   Application portability macros and structures.
+ *
+ * @addtogroup application_portability
+ * @{
+ */
+
+#ifndef PORTAB_H
+#define PORTAB_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/* Resolution of the simulator realtime counter, microseconds.*/
+#define PORTAB_RTC_FREQUENCY        1000000U
+
+/* Simulated disk geometry, 8MB.*/
+#define PORTAB_DISK_BLOCK_SIZE      512U
+#define PORTAB_DISK_BLOCKS          16384U
+
+/* Host file backing the simulated disk, NULL for a volatile disk.*/
+#if !defined(PORTAB_DISK_PATH)
+#define PORTAB_DISK_PATH            NULL
+#endif
+
+/* Simulated disk latencies in microseconds, per command and per block.*/
+#if !defined(PORTAB_DISK_ACCESS_TIME)
+#define PORTAB_DISK_ACCESS_TIME     0U
+#endif
+#if !defined(PORTAB_DISK_READ_TIME)
+#define PORTAB_DISK_READ_TIME       0U
+#endif
+#if !defined(PORTAB_DISK_WRITE_TIME)
+#define PORTAB_DISK_WRITE_TIME      0U
+#endif
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern const fatfs_bench_config_t portab_fatfs_bench_config;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void portab_setup(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* PORTAB_H */
+
+/** @} */
@@ -0,0 +1,309 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_bench.c
+ * @brief   FatFS Bench benchmark code.
+ * @details The file system is created on a simulated disk, the number of
+ *          device operations generated by typical file accesses is measured.
+ *
+ * @addtogroup FATFS_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "ff.h"
+
+#include "fatfs_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static FATFS fs;
+static FIL file;
+static uint8_t chunk[FATFS_BENCH_CFG_CHUNK_SIZE];
+static uint8_t work[FF_MAX_SS * 4];
+static rtcnt_t start;
+static uint32_t errors;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Pattern byte at the specified file offset.
+ */
+static uint8_t pattern(uint32_t seed, uint32_t offset) {
+
+  return (uint8_t)((offset * 7U) + (offset >> 9) + seed);
+}
+
+static void fill_chunk(uint32_t seed, uint32_t offset, size_t n) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    chunk[i] = pattern(seed, offset + (uint32_t)i);
+  }
+}
+
+static bool check_chunk(uint32_t seed, uint32_t offset, size_t n) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    if (chunk[i] != pattern(seed, offset + (uint32_t)i)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void phase_begin(const fatfs_bench_config_t *cfg) {
+
+  sblkResetStats(cfg->sbdp);
+  start = chSysGetRealtimeCounterX();
+}
+
+static void phase_end(const fatfs_bench_config_t *cfg, const char *name,
+                      FRESULT res) {
+  rtcnt_t t = chSysGetRealtimeCounterX() - start;
+  const sim_blk_stats_t *sp = sblkGetStats(cfg->sbdp);
+
+  if (res != FR_OK) {
+    errors++;
+  }
+  chprintf(cfg->out, "%-18s %8d %6d %7d %6d %7d %5d  %s\r\n", name,
+           (uint32_t)(((uint64_t)t * 1000000U) / cfg->rtcfreq),
+           sp->n_reads, sp->n_read_blocks,
+           sp->n_writes, sp->n_written_blocks, sp->n_syncs,
+           res == FR_OK ? "ok" : "FAILED");
+}
+
+static FRESULT write_file(const char *path, uint32_t seed, uint32_t size) {
+  FRESULT res;
+  uint32_t offset;
+  UINT n;
+
+  res = f_open(&file, path, FA_CREATE_ALWAYS | FA_WRITE);
+  if (res != FR_OK) {
+    return res;
+  }
+  for (offset = 0U; offset < size; offset += n) {
+    UINT len = size - offset < sizeof (chunk) ? size - offset : sizeof (chunk);
+
+    fill_chunk(seed, offset, len);
+    res = f_write(&file, chunk, len, &n);
+    if ((res != FR_OK) || (n != len)) {
+      (void) f_close(&file);
+      return res != FR_OK ? res : FR_DISK_ERR;
+    }
+  }
+
+  return f_close(&file);
+}
+
+static FRESULT read_file(const char *path, uint32_t seed, uint32_t size) {
+  FRESULT res;
+  uint32_t offset;
+  UINT n;
+
+  res = f_open(&file, path, FA_READ);
+  if (res != FR_OK) {
+    return res;
+  }
+  if (f_size(&file) != size) {
+    (void) f_close(&file);
+    return FR_INT_ERR;
+  }
+  for (offset = 0U; offset < size; offset += n) {
+    res = f_read(&file, chunk, sizeof (chunk), &n);
+    if ((res != FR_OK) || (n == 0U) || !check_chunk(seed, offset, n)) {
+      (void) f_close(&file);
+      return res != FR_OK ? res : FR_INT_ERR;
+    }
+  }
+
+  return f_close(&file);
+}
+
+static FRESULT small_files(bool write) {
+  FRESULT res;
+  unsigned i;
+  char path[16];
+
+  for (i = 0U; i < FATFS_BENCH_CFG_SMALL_FILES; i++) {
+    chsnprintf(path, sizeof (path), "/dir/f%u.bin", i);
+    if (write) {
+      res = write_file(path, i, 600U + i);
+    }
+    else {
+      res = read_file(path, i, 600U + i);
+    }
+    if (res != FR_OK) {
+      return res;
+    }
+  }
+
+  return FR_OK;
+}
+
+static FRESULT scan_dir(void) {
+  FRESULT res;
+  DIR dir;
+  FILINFO fno;
+  unsigned n = 0U;
+
+  res = f_opendir(&dir, "/dir");
+  if (res != FR_OK) {
+    return res;
+  }
+  while (true) {
+    res = f_readdir(&dir, &fno);
+    if ((res != FR_OK) || (fno.fname[0] == '\0')) {
+      break;
+    }
+    n++;
+  }
+  (void) f_closedir(&dir);
+  if ((res == FR_OK) && (n != FATFS_BENCH_CFG_SMALL_FILES)) {
+    res = FR_INT_ERR;
+  }
+
+  return res;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   FatFS bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void fatfs_bench_execute(const fatfs_bench_config_t *cfg) {
+  static const MKFS_PARM opt = {FM_FAT | FM_SFD, 0, 0, 0, 0};
+  FRESULT res;
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT FATFS-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+#if FATFS_USE_CACHE == TRUE
+  chprintf(cfg->out, "*** Cache:        %d sectors, read ahead %d\r\n",
+           FATFS_CACHE_SECTORS, FATFS_CACHE_READ_AHEAD);
+#else
+  chprintf(cfg->out, "*** Cache:        none\r\n");
+#endif
+  chprintf(cfg->out, "*** Disk:         %d blocks\r\n",
+           cfg->sbdp->config->blk_num);
+  chprintf(cfg->out, "*** File Size:    %d\r\n", FATFS_BENCH_CFG_FILE_SIZE);
+  chprintf(cfg->out, "*** Chunk Size:   %d\r\n", FATFS_BENCH_CFG_CHUNK_SIZE);
+  chprintf(cfg->out, "\r\n");
+
+  res = f_mkfs("", &opt, work, sizeof (work));
+  if (res == FR_OK) {
+    res = f_mount(&fs, "", 1);
+  }
+  if (res == FR_OK) {
+    res = f_mkdir("/dir");
+  }
+  if (res != FR_OK) {
+    chprintf(cfg->out, "File system creation failed (%d)\r\n", res);
+    return;
+  }
+
+  chprintf(cfg->out, "Phase                    us  reads  blocks writes  blocks syncs\r\n");
+
+  phase_begin(cfg);
+  res = write_file("/seq.bin", 0x55U, FATFS_BENCH_CFG_FILE_SIZE);
+  phase_end(cfg, "Sequential write", res);
+
+  phase_begin(cfg);
+  res = read_file("/seq.bin", 0x55U, FATFS_BENCH_CFG_FILE_SIZE);
+  phase_end(cfg, "Sequential read", res);
+
+  phase_begin(cfg);
+  res = small_files(true);
+  phase_end(cfg, "Small files write", res);
+
+  phase_begin(cfg);
+  res = scan_dir();
+  phase_end(cfg, "Directory scan", res);
+
+  phase_begin(cfg);
+  res = small_files(false);
+  phase_end(cfg, "Small files read", res);
+
+  /* Mounting again, the data is read back from the disk.*/
+  phase_begin(cfg);
+  res = f_unmount("");
+  if (res == FR_OK) {
+    res = f_mount(&fs, "", 1);
+  }
+  if (res == FR_OK) {
+    res = read_file("/seq.bin", 0x55U, FATFS_BENCH_CFG_FILE_SIZE);
+  }
+  if (res == FR_OK) {
+    res = small_files(false);
+  }
+  phase_end(cfg, "Remount and verify", res);
+
+  chprintf(cfg->out, "Errors: %d\r\n", errors);
+
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
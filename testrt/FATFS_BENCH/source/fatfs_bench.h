@@ -0,0 +1,109 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_bench.h
+ * @brief   FatFS Bench benchmark header.
+ *
+ * @addtogroup FATFS_BENCH
+ * @{
+ */
+
+#ifndef FATFS_BENCH_H
+#define FATFS_BENCH_H
+
+#include "simblk.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the file used for sequential accesses.
+ */
+#if !defined(FATFS_BENCH_CFG_FILE_SIZE) || defined(__DOXYGEN__)
+#define FATFS_BENCH_CFG_FILE_SIZE           (1024 * 1024)
+#endif
+
+/**
+ * @brief   Size of the chunks used for sequential accesses.
+ */
+#if !defined(FATFS_BENCH_CFG_CHUNK_SIZE) || defined(__DOXYGEN__)
+#define FATFS_BENCH_CFG_CHUNK_SIZE          256
+#endif
+
+/**
+ * @brief   Number of small files.
+ */
+#if !defined(FATFS_BENCH_CFG_SMALL_FILES) || defined(__DOXYGEN__)
+#define FATFS_BENCH_CFG_SMALL_FILES         32
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Realtime counter frequency.
+   */
+  uint32_t              rtcfreq;
+  /**
+   * @brief   Block device used by the file system.
+   */
+  SimBlockDevice        *sbdp;
+} fatfs_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void fatfs_bench_execute(const fatfs_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* FATFS_BENCH_H */
+
+/** @} */
@@ -0,0 +1,115 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    portab.c
+ * @brief   Application portability module code.
+ *
+ * @addtogroup application_portability
+ * @{
+ */
+
+#include <stdio.h>
+
+#include "hal.h"
+#include "hal_queues_test.h"
+
+#include "portab.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions prototypes.                                        */
+/*===========================================================================*/
+
+static size_t _write(void *ip, const uint8_t *bp, size_t n);
+static size_t _read(void *ip, uint8_t *bp, size_t n);
+static msg_t _put(void *ip, uint8_t b);
+static msg_t _get(void *ip);
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*
+ * Stream writing on the host standard output.
+ */
+static const struct BaseSequentialStreamVMT vmt = {
+  (size_t)0, _write, _read, _put, _get
+};
+
+static BaseSequentialStream stdout_stream = {&vmt};
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*
+ * HAL queues test configuration.
+ */
+const hal_queues_test_config_t portab_hal_queues_test_config = {
+  &stdout_stream
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static size_t _write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+
+  return fwrite(bp, 1, n, stdout);
+}
+
+static size_t _read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return (size_t)0;
+}
+
+static msg_t _put(void *ip, uint8_t b) {
+
+  (void)ip;
+
+  return putchar((int)b) == EOF ? MSG_RESET : MSG_OK;
+}
+
+static msg_t _get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+void portab_setup(void) {
+
+}
+
+/** @} */
@@ -0,0 +1,303 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_queues_test.c
+ * @brief   HAL queues test code.
+ * @details The zero-copy peek/consume and reserve/commit functions of the
+ *          HAL I/O queues are exercised with the queue pointers placed near
+ *          the end of the buffer, the returned spans must wrap around and
+ *          the low side must be notified on consume and commit.
+ *
+ * @addtogroup HAL_QUEUES_TEST
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "hal_queues_test.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/* Size of the queues buffers.*/
+#define QUEUE_SIZE                  16U
+
+/* Offset of the queues pointers when starting a test case.*/
+#define QUEUE_OFFSET                10U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+typedef struct {
+  const char                *name;
+  bool                      (*fn)(void);
+} queues_case_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static uint8_t iq_buffer[QUEUE_SIZE];
+static uint8_t oq_buffer[QUEUE_SIZE];
+static input_queue_t iq;
+static output_queue_t oq;
+static unsigned notifications;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void notify(io_queue_t *qp) {
+
+  (void)qp;
+
+  notifications++;
+}
+
+/*
+ * Input queue with the read pointer at QUEUE_OFFSET and the specified
+ * number of bytes queued, byte values follow their position in the
+ * stream.
+ */
+static void iq_prepare(size_t n) {
+  size_t i;
+
+  iqObjectInit(&iq, iq_buffer, QUEUE_SIZE, notify, NULL);
+  osalSysLock();
+  for (i = 0U; i < QUEUE_OFFSET; i++) {
+    (void) iqPutI(&iq, 0xFFU);
+    (void) iqGetI(&iq);
+  }
+  for (i = 0U; i < n; i++) {
+    (void) iqPutI(&iq, (uint8_t)i);
+  }
+  osalSysUnlock();
+  notifications = 0U;
+}
+
+/*
+ * Empty output queue with the write pointer at QUEUE_OFFSET.
+ */
+static void oq_prepare(void) {
+  size_t i;
+
+  oqObjectInit(&oq, oq_buffer, QUEUE_SIZE, notify, NULL);
+  osalSysLock();
+  for (i = 0U; i < QUEUE_OFFSET; i++) {
+    (void) oqPutI(&oq, 0xFFU);
+    (void) oqGetI(&oq);
+  }
+  osalSysUnlock();
+  notifications = 0U;
+}
+
+static bool check_span(const uint8_t *p, size_t n, uint8_t first) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    if (p[i] != (uint8_t)(first + i)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool iq_peek_wrap(void) {
+  io_queue_span_t span;
+  size_t n;
+  msg_t msg;
+
+  iq_prepare(12U);
+
+  osalSysLock();
+  n = iqPeekI(&iq, &span);
+  osalSysUnlock();
+
+  if ((n != 12U) ||
+      (span.p1 != &iq_buffer[QUEUE_OFFSET]) || (span.n1 != 6U) ||
+      (span.p2 != &iq_buffer[0]) || (span.n2 != 6U) ||
+      !check_span(span.p1, span.n1, 0U) ||
+      !check_span(span.p2, span.n2, 6U)) {
+    return false;
+  }
+
+  /* Consuming across the buffer end.*/
+  iqConsume(&iq, 7U);
+  if (notifications != 1U) {
+    return false;
+  }
+  msg = iqGetTimeout(&iq, TIME_IMMEDIATE);
+
+  osalSysLock();
+  n = iqGetFullI(&iq);
+  osalSysUnlock();
+
+  return (msg == (msg_t)7) && (n == 4U);
+}
+
+static bool iq_peek_exact_end(void) {
+  io_queue_span_t span;
+  size_t n;
+
+  iq_prepare(6U);
+
+  n = iqPeekTimeout(&iq, 6U, &span, TIME_IMMEDIATE);
+  if ((n != 6U) || (span.n1 != 6U) || (span.p2 != NULL) ||
+      (span.n2 != 0U)) {
+    return false;
+  }
+
+  /* Consuming up to the buffer end, the read pointer must wrap.*/
+  iqConsume(&iq, 6U);
+  osalSysLock();
+  (void) iqPutI(&iq, 0x55U);
+  n = iqPeekI(&iq, &span);
+  osalSysUnlock();
+
+  return (n == 1U) && (span.p1 == &iq_buffer[0]) && (span.n1 == 1U) &&
+         (iqGetTimeout(&iq, TIME_IMMEDIATE) == (msg_t)0x55);
+}
+
+static bool iq_peek_timeout(void) {
+  io_queue_span_t span;
+
+  iq_prepare(3U);
+
+  return (iqPeekTimeout(&iq, 4U, &span, TIME_IMMEDIATE) == 0U) &&
+         (iqPeekTimeout(&iq, 3U, &span, TIME_IMMEDIATE) == 3U);
+}
+
+static bool oq_reserve_wrap(void) {
+  io_queue_span_t span;
+  size_t i, n;
+
+  oq_prepare();
+
+  n = oqReserveTimeout(&oq, 12U, &span, TIME_IMMEDIATE);
+  if ((n != QUEUE_SIZE) ||
+      (span.p1 != &oq_buffer[QUEUE_OFFSET]) ||
+      (span.n1 != QUEUE_SIZE - QUEUE_OFFSET) ||
+      (span.p2 != &oq_buffer[0]) || (span.n2 != QUEUE_OFFSET)) {
+    return false;
+  }
+
+  /* Filling and committing across the buffer end.*/
+  for (i = 0U; i < 12U; i++) {
+    if (i < span.n1) {
+      span.p1[i] = (uint8_t)i;
+    }
+    else {
+      span.p2[i - span.n1] = (uint8_t)i;
+    }
+  }
+  oqCommit(&oq, 12U);
+
+  /* The low side must get the data in order.*/
+  osalSysLock();
+  n = oqGetEmptyI(&oq);
+  if ((notifications != 1U) || (n != QUEUE_SIZE - 12U)) {
+    osalSysUnlock();
+    return false;
+  }
+  for (i = 0U; i < 12U; i++) {
+    if (oqGetI(&oq) != (msg_t)i) {
+      break;
+    }
+  }
+  osalSysUnlock();
+
+  return i == 12U;
+}
+
+static bool oq_reserve_timeout(void) {
+  io_queue_span_t span;
+  size_t n;
+
+  oq_prepare();
+
+  n = oqReserveTimeout(&oq, QUEUE_SIZE, &span, TIME_IMMEDIATE);
+  oqCommit(&oq, n);
+  if (oqReserveTimeout(&oq, 1U, &span, TIME_IMMEDIATE) != 0U) {
+    return false;
+  }
+
+  /* A zero commit does nothing.*/
+  notifications = 0U;
+  oqCommit(&oq, 0U);
+
+  return notifications == 0U;
+}
+
+static const queues_case_t cases[] = {
+  {"iq peek wraparound",      iq_peek_wrap},
+  {"iq peek buffer end",      iq_peek_exact_end},
+  {"iq peek timeout",         iq_peek_timeout},
+  {"oq reserve wraparound",   oq_reserve_wrap},
+  {"oq reserve timeout",      oq_reserve_timeout}
+};
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Executes the HAL queues test cases.
+ *
+ * @param[in] cfg       test configuration
+ * @return              The number of failed test cases.
+ */
+unsigned hal_queues_test_execute(const hal_queues_test_config_t *cfg) {
+  unsigned i, failed = 0U;
+
+  /* Test header.*/
+  chprintf(cfg->out, "\r\n*** ChibiOS/HAL queues test\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+  chprintf(cfg->out, "\r\n");
+
+  for (i = 0U; i < sizeof (cases) / sizeof (cases[0]); i++) {
+    bool ok = cases[i].fn();
+
+    chprintf(cfg->out, "%-24s %s\r\n", cases[i].name, ok ? "PASS" : "FAIL");
+    if (!ok) {
+      failed++;
+    }
+  }
+
+  chprintf(cfg->out, "\r\nFailed: %d\r\n\r\n", failed);
+
+  return failed;
+}
+
+/** @} */
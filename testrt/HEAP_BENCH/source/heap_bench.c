@@ -0,0 +1,249 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    heap_bench.c
+ * @brief   Heap Bench benchmark code.
+ *
+ * @addtogroup HEAP_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "heap_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*
+ * Allocation sizes profile.
+ */
+typedef struct {
+  const char            *name;
+  size_t                min;
+  size_t                max;
+} bench_profile_t;
+
+/*
+ * Measurements of a single run.
+ */
+typedef struct {
+  rtcnt_t               alloc_sum;
+  rtcnt_t               alloc_max;
+  unsigned              allocs;
+  rtcnt_t               free_sum;
+  rtcnt_t               free_max;
+  unsigned              frees;
+  unsigned              fails;
+  size_t                frags;
+  size_t                total;
+  size_t                largest;
+} bench_stats_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static const bench_profile_t profiles[] = {
+  {"small", 8U,   64U},
+  {"mixed", 8U,   1024U},
+  {"large", 128U, 1024U}
+};
+
+static CH_HEAP_AREA(heap_area, HEAP_BENCH_CFG_HEAP_SIZE);
+static memory_heap_t heap;
+static void *slots[HEAP_BENCH_CFG_SLOTS];
+static uint32_t seed;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Pseudo-random numbers, a simple LCG is enough.
+ */
+static uint32_t rnd(void) {
+
+  seed = (seed * 1664525U) + 1013904223U;
+  return seed >> 8;
+}
+
+/*
+ * Returns the duration of an operation in nanoseconds.
+ */
+static uint32_t to_ns(const heap_bench_config_t *cfg,
+                      rtcnt_t cnt, unsigned n) {
+
+  if (n == 0U) {
+    return 0U;
+  }
+
+  return (uint32_t)(((uint64_t)cnt * 1000000000ULL) /
+                    ((uint64_t)cfg->rtcfreq * n));
+}
+
+/*
+ * Random allocate/free sequence over the slots array, the same sequence is
+ * replayed for each engine.
+ */
+static void bench_run(const bench_profile_t *pp, bench_stats_t *sp) {
+  unsigned i;
+
+  memset(sp, 0, sizeof (bench_stats_t));
+  memset(slots, 0, sizeof (slots));
+  seed = 1U;
+
+  for (i = 0U; i < HEAP_BENCH_CFG_CYCLES; i++) {
+    unsigned slot = rnd() % HEAP_BENCH_CFG_SLOTS;
+    rtcnt_t start, t;
+
+    if (slots[slot] != NULL) {
+      start = chSysGetRealtimeCounterX();
+      chHeapFree(slots[slot]);
+      t = chSysGetRealtimeCounterX() - start;
+      slots[slot] = NULL;
+      sp->free_sum += t;
+      if (t > sp->free_max) {
+        sp->free_max = t;
+      }
+      sp->frees++;
+    }
+    else {
+      size_t size = pp->min + (rnd() % ((pp->max - pp->min) + 1U));
+
+      start = chSysGetRealtimeCounterX();
+      slots[slot] = chHeapAlloc(&heap, size);
+      t = chSysGetRealtimeCounterX() - start;
+      sp->alloc_sum += t;
+      if (t > sp->alloc_max) {
+        sp->alloc_max = t;
+      }
+      sp->allocs++;
+
+      /* Failures are counted only if there was enough free space, those
+         are caused by fragmentation.*/
+      if (slots[slot] == NULL) {
+        size_t total;
+
+        (void)chHeapStatus(&heap, &total, NULL);
+        if (total >= size) {
+          sp->fails++;
+        }
+      }
+    }
+  }
+
+  /* Fragmentation at the end of the sequence.*/
+  sp->frags = chHeapStatus(&heap, &sp->total, &sp->largest);
+
+  /* Releasing everything.*/
+  for (i = 0U; i < HEAP_BENCH_CFG_SLOTS; i++) {
+    if (slots[i] != NULL) {
+      chHeapFree(slots[i]);
+    }
+  }
+}
+
+static void bench_print(const heap_bench_config_t *cfg, const char *engine,
+                        const bench_profile_t *pp, const bench_stats_t *sp) {
+  unsigned frag = 0U;
+
+  if (sp->total > 0U) {
+    frag = 100U - (unsigned)((sp->largest * 100U) / sp->total);
+  }
+
+  chprintf(cfg->out, "%-9s  %-7s  %9d  %7d  %8d  %7d  %5d  %5d  %7d\r\n",
+           engine, pp->name,
+           to_ns(cfg, sp->alloc_sum, sp->allocs), to_ns(cfg, sp->alloc_max, 1U),
+           to_ns(cfg, sp->free_sum, sp->frees), to_ns(cfg, sp->free_max, 1U),
+           sp->fails, (unsigned)sp->frags, frag);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Heap bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void heap_bench_execute(const heap_bench_config_t *cfg) {
+  unsigned i;
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT HEAP-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+  chprintf(cfg->out, "*** Heap Size:    %d\r\n", HEAP_BENCH_CFG_HEAP_SIZE);
+  chprintf(cfg->out, "*** TLSF Control: %d\r\n", (int)sizeof (heap_tlsf_t));
+  chprintf(cfg->out, "*** Slots:        %d\r\n", HEAP_BENCH_CFG_SLOTS);
+  chprintf(cfg->out, "*** Cycles:       %d\r\n", HEAP_BENCH_CFG_CYCLES);
+  chprintf(cfg->out, "\r\n");
+  chprintf(cfg->out, "Engine     Profile  Alloc(ns)  Max(ns)  Free(ns)  Max(ns)"
+                     "  Fails  Frags  Frag(%%)\r\n");
+
+  for (i = 0U; i < sizeof (profiles) / sizeof (profiles[0]); i++) {
+    bench_stats_t stats;
+
+    chHeapObjectInit(&heap, heap_area, sizeof (heap_area));
+    bench_run(&profiles[i], &stats);
+    bench_print(cfg, "first-fit", &profiles[i], &stats);
+
+    chHeapObjectInitTLSF(&heap, heap_area, sizeof (heap_area), NULL);
+    bench_run(&profiles[i], &stats);
+    bench_print(cfg, "tlsf", &profiles[i], &stats);
+  }
+
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
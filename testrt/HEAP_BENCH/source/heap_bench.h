@@ -0,0 +1,107 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    heap_bench.h
+ * @brief   Heap Bench benchmark header.
+ *
+ * @addtogroup HEAP_BENCH
+ * @{
+ */
+
+#ifndef HEAP_BENCH_H
+#define HEAP_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the heap areas used during the test.
+ */
+#if !defined(HEAP_BENCH_CFG_HEAP_SIZE) || defined(__DOXYGEN__)
+#define HEAP_BENCH_CFG_HEAP_SIZE            524288
+#endif
+
+/**
+ * @brief   Maximum number of blocks allocated at the same time.
+ */
+#if !defined(HEAP_BENCH_CFG_SLOTS) || defined(__DOXYGEN__)
+#define HEAP_BENCH_CFG_SLOTS                1024
+#endif
+
+/**
+ * @brief   Number of allocate/free operations for each measurement.
+ */
+#if !defined(HEAP_BENCH_CFG_CYCLES) || defined(__DOXYGEN__)
+#define HEAP_BENCH_CFG_CYCLES               200000
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_HEAP_USE_TLSF == FALSE
+#error "HEAP_BENCH requires CH_CFG_HEAP_USE_TLSF"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Realtime counter frequency.
+   */
+  uint32_t              rtcfreq;
+} heap_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void heap_bench_execute(const heap_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* HEAP_BENCH_H */
+
+/** @} */
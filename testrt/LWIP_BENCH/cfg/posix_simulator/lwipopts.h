@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2001-2003 Swedish Institute of Computer Science.
+ * All rights reserved. 
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED 
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+ * SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT 
+ * OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING 
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+ * OF SUCH DAMAGE.
+ *
+ * This file is part of the lwIP TCP/IP stack.
+ * 
+ * Author: Simon Goldschmidt
+ *
+ */
+#ifndef LWIP_HDR_LWIPOPTS_H__
+#define LWIP_HDR_LWIPOPTS_H__
+
+/* Fixed settings mandated by the ChibiOS integration.*/
+#include "static_lwipopts.h"
+
+/* Optional, application-specific settings.*/
+#if !defined(TCPIP_MBOX_SIZE)
+#define TCPIP_MBOX_SIZE                 MEMP_NUM_PBUF
+#endif
+#if !defined(TCPIP_THREAD_STACKSIZE)
+#define TCPIP_THREAD_STACKSIZE          4096
+#endif
+#if !defined(LWIP_THREAD_STACK_SIZE)
+#define LWIP_THREAD_STACK_SIZE          4096
+#endif
+
+/* The simulator HAL includes the host network headers, the equivalent
+   lwIP definitions must be disabled.*/
+#define LWIP_SOCKET                     0
+#define LWIP_DONT_PROVIDE_BYTEORDER_FUNCTIONS 1
+
+/* Frames sent to our own address go through the loopback MAC.*/
+#define LWIP_NETIF_LOOPBACK             0
+
+/* Zero-copy MAC interface, custom pbufs are required.*/
+#define LWIP_SUPPORT_CUSTOM_PBUF        1
+#if !defined(LWIP_USE_ZERO_COPY)
+#define LWIP_USE_ZERO_COPY              TRUE
+#endif
+#if !defined(LWIP_RX_BATCH_SIZE)
+#define LWIP_RX_BATCH_SIZE              8
+#endif
+
+/* Use ChibiOS specific priorities. */
+#if !defined(TCPIP_THREAD_PRIO)
+#define TCPIP_THREAD_PRIO               (LOWPRIO + 1)
+#endif
+#if !defined(LWIP_THREAD_PRIORITY)
+#define LWIP_THREAD_PRIORITY            (LOWPRIO)
+#endif
+
+#endif /* LWIP_HDR_LWIPOPTS_H__ */
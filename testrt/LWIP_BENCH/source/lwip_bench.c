@@ -0,0 +1,250 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    lwip_bench.c
+ * @brief   lwIP Bench benchmark code.
+ * @details UDP datagrams are sent to the local address, the frames go
+ *          through the whole stack and the MAC driver, which must be
+ *          a loopback device.
+ *
+ * @addtogroup LWIP_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "lwipthread.h"
+#include <lwip/netif.h>
+#include <lwip/tcpip.h>
+#include <lwip/udp.h>
+
+#include "lwip_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Largest payload not requiring IP fragmentation.
+ */
+#define BENCH_MAX_PAYLOAD       (LWIP_NETIF_MTU - 28)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static const size_t sizes[] = {64U, BENCH_MAX_PAYLOAD};
+
+static uint8_t payload[BENCH_MAX_PAYLOAD];
+static struct udp_pcb *pcb;
+static semaphore_t rxsem;
+static size_t rxsize;
+static uint32_t rxbad;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Datagrams receive callback, executed in the stack context.
+ */
+static void bench_recv(void *arg, struct udp_pcb *upcb, struct pbuf *p,
+                       const ip_addr_t *addr, u16_t port) {
+
+  (void)arg;
+  (void)upcb;
+  (void)addr;
+  (void)port;
+
+  if ((p->tot_len != rxsize) ||
+      (pbuf_memcmp(p, 0U, payload, p->tot_len) != 0U)) {
+    rxbad++;
+  }
+  pbuf_free(p);
+
+  chSemSignal(&rxsem);
+}
+
+/*
+ * Sends a datagram to the local address, the payload is referenced, not
+ * copied, so the frame is made of a chain of two pbufs.
+ */
+static bool bench_send(size_t size) {
+  struct pbuf *p;
+  err_t err;
+
+  p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)size, PBUF_REF);
+  if (p == NULL) {
+    return false;
+  }
+  p->payload = payload;
+
+  LOCK_TCPIP_CORE();
+  err = udp_sendto(pcb, p, netif_ip_addr4(netif_default),
+                   LWIP_BENCH_CFG_PORT);
+  UNLOCK_TCPIP_CORE();
+  pbuf_free(p);
+
+  return err == ERR_OK;
+}
+
+/*
+ * Sends datagrams keeping a window of them in flight, returns the number
+ * of datagrams per second.
+ */
+static uint32_t bench_run(const lwip_bench_config_t *cfg,
+                          size_t size, uint32_t *lostp) {
+  uint32_t i, inflight, lost;
+  rtcnt_t start, t;
+
+  chSemReset(&rxsem, (cnt_t)0);
+  rxsize   = size;
+  inflight = 0U;
+  lost     = 0U;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < LWIP_BENCH_CFG_DATAGRAMS; i++) {
+    if (inflight >= LWIP_BENCH_CFG_WINDOW) {
+      if (chSemWaitTimeout(&rxsem, TIME_MS2I(100)) == MSG_OK) {
+        inflight--;
+      }
+      else {
+        lost += inflight;
+        inflight = 0U;
+      }
+    }
+    if (bench_send(size)) {
+      inflight++;
+    }
+    else {
+      lost++;
+    }
+  }
+  while (inflight > 0U) {
+    if (chSemWaitTimeout(&rxsem, TIME_MS2I(100)) != MSG_OK) {
+      lost += inflight;
+      break;
+    }
+    inflight--;
+  }
+  t = chSysGetRealtimeCounterX() - start;
+  if (t == (rtcnt_t)0) {
+    t = (rtcnt_t)1;
+  }
+
+  *lostp = lost;
+
+  return (uint32_t)(((uint64_t)LWIP_BENCH_CFG_DATAGRAMS * cfg->rtcfreq) / t);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   lwIP bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void lwip_bench_execute(const lwip_bench_config_t *cfg) {
+  unsigned i;
+  uint32_t lost;
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT LWIP-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+  chprintf(cfg->out, "*** Zero Copy:    %s\r\n",
+           LWIP_USE_ZERO_COPY == TRUE ? "yes" : "no");
+  chprintf(cfg->out, "*** RX Batch:     %d\r\n", LWIP_RX_BATCH_SIZE);
+  chprintf(cfg->out, "*** Window:       %d\r\n", LWIP_BENCH_CFG_WINDOW);
+  chprintf(cfg->out, "*** Datagrams:    %d\r\n", LWIP_BENCH_CFG_DATAGRAMS);
+  chprintf(cfg->out, "\r\n");
+
+  for (i = 0U; i < sizeof (payload); i++) {
+    payload[i] = (uint8_t)i;
+  }
+  chSemObjectInit(&rxsem, (cnt_t)0);
+
+  lwipInit(NULL);
+
+  LOCK_TCPIP_CORE();
+  pcb = udp_new();
+  if (pcb != NULL) {
+    (void) udp_bind(pcb, IP4_ADDR_ANY, LWIP_BENCH_CFG_PORT);
+    udp_recv(pcb, bench_recv, NULL);
+  }
+  UNLOCK_TCPIP_CORE();
+  if (pcb == NULL) {
+    chprintf(cfg->out, "UDP PCB allocation failed\r\n");
+    return;
+  }
+
+  /* The first datagram also resolves our own address.*/
+  rxsize = 16U;
+  (void) bench_send(16U);
+  if (chSemWaitTimeout(&rxsem, TIME_S2I(1)) != MSG_OK) {
+    chprintf(cfg->out, "Loopback not working\r\n");
+    return;
+  }
+
+  chprintf(cfg->out, "Payload  datagrams/s      kB/s   lost\r\n");
+  for (i = 0U; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+    uint32_t dps = bench_run(cfg, sizes[i], &lost);
+
+    chprintf(cfg->out, "%7d  %11d  %8d  %5d\r\n",
+             (int)sizes[i], dps, (dps * sizes[i]) / 1024U, lost);
+  }
+  chprintf(cfg->out, "Bad datagrams: %d\r\n", rxbad);
+
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
@@ -0,0 +1,104 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    lwip_bench.h
+ * @brief   lwIP Bench benchmark header.
+ *
+ * @addtogroup LWIP_BENCH
+ * @{
+ */
+
+#ifndef LWIP_BENCH_H
+#define LWIP_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of datagrams sent for each measurement.
+ */
+#if !defined(LWIP_BENCH_CFG_DATAGRAMS) || defined(__DOXYGEN__)
+#define LWIP_BENCH_CFG_DATAGRAMS            20000
+#endif
+
+/**
+ * @brief   Maximum number of datagrams in flight.
+ * @note    Must be lower than the number of MAC receive buffers.
+ */
+#if !defined(LWIP_BENCH_CFG_WINDOW) || defined(__DOXYGEN__)
+#define LWIP_BENCH_CFG_WINDOW               4
+#endif
+
+/**
+ * @brief   UDP port used by the test.
+ */
+#if !defined(LWIP_BENCH_CFG_PORT) || defined(__DOXYGEN__)
+#define LWIP_BENCH_CFG_PORT                 7777
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Realtime counter frequency.
+   */
+  uint32_t              rtcfreq;
+} lwip_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void lwip_bench_execute(const lwip_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* LWIP_BENCH_H */
+
+/** @} */
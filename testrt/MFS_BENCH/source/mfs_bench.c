@@ -0,0 +1,265 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    mfs_bench.c
+ * @brief   MFS Bench benchmark code.
+ * @details The file system is created on a simulated flash, records are
+ *          updated repeatedly in order to measure the flash operations and
+ *          the wear caused by garbage collection.
+ *
+ * @addtogroup MFS_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "mfs_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static MFSDriver mfs;
+static uint8_t buffer[MFS_BENCH_CFG_RECORD_SIZE];
+static uint32_t seeds[MFS_BENCH_CFG_RECORDS];
+static rtcnt_t start;
+static uint32_t gcs;
+static uint32_t errors;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Pattern byte at the specified record offset.
+ */
+static uint8_t pattern(uint32_t seed, uint32_t offset) {
+
+  return (uint8_t)((offset * 7U) + (seed >> 8) + seed);
+}
+
+/*
+ * Record size for the specified seed, between half and full size.
+ */
+static size_t record_size(uint32_t seed) {
+
+  return (size_t)((MFS_BENCH_CFG_RECORD_SIZE / 2) +
+                  (seed % ((MFS_BENCH_CFG_RECORD_SIZE / 2) + 1)));
+}
+
+/*
+ * Error codes accounting, warnings are not errors.
+ */
+static mfs_error_t account(mfs_error_t err) {
+
+  if (err == MFS_WARN_GC) {
+    gcs++;
+  }
+
+  return err < MFS_NO_ERROR ? err : MFS_NO_ERROR;
+}
+
+static mfs_error_t write_record(mfs_id_t id, uint32_t seed) {
+  size_t i, n = record_size(seed);
+
+  for (i = 0U; i < n; i++) {
+    buffer[i] = pattern(seed, (uint32_t)i);
+  }
+  seeds[id - 1U] = seed;
+
+  return account(mfsWriteRecord(&mfs, id, n, buffer));
+}
+
+static mfs_error_t write_records(uint32_t seed, uint32_t n) {
+  mfs_error_t err;
+  uint32_t i;
+
+  for (i = 0U; i < n; i++) {
+    err = write_record((mfs_id_t)((i % MFS_BENCH_CFG_RECORDS) + 1U),
+                       seed + i);
+    if (err != MFS_NO_ERROR) {
+      return err;
+    }
+  }
+
+  return MFS_NO_ERROR;
+}
+
+static mfs_error_t check_records(void) {
+  mfs_error_t err;
+  mfs_id_t id;
+  size_t i, n;
+
+  for (id = 1U; id <= MFS_BENCH_CFG_RECORDS; id++) {
+    n = sizeof (buffer);
+    err = mfsReadRecord(&mfs, id, &n, buffer);
+    if (err != MFS_NO_ERROR) {
+      return err;
+    }
+    if (n != record_size(seeds[id - 1U])) {
+      return MFS_ERR_INTERNAL;
+    }
+    for (i = 0U; i < n; i++) {
+      if (buffer[i] != pattern(seeds[id - 1U], (uint32_t)i)) {
+        return MFS_ERR_INTERNAL;
+      }
+    }
+  }
+
+  return MFS_NO_ERROR;
+}
+
+static void phase_begin(const mfs_bench_config_t *cfg) {
+
+  eflSimResetStats(cfg->eflp);
+  gcs = 0U;
+  start = chSysGetRealtimeCounterX();
+}
+
+static void phase_end(const mfs_bench_config_t *cfg, const char *name,
+                      mfs_error_t err) {
+  rtcnt_t t = chSysGetRealtimeCounterX() - start;
+  const efl_sim_stats_t *sp = eflSimGetStats(cfg->eflp);
+
+  if (err != MFS_NO_ERROR) {
+    errors++;
+  }
+  chprintf(cfg->out, "%-18s %8d %6d %6d %7d %6d %4d %9d  %s\r\n", name,
+           (uint32_t)(((uint64_t)t * 1000000U) / cfg->rtcfreq),
+           sp->n_reads, sp->n_programs, sp->programmed_bytes,
+           sp->n_erases, gcs, (uint32_t)sp->busy_time,
+           err == MFS_NO_ERROR ? "ok" : "FAILED");
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   MFS bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void mfs_bench_execute(const mfs_bench_config_t *cfg) {
+  const flash_descriptor_t *fdp = flashGetDescriptor(cfg->eflp);
+  flash_sector_t sector;
+  mfs_error_t err;
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT MFS-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+  chprintf(cfg->out, "*** Flash:        %d sectors of %d bytes\r\n",
+           fdp->sectors_count, fdp->sectors_size);
+  chprintf(cfg->out, "*** Bank Size:    %d\r\n", cfg->mfscfgp->bank_size);
+  chprintf(cfg->out, "*** Records:      %d of up to %d bytes\r\n",
+           MFS_BENCH_CFG_RECORDS, MFS_BENCH_CFG_RECORD_SIZE);
+  chprintf(cfg->out, "*** Updates:      %d\r\n", MFS_BENCH_CFG_UPDATES);
+  chprintf(cfg->out, "\r\n");
+
+  chprintf(cfg->out, "Phase                    us  reads  pgms    bytes erases  gcs    busy us\r\n");
+
+  mfsObjectInit(&mfs);
+
+  phase_begin(cfg);
+  err = account(mfsStart(&mfs, cfg->mfscfgp));
+  if (err == MFS_NO_ERROR) {
+    err = account(mfsErase(&mfs));
+  }
+  phase_end(cfg, "Format", err);
+  if (err != MFS_NO_ERROR) {
+    chprintf(cfg->out, "File system creation failed (%d)\r\n", err);
+    return;
+  }
+
+  phase_begin(cfg);
+  err = write_records(0U, MFS_BENCH_CFG_RECORDS);
+  phase_end(cfg, "Records creation", err);
+
+  phase_begin(cfg);
+  err = write_records(MFS_BENCH_CFG_RECORDS, MFS_BENCH_CFG_UPDATES);
+  phase_end(cfg, "Records update", err);
+
+  phase_begin(cfg);
+  err = check_records();
+  phase_end(cfg, "Records read", err);
+
+  phase_begin(cfg);
+  err = account(mfsPerformGarbageCollection(&mfs));
+  if (err == MFS_NO_ERROR) {
+    err = check_records();
+  }
+  phase_end(cfg, "Forced GC", err);
+
+  /* Starting again, the state is rebuilt by scanning the flash.*/
+  phase_begin(cfg);
+  mfsStop(&mfs);
+  err = account(mfsStart(&mfs, cfg->mfscfgp));
+  if (err == MFS_NO_ERROR) {
+    err = check_records();
+  }
+  phase_end(cfg, "Restart and verify", err);
+
+  mfsStop(&mfs);
+
+  chprintf(cfg->out, "Errors: %d\r\n", errors);
+
+  chprintf(cfg->out, "\r\nSector erases:");
+  for (sector = 0U; sector < fdp->sectors_count; sector++) {
+    chprintf(cfg->out, " %d", eflSimGetEraseCount(cfg->eflp, sector));
+  }
+  chprintf(cfg->out, "\r\n");
+
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
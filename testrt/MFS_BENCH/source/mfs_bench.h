@@ -0,0 +1,117 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    mfs_bench.h
+ * @brief   MFS Bench benchmark header.
+ *
+ * @addtogroup MFS_BENCH
+ * @{
+ */
+
+#ifndef MFS_BENCH_H
+#define MFS_BENCH_H
+
+#include "hal_mfs.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of records used by the test.
+ */
+#if !defined(MFS_BENCH_CFG_RECORDS) || defined(__DOXYGEN__)
+#define MFS_BENCH_CFG_RECORDS               8
+#endif
+
+/**
+ * @brief   Maximum size of the records.
+ */
+#if !defined(MFS_BENCH_CFG_RECORD_SIZE) || defined(__DOXYGEN__)
+#define MFS_BENCH_CFG_RECORD_SIZE           64
+#endif
+
+/**
+ * @brief   Number of record updates.
+ */
+#if !defined(MFS_BENCH_CFG_UPDATES) || defined(__DOXYGEN__)
+#define MFS_BENCH_CFG_UPDATES               4000
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if MFS_BENCH_CFG_RECORDS > MFS_CFG_MAX_RECORDS
+#error "MFS_BENCH_CFG_RECORDS exceeds MFS_CFG_MAX_RECORDS"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Realtime counter frequency.
+   */
+  uint32_t              rtcfreq;
+  /**
+   * @brief   Simulated flash used by the file system.
+   */
+  EFlashDriver          *eflp;
+  /**
+   * @brief   MFS configuration.
+   */
+  const MFSConfig       *mfscfgp;
+} mfs_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mfs_bench_execute(const mfs_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* MFS_BENCH_H */
+
+/** @} */
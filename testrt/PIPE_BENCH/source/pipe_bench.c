@@ -0,0 +1,242 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    pipe_bench.c
+ * @brief   Pipe Bench benchmark code.
+ *
+ * @addtogroup PIPE_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "pipe_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Context switches counter.
+ * @note    Incremented by @p CH_CFG_CONTEXT_SWITCH_HOOK() in @p chconf.h.
+ */
+volatile uint32_t pipe_bench_ctxsw;
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*
+ * Threads priorities scenario.
+ */
+typedef struct {
+  const char            *name;
+  tprio_t               wrprio;
+  tprio_t               rdprio;
+} bench_scenario_t;
+
+/*
+ * Transfer parameters.
+ */
+typedef struct {
+  size_t                chunk;
+  size_t                total;
+} bench_transfer_t;
+
+/*===========================================================================*/
+/* Module local functions prototypes.                                        */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static const bench_scenario_t scenarios[] = {
+  {"wr=rd", NORMALPRIO + 1, NORMALPRIO + 1},
+  {"wr<rd", NORMALPRIO + 1, NORMALPRIO + 2},
+  {"wr>rd", NORMALPRIO + 2, NORMALPRIO + 1}
+};
+
+static const size_t chunks[] = {16U, 64U, 256U};
+
+static uint8_t pipe_buffer[PIPE_BENCH_CFG_BUFFER_SIZE];
+static pipe_t pipe1;
+
+static uint8_t wrbuf[256];
+static uint8_t rdbuf[256];
+
+static THD_WORKING_AREA(waWriter, PIPE_BENCH_CFG_WA_SIZE);
+static THD_WORKING_AREA(waReader, PIPE_BENCH_CFG_WA_SIZE);
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Writer thread, writes the whole amount of data in chunks.
+ */
+static THD_FUNCTION(Writer, arg) {
+  const bench_transfer_t *tp = (const bench_transfer_t *)arg;
+  size_t n = tp->total;
+
+  while (n > 0U) {
+    n -= chPipeWriteTimeout(&pipe1, wrbuf, tp->chunk, TIME_INFINITE);
+  }
+}
+
+/*
+ * Reader thread, reads the whole amount of data in chunks.
+ */
+static THD_FUNCTION(Reader, arg) {
+  const bench_transfer_t *tp = (const bench_transfer_t *)arg;
+  size_t n = tp->total;
+
+  while (n > 0U) {
+    n -= chPipeReadTimeout(&pipe1, rdbuf, tp->chunk, TIME_INFINITE);
+  }
+}
+
+/*
+ * Transfers the data between a writer and a reader thread, returns the
+ * throughput in kB/s and the number of context switches per MB.
+ */
+static uint32_t bench_run(const pipe_bench_config_t *cfg,
+                          const bench_scenario_t *sp,
+                          bool spsc, size_t chunk,
+                          uint32_t *ctxswp) {
+  bench_transfer_t transfer;
+  thread_descriptor_t wtd = {
+    .name  = "writer",
+    .wbase = waWriter,
+    .wend  = THD_WORKING_AREA_END(waWriter),
+    .prio  = sp->wrprio,
+    .funcp = Writer,
+    .arg   = &transfer
+  };
+  thread_descriptor_t rtd = {
+    .name  = "reader",
+    .wbase = waReader,
+    .wend  = THD_WORKING_AREA_END(waReader),
+    .prio  = sp->rdprio,
+    .funcp = Reader,
+    .arg   = &transfer
+  };
+  thread_t *wtp, *rtp;
+  uint32_t ctxsw;
+  rtcnt_t start, t;
+
+  transfer.chunk = chunk;
+  transfer.total = (PIPE_BENCH_CFG_TOTAL_BYTES / chunk) * chunk;
+
+  if (spsc) {
+    chPipeObjectInitSPSC(&pipe1, pipe_buffer, sizeof (pipe_buffer));
+  }
+  else {
+    chPipeObjectInit(&pipe1, pipe_buffer, sizeof (pipe_buffer));
+  }
+
+  /* Both threads are started atomically.*/
+  chSysLock();
+  wtp = chThdCreateSuspendedI(&wtd);
+  rtp = chThdCreateSuspendedI(&rtd);
+  ctxsw = pipe_bench_ctxsw;
+  start = chSysGetRealtimeCounterX();
+  (void) chThdStartI(rtp);
+  (void) chThdStartI(wtp);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  (void) chThdWait(wtp);
+  (void) chThdWait(rtp);
+  t = chSysGetRealtimeCounterX() - start;
+  ctxsw = pipe_bench_ctxsw - ctxsw;
+  if (t == (rtcnt_t)0) {
+    t = (rtcnt_t)1;
+  }
+
+  *ctxswp = (uint32_t)(((uint64_t)ctxsw * 1048576U) / transfer.total);
+
+  return (uint32_t)(((uint64_t)transfer.total * cfg->rtcfreq) /
+                    ((uint64_t)t * 1024U));
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Pipe bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void pipe_bench_execute(const pipe_bench_config_t *cfg) {
+  unsigned i, j, k;
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT PIPE-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+  chprintf(cfg->out, "*** Pipe Size:    %d\r\n", PIPE_BENCH_CFG_BUFFER_SIZE);
+  chprintf(cfg->out, "*** Total Bytes:  %d\r\n", PIPE_BENCH_CFG_TOTAL_BYTES);
+  chprintf(cfg->out, "\r\n");
+
+  chprintf(cfg->out, "Prio   Chunk  Locked kB/s  ctxsw/MB");
+  chprintf(cfg->out, "    SPSC kB/s  ctxsw/MB\r\n");
+  for (i = 0U; i < sizeof (scenarios) / sizeof (scenarios[0]); i++) {
+    for (j = 0U; j < sizeof (chunks) / sizeof (chunks[0]); j++) {
+      chprintf(cfg->out, "%s  %5d", scenarios[i].name, (int)chunks[j]);
+      for (k = 0U; k < 2U; k++) {
+        uint32_t ctxsw, kbps;
+
+        kbps = bench_run(cfg, &scenarios[i], k != 0U, chunks[j], &ctxsw);
+        chprintf(cfg->out, "  %11d  %8d", kbps, ctxsw);
+      }
+      chprintf(cfg->out, "\r\n");
+    }
+  }
+
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
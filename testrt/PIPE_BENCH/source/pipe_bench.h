@@ -0,0 +1,103 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    pipe_bench.h
+ * @brief   Pipe Bench benchmark header.
+ *
+ * @addtogroup PIPE_BENCH
+ * @{
+ */
+
+#ifndef PIPE_BENCH_H
+#define PIPE_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the pipe buffer used during the test.
+ */
+#if !defined(PIPE_BENCH_CFG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define PIPE_BENCH_CFG_BUFFER_SIZE          1024
+#endif
+
+/**
+ * @brief   Number of bytes transferred for each measurement.
+ */
+#if !defined(PIPE_BENCH_CFG_TOTAL_BYTES) || defined(__DOXYGEN__)
+#define PIPE_BENCH_CFG_TOTAL_BYTES          16777216
+#endif
+
+/**
+ * @brief   Working area size of the writer and reader threads.
+ */
+#if !defined(PIPE_BENCH_CFG_WA_SIZE) || defined(__DOXYGEN__)
+#define PIPE_BENCH_CFG_WA_SIZE              1024
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Realtime counter frequency.
+   */
+  uint32_t              rtcfreq;
+} pipe_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void pipe_bench_execute(const pipe_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* PIPE_BENCH_H */
+
+/** @} */
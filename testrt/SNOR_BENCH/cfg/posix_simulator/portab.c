@@ -0,0 +1,153 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    portab.c
+ * @brief   Application portability module code.
+ *
+ * @addtogroup application_portability
+ * @{
+ */
+
+#include <stdio.h>
+
+#include "hal.h"
+#include "snor_bench.h"
+
+#include "portab.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions prototypes.                                        */
+/*===========================================================================*/
+
+static size_t _write(void *ip, const uint8_t *bp, size_t n);
+static size_t _read(void *ip, uint8_t *bp, size_t n);
+static msg_t _put(void *ip, uint8_t b);
+static msg_t _get(void *ip);
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*
+ * Stream writing on the host standard output.
+ */
+static const struct BaseSequentialStreamVMT vmt = {
+  (size_t)0, _write, _read, _put, _get
+};
+
+static BaseSequentialStream stdout_stream = {&vmt};
+
+/*
+ * Simulated serial flash attached to the WSPI port.
+ */
+static const WSPIConfig wspi_config = {
+  .end_cb               = NULL,
+  .error_cb             = NULL,
+  .path                 = PORTAB_FLASH_PATH,
+  .byte_time            = PORTAB_FLASH_BYTE_TIME,
+  .program_time         = PORTAB_FLASH_PROGRAM_TIME,
+  .sector_erase_time    = PORTAB_FLASH_SECTOR_ERASE_TIME,
+  .block_erase_time     = PORTAB_FLASH_BLOCK_ERASE_TIME,
+  .suspend_time         = PORTAB_FLASH_SUSPEND_TIME,
+  .resume_time          = PORTAB_FLASH_RESUME_TIME
+};
+
+/*
+ * Serial NOR driver configuration.
+ */
+static const SNORConfig snor_config = {
+  .busp                 = &WSPID1,
+  .buscfg               = &wspi_config
+};
+
+static SNORDriver snor1;
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*
+ * SNOR Bench configuration.
+ */
+const snor_bench_config_t portab_snor_bench_config = {
+  &stdout_stream,
+  PORTAB_RTC_FREQUENCY,
+  &snor1,
+  &snor_config
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static size_t _write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+
+  return fwrite(bp, 1, n, stdout);
+}
+
+static size_t _read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return (size_t)0;
+}
+
+static msg_t _put(void *ip, uint8_t b) {
+
+  (void)ip;
+
+  return putchar((int)b) == EOF ? MSG_RESET : MSG_OK;
+}
+
+static msg_t _get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+void portab_setup(void) {
+
+  wspiStart(&WSPID1, &wspi_config);
+}
+
+void portab_cleanup(void) {
+  const wspi_sim_stats_t *sp = wspiSimGetStats(&WSPID1);
+
+  printf("Simulated flash: %u commands, %u erases, %u suspends, "
+         "%u us suspended\n",
+         (unsigned)sp->n_commands, (unsigned)sp->n_erases,
+         (unsigned)sp->n_suspends, (unsigned)sp->suspended_time);
+}
+
+/** @} */
@@ -0,0 +1,381 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    snor_bench.c
+ * @brief   SNOR Bench benchmark code.
+ * @details The read latency of a serial NOR flash is measured while idle
+ *          and while a low priority thread keeps erasing another sector.
+ *          Reads failing with @p FLASH_BUSY_ERASING are retried each
+ *          millisecond, this is the only option when erase suspend is not
+ *          enabled in the driver.
+ *
+ * @addtogroup SNOR_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "snor_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/* Sector continuously erased during the erase phases.*/
+#define ERASED_SECTOR               0U
+
+/* Sector containing the data being read.*/
+#define READ_SECTOR                 1U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*
+ * Reader thread state and results.
+ */
+typedef struct {
+  BaseFlash             *flashp;
+  unsigned              seed;
+  time_histogram_t      hist;
+  uint32_t              retries;
+  uint32_t              errors;
+} reader_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(wa_reader1, 1024 + SNOR_BENCH_CFG_READ_SIZE);
+static THD_WORKING_AREA(wa_reader2, 1024 + SNOR_BENCH_CFG_READ_SIZE);
+static THD_WORKING_AREA(wa_eraser, 1024);
+
+static reader_t readers[2];
+static uint32_t erases;
+static rtcnt_t erase_worst;
+static uint32_t erase_errors;
+static uint32_t errors;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Pattern byte at the specified flash offset.
+ */
+static uint8_t pattern(flash_offset_t offset) {
+
+  return (uint8_t)(offset ^ (offset >> 8) ^ 0x5AU);
+}
+
+static uint32_t to_us(const snor_bench_config_t *cfg, rtcnt_t t) {
+
+  return (uint32_t)(((uint64_t)t * 1000000U) / cfg->rtcfreq);
+}
+
+/*
+ * Reader thread, reads with retry on busy and verifies the data.
+ */
+static THD_FUNCTION(reader_thread, arg) {
+  reader_t *rp = (reader_t *)arg;
+  const flash_descriptor_t *fdp = flashGetDescriptor(rp->flashp);
+  uint32_t slots = fdp->sectors_size / SNOR_BENCH_CFG_READ_SIZE;
+  uint8_t buf[SNOR_BENCH_CFG_READ_SIZE];
+  unsigned i, j;
+
+  for (i = 0U; i < SNOR_BENCH_CFG_READS; i++) {
+    flash_offset_t offset;
+    flash_error_t err;
+    rtcnt_t start;
+
+    offset = flashGetSectorOffset(rp->flashp, READ_SECTOR) +
+             (((i * 37U) + rp->seed) % slots) * SNOR_BENCH_CFG_READ_SIZE;
+
+    start = chSysGetRealtimeCounterX();
+    while ((err = flashRead(rp->flashp, offset, sizeof buf, buf)) ==
+           FLASH_BUSY_ERASING) {
+      rp->retries++;
+      chThdSleepMilliseconds(1);
+    }
+    chTMHistogramAddX(&rp->hist, chSysGetRealtimeCounterX() - start);
+
+    if (err != FLASH_NO_ERROR) {
+      rp->errors++;
+    }
+    else {
+      for (j = 0U; j < sizeof buf; j++) {
+        if (buf[j] != pattern(offset + j)) {
+          rp->errors++;
+          break;
+        }
+      }
+    }
+
+    chThdSleepMilliseconds(SNOR_BENCH_CFG_READ_INTERVAL);
+  }
+}
+
+/*
+ * Eraser thread, erases the same sector until terminated.
+ */
+static THD_FUNCTION(eraser_thread, arg) {
+  BaseFlash *flashp = (BaseFlash *)arg;
+
+  while (!chThdShouldTerminateX()) {
+    flash_error_t err;
+    rtcnt_t start, t;
+
+    start = chSysGetRealtimeCounterX();
+    err = flashStartEraseSector(flashp, ERASED_SECTOR);
+    if (err == FLASH_NO_ERROR) {
+      err = flashWaitErase(flashp);
+    }
+    t = chSysGetRealtimeCounterX() - start;
+
+    if (err != FLASH_NO_ERROR) {
+      erase_errors++;
+    }
+    erases++;
+    if (t > erase_worst) {
+      erase_worst = t;
+    }
+
+    chThdSleepMilliseconds(SNOR_BENCH_CFG_ERASE_INTERVAL);
+  }
+}
+
+static void reader_init(reader_t *rp, BaseFlash *flashp, unsigned seed) {
+
+  rp->flashp  = flashp;
+  rp->seed    = seed;
+  rp->retries = 0U;
+  rp->errors  = 0U;
+  chTMHistogramObjectInit(&rp->hist);
+}
+
+static void print_reader(const snor_bench_config_t *cfg, const char *name,
+                         const reader_t *rp) {
+  const time_measurement_t *tmp = &rp->hist.tm;
+
+  chprintf(cfg->out, "%-24s %6d %7d %7d %7d %7d %7d %7d %6d\r\n", name,
+           tmp->n,
+           to_us(cfg, tmp->n > 0U ? (rtcnt_t)(tmp->cumulative / tmp->n) : 0U),
+           to_us(cfg, chTMHistogramGetPercentileX(&rp->hist, 5000U)),
+           to_us(cfg, chTMHistogramGetPercentileX(&rp->hist, 9000U)),
+           to_us(cfg, chTMHistogramGetPercentileX(&rp->hist, 9900U)),
+           to_us(cfg, tmp->worst),
+           rp->retries, rp->errors);
+  errors += rp->errors;
+}
+
+/*
+ * Runs the readers, optionally with the eraser thread in background.
+ */
+static void run_phase(const snor_bench_config_t *cfg, unsigned nreaders,
+                      bool erasing) {
+  BaseFlash *flashp = (BaseFlash *)cfg->snorp;
+  thread_t *rdtp[2], *ertp = NULL;
+  unsigned i;
+
+  erases       = 0U;
+  erase_worst  = (rtcnt_t)0;
+  erase_errors = 0U;
+  for (i = 0U; i < nreaders; i++) {
+    reader_init(&readers[i], flashp, i * 101U);
+  }
+
+  if (erasing) {
+    ertp = chThdCreateStatic(wa_eraser, sizeof wa_eraser, NORMALPRIO - 1,
+                             eraser_thread, flashp);
+  }
+  rdtp[0] = chThdCreateStatic(wa_reader1, sizeof wa_reader1, NORMALPRIO + 2,
+                              reader_thread, &readers[0]);
+  if (nreaders > 1U) {
+    rdtp[1] = chThdCreateStatic(wa_reader2, sizeof wa_reader2,
+                                NORMALPRIO + 1, reader_thread, &readers[1]);
+  }
+
+  for (i = 0U; i < nreaders; i++) {
+    chThdWait(rdtp[i]);
+  }
+  if (ertp != NULL) {
+    chThdTerminate(ertp);
+    chThdWait(ertp);
+  }
+}
+
+static void print_erases(const snor_bench_config_t *cfg) {
+
+  chprintf(cfg->out, "%-24s %6d%32s %7d%8s %6d\r\n", "  background erases",
+           erases, "", to_us(cfg, erase_worst), "", erase_errors);
+  errors += erase_errors;
+}
+
+static void print_op_stats(const snor_bench_config_t *cfg, const char *name,
+                           const flash_op_stats_t *sp) {
+
+  chprintf(cfg->out, "%-24s %6d %7d %7d %7d %8d\r\n", name, sp->n,
+           sp->n > 0U ? (uint32_t)TIME_I2US(sp->cumulative / sp->n) : 0U,
+           (uint32_t)TIME_I2US(sp->best), (uint32_t)TIME_I2US(sp->worst),
+           sp->n > 0U ? sp->polls / sp->n : 0U);
+}
+
+/*
+ * Prints the operations statistics collected by the driver.
+ */
+static void print_stats(const snor_bench_config_t *cfg) {
+  flash_stats_t stats;
+
+  if (flashGetStats((BaseFlash *)cfg->snorp, &stats) != FLASH_NO_ERROR) {
+    chprintf(cfg->out, "Driver statistics not available\r\n");
+    return;
+  }
+
+  chprintf(cfg->out, "Operation                   ops  avg us best us  max us polls/op\r\n");
+  print_op_stats(cfg, "Program", &stats.program);
+  print_op_stats(cfg, "Erase", &stats.erase);
+}
+
+/*
+ * Prepares the read sector with the test pattern.
+ */
+static flash_error_t prepare(BaseFlash *flashp) {
+  const flash_descriptor_t *fdp = flashGetDescriptor(flashp);
+  flash_offset_t base = flashGetSectorOffset(flashp, READ_SECTOR);
+  uint8_t buf[SNOR_BENCH_CFG_READ_SIZE];
+  flash_error_t err;
+  uint32_t i, j;
+
+  err = flashStartEraseSector(flashp, READ_SECTOR);
+  if (err == FLASH_NO_ERROR) {
+    err = flashWaitErase(flashp);
+  }
+
+  for (i = 0U; (err == FLASH_NO_ERROR) && (i < fdp->sectors_size);
+       i += sizeof buf) {
+    for (j = 0U; j < sizeof buf; j++) {
+      buf[j] = pattern(base + i + j);
+    }
+    err = flashProgram(flashp, base + i, sizeof buf, buf);
+  }
+
+  return err;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   SNOR bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void snor_bench_execute(const snor_bench_config_t *cfg) {
+  BaseFlash *flashp = (BaseFlash *)cfg->snorp;
+  const flash_descriptor_t *fdp;
+  flash_error_t err;
+
+  snorObjectInit(cfg->snorp);
+  snorStart(cfg->snorp, cfg->snorcfgp);
+  fdp = flashGetDescriptor(flashp);
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT SNOR-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+  chprintf(cfg->out, "*** Flash:        %d sectors of %d bytes\r\n",
+           fdp->sectors_count, fdp->sectors_size);
+  chprintf(cfg->out, "*** Device ID:    %02X %02X %02X\r\n",
+           cfg->snorp->device_id[0], cfg->snorp->device_id[1],
+           cfg->snorp->device_id[2]);
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  chprintf(cfg->out, "*** Erase Susp.:  enabled, window %d\r\n",
+           SNOR_ERASE_SUSPEND_WINDOW);
+#else
+  chprintf(cfg->out, "*** Erase Susp.:  disabled\r\n");
+#endif
+  chprintf(cfg->out, "*** Reads:        %d of %d bytes every %d ms\r\n",
+           SNOR_BENCH_CFG_READS, SNOR_BENCH_CFG_READ_SIZE,
+           SNOR_BENCH_CFG_READ_INTERVAL);
+  chprintf(cfg->out, "*** Erases:       sector %d every %d ms\r\n",
+           ERASED_SECTOR, SNOR_BENCH_CFG_ERASE_INTERVAL);
+#if SNOR_BUS_SUPPORTS_POLLING == TRUE
+  chprintf(cfg->out, "*** Polling:      bus controller\r\n");
+#else
+  chprintf(cfg->out, "*** Polling:      adaptive delays\r\n");
+#endif
+  chprintf(cfg->out, "\r\n");
+
+  err = prepare(flashp);
+  if (err != FLASH_NO_ERROR) {
+    chprintf(cfg->out, "Test data preparation failed (%d)\r\n", err);
+    snorStop(cfg->snorp);
+    return;
+  }
+
+  chprintf(cfg->out, "Phase                     reads  avg us  p50 us  p90 us  p99 us  max us retries errors\r\n");
+
+  run_phase(cfg, 1U, false);
+  print_reader(cfg, "Idle", &readers[0]);
+
+  run_phase(cfg, 1U, true);
+  print_reader(cfg, "During erase", &readers[0]);
+  print_erases(cfg);
+
+  run_phase(cfg, 2U, true);
+  print_reader(cfg, "During erase, high prio", &readers[0]);
+  print_reader(cfg, "During erase, low prio", &readers[1]);
+  print_erases(cfg);
+  chprintf(cfg->out, "\r\n");
+
+  print_stats(cfg);
+
+  snorStop(cfg->snorp);
+
+  chprintf(cfg->out, "Errors: %d\r\n", errors);
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
@@ -0,0 +1,126 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    snor_bench.h
+ * @brief   SNOR Bench benchmark header.
+ *
+ * @addtogroup SNOR_BENCH
+ * @{
+ */
+
+#ifndef SNOR_BENCH_H
+#define SNOR_BENCH_H
+
+#include "hal_serial_nor.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of reads performed by each reader in each phase.
+ */
+#if !defined(SNOR_BENCH_CFG_READS) || defined(__DOXYGEN__)
+#define SNOR_BENCH_CFG_READS                500
+#endif
+
+/**
+ * @brief   Size of each read.
+ */
+#if !defined(SNOR_BENCH_CFG_READ_SIZE) || defined(__DOXYGEN__)
+#define SNOR_BENCH_CFG_READ_SIZE            256
+#endif
+
+/**
+ * @brief   Interval between reads in milliseconds.
+ */
+#if !defined(SNOR_BENCH_CFG_READ_INTERVAL) || defined(__DOXYGEN__)
+#define SNOR_BENCH_CFG_READ_INTERVAL        1
+#endif
+
+/**
+ * @brief   Pause between background erases in milliseconds.
+ * @note    Without erase suspend readers can only be served during
+ *          these pauses.
+ */
+#if !defined(SNOR_BENCH_CFG_ERASE_INTERVAL) || defined(__DOXYGEN__)
+#define SNOR_BENCH_CFG_ERASE_INTERVAL       10
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_TM == FALSE
+#error "SNOR Bench requires CH_CFG_USE_TM"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Realtime counter frequency.
+   */
+  uint32_t              rtcfreq;
+  /**
+   * @brief   Serial NOR driver under test.
+   */
+  SNORDriver            *snorp;
+  /**
+   * @brief   Serial NOR driver configuration.
+   */
+  const SNORConfig      *snorcfgp;
+} snor_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void snor_bench_execute(const snor_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* SNOR_BENCH_H */
+
+/** @} */
@@ -0,0 +1,158 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    portab.c
+ * @brief   Application portability module code.
+ *
+ * @addtogroup application_portability
+ * @{
+ */
+
+#include <stdio.h>
+
+#include "hal.h"
+#include "snor_sfdp_test.h"
+
+#include "portab.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions prototypes.                                        */
+/*===========================================================================*/
+
+static size_t _write(void *ip, const uint8_t *bp, size_t n);
+static size_t _read(void *ip, uint8_t *bp, size_t n);
+static msg_t _put(void *ip, uint8_t b);
+static msg_t _get(void *ip);
+static const SNORConfig *_getcfg(const uint8_t *sfdp, size_t size);
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*
+ * Stream writing on the host standard output.
+ */
+static const struct BaseSequentialStreamVMT vmt = {
+  (size_t)0, _write, _read, _put, _get
+};
+
+static BaseSequentialStream stdout_stream = {&vmt};
+
+/*
+ * Simulated serial flash attached to the WSPI port, the SFDP image is
+ * changed by each test case.
+ */
+static WSPIConfig wspi_config = {
+  .end_cb               = NULL,
+  .error_cb             = NULL,
+  .path                 = NULL,
+  .byte_time            = PORTAB_FLASH_BYTE_TIME,
+  .program_time         = PORTAB_FLASH_PROGRAM_TIME,
+  .sector_erase_time    = PORTAB_FLASH_SECTOR_ERASE_TIME,
+  .block_erase_time     = PORTAB_FLASH_BLOCK_ERASE_TIME,
+  .suspend_time         = PORTAB_FLASH_SUSPEND_TIME,
+  .resume_time          = PORTAB_FLASH_RESUME_TIME,
+  .sfdp                 = NULL,
+  .sfdp_size            = 0U
+};
+
+/*
+ * Serial NOR driver configuration.
+ */
+static const SNORConfig snor_config = {
+  .busp                 = &WSPID1,
+  .buscfg               = &wspi_config
+};
+
+static SNORDriver snor1;
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*
+ * SNOR SFDP test configuration.
+ */
+const snor_sfdp_test_config_t portab_snor_sfdp_test_config = {
+  &stdout_stream,
+  &snor1,
+  _getcfg
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static size_t _write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+
+  return fwrite(bp, 1, n, stdout);
+}
+
+static size_t _read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return (size_t)0;
+}
+
+static msg_t _put(void *ip, uint8_t b) {
+
+  (void)ip;
+
+  return putchar((int)b) == EOF ? MSG_RESET : MSG_OK;
+}
+
+static msg_t _get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+/*
+ * The simulated device is reinitialized on each driver start, the new
+ * SFDP image is used from that point.
+ */
+static const SNORConfig *_getcfg(const uint8_t *sfdp, size_t size) {
+
+  wspi_config.sfdp      = sfdp;
+  wspi_config.sfdp_size = size;
+
+  return &snor_config;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+void portab_setup(void) {
+
+}
+
+/** @} */
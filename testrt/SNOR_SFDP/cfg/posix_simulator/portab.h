@@ -0,0 +1,89 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    portab.h
+ * @brief   Application portability macros and structures.
+ *
+ * @addtogroup application_portability
+ * @{
+ */
+
+#ifndef PORTAB_H
+#define PORTAB_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/* Simulated flash timings, typical values of MX25 devices. The bus
+   transfer time is in nanoseconds per byte, the others in microseconds.*/
+#if !defined(PORTAB_FLASH_BYTE_TIME)
+#define PORTAB_FLASH_BYTE_TIME             80U
+#endif
+#if !defined(PORTAB_FLASH_PROGRAM_TIME)
+#define PORTAB_FLASH_PROGRAM_TIME          150U
+#endif
+#if !defined(PORTAB_FLASH_SECTOR_ERASE_TIME)
+#define PORTAB_FLASH_SECTOR_ERASE_TIME     25000U
+#endif
+#if !defined(PORTAB_FLASH_BLOCK_ERASE_TIME)
+#define PORTAB_FLASH_BLOCK_ERASE_TIME      220000U
+#endif
+#if !defined(PORTAB_FLASH_SUSPEND_TIME)
+#define PORTAB_FLASH_SUSPEND_TIME          20U
+#endif
+#if !defined(PORTAB_FLASH_RESUME_TIME)
+#define PORTAB_FLASH_RESUME_TIME           100U
+#endif
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern const snor_sfdp_test_config_t portab_snor_sfdp_test_config;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void portab_setup(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* PORTAB_H */
+
+/** @} */
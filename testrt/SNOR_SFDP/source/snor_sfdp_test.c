@@ -0,0 +1,513 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    snor_sfdp_test.c
+ * @brief   SNOR SFDP test code.
+ * @details The JEDEC SFDP generic device is started on a set of SFDP
+ *          images and the parameters selected by the driver are checked
+ *          against the expected ones. Images describing the simulated
+ *          device are also used for erase, program and read cycles in
+ *          the selected modes.
+ *
+ * @addtogroup SNOR_SFDP_TEST
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "snor_sfdp_test.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/* Maximum size of a generated SFDP image.*/
+#define IMAGE_SIZE                  512U
+
+/* Sector used for the erase, program and read cycles.*/
+#define RW_SECTOR                   1U
+
+/* Programmed area, it is misaligned and crosses pages.*/
+#define RW_OFFSET                   100U
+#define RW_SIZE                     600U
+
+/* Basic Flash Parameter Table common DWORDs, JESD216B.*/
+#define BFPT_DENSITY_4MB            0x01FFFFFFU
+#define BFPT_DW1_BASE               0xFF8020E5U
+#define BFPT_DW1_1_1_2              (1U << 16)
+#define BFPT_DW1_3B_4B              (1U << 17)
+#define BFPT_DW1_1_2_2              (1U << 20)
+#define BFPT_DW1_1_4_4              (1U << 21)
+#define BFPT_DW1_1_1_4              (1U << 22)
+#define BFPT_DW1_MULTI_IO           (BFPT_DW1_1_1_2 | BFPT_DW1_1_2_2 |      \
+                                     BFPT_DW1_1_4_4 | BFPT_DW1_1_1_4)
+#define BFPT_DW3_QUAD               0x6B08EB44U
+#define BFPT_DW4_DUAL               0xBB043B08U
+#define BFPT_DW5_NO_4_4_4           0xFFFFFFEEU
+#define BFPT_DW5_4_4_4              0xFFFFFFFEU
+#define BFPT_DW7_4_4_4              0xEB44FFFFU
+#define BFPT_DW8_ERASE              0x0000200CU
+#define BFPT_DW9_ERASE              0x0000D810U
+#define BFPT_DW10_TIMES             (2U | (24U << 4) | (13U << 18) | (1U << 23))
+#define BFPT_DW11_TIMES             (1U | (8U << 4) | (18U << 8) |          \
+                                     (3U << 24) | (2U << 29))
+#define BFPT_DW12_NO_SUSPEND        (1U << 31)
+#define BFPT_DW13_SUSPEND           0xB030B030U
+#define BFPT_DW15_QER2              (2U << 20)
+#define BFPT_DW15_QPI_35            (1U << 6)
+#define BFPT_DW16_B7                (1U << 24)
+#define BFPT_DW18_EXT_INV           (1U << 29)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*
+ * Parameter table of an SFDP image.
+ */
+typedef struct {
+  uint16_t              id;
+  uint8_t               n;
+  const uint32_t        *dwords;
+} sfdp_table_t;
+
+/*
+ * Test case, the image and the parameters expected to be selected.
+ */
+typedef struct {
+  const char            *name;
+  const sfdp_table_t    *tables;
+  uint8_t               ntables;
+  uint8_t               proto;
+  uint8_t               opcode;
+  uint8_t               dummy;
+  uint8_t               addr_mode;
+  uint8_t               erase_opcode;
+  uint32_t              sectors_size;
+  uint32_t              size;
+  bool                  suspend;
+  bool                  rw;
+} sfdp_case_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*
+ * Single I/O device, JESD216 nine DWORDs table.
+ */
+static const uint32_t bfpt_single[] = {
+  BFPT_DW1_BASE, BFPT_DENSITY_4MB, 0U, 0U, BFPT_DW5_NO_4_4_4,
+  0x0000FFFFU, 0x0000FFFFU, BFPT_DW8_ERASE, BFPT_DW9_ERASE
+};
+
+/*
+ * Multi I/O device with no Quad Enable information, quad modes are not
+ * usable.
+ */
+static const uint32_t bfpt_dual[] = {
+  BFPT_DW1_BASE | BFPT_DW1_MULTI_IO, BFPT_DENSITY_4MB, BFPT_DW3_QUAD,
+  BFPT_DW4_DUAL, BFPT_DW5_NO_4_4_4, 0x0000FFFFU, 0x0000FFFFU,
+  BFPT_DW8_ERASE, BFPT_DW9_ERASE
+};
+
+/*
+ * Quad device, JESD216B table.
+ */
+static const uint32_t bfpt_quad[] = {
+  BFPT_DW1_BASE | BFPT_DW1_MULTI_IO, BFPT_DENSITY_4MB, BFPT_DW3_QUAD,
+  BFPT_DW4_DUAL, BFPT_DW5_NO_4_4_4, 0x0000FFFFU, 0x0000FFFFU,
+  BFPT_DW8_ERASE, BFPT_DW9_ERASE, BFPT_DW10_TIMES, BFPT_DW11_TIMES,
+  0U, BFPT_DW13_SUSPEND, 0x00000004U, BFPT_DW15_QER2, 0U
+};
+
+/*
+ * Quad device, JESD216B table, erase suspend not supported.
+ */
+static const uint32_t bfpt_quad_nosuspend[] = {
+  BFPT_DW1_BASE | BFPT_DW1_MULTI_IO, BFPT_DENSITY_4MB, BFPT_DW3_QUAD,
+  BFPT_DW4_DUAL, BFPT_DW5_NO_4_4_4, 0x0000FFFFU, 0x0000FFFFU,
+  BFPT_DW8_ERASE, BFPT_DW9_ERASE, BFPT_DW10_TIMES, BFPT_DW11_TIMES,
+  BFPT_DW12_NO_SUSPEND, 0U, 0x00000004U, BFPT_DW15_QER2, 0U
+};
+
+/*
+ * Quad device with QPI mode.
+ */
+static const uint32_t bfpt_qpi[] = {
+  BFPT_DW1_BASE | BFPT_DW1_MULTI_IO, BFPT_DENSITY_4MB, BFPT_DW3_QUAD,
+  BFPT_DW4_DUAL, BFPT_DW5_4_4_4, 0x0000FFFFU, BFPT_DW7_4_4_4,
+  BFPT_DW8_ERASE, BFPT_DW9_ERASE, BFPT_DW10_TIMES, BFPT_DW11_TIMES,
+  0U, BFPT_DW13_SUSPEND, 0x00000004U, BFPT_DW15_QER2 | BFPT_DW15_QPI_35, 0U
+};
+
+/*
+ * Quad 64MB device, 4 bytes addressing through the 4BAIT.
+ */
+static const uint32_t bfpt_quad_64mb[] = {
+  BFPT_DW1_BASE | BFPT_DW1_MULTI_IO | BFPT_DW1_3B_4B, 0x80000000U | 29U,
+  BFPT_DW3_QUAD, BFPT_DW4_DUAL, BFPT_DW5_NO_4_4_4, 0x0000FFFFU,
+  0x0000FFFFU, BFPT_DW8_ERASE, BFPT_DW9_ERASE, BFPT_DW10_TIMES,
+  BFPT_DW11_TIMES, 0U, BFPT_DW13_SUSPEND, 0x00000004U, BFPT_DW15_QER2, 0U
+};
+
+/*
+ * Quad 64MB device, 4 bytes addressing mode entered with B7h.
+ */
+static const uint32_t bfpt_quad_64mb_b7[] = {
+  BFPT_DW1_BASE | BFPT_DW1_MULTI_IO | BFPT_DW1_3B_4B, 0x80000000U | 29U,
+  BFPT_DW3_QUAD, BFPT_DW4_DUAL, BFPT_DW5_NO_4_4_4, 0x0000FFFFU,
+  0x0000FFFFU, BFPT_DW8_ERASE, BFPT_DW9_ERASE, BFPT_DW10_TIMES,
+  BFPT_DW11_TIMES, 0U, BFPT_DW13_SUSPEND, 0x00000004U, BFPT_DW15_QER2,
+  BFPT_DW16_B7
+};
+
+/*
+ * Octal SPI device, JESD216C table with 1-1-8 and 1-8-8 modes.
+ */
+static const uint32_t bfpt_octal_spi[] = {
+  BFPT_DW1_BASE, BFPT_DENSITY_4MB, 0U, 0U, BFPT_DW5_NO_4_4_4, 0x0000FFFFU,
+  0x0000FFFFU, BFPT_DW8_ERASE, BFPT_DW9_ERASE, BFPT_DW10_TIMES,
+  BFPT_DW11_TIMES, 0U, BFPT_DW13_SUSPEND, 0x00000004U, 0U, 0U,
+  0xCC108B08U
+};
+
+/*
+ * Octal DTR device, JESD216C table.
+ */
+static const uint32_t bfpt_octal_dtr[] = {
+  BFPT_DW1_BASE | BFPT_DW1_3B_4B, BFPT_DENSITY_4MB, 0U, 0U,
+  BFPT_DW5_NO_4_4_4, 0x0000FFFFU, 0x0000FFFFU, BFPT_DW8_ERASE,
+  BFPT_DW9_ERASE, BFPT_DW10_TIMES, BFPT_DW11_TIMES, 0U, BFPT_DW13_SUSPEND,
+  0x00000004U, 0U, 0U, 0U, BFPT_DW18_EXT_INV, 0U, 0U
+};
+
+/*
+ * 4 bytes address instructions table, 4kB erase is 21h, 64kB erase is DCh.
+ */
+static const uint32_t bait[] = {
+  0x00000A7EU, 0xFFDCFF21U
+};
+
+/*
+ * xSPI profile 1.0, read EEh, status read with address and 4 dummy
+ * cycles, 20 dummy cycles at the highest frequency.
+ */
+static const uint32_t profile1[] = {
+  0x2000EE00U, 0U, 0U, 0U, 20U << 27
+};
+
+/*
+ * Octal DDR enable sequences, WREN then WRCR2 writing 02h at address 0.
+ */
+static const uint32_t octal_ddr[] = {
+  0x01060000U, 0x00000000U, 0x06720000U, 0x00000200U
+};
+
+static const sfdp_table_t tables_single[] = {
+  {0xFF00U, 9U, bfpt_single}
+};
+
+static const sfdp_table_t tables_dual[] = {
+  {0xFF00U, 9U, bfpt_dual}
+};
+
+static const sfdp_table_t tables_quad[] = {
+  {0xFF00U, 16U, bfpt_quad}
+};
+
+static const sfdp_table_t tables_quad_nosuspend[] = {
+  {0xFF00U, 16U, bfpt_quad_nosuspend}
+};
+
+static const sfdp_table_t tables_qpi[] = {
+  {0xFF00U, 16U, bfpt_qpi}
+};
+
+static const sfdp_table_t tables_quad_64mb[] = {
+  {0xFF00U, 16U, bfpt_quad_64mb},
+  {0xFF84U, 2U, bait}
+};
+
+static const sfdp_table_t tables_quad_64mb_b7[] = {
+  {0xFF00U, 16U, bfpt_quad_64mb_b7}
+};
+
+static const sfdp_table_t tables_octal_spi[] = {
+  {0xFF00U, 17U, bfpt_octal_spi}
+};
+
+static const sfdp_table_t tables_octal_dtr[] = {
+  {0xFF00U, 20U, bfpt_octal_dtr},
+  {0xFF84U, 2U, bait},
+  {0xFF05U, 5U, profile1},
+  {0xFF0AU, 4U, octal_ddr}
+};
+
+/*
+ * Test cases, selection only cases describe devices the simulator does not
+ * implement.
+ */
+static const sfdp_case_t cases[] = {
+  {"No SFDP", NULL, 0U,
+   SFDP_PROTO_1_1_1, 0x0BU, 8U, SFDP_ADDR_3B, 0xD8U,
+   0x00010000U, 0x00400000U, false, true},
+  {"Single I/O", tables_single, 1U,
+   SFDP_PROTO_1_1_1, 0x0BU, 8U, SFDP_ADDR_3B, 0xD8U,
+   0x00010000U, 0x00400000U, false, true},
+  {"Multi I/O, no QER", tables_dual, 1U,
+   SFDP_PROTO_1_2_2, 0xBBU, 4U, SFDP_ADDR_3B, 0xD8U,
+   0x00010000U, 0x00400000U, false, true},
+  {"Quad", tables_quad, 1U,
+   SFDP_PROTO_1_4_4, 0xEBU, 6U, SFDP_ADDR_3B, 0xD8U,
+   0x00010000U, 0x00400000U, true, true},
+  {"Quad, no suspend", tables_quad_nosuspend, 1U,
+   SFDP_PROTO_1_4_4, 0xEBU, 6U, SFDP_ADDR_3B, 0xD8U,
+   0x00010000U, 0x00400000U, false, true},
+  {"Quad, QPI", tables_qpi, 1U,
+   SFDP_PROTO_4_4_4, 0xEBU, 6U, SFDP_ADDR_3B, 0xD8U,
+   0x00010000U, 0x00400000U, true, true},
+  {"Quad 64MB, 4BAIT", tables_quad_64mb, 2U,
+   SFDP_PROTO_1_4_4, 0xECU, 6U, SFDP_ADDR_4B_OPCODES, 0xDCU,
+   0x00010000U, 0x04000000U, true, false},
+  {"Quad 64MB, EN4B", tables_quad_64mb_b7, 1U,
+   SFDP_PROTO_1_4_4, 0xEBU, 6U, SFDP_ADDR_4B_MODE, 0xD8U,
+   0x00010000U, 0x04000000U, true, false},
+  {"Octal SPI", tables_octal_spi, 1U,
+   SFDP_PROTO_1_8_8, 0xCCU, 16U, SFDP_ADDR_3B, 0xD8U,
+   0x00010000U, 0x00400000U, true, false},
+  {"Octal DTR", tables_octal_dtr, 4U,
+   SFDP_PROTO_8D_8D_8D, 0xEEU, 20U, SFDP_ADDR_4B_OPCODES, 0xDCU,
+   0x00010000U, 0x00400000U, true, true}
+};
+
+static uint8_t image[IMAGE_SIZE];
+static uint8_t buf[RW_SIZE];
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Pattern byte at the specified flash offset.
+ */
+static uint8_t pattern(flash_offset_t offset) {
+
+  return (uint8_t)(offset ^ (offset >> 8) ^ 0xA5U);
+}
+
+static size_t put_dword(size_t i, uint32_t dw) {
+
+  image[i++] = (uint8_t)(dw >> 0);
+  image[i++] = (uint8_t)(dw >> 8);
+  image[i++] = (uint8_t)(dw >> 16);
+  image[i++] = (uint8_t)(dw >> 24);
+
+  return i;
+}
+
+/*
+ * Builds an SFDP image, the header is followed by the parameter headers
+ * and then by the tables.
+ */
+static size_t build_image(const sfdp_table_t *tp, unsigned n) {
+  size_t i, ptr;
+  unsigned j, k;
+
+  memset(image, 0xFF, sizeof image);
+  i = put_dword(0U, 0x50444653U);
+  i = put_dword(i, 0xFF000106U | ((uint32_t)(n - 1U) << 16));
+  ptr = 8U + (n * 8U);
+  for (j = 0U; j < n; j++) {
+    i = put_dword(i, ((uint32_t)tp[j].n << 24) | 0x00010600U |
+                     (tp[j].id & 0xFFU));
+    i = put_dword(i, ((uint32_t)(tp[j].id & 0xFF00U) << 16) |
+                     (uint32_t)ptr);
+    ptr += (size_t)tp[j].n * 4U;
+  }
+  for (j = 0U; j < n; j++) {
+    for (k = 0U; k < tp[j].n; k++) {
+      i = put_dword(i, tp[j].dwords[k]);
+    }
+  }
+  osalDbgAssert(i <= sizeof image, "image overflow");
+
+  return i;
+}
+
+/*
+ * Erase, program and read cycle on a sector, a different sector is read
+ * during the erase, the read suspends the erase if the device is able to.
+ */
+static bool rw_cycle(SNORDriver *snorp, bool suspend) {
+  BaseFlash *flashp = (BaseFlash *)snorp;
+  flash_offset_t base = flashGetSectorOffset(flashp, RW_SECTOR);
+  flash_error_t err;
+  unsigned i;
+
+  err = flashStartEraseSector(flashp, RW_SECTOR);
+  if (err == FLASH_NO_ERROR) {
+    err = flashRead(flashp, flashGetSectorOffset(flashp, 0U), 16U, buf);
+    if (err != (suspend ? FLASH_NO_ERROR : FLASH_BUSY_ERASING)) {
+      (void) flashWaitErase(flashp);
+      return false;
+    }
+    err = flashWaitErase(flashp);
+  }
+  if (err == FLASH_NO_ERROR) {
+    err = flashVerifyErase(flashp, RW_SECTOR);
+  }
+  if (err != FLASH_NO_ERROR) {
+    return false;
+  }
+
+  for (i = 0U; i < RW_SIZE; i++) {
+    buf[i] = pattern(base + RW_OFFSET + i);
+  }
+  err = flashProgram(flashp, base + RW_OFFSET, RW_SIZE, buf);
+  if (err != FLASH_NO_ERROR) {
+    return false;
+  }
+
+  memset(buf, 0, sizeof buf);
+  err = flashRead(flashp, base + RW_OFFSET, RW_SIZE, buf);
+  if (err != FLASH_NO_ERROR) {
+    return false;
+  }
+  for (i = 0U; i < RW_SIZE; i++) {
+    if (buf[i] != pattern(base + RW_OFFSET + i)) {
+      return false;
+    }
+  }
+
+  /* The area around the programmed data must be still erased.*/
+  err = flashRead(flashp, base + RW_OFFSET + RW_SIZE, 16U, buf);
+  if (err != FLASH_NO_ERROR) {
+    return false;
+  }
+  for (i = 0U; i < 16U; i++) {
+    if (buf[i] != 0xFFU) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+ * Executes a test case.
+ */
+static bool run_case(const snor_sfdp_test_config_t *cfg,
+                     const sfdp_case_t *cp) {
+  const sfdp_params_t *pp = &snor_sfdp_params;
+  const flash_descriptor_t *fdp;
+  const uint8_t *sfdp = NULL;
+  size_t size = 0U;
+  bool ok;
+
+  if (cp->tables != NULL) {
+    size = build_image(cp->tables, cp->ntables);
+    sfdp = image;
+  }
+
+  snorStart(cfg->snorp, cfg->getcfg(sfdp, size));
+  fdp = flashGetDescriptor((BaseFlash *)cfg->snorp);
+
+  chprintf(cfg->out, "%-20s proto %d op %02X dummy %2d addr %d "
+           "erase %02X/%6d size %8d", cp->name, pp->read.proto,
+           pp->read.opcode, pp->read.dummy, pp->addr_mode,
+           pp->erase_opcode, fdp->sectors_size, fdp->size);
+
+  ok = (pp->valid == (cp->tables != NULL)) &&
+       (pp->read.proto == cp->proto) &&
+       (pp->read.opcode == cp->opcode) &&
+       (pp->read.dummy == cp->dummy) &&
+       (pp->addr_mode == cp->addr_mode) &&
+       (pp->erase_opcode == cp->erase_opcode) &&
+       (fdp->sectors_size == cp->sectors_size) &&
+       (fdp->size == cp->size) &&
+       (fdp->page_size == 256U) &&
+       (((fdp->attributes & FLASH_ATTR_SUSPEND_ERASE_CAPABLE) != 0U) ==
+        cp->suspend);
+
+  /* SFDP reads must also work in the selected commands protocol.*/
+  if (ok && (sfdp != NULL)) {
+    uint8_t sig[4];
+
+    ok = (cfg->snorp->vmt->read_sfdp(cfg->snorp, 0U, sizeof sig, sig) ==
+          FLASH_NO_ERROR) && (memcmp(sig, "SFDP", 4) == 0);
+  }
+
+  if (ok && cp->rw) {
+    ok = rw_cycle(cfg->snorp, cp->suspend);
+  }
+
+  snorStop(cfg->snorp);
+
+  chprintf(cfg->out, "%s\r\n", ok ? "  PASS" : "  FAIL");
+
+  return ok;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Executes the test cases.
+ *
+ * @param[in] cfg       pointer to the test configuration
+ * @return              The number of failed test cases.
+ */
+unsigned snor_sfdp_test_execute(const snor_sfdp_test_config_t *cfg) {
+  unsigned i, failed = 0U;
+
+  snorObjectInit(cfg->snorp);
+
+  chprintf(cfg->out, "\r\n*** ChibiOS/HAL SNOR-SFDP test\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+  chprintf(cfg->out, "\r\n");
+
+  for (i = 0U; i < sizeof cases / sizeof cases[0]; i++) {
+    if (!run_case(cfg, &cases[i])) {
+      failed++;
+    }
+  }
+
+  chprintf(cfg->out, "\r\nFailed: %d\r\n\r\n", failed);
+
+  return failed;
+}
+
+/** @} */
@@ -0,0 +1,85 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    snor_sfdp_test.h
+ * @brief   SNOR SFDP test header.
+ *
+ * @addtogroup SNOR_SFDP_TEST
+ * @{
+ */
+
+#ifndef SNOR_SFDP_TEST_H
+#define SNOR_SFDP_TEST_H
+
+#include "hal_serial_nor.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Serial NOR driver under test.
+   */
+  SNORDriver            *snorp;
+  /**
+   * @brief   Returns a driver configuration for a device exposing the
+   *          specified SFDP image.
+   * @note    The image pointer can be @p NULL for a device without SFDP.
+   */
+  const SNORConfig      *(*getcfg)(const uint8_t *sfdp, size_t size);
+} snor_sfdp_test_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  unsigned snor_sfdp_test_execute(const snor_sfdp_test_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* SNOR_SFDP_TEST_H */
+
+/** @} */
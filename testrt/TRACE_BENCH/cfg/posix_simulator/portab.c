@@ -0,0 +1,165 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    portab.c
+ * @brief   Application portability module code.
+ *
+ * @addtogroup application_portability
+ * @{
+ */
+
+#include <stdio.h>
+
+#include "hal.h"
+#include "trace_bench.h"
+
+#include "portab.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions prototypes.                                        */
+/*===========================================================================*/
+
+static size_t _write(void *ip, const uint8_t *bp, size_t n);
+static size_t _read(void *ip, uint8_t *bp, size_t n);
+static msg_t _put(void *ip, uint8_t b);
+static msg_t _get(void *ip);
+static size_t _file_write(void *ip, const uint8_t *bp, size_t n);
+static msg_t _file_put(void *ip, uint8_t b);
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*
+ * Stream writing on the host standard output.
+ */
+static const struct BaseSequentialStreamVMT vmt = {
+  (size_t)0, _write, _read, _put, _get
+};
+
+static BaseSequentialStream stdout_stream = {&vmt};
+
+/*
+ * Stream writing the trace records on a host file.
+ */
+static const struct BaseSequentialStreamVMT file_vmt = {
+  (size_t)0, _file_write, _read, _file_put, _get
+};
+
+static BaseSequentialStream file_stream = {&file_vmt};
+
+static FILE *trace_file;
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*
+ * Trace Bench configuration.
+ */
+const trace_bench_config_t portab_trace_bench_config = {
+  &stdout_stream,
+  PORTAB_RTC_FREQUENCY,
+  &file_stream,
+  PORTAB_TRACE_PATH
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static size_t _write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+
+  return fwrite(bp, 1, n, stdout);
+}
+
+static size_t _read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return (size_t)0;
+}
+
+static msg_t _put(void *ip, uint8_t b) {
+
+  (void)ip;
+
+  return putchar((int)b) == EOF ? MSG_RESET : MSG_OK;
+}
+
+static msg_t _get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+static size_t _file_write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+
+  if (trace_file == NULL) {
+    return (size_t)0;
+  }
+
+  return fwrite(bp, 1, n, trace_file);
+}
+
+static msg_t _file_put(void *ip, uint8_t b) {
+
+  (void)ip;
+
+  if (trace_file == NULL) {
+    return MSG_RESET;
+  }
+
+  return fputc((int)b, trace_file) == EOF ? MSG_RESET : MSG_OK;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+void portab_setup(void) {
+
+  trace_file = fopen(PORTAB_TRACE_PATH, "wb");
+  if (trace_file == NULL) {
+    printf("Cannot create %s\r\n", PORTAB_TRACE_PATH);
+  }
+}
+
+void portab_cleanup(void) {
+
+  if (trace_file != NULL) {
+    fclose(trace_file);
+    trace_file = NULL;
+  }
+}
+
+/** @} */
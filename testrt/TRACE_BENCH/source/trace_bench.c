@@ -0,0 +1,204 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_bench.c
+ * @brief   Trace Bench benchmark code.
+ * @details The trace streamer drains the kernel trace buffer while two
+ *          threads exchange semaphore signals, first at a rate the streamer
+ *          can sustain then at full speed in order to overflow the buffer
+ *          and measure the dropped records.
+ *
+ * @addtogroup TRACE_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "trace_streamer.h"
+
+#include "trace_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static semaphore_t sem_ping;
+static semaphore_t sem_pong;
+
+static trace_streamer_stats_t last_stats;
+static rtcnt_t start;
+
+static THD_WORKING_AREA(waPonger, TRACE_BENCH_CFG_WA_SIZE);
+static THD_WORKING_AREA(waStreamer, TRACE_BENCH_CFG_STREAMER_WA_SIZE);
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Answers to each signal until a reset.
+ */
+static THD_FUNCTION(Ponger, arg) {
+
+  (void)arg;
+  chRegSetThreadName("ponger");
+
+  while (chSemWait(&sem_ping) == MSG_OK) {
+    chSemSignal(&sem_pong);
+  }
+}
+
+/*
+ * Performs a number of exchanges with the ponger thread, a pause is
+ * inserted after each burst if requested.
+ */
+static void exchanges(uint32_t n, bool pause) {
+  uint32_t i;
+
+  for (i = 0U; i < n; i++) {
+    chSemSignal(&sem_ping);
+    (void) chSemWait(&sem_pong);
+
+    if (((i + 1U) % TRACE_BENCH_CFG_BURST) == 0U) {
+      /* Marking the burst end in the trace.*/
+      chDbgWriteTrace((void *)(uintptr_t)(i + 1U), NULL);
+      if (pause) {
+        chThdSleepMilliseconds(TRACE_BENCH_CFG_PAUSE);
+      }
+    }
+  }
+}
+
+static void phase_begin(void) {
+
+  start = chSysGetRealtimeCounterX();
+}
+
+static void phase_end(const trace_bench_config_t *cfg, const char *name) {
+  rtcnt_t t = chSysGetRealtimeCounterX() - start;
+  trace_streamer_stats_t stats;
+  uint32_t records, bytes;
+
+  /* Giving the streamer the time to drain the trace buffer.*/
+  chThdSleepMilliseconds(TRACE_STREAMER_INTERVAL * 4);
+
+  traceStreamerGetStats(&stats);
+  records = stats.records - last_stats.records;
+  bytes   = stats.bytes - last_stats.bytes;
+  chprintf(cfg->out, "%-8s %9d %8d %8d %8d %9d %5d.%02d\r\n", name,
+           (uint32_t)(((uint64_t)t * 1000000U) / cfg->rtcfreq),
+           records + (stats.dropped - last_stats.dropped),
+           records, stats.dropped - last_stats.dropped, bytes,
+           records > 0U ? bytes / records : 0U,
+           records > 0U ? ((bytes % records) * 100U) / records : 0U);
+  last_stats = stats;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Trace bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void trace_bench_execute(const trace_bench_config_t *cfg) {
+  TraceStreamerConfig tsc = {cfg->trace, cfg->rtcfreq};
+  thread_t *ptp, *stp;
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT TRACE-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+  chprintf(cfg->out, "*** Trace Buffer: %d records\r\n",
+           CH_DBG_TRACE_BUFFER_SIZE);
+  chprintf(cfg->out, "*** Exchanges:    %d, bursts of %d\r\n",
+           TRACE_BENCH_CFG_EXCHANGES, TRACE_BENCH_CFG_BURST);
+  chprintf(cfg->out, "*** Trace Output: %s\r\n", cfg->trace_name);
+  chprintf(cfg->out, "\r\n");
+
+  chSemObjectInit(&sem_ping, (cnt_t)0);
+  chSemObjectInit(&sem_pong, (cnt_t)0);
+
+  /* The streamer runs at the lowest priority, it only gets the time left
+     by the application.*/
+  stp = chThdCreateStatic(waStreamer, sizeof (waStreamer), LOWPRIO,
+                          traceStreamerThread, &tsc);
+  ptp = chThdCreateStatic(waPonger, sizeof (waPonger), NORMALPRIO + 1,
+                          Ponger, NULL);
+
+  /* Letting the streamer send the header and start.*/
+  chThdSleepMilliseconds(TRACE_STREAMER_INTERVAL);
+  traceStreamerGetStats(&last_stats);
+
+  chprintf(cfg->out, "Phase           us   events  records  dropped     bytes bytes/rec\r\n");
+
+  phase_begin();
+  exchanges(TRACE_BENCH_CFG_EXCHANGES, true);
+  phase_end(cfg, "Steady");
+
+  phase_begin();
+  exchanges(TRACE_BENCH_CFG_EXCHANGES, false);
+  phase_end(cfg, "Burst");
+
+  chSemReset(&sem_ping, (cnt_t)0);
+  (void) chThdWait(ptp);
+
+  chThdTerminate(stp);
+  (void) chThdWait(stp);
+
+  chprintf(cfg->out, "\r\nTotal: %d records, %d dropped, %d bytes\r\n",
+           last_stats.records, last_stats.dropped, last_stats.bytes);
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
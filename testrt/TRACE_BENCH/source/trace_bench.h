@@ -0,0 +1,127 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_bench.h
+ * @brief   Trace Bench benchmark header.
+ *
+ * @addtogroup TRACE_BENCH
+ * @{
+ */
+
+#ifndef TRACE_BENCH_H
+#define TRACE_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of exchanges between the test threads in each phase.
+ */
+#if !defined(TRACE_BENCH_CFG_EXCHANGES) || defined(__DOXYGEN__)
+#define TRACE_BENCH_CFG_EXCHANGES           5000
+#endif
+
+/**
+ * @brief   Number of exchanges between pauses in the steady phase.
+ */
+#if !defined(TRACE_BENCH_CFG_BURST) || defined(__DOXYGEN__)
+#define TRACE_BENCH_CFG_BURST               50
+#endif
+
+/**
+ * @brief   Pause between bursts in the steady phase, milliseconds.
+ */
+#if !defined(TRACE_BENCH_CFG_PAUSE) || defined(__DOXYGEN__)
+#define TRACE_BENCH_CFG_PAUSE               10
+#endif
+
+/**
+ * @brief   Working area size of the test thread.
+ */
+#if !defined(TRACE_BENCH_CFG_WA_SIZE) || defined(__DOXYGEN__)
+#define TRACE_BENCH_CFG_WA_SIZE             1024
+#endif
+
+/**
+ * @brief   Working area size of the streamer thread.
+ * @note    The streamer writes on the output stream, enough stack must be
+ *          reserved for the stream implementation.
+ */
+#if !defined(TRACE_BENCH_CFG_STREAMER_WA_SIZE) || defined(__DOXYGEN__)
+#define TRACE_BENCH_CFG_STREAMER_WA_SIZE    8192
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Realtime counter frequency.
+   */
+  uint32_t              rtcfreq;
+  /**
+   * @brief   Stream for the trace records.
+   */
+  BaseSequentialStream  *trace;
+  /**
+   * @brief   Name of the trace destination.
+   */
+  const char            *trace_name;
+} trace_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void trace_bench_execute(const trace_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* TRACE_BENCH_H */
+
+/** @} */
@@ -0,0 +1,235 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    vt_bench.c
+ * @brief   VT Bench benchmark code.
+ *
+ * @addtogroup VT_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+#include "vt_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Background timers are spread over this range so that none of them
+ * expires during a measurement.
+ */
+#define LOAD_BASE_DELAY         TIME_S2I(100)
+#define LOAD_SPREAD_DELAY       TIME_S2I(100)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static const unsigned loads[] = {0U, 16U, 64U, 256U, VT_BENCH_CFG_MAX_TIMERS};
+
+static virtual_timer_t load[VT_BENCH_CFG_MAX_TIMERS];
+static virtual_timer_t probe;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void dummy_cb(void *p) {
+
+  (void)p;
+}
+
+/*
+ * Pseudo-random delay inside the load range, a simple LCG is enough.
+ */
+static sysinterval_t rnd_delay(void) {
+  static uint32_t seed = 1U;
+
+  seed = (seed * 1664525U) + 1013904223U;
+  return LOAD_BASE_DELAY + (sysinterval_t)((seed >> 8) % LOAD_SPREAD_DELAY);
+}
+
+/*
+ * Returns the average duration of an operation in nanoseconds.
+ */
+static uint32_t to_ns(const vt_bench_config_t *cfg, rtcnt_t cnt) {
+
+  return (uint32_t)(((uint64_t)cnt * 1000000000ULL) /
+                    ((uint64_t)cfg->rtcfreq * VT_BENCH_CFG_CYCLES));
+}
+
+/*
+ * Arm/disarm cycles of a single timer among the armed ones, the delay is
+ * random so the delta list is walked half of its length on average.
+ */
+static rtcnt_t bench_random(void) {
+  rtcnt_t start;
+  unsigned i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < VT_BENCH_CFG_CYCLES; i++) {
+    chSysLock();
+    chVTSetI(&probe, rnd_delay(), dummy_cb, NULL);
+    chVTResetI(&probe);
+    chSysUnlock();
+  }
+
+  return chSysGetRealtimeCounterX() - start;
+}
+
+/*
+ * Arm/disarm cycles of a timer expiring after all the armed ones, worst
+ * case for the delta list.
+ */
+static rtcnt_t bench_last(void) {
+  rtcnt_t start;
+  unsigned i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < VT_BENCH_CFG_CYCLES; i++) {
+    chSysLock();
+    chVTSetI(&probe, LOAD_BASE_DELAY + LOAD_SPREAD_DELAY, dummy_cb, NULL);
+    chVTResetI(&probe);
+    chSysUnlock();
+  }
+
+  return chSysGetRealtimeCounterX() - start;
+}
+
+/*
+ * Re-arming cycles of the already armed timers, this is what happens
+ * when threads repeatedly block with a timeout.
+ */
+static rtcnt_t bench_rearm(unsigned n) {
+  rtcnt_t start;
+  unsigned i;
+
+  if (n == 0U) {
+    return (rtcnt_t)0;
+  }
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < VT_BENCH_CFG_CYCLES; i++) {
+    chSysLock();
+    chVTSetI(&load[i % n], rnd_delay(), dummy_cb, NULL);
+    chSysUnlock();
+  }
+
+  return chSysGetRealtimeCounterX() - start;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   VT bench execution.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ *
+ * @api
+ */
+void vt_bench_execute(const vt_bench_config_t *cfg) {
+  unsigned i, j;
+
+  /* Printing environment information.*/
+  chprintf(cfg->out, "");
+  chprintf(cfg->out, "\r\n*** ChibiOS/RT VT-BENCH benchmark\r\n***\r\n");
+  chprintf(cfg->out, "*** Kernel:       %s\r\n", CH_KERNEL_VERSION);
+  chprintf(cfg->out, "*** Compiled:     %s\r\n", __DATE__ " - " __TIME__);
+#ifdef PORT_COMPILER_NAME
+  chprintf(cfg->out, "*** Compiler:     %s\r\n", PORT_COMPILER_NAME);
+#endif
+  chprintf(cfg->out, "*** Architecture: %s\r\n", PORT_ARCHITECTURE_NAME);
+#ifdef PORT_CORE_VARIANT_NAME
+  chprintf(cfg->out, "*** Core Variant: %s\r\n", PORT_CORE_VARIANT_NAME);
+#endif
+#ifdef PORT_INFO
+  chprintf(cfg->out, "*** Port Info:    %s\r\n", PORT_INFO);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, "*** Platform:     %s\r\n", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, "*** Test Board:   %s\r\n", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "***\r\n");
+#if CH_CFG_VT_USE_WHEEL == TRUE
+  chprintf(cfg->out, "*** Backend:      timing wheel (%d bits)\r\n",
+           CH_CFG_VT_WHEEL_BITS);
+#else
+  chprintf(cfg->out, "*** Backend:      delta list\r\n");
+#endif
+  chprintf(cfg->out, "*** System Time:  %d\r\n", CH_CFG_ST_RESOLUTION);
+  chprintf(cfg->out, "*** Intervals:    %d\r\n", CH_CFG_INTERVALS_SIZE);
+  chprintf(cfg->out, "*** SysTick:      %d\r\n", CH_CFG_ST_FREQUENCY);
+  chprintf(cfg->out, "*** Delta:        %d\r\n", CH_CFG_ST_TIMEDELTA);
+  chprintf(cfg->out, "*** Cycles:       %d\r\n", VT_BENCH_CFG_CYCLES);
+  chprintf(cfg->out, "\r\n");
+  chprintf(cfg->out, "Timers  Random(ns)  Last(ns)  Rearm(ns)\r\n");
+
+  chVTObjectInit(&probe);
+  for (i = 0U; i < VT_BENCH_CFG_MAX_TIMERS; i++) {
+    chVTObjectInit(&load[i]);
+  }
+
+  j = 0U;
+  for (i = 0U; i < sizeof (loads) / sizeof (loads[0]); i++) {
+    rtcnt_t t1, t2, t3;
+
+    /* Arming background timers up to the required load.*/
+    chSysLock();
+    while (j < loads[i]) {
+      chVTSetI(&load[j], rnd_delay(), dummy_cb, NULL);
+      j++;
+    }
+    chSysUnlock();
+
+    t1 = bench_random();
+    t2 = bench_last();
+    t3 = bench_rearm(j);
+
+    chprintf(cfg->out, "%6d  %10d  %8d  %9d\r\n",
+             j, to_ns(cfg, t1), to_ns(cfg, t2), to_ns(cfg, t3));
+  }
+
+  /* Disarming everything.*/
+  chSysLock();
+  for (i = 0U; i < VT_BENCH_CFG_MAX_TIMERS; i++) {
+    if (chVTIsArmedI(&load[i])) {
+      chVTResetI(&load[i]);
+    }
+  }
+  chSysUnlock();
+
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
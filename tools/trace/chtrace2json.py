@@ -0,0 +1,314 @@
+#!/usr/bin/env python3
+#
+#    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+"""Converts a ChibiOS/RT trace stream into a Chrome trace JSON file.
+
+The input is the binary stream produced by the trace streamer module
+(os/various/trace_streamer), the output can be loaded in chrome://tracing
+or in the Perfetto UI (https://ui.perfetto.dev).
+"""
+
+import argparse
+import json
+import sys
+
+# Kernel record types, see chtrace.h.
+TYPE_STREAMER   = 0
+TYPE_READY      = 1
+TYPE_SWITCH     = 2
+TYPE_ISR_ENTER  = 3
+TYPE_ISR_LEAVE  = 4
+TYPE_HALT       = 5
+TYPE_USER       = 6
+
+# Streamer records kinds, see trace_streamer.h.
+KIND_SYNC       = 0
+KIND_DROPPED    = 1
+KIND_NAME       = 2
+
+# Thread states, see CH_STATE_NAMES in chschd.h.
+STATE_NAMES = ["READY", "CURRENT", "WTSTART", "SUSPENDED", "QUEUED", "WTSEM",
+               "WTMTX", "WTCOND", "SLEEPING", "WTEXIT", "WTOREVT", "WTANDEVT",
+               "SNDMSGQ", "SNDMSG", "WTMSG", "FINAL"]
+
+RTSTAMP_RANGE = 1 << 24
+
+PID = 1
+ISR_TID = 1
+
+
+class StreamError(Exception):
+    pass
+
+
+class Reader:
+    """Sequential reader of the stream bytes."""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def at_end(self):
+        return self.pos >= len(self.data)
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise StreamError("truncated stream")
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def bytes(self, n):
+        if self.pos + n > len(self.data):
+            raise StreamError("truncated stream")
+        b = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return b
+
+    def u32(self):
+        return int.from_bytes(self.bytes(4), "little")
+
+    def number(self):
+        n = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            n |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80:
+                return n
+
+    def signed(self):
+        n = self.number()
+        return (n >> 1) ^ -(n & 1)
+
+
+class Decoder:
+    """Rebuilds the timeline from the stream records."""
+
+    def __init__(self, rtfreq, stfreq, systime_bits):
+        self.rtfreq = rtfreq
+        self.stfreq = stfreq
+        self.freq = rtfreq if rtfreq > 0 else stfreq
+        self.systime_range = 1 << systime_bits
+        self.names = {}
+        self.tids = {}
+        self.events = []
+        self.records = 0
+        self.dropped = 0
+        self.now = None
+        self.last_rt = 0
+        self.sync_sys = None
+        self.sync_now = 0
+        self.current = None
+        self.current_start = 0
+        self.isr_stack = []
+
+    # Time handling.
+
+    def us(self, t):
+        return t * 1000000.0 / self.freq
+
+    def sync(self, systime, rtstamp):
+        if self.sync_sys is None:
+            if self.rtfreq > 0:
+                self.now = systime * self.rtfreq // self.stfreq
+            else:
+                self.now = systime
+        else:
+            dsys = (systime - self.sync_sys) % self.systime_range
+            known = self.now - self.sync_now
+            if self.rtfreq > 0:
+                expected = dsys * self.rtfreq // self.stfreq - known
+                drt = (rtstamp - self.last_rt) % RTSTAMP_RANGE
+                wraps = max(0, round((expected - drt) / RTSTAMP_RANGE))
+                self.now += drt + wraps * RTSTAMP_RANGE
+            else:
+                self.now += max(0, dsys - known)
+        self.sync_sys = systime
+        self.sync_now = self.now
+        self.last_rt = rtstamp
+
+    def advance(self, dt):
+        if self.now is None:
+            raise StreamError("record without time reference")
+        self.now += dt
+        self.last_rt = (self.last_rt + dt) % RTSTAMP_RANGE
+
+    # Events generation.
+
+    def name(self, ident):
+        name = self.names.get(ident)
+        if name:
+            return name
+        return "0x%x" % ident
+
+    def tid(self, tp):
+        if tp not in self.tids:
+            self.tids[tp] = len(self.tids) + ISR_TID + 1
+        return self.tids[tp]
+
+    def instant(self, name, tid, args, scope="t"):
+        self.events.append({"name": name, "ph": "i", "s": scope, "pid": PID,
+                            "tid": tid, "ts": self.us(self.now),
+                            "args": args})
+
+    def slice(self, name, tid, start, args):
+        self.events.append({"name": name, "ph": "X", "pid": PID, "tid": tid,
+                            "ts": self.us(start),
+                            "dur": self.us(self.now - start),
+                            "args": args})
+
+    def close_current(self, args):
+        if self.current is not None:
+            self.slice(self.name(self.current), self.tid(self.current),
+                       self.current_start, args)
+
+    def record(self, rtype, state, r):
+        if rtype == TYPE_READY:
+            tp = r.number()
+            msg = r.signed()
+            self.instant("ready", self.tid(tp), {"msg": msg})
+        elif rtype == TYPE_SWITCH:
+            ntp = r.number()
+            wtobjp = r.number()
+            state_name = STATE_NAMES[state] if state < len(STATE_NAMES) \
+                         else str(state)
+            self.close_current({"out state": state_name,
+                                "wait object": "0x%x" % wtobjp})
+            self.current = ntp
+            self.current_start = self.now
+        elif rtype == TYPE_ISR_ENTER:
+            self.isr_stack.append((r.number(), self.now))
+        elif rtype == TYPE_ISR_LEAVE:
+            name = r.number()
+            if self.isr_stack:
+                name, start = self.isr_stack.pop()
+                self.slice(self.name(name), ISR_TID, start, {})
+        elif rtype == TYPE_HALT:
+            self.instant("halt: " + self.name(r.number()), 0, {}, "g")
+        elif rtype == TYPE_USER:
+            up1 = r.number()
+            up2 = r.number()
+            tid = self.tid(self.current) if self.current is not None \
+                  else ISR_TID
+            self.instant("user", tid, {"up1": "0x%x" % up1,
+                                       "up2": "0x%x" % up2})
+        else:
+            raise StreamError("unknown record type %d" % rtype)
+        self.records += 1
+
+    def streamer_record(self, kind, r):
+        if kind == KIND_SYNC:
+            systime = r.number()
+            rtstamp = r.number()
+            self.sync(systime, rtstamp)
+        elif kind == KIND_DROPPED:
+            n = r.number()
+            self.dropped += n
+            if self.now is not None:
+                self.instant("dropped %d records" % n, 0, {"count": n}, "g")
+                self.events.append({"name": "dropped records", "ph": "C",
+                                    "pid": PID, "ts": self.us(self.now),
+                                    "args": {"total": self.dropped}})
+        elif kind == KIND_NAME:
+            ident = r.number()
+            n = r.number()
+            self.names[ident] = r.bytes(n).decode("ascii", "replace")
+        else:
+            raise StreamError("unknown streamer record kind %d" % kind)
+
+    def decode(self, r):
+        while not r.at_end():
+            tag = r.byte()
+            rtype = tag & 7
+            state = tag >> 3
+            if rtype == TYPE_STREAMER:
+                self.streamer_record(state, r)
+            else:
+                self.advance(r.number())
+                self.record(rtype, state, r)
+
+    def finish(self):
+        if self.now is not None:
+            self.close_current({})
+        meta = [{"name": "process_name", "ph": "M", "pid": PID,
+                 "args": {"name": "ChibiOS/RT"}},
+                {"name": "thread_name", "ph": "M", "pid": PID,
+                 "tid": ISR_TID, "args": {"name": "ISRs"}}]
+        for tp, tid in self.tids.items():
+            meta.append({"name": "thread_name", "ph": "M", "pid": PID,
+                         "tid": tid, "args": {"name": self.name(tp)}})
+        return {"traceEvents": meta + self.events,
+                "displayTimeUnit": "ns",
+                "otherData": {"records": self.records,
+                              "dropped": self.dropped}}
+
+
+def decode(data):
+    r = Reader(data)
+    if r.bytes(4) != b"CHTS":
+        raise StreamError("not a trace stream")
+    version = r.byte()
+    if version != 1:
+        raise StreamError("unsupported stream version %d" % version)
+    systime_bits = r.byte() * 8
+    rtfreq = r.u32()
+    stfreq = r.u32()
+    d = Decoder(rtfreq, stfreq, systime_bits)
+    try:
+        d.decode(r)
+    except StreamError as e:
+        # A capture can be interrupted at any point, what has been decoded
+        # is still returned.
+        print("warning: %s at offset %d" % (e, r.pos), file=sys.stderr)
+    return d
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="trace stream file, - for stdin")
+    parser.add_argument("-o", "--output", default="-",
+                        help="JSON output file, - for stdout")
+    args = parser.parse_args()
+
+    if args.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, "rb") as f:
+            data = f.read()
+
+    try:
+        d = decode(data)
+    except StreamError as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 1
+
+    result = d.finish()
+    if args.output == "-":
+        json.dump(result, sys.stdout)
+    else:
+        with open(args.output, "w") as f:
+            json.dump(result, f)
+
+    print("%d records, %d dropped, %d threads" %
+          (d.records, d.dropped, len(d.tids)), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())